@@ -0,0 +1,206 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+
+#include <core/chronometer.h>
+#include <core/exception.h>
+#include <core/runtime.h>
+#include <core/utils.h>
+
+#include <algorithm>
+#include <numeric>
+#include <stdio.h>
+#include <unordered_map>
+using namespace std;
+
+namespace benchmarks {
+
+namespace {
+
+volatile double g_sink = 0;
+
+}  // namespace
+
+double Result::itemsPerSecond() const {
+  return median_ms > 0 ? items * 1000.0 / median_ms : 0;
+}
+
+void to_json(json& json_obj, const Result& result) {
+  json_obj["name"] = result.name;
+  json_obj["category"] = core::toString(result.category);
+  json_obj["items"] = result.items;
+  json_obj["repetitions"] = result.repetitions;
+  json_obj["min_ms"] = result.min_ms;
+  json_obj["median_ms"] = result.median_ms;
+  json_obj["mean_ms"] = result.mean_ms;
+  json_obj["items_per_second"] = result.itemsPerSecond();
+}
+
+void from_json(const json& json_obj, Result& result) {
+  result.name = json_obj.at("name").get<string>();
+  result.category = core::fromString<Category>(json_obj.at("category").get<string>());
+  result.items = json_obj.at("items").get<size_t>();
+  result.repetitions = json_obj.at("repetitions").get<int>();
+  result.min_ms = json_obj.at("min_ms").get<double>();
+  result.median_ms = json_obj.at("median_ms").get<double>();
+  result.mean_ms = json_obj.at("mean_ms").get<double>();
+}
+
+void State::measure(size_t items,
+                    const function<void()>& body,
+                    const function<void()>& setup) {
+  CHECK(samples_ms_.empty(), "measure() can only be called once per benchmark");
+  CHECK(items > 0);
+  items_ = items;
+
+  auto repetition = [&] {
+    if (setup)
+      setup();
+    double elapsed_ms = 0;
+    {
+      core::Chronometer chronometer(&elapsed_ms);
+      body();
+    }
+    return elapsed_ms;
+  };
+
+  // warm-up (caches, lazy initialization, ...)
+  repetition();
+
+  double total_ms = 0;
+  while (int(samples_ms_.size()) < options_.max_repetitions) {
+    if (int(samples_ms_.size()) >= options_.min_repetitions &&
+        total_ms >= options_.min_time_ms) {
+      break;
+    }
+    const double elapsed_ms = repetition();
+    samples_ms_.push_back(elapsed_ms);
+    total_ms += elapsed_ms;
+  }
+}
+
+void Suite::add(const string& name, Category category, const BenchmarkBody& body) {
+  for (const auto& benchmark : benchmarks_) {
+    CHECK(benchmark.name != name, "Duplicate benchmark name");
+  }
+  benchmarks_.push_back({ name, category, body });
+}
+
+vector<string> Suite::names() const {
+  vector<string> names;
+  for (const auto& benchmark : benchmarks_) {
+    names.push_back(benchmark.name);
+  }
+  return names;
+}
+
+vector<Result> Suite::run(const Options& options) const {
+  vector<Result> results;
+  for (const auto& benchmark : benchmarks_) {
+    if (!options.filter.empty() && benchmark.name.find(options.filter) == string::npos)
+      continue;
+
+    State state(options);
+    benchmark.body(&state);
+    if (state.samples().empty())
+      throw core::Exception("Benchmark '%s' didn't measure anything", benchmark.name);
+
+    auto samples = state.samples();
+    std::sort(samples.begin(), samples.end());
+    const size_t count = samples.size();
+
+    Result result;
+    result.name = benchmark.name;
+    result.category = benchmark.category;
+    result.items = state.items();
+    result.repetitions = int(count);
+    result.min_ms = samples.front();
+    result.median_ms = (count % 2 == 1)
+                           ? samples[count / 2]
+                           : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+    result.mean_ms = std::accumulate(samples.begin(), samples.end(), 0.0) / count;
+
+    printf("%-60s %12.3f ms %14.1f items/s  (%d reps)\n",
+           result.name.c_str(),
+           result.median_ms,
+           result.itemsPerSecond(),
+           result.repetitions);
+    fflush(stdout);
+
+    results.push_back(result);
+  }
+  return results;
+}
+
+json resultsToJson(const vector<Result>& results) {
+  json json_obj;
+  json_obj["build"] = core::Runtime::buildString();
+  json_obj["benchmarks"] = results;
+  return json_obj;
+}
+
+vector<Result> resultsFromJson(const json& json_obj) {
+  return json_obj.at("benchmarks").get<vector<Result>>();
+}
+
+vector<Comparison> compareResults(const vector<Result>& results,
+                                  const vector<Result>& baseline,
+                                  double tolerance_percent) {
+  CHECK(tolerance_percent >= 0);
+
+  unordered_map<string, const Result*> baseline_index;
+  for (const auto& result : baseline) {
+    baseline_index[result.name] = &result;
+  }
+
+  vector<Comparison> comparisons;
+  for (const auto& result : results) {
+    auto it = baseline_index.find(result.name);
+    if (it == baseline_index.end())
+      continue;
+
+    const auto baseline_result = it->second;
+    if (baseline_result->items != result.items) {
+      throw core::Exception("Benchmark '%s' doesn't match the baseline configuration",
+                            result.name);
+    }
+
+    // same number of items per repetition, so the median times are comparable
+    Comparison comparison;
+    comparison.name = result.name;
+    if (baseline_result->median_ms > 0) {
+      comparison.change = result.median_ms / baseline_result->median_ms - 1;
+    }
+    comparison.regression = comparison.change * 100 > tolerance_percent;
+    comparisons.push_back(comparison);
+  }
+  return comparisons;
+}
+
+void consume(double value) {
+  g_sink = value;
+}
+
+void setProperty(core::PropertySet* config, const string& name, const string& value) {
+  for (auto property : config->properties()) {
+    if (property->name() == name) {
+      property->setValue(value);
+      return;
+    }
+  }
+  throw core::Exception("Unknown property '%s'", name);
+}
+
+}  // namespace benchmarks
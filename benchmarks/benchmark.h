@@ -0,0 +1,174 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <core/properties.h>
+#include <core/stringify.h>
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <functional>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace benchmarks {
+
+//! Benchmark category
+enum class Category {
+  Micro,  //!< Isolated hot paths (ex. Brain::think())
+  Macro,  //!< End-to-end workloads (ex. a full generation)
+};
+
+inline auto customStringify(core::TypeTag<Category>) {
+  static auto stringify = new core::StringifyKnownValues<Category>{
+    { Category::Micro, "micro" },
+    { Category::Macro, "macro" },
+  };
+  return stringify;
+}
+
+//! Benchmark runner options
+struct Options {
+  //! Only run the benchmarks with names containing this string (if not empty)
+  string filter;
+
+  //! The minimum number of timed repetitions
+  int min_repetitions = 5;
+
+  //! The maximum number of timed repetitions
+  int max_repetitions = 1000;
+
+  //! Keep repeating (up to max_repetitions) until this much time is spent
+  double min_time_ms = 500;
+
+  //! Regression threshold (as a percentage of the baseline median time)
+  double tolerance_percent = 10;
+};
+
+//! The results for a single benchmark
+struct Result {
+  string name;
+  Category category = Category::Micro;
+
+  //! The number of work items processed in each repetition
+  size_t items = 0;
+
+  int repetitions = 0;
+
+  //! Time per repetition, in milliseconds
+  double min_ms = 0;
+  double median_ms = 0;
+  double mean_ms = 0;
+
+  //! Throughput, based on the median time
+  double itemsPerSecond() const;
+
+  friend void to_json(json& json_obj, const Result& result);
+  friend void from_json(const json& json_obj, Result& result);
+};
+
+//! The timing loop for a single benchmark
+class State {
+ public:
+  explicit State(const Options& options) : options_(options) {}
+
+  //! Times the benchmark body
+  //!
+  //! Each repetition is expected to process the specified number of work items.
+  //! The optional `setup` is invoked, untimed, before every repetition.
+  //!
+  //! \note measure() must be called exactly once per benchmark
+  //!
+  void measure(size_t items,
+               const function<void()>& body,
+               const function<void()>& setup = nullptr);
+
+  //! The measurements (valid after measure() returns)
+  const vector<double>& samples() const { return samples_ms_; }
+
+  //! The number of work items per repetition
+  size_t items() const { return items_; }
+
+ private:
+  const Options& options_;
+  vector<double> samples_ms_;
+  size_t items_ = 0;
+};
+
+//! A benchmark entry point
+using BenchmarkBody = function<void(State*)>;
+
+//! A collection of named benchmarks
+class Suite {
+ public:
+  //! Registers a new benchmark (the name must be unique)
+  void add(const string& name, Category category, const BenchmarkBody& body);
+
+  //! The names of the registered benchmarks
+  vector<string> names() const;
+
+  //! Runs the selected benchmarks
+  vector<Result> run(const Options& options) const;
+
+ private:
+  struct Benchmark {
+    string name;
+    Category category = Category::Micro;
+    BenchmarkBody body;
+  };
+
+  vector<Benchmark> benchmarks_;
+};
+
+//! The outcome of comparing one result against the baseline
+struct Comparison {
+  string name;
+
+  //! Relative change in the median time (ex. +0.15 means 15% slower)
+  double change = 0;
+
+  bool regression = false;
+};
+
+//! Serializes a set of results (including the build information)
+json resultsToJson(const vector<Result>& results);
+
+//! Loads a set of results previously saved by resultsToJson()
+vector<Result> resultsFromJson(const json& json_obj);
+
+//! Compares the results against a baseline
+//!
+//! Only the benchmarks present in both sets are compared.
+//!
+vector<Comparison> compareResults(const vector<Result>& results,
+                                  const vector<Result>& baseline,
+                                  double tolerance_percent);
+
+//! Keeps a computed value "alive" (so the compiler can't optimize away its computation)
+void consume(double value);
+
+//! Helper for setting a property value by name (ex. "selection_algorithm")
+void setProperty(core::PropertySet* config, const string& name, const string& value);
+
+// the benchmarks registration
+void addBrainBenchmarks(Suite* suite);
+void addCameraBenchmarks(Suite* suite);
+void addDomainBenchmarks(Suite* suite);
+void addSelectionBenchmarks(Suite* suite);
+void addGenerationBenchmarks(Suite* suite);
+
+}  // namespace benchmarks
@@ -0,0 +1,37 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <core/darwin.h>
+
+namespace benchmarks {
+
+//! A placeholder domain, used to instantiate populations with a specific
+//! number of inputs and outputs
+class BenchmarkDomain : public darwin::Domain {
+ public:
+  BenchmarkDomain(size_t inputs, size_t outputs) : inputs_(inputs), outputs_(outputs) {}
+
+  size_t inputs() const override { return inputs_; }
+  size_t outputs() const override { return outputs_; }
+
+  bool evaluatePopulation(darwin::Population*) const override { return false; }
+
+ private:
+  size_t inputs_ = 0;
+  size_t outputs_ = 0;
+};
+
+}  // namespace benchmarks
@@ -0,0 +1,24 @@
+include(../common.pri)
+
+TEMPLATE = app
+CONFIG += console
+CONFIG += thread
+CONFIG -= app_bundle
+CONFIG -= qt
+CONFIG += link_prl
+
+SOURCES += \
+    main.cpp \
+    benchmark.cpp \
+    brain_benchmarks.cpp \
+    camera_benchmarks.cpp \
+    domain_benchmarks.cpp \
+    generation_benchmarks.cpp \
+    selection_benchmarks.cpp
+
+HEADERS += \
+    benchmark.h \
+    benchmark_domain.h
+
+addLibrary(../registry)
+addLibrary(../core)
@@ -0,0 +1,75 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+#include "benchmark_domain.h"
+
+#include <core/darwin.h>
+#include <core/format.h>
+#include <core/utils.h>
+
+#include <memory>
+#include <random>
+#include <vector>
+using namespace std;
+
+namespace benchmarks {
+
+// Brain::think() for every registered population, using a range of brain sizes
+// (the number of inputs and outputs, the hidden structure is the population default)
+void addBrainBenchmarks(Suite* suite) {
+  constexpr int kPopulationSize = 16;
+  constexpr int kThinkSteps = 1000;
+  constexpr size_t kSizes[] = { 8, 32, 128 };
+
+  for (const auto& [population_name, factory] : darwin::registry()->populations) {
+    for (size_t size : kSizes) {
+      auto name = core::format("brain/%s/io_%d", population_name, size);
+      auto body = [population_factory = factory.get(), size](State* state) {
+        BenchmarkDomain domain(size, size);
+        auto config = population_factory->defaultConfig(darwin::ComplexityHint::Balanced);
+        auto population = population_factory->create(*config, domain);
+        population->createPrimordialGeneration(kPopulationSize);
+        auto brain = population->genotype(0)->grow();
+
+        // a fixed set of inputs
+        default_random_engine rnd(size);
+        uniform_real_distribution<float> dist(-1, 1);
+        vector<float> inputs(size * kThinkSteps);
+        for (auto& value : inputs) {
+          value = dist(rnd);
+        }
+
+        float checksum = 0;
+        state->measure(kThinkSteps, [&] {
+          const float* input = inputs.data();
+          for (int step = 0; step < kThinkSteps; ++step) {
+            for (size_t i = 0; i < size; ++i) {
+              brain->setInput(int(i), *input++);
+            }
+            brain->think();
+            for (size_t i = 0; i < size; ++i) {
+              checksum += brain->output(int(i));
+            }
+          }
+        });
+
+        consume(checksum);
+      };
+      suite->add(name, Category::Micro, body);
+    }
+  }
+}
+
+}  // namespace benchmarks
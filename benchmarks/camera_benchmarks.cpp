@@ -0,0 +1,87 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "benchmark.h"
+
+#include <core/format.h>
+#include <core/sim/camera.h>
+#include <core/sim/track.h>
+#include <third_party/box2d/box2d.h>
+
+#include <math.h>
+#include <vector>
+using namespace std;
+
+namespace benchmarks {
+
+// sim::Camera::render() on a car_track style scene (a track with gates and
+// a light attached to the camera body), comparing the reference ray casting
+// (b2World::RayCast) with the batched sim::RayCaster implementation
+void addCameraBenchmarks(Suite* suite) {
+  constexpr int kViews = 100;
+  constexpr int kResolutions[] = { 16, 64, 256 };
+
+  for (bool batched : { false, true }) {
+    for (int resolution : kResolutions) {
+      auto name = core::format(
+          "camera/%s/res_%d", batched ? "batched" : "reference", resolution);
+      auto body = [batched, resolution](State* state) {
+        b2World world(b2Vec2(0, 0));
+
+        sim::TrackConfig track_config;
+        track_config.gates = true;
+        const sim::Track track(1, track_config);
+        track.createFixtures(&world);
+
+        b2BodyDef body_def;
+        body_def.type = b2_dynamicBody;
+        auto camera_body = world.CreateBody(&body_def);
+
+        b2LightDef light_def;
+        light_def.body = camera_body;
+        light_def.color = b2Color(1, 1, 1);
+        light_def.intensity = 2.0f;
+        light_def.attenuation_distance = 10.0f;
+        world.CreateLight(&light_def);
+
+        sim::Camera camera(camera_body, 90, 0.1f, 50.0f, resolution);
+        camera.setBatchedRaycasting(batched);
+
+        // a fixed set of camera positions along the track
+        vector<b2Transform> views(kViews);
+        for (int i = 0; i < kViews; ++i) {
+          const auto& node = track.distanceToNode(i * track.nodesCount() / kViews);
+          const auto position = node.offset(-track_config.width / 2);
+          views[i].p.Set(float(position.x), float(position.y));
+          views[i].q.Set(float(atan2(node.n.y, node.n.x)));
+        }
+
+        float checksum = 0;
+        state->measure(kViews * resolution, [&] {
+          for (const auto& view : views) {
+            camera_body->SetTransform(view.p, view.q.GetAngle());
+            for (const auto& receptor : camera.render()) {
+              checksum += receptor.depth;
+            }
+          }
+        });
+
+        consume(checksum);
+      };
+      suite->add(name, Category::Micro, body);
+    }
+  }
+}
+
+}  // namespace benchmarks
@@ -0,0 +1,94 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "benchmark.h"
+
+#include <core/darwin.h>
+#include <core/format.h>
+#include <core/utils.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace benchmarks {
+
+// Domain::evaluatePopulation() for every registered domain
+//
+// The population is fixed (a small, minimal cne.feedforward population) so
+// the measurements are dominated by the domain simulation. The throughput
+// is reported in evaluated genotypes (episodes) per second.
+//
+// A few domains are also measured with alternate configurations
+// (ex. the analytic physics for the cart-pole domains, or large harvester maps).
+//
+void addDomainBenchmarks(Suite* suite) {
+  constexpr int kPopulationSize = 20;
+  constexpr char kPopulationName[] = "cne.feedforward";
+
+  struct Variant {
+    string domain;
+    vector<pair<string, string>> properties;
+  };
+
+  const vector<Variant> variants = {
+    { "cart_pole", { { "physics", "analytic" } } },
+    { "double_cart_pole", { { "physics", "analytic" } } },
+    { "harvester", { { "map_width", "256" }, { "map_height", "256" } } },
+    { "tic_tac_toe", { { "tournament_type", "swiss" } } },
+    { "tic_tac_toe", { { "tournament_type", "swiss" }, { "memoize_moves", "true" } } },
+  };
+
+  auto population_factory = darwin::registry()->populations.find(kPopulationName);
+  CHECK(population_factory != nullptr);
+
+  auto addBenchmark = [&](const string& name,
+                          darwin::DomainFactory* domain_factory,
+                          const Variant& variant) {
+    auto body = [domain_factory, population_factory, variant](State* state) {
+      auto domain_config = domain_factory->defaultConfig(darwin::ComplexityHint::Minimal);
+      for (const auto& [property, value] : variant.properties) {
+        setProperty(domain_config.get(), property, value);
+      }
+      auto domain = domain_factory->create(*domain_config);
+
+      auto population_config =
+          population_factory->defaultConfig(darwin::ComplexityHint::Minimal);
+      auto population = population_factory->create(*population_config, *domain);
+      population->createPrimordialGeneration(kPopulationSize);
+
+      state->measure(kPopulationSize,
+                     [&] { domain->evaluatePopulation(population.get()); });
+    };
+    suite->add(name, Category::Macro, body);
+  };
+
+  for (const auto& [domain_name, factory] : darwin::registry()->domains) {
+    addBenchmark(core::format("domain/%s", domain_name), factory.get(), Variant());
+    for (const auto& variant : variants) {
+      if (variant.domain == domain_name) {
+        string settings;
+        for (const auto& [property, value] : variant.properties) {
+          settings += core::format(
+              "%s%s=%s", settings.empty() ? "" : ",", property, value);
+        }
+        const auto name = core::format("domain/%s/%s", domain_name, settings);
+        addBenchmark(name, factory.get(), variant);
+      }
+    }
+  }
+}
+
+}  // namespace benchmarks
@@ -0,0 +1,65 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "benchmark.h"
+
+#include <core/darwin.h>
+#include <core/format.h>
+#include <core/utils.h>
+
+#include <memory>
+#include <string>
+using namespace std;
+
+namespace benchmarks {
+
+// Full generation throughput (evaluation + creating the next generation)
+// for a representative set of domain / population combinations
+void addGenerationBenchmarks(Suite* suite) {
+  constexpr int kPopulationSize = 100;
+
+  const pair<string, string> experiments[] = {
+    { "cart_pole", "cne.feedforward" },
+    { "find_max_value", "cne.rnn" },
+    { "harvester", "cne.lstm" },
+    { "pong", "cgp" },
+    { "tic_tac_toe", "neat" },
+    { "car_track", "cne.lstm_lite" },
+  };
+
+  for (const auto& [domain_name, population_name] : experiments) {
+    auto domain_factory = darwin::registry()->domains.find(domain_name);
+    auto population_factory = darwin::registry()->populations.find(population_name);
+    if (domain_factory == nullptr || population_factory == nullptr)
+      continue;
+
+    auto name = core::format("generation/%s/%s", domain_name, population_name);
+    auto body = [domain_factory, population_factory](State* state) {
+      auto domain_config = domain_factory->defaultConfig(darwin::ComplexityHint::Minimal);
+      auto domain = domain_factory->create(*domain_config);
+
+      auto population_config =
+          population_factory->defaultConfig(darwin::ComplexityHint::Minimal);
+      auto population = population_factory->create(*population_config, *domain);
+      population->createPrimordialGeneration(kPopulationSize);
+
+      state->measure(kPopulationSize, [&] {
+        domain->evaluatePopulation(population.get());
+        population->createNextGeneration();
+      });
+    };
+    suite->add(name, Category::Macro, body);
+  }
+}
+
+}  // namespace benchmarks
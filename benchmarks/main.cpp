@@ -0,0 +1,175 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "benchmark.h"
+
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/runtime.h>
+#include <core/thread_pool.h>
+#include <registry/registry.h>
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <fstream>
+#include <memory>
+#include <stdio.h>
+#include <string>
+using namespace std;
+
+namespace {
+
+constexpr char kUsage[] =
+    "Usage: benchmarks [options]\n"
+    "\n"
+    "  --list                 List the available benchmarks\n"
+    "  --filter=<str>         Only run benchmarks with names containing <str>\n"
+    "  --output=<file>        Save the results (JSON)\n"
+    "  --baseline=<file>      Compare the results against a saved baseline\n"
+    "  --tolerance=<percent>  Regression threshold (default: 10)\n"
+    "  --min_repetitions=<n>  Minimum number of repetitions (default: 5)\n"
+    "  --min_time=<ms>        Minimum time per benchmark (default: 500)\n"
+    "\n"
+    "Exit status: 0 = success, 1 = performance regressions, 2 = errors\n";
+
+class NullProgressMonitor final : public darwin::ProgressMonitor {
+  void beginStage(const string&, size_t, uint32_t) final {}
+  void finishStage(const string&) final {}
+  void reportProgress(size_t) final {}
+};
+
+// matches "--name=value" arguments
+bool parseOption(const string& arg, const string& name, string* value) {
+  const auto prefix = "--" + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0)
+    return false;
+  *value = arg.substr(prefix.size());
+  return true;
+}
+
+json loadJson(const string& filename) {
+  ifstream file(filename);
+  if (!file)
+    throw core::Exception("Can't open '%s'", filename);
+  json json_obj;
+  file >> json_obj;
+  return json_obj;
+}
+
+void saveJson(const string& filename, const json& json_obj) {
+  ofstream file(filename);
+  if (!file)
+    throw core::Exception("Can't create '%s'", filename);
+  file << json_obj.dump(2) << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  benchmarks::Options options;
+  string output_filename;
+  string baseline_filename;
+  bool list_only = false;
+
+  try {
+    for (int i = 1; i < argc; ++i) {
+      const string arg = argv[i];
+      string value;
+      if (arg == "--list") {
+        list_only = true;
+      } else if (parseOption(arg, "filter", &value)) {
+        options.filter = value;
+      } else if (parseOption(arg, "output", &value)) {
+        output_filename = value;
+      } else if (parseOption(arg, "baseline", &value)) {
+        baseline_filename = value;
+      } else if (parseOption(arg, "tolerance", &value)) {
+        options.tolerance_percent = stod(value);
+      } else if (parseOption(arg, "min_repetitions", &value)) {
+        options.min_repetitions = stoi(value);
+      } else if (parseOption(arg, "min_time", &value)) {
+        options.min_time_ms = stod(value);
+      } else {
+        fprintf(stderr, "%s", kUsage);
+        return 2;
+      }
+    }
+  } catch (const std::exception&) {
+    fprintf(stderr, "%s", kUsage);
+    return 2;
+  }
+
+  // Darwin initialization
+  core::Runtime::init(argc, argv);
+  registry::init();
+
+  auto monitor = make_unique<NullProgressMonitor>();
+  darwin::ProgressManager::registerMonitor(monitor.get());
+
+  pp::ParallelForSupport::init(nullptr);
+
+  benchmarks::Suite suite;
+  benchmarks::addBrainBenchmarks(&suite);
+  benchmarks::addCameraBenchmarks(&suite);
+  benchmarks::addSelectionBenchmarks(&suite);
+  benchmarks::addDomainBenchmarks(&suite);
+  benchmarks::addGenerationBenchmarks(&suite);
+
+  if (list_only) {
+    for (const auto& name : suite.names()) {
+      printf("%s\n", name.c_str());
+    }
+    return 0;
+  }
+
+#ifndef NDEBUG
+  printf("\nWARNING: this is a debug build, the results are not representative\n");
+#endif
+
+  try {
+    printf("\nRunning benchmarks (%s)\n\n", core::Runtime::buildString());
+    const auto results = suite.run(options);
+
+    if (!output_filename.empty()) {
+      saveJson(output_filename, benchmarks::resultsToJson(results));
+    }
+
+    if (!baseline_filename.empty()) {
+      const auto baseline = benchmarks::resultsFromJson(loadJson(baseline_filename));
+      const auto comparisons =
+          benchmarks::compareResults(results, baseline, options.tolerance_percent);
+
+      int regressions = 0;
+      printf("\nComparison against '%s':\n\n", baseline_filename.c_str());
+      for (const auto& comparison : comparisons) {
+        printf("%-60s %+8.1f%%%s\n",
+               comparison.name.c_str(),
+               comparison.change * 100,
+               comparison.regression ? "  REGRESSION" : "");
+        if (comparison.regression)
+          ++regressions;
+      }
+
+      if (regressions > 0) {
+        printf("\n%d performance regression(s)\n", regressions);
+        return 1;
+      }
+    }
+  } catch (const std::exception& e) {
+    fprintf(stderr, "\nBenchmarks failed: %s\n", e.what());
+    return 2;
+  }
+
+  return 0;
+}
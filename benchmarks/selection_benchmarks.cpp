@@ -0,0 +1,81 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "benchmark.h"
+#include "benchmark_domain.h"
+
+#include <core/darwin.h>
+#include <core/format.h>
+#include <core/utils.h>
+
+#include <memory>
+#include <random>
+using namespace std;
+
+namespace benchmarks {
+
+namespace {
+
+constexpr char kSelectionAlgorithm[] = "selection_algorithm";
+
+}  // namespace
+
+// Population::createNextGeneration() for every selection algorithm
+// (for the populations which support multiple selection algorithms)
+void addSelectionBenchmarks(Suite* suite) {
+  constexpr int kPopulationSize = 1000;
+  const char* population_names[] = { "cne.feedforward", "cgp" };
+
+  for (const auto population_name : population_names) {
+    auto population_factory = darwin::registry()->populations.find(population_name);
+    if (population_factory == nullptr)
+      continue;
+
+    // enumerate the known selection algorithms
+    vector<string> selection_algorithms;
+    auto default_config =
+        population_factory->defaultConfig(darwin::ComplexityHint::Balanced);
+    for (const auto property : default_config->properties()) {
+      if (property->name() == kSelectionAlgorithm) {
+        selection_algorithms = property->knownValues();
+      }
+    }
+
+    for (const auto& selection_algorithm : selection_algorithms) {
+      auto name =
+          core::format("selection/%s/%s", population_name, selection_algorithm);
+      auto body = [population_factory, selection_algorithm](State* state) {
+        BenchmarkDomain domain(16, 4);
+        auto config = population_factory->defaultConfig(darwin::ComplexityHint::Balanced);
+        setProperty(config.get(), kSelectionAlgorithm, selection_algorithm);
+        auto population = population_factory->create(*config, domain);
+        population->createPrimordialGeneration(kPopulationSize);
+
+        // the same (reproducible) sequence of fitness values for every run
+        default_random_engine rnd(kPopulationSize);
+        normal_distribution<float> dist(0, 1);
+        auto assignFitness = [&] {
+          for (size_t i = 0; i < population->size(); ++i) {
+            population->genotype(i)->fitness = dist(rnd);
+          }
+        };
+
+        state->measure(
+            kPopulationSize, [&] { population->createNextGeneration(); }, assignFitness);
+      };
+      suite->add(name, Category::Micro, body);
+    }
+  }
+}
+
+}  // namespace benchmarks
@@ -345,6 +345,7 @@ Experiment::Experiment(shared_ptr<Domain> domain,
 
 Experiment::~Experiment() {
   reset();
+  ann::g_config.unbind(&core_config_);
 
   // population and domain can be now used in new experiments
   domain_->setUsed(false);
@@ -402,8 +403,8 @@ GenerationSummary Experiment::evaluatePopulation() {
     throw std::runtime_error("population must be initialized first");
   }
 
-  // setup the shared ANN library
-  ann::g_config.copyFrom(core_config_);
+  // setup the ANN library
+  ann::g_config.bind(&core_config_);
 
   const auto real_population = population_->realPopulation();
   CHECK(real_population != nullptr);
@@ -447,8 +448,8 @@ void Experiment::createNextGeneration() {
     throw std::runtime_error("population must be initialized first");
   }
 
-  // setup the shared ANN library
-  ann::g_config.copyFrom(core_config_);
+  // setup the ANN library
+  ann::g_config.bind(&core_config_);
 
   const auto real_population = population_->realPopulation();
   CHECK(real_population != nullptr);
@@ -16,8 +16,7 @@
 
 namespace ann {
 
-ActivationFunctionPfn g_activation_function = nullptr;
-ActivationFunctionPfn g_gate_activation_function = nullptr;
+core::ContextSlot<ActivationFunctions> g_activation_functions;
 
 static ActivationFunctionPfn activationFunctionPfn(ActivationFunction afn) {
   switch (afn) {
@@ -40,12 +39,9 @@ static ActivationFunctionPfn activationFunctionPfn(ActivationFunction afn) {
   }
 }
 
-void setActivationFunction(ActivationFunction afn) {
-  g_activation_function = activationFunctionPfn(afn);
-}
-
-void setGateActivationFunction(ActivationFunction afn) {
-  g_gate_activation_function = activationFunctionPfn(afn);
-}
+ActivationFunctions::ActivationFunctions(ActivationFunction afn,
+                                         ActivationFunction gate_afn)
+    : activation(activationFunctionPfn(afn)),
+      gate_activation(activationFunctionPfn(gate_afn)) {}
 
 }  // namespace ann
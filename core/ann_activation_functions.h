@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <core/context.h>
 #include <core/stringify.h>
 
 #include <cmath>
@@ -50,26 +51,33 @@ inline auto customStringify(core::TypeTag<ActivationFunction>) {
 
 using ActivationFunctionPfn = float (*)(float);
 
-extern ActivationFunctionPfn g_activation_function;
-extern ActivationFunctionPfn g_gate_activation_function;
+//! The selected activation functions
+struct ActivationFunctions {
+  //! The main activation function
+  ActivationFunctionPfn activation = nullptr;
 
-//! Selects the activation function
-void setActivationFunction(ActivationFunction afn);
+  //! The gate activation function
+  //! (used with ANNs which include gates, for example LSTM)
+  ActivationFunctionPfn gate_activation = nullptr;
 
-//! Selects the gate activation function
-//! (used with ANNs which include gates, for example LSTM)
-void setGateActivationFunction(ActivationFunction afn);
+  ActivationFunctions() = default;
+  ActivationFunctions(ActivationFunction afn, ActivationFunction gate_afn);
+};
+
+//! The activation functions for the current context
+//! (normally bound to the population instance, see core::ContextSlot)
+extern core::ContextSlot<ActivationFunctions> g_activation_functions;
 
 //! Applies the selected activation function
-//! \sa setActivationFunction
+//! \sa ActivationFunctions
 inline float activate(float x) {
-  return (*g_activation_function)(x);
+  return (*g_activation_functions->activation)(x);
 }
 
 //! Applies the selected gate activation function
-//! \sa setGateActivationFunction
+//! \sa ActivationFunctions
 inline float activateGate(float x) {
-  return (*g_gate_activation_function)(x);
+  return (*g_activation_functions->gate_activation)(x);
 }
 
 //! Identity function
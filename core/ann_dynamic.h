@@ -48,8 +48,9 @@ extern EvaluateLayer evaluateLayer;
 //! Apply the activation function over a set of values
 //! \sa ann::activate()
 inline void activateLayer(vector<float>& out) {
+  const auto activation = g_activation_functions->activation;
   for (float& value : out)
-    value = ann::activate(value);
+    value = (*activation)(value);
 }
 
 //! Randomize the values in a Matrix
@@ -60,14 +61,14 @@ inline void activateLayer(vector<float>& out) {
 //!   the Config::weights_density value)
 //! 
 inline void randomize(Matrix& w) {
-  const float range = g_config.connection_range;
+  const float range = g_config->connection_range;
 
   std::random_device rd;
   std::default_random_engine rnd(rd());
   std::uniform_real_distribution<float> dist(-range, range);
 
-  if (g_config.sparse_weights) {
-    std::bernoulli_distribution density(g_config.weights_density);
+  if (g_config->sparse_weights) {
+    std::bernoulli_distribution density(g_config->weights_density);
     for (float& value : w.values)
       value = density(rnd) ? ann::roundWeight(dist(rnd)) : 0;
   } else {
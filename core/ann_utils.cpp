@@ -16,6 +16,8 @@
 
 namespace ann {
 
-Config g_config;
+static Config g_default_config;
+
+core::ContextSlot<Config> g_config(&g_default_config);
 
 }  // namespace ann
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "ann_activation_functions.h"
+#include "context.h"
 #include "utils.h"
 #include "matrix.h"
 #include "properties.h"
@@ -55,13 +56,13 @@ struct Config : public core::PropertySet {
            "Probability of non-zero weights (if sparse_weights is true)");
 };
 
-// global configuration values
+// the configuration values for the current context (see core::ContextSlot)
 // (shall not be changed while the evolution is running)
-extern Config g_config;
+extern core::ContextSlot<Config> g_config;
 
 //! Ajust a value by rounding to Config::connection_resolution
 inline float roundWeight(float w) {
-  const float resolution = g_config.connection_resolution;
+  const float resolution = g_config->connection_resolution;
   return int(w / resolution) * resolution;
 }
 
@@ -71,11 +72,11 @@ inline float roundWeight(float w) {
 //! \sa roundWeight()
 template <class T, class RND>
 void mutateValue(T& value, RND& rnd, T std_dev) {
-  if (g_config.mutation_normal_distribution) {
+  if (g_config->mutation_normal_distribution) {
     std::normal_distribution<T> dist(value, std_dev);
     value = roundWeight(dist(rnd));
   } else {
-    const float range = g_config.connection_range;
+    const float range = g_config->connection_range;
     std::uniform_real_distribution<T> dist(-range, range);
     value = roundWeight(dist(rnd));
   }
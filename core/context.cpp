@@ -0,0 +1,68 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "context.h"
+
+namespace core {
+
+// the slots are allocated during the static initialization, so the counter
+// must be constant-initialized
+static atomic<int> g_slots_count = 0;
+
+thread_local void* Context::thread_values_[kMaxSlots] = {};
+atomic<void*> Context::default_values_[kMaxSlots] = {};
+
+Context Context::current() {
+  Context context;
+  for (int i = 0; i < kMaxSlots; ++i) {
+    auto value = thread_values_[i];
+    if (value == nullptr)
+      value = default_values_[i].load(std::memory_order_relaxed);
+    context.values_[i] = value;
+  }
+  return context;
+}
+
+int Context::allocateSlot() {
+  const int index = g_slots_count++;
+  CHECK(index < kMaxSlots, "Too many context slots");
+  return index;
+}
+
+ContextScope::ContextScope(const Context& context) {
+  for (int i = 0; i < Context::kMaxSlots; ++i) {
+    saved_context_.values_[i] = Context::thread_values_[i];
+    Context::thread_values_[i] = context.values_[i];
+  }
+}
+
+ContextScope::~ContextScope() {
+  for (int i = 0; i < Context::kMaxSlots; ++i) {
+    Context::thread_values_[i] = saved_context_.values_[i];
+  }
+}
+
+IsolatedContextScope::IsolatedContextScope() {
+  for (int i = 0; i < Context::kMaxSlots; ++i) {
+    saved_defaults_[i] = Context::default_values_[i].load(std::memory_order_relaxed);
+  }
+}
+
+IsolatedContextScope::~IsolatedContextScope() {
+  for (int i = 0; i < Context::kMaxSlots; ++i) {
+    Context::default_values_[i].store(saved_defaults_[i], std::memory_order_relaxed);
+  }
+}
+
+}  // namespace core
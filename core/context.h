@@ -0,0 +1,173 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "utils.h"
+
+#include <assert.h>
+#include <atomic>
+using namespace std;
+
+namespace core {
+
+template <class T>
+class ContextSlot;
+
+//! A snapshot of the values of all the context slots
+//!
+//! The context of a thread is captured by pp::WorkBatch and installed on the
+//! threads executing the batch shards, so the per-experiment state (ex. the domain
+//! and population configurations) follows the work across a shared thread pool.
+//!
+//! \sa ContextSlot
+//! \sa ContextScope
+//!
+class Context {
+  template <class T>
+  friend class ContextSlot;
+  friend class ContextScope;
+  friend class IsolatedContextScope;
+
+ public:
+  //! The max number of context slots
+  static constexpr int kMaxSlots = 32;
+
+ public:
+  //! Captures the context of the current thread
+  //! (the slots without a thread binding capture their default values)
+  static Context current();
+
+  //! Sets the value of a slot in this context
+  template <class T>
+  void set(const ContextSlot<T>& slot, T* value) {
+    CHECK(value != nullptr);
+    values_[slot.index_] = value;
+  }
+
+ private:
+  static int allocateSlot();
+
+ private:
+  void* values_[kMaxSlots] = {};
+
+  static thread_local void* thread_values_[kMaxSlots];
+  static atomic<void*> default_values_[kMaxSlots];
+};
+
+//! A global variable with a per-context value (a non-owning pointer)
+//!
+//! The value seen by a thread is either bound to the thread (directly, with bind(),
+//! or through a ContextScope), or the slot default (the most recently bound value),
+//! which preserves the single-experiment behavior for the threads which are not
+//! associated with a particular experiment (ex. the UI thread). If there's no bound
+//! value at all, the slot uses the optional fallback value.
+//!
+//! ```cpp
+//! static Config g_default_config;
+//! core::ContextSlot<Config> g_config(&g_default_config);
+//!
+//! Domain::Domain(const core::PropertySet& config) {
+//!   config_.copyFrom(config);
+//!   g_config.bind(&config_);
+//! }
+//!
+//! ... g_config->max_steps ...
+//! ```
+//!
+//! \note ContextSlot instances must be global variables
+//!
+template <class T>
+class ContextSlot : public core::NonCopyable {
+  friend class Context;
+
+ public:
+  explicit ContextSlot(T* fallback = nullptr)
+      : index_(Context::allocateSlot()), fallback_(fallback) {}
+
+  //! Binds the slot to the specified value, on the current thread
+  //! (the value also becomes the default value)
+  void bind(T* value) {
+    CHECK(value != nullptr);
+    Context::thread_values_[index_] = value;
+    Context::default_values_[index_].store(value, std::memory_order_relaxed);
+  }
+
+  //! Sets the default value, without binding it to the current thread
+  void setDefault(T* value) {
+    Context::default_values_[index_].store(value, std::memory_order_relaxed);
+  }
+
+  //! Clears the bindings to the specified value (called before the value is destroyed)
+  //! \note The bindings on other threads are not affected
+  void unbind(T* value) {
+    if (Context::thread_values_[index_] == value)
+      Context::thread_values_[index_] = nullptr;
+    void* expected = value;
+    Context::default_values_[index_].compare_exchange_strong(expected, nullptr);
+  }
+
+  //! The current value (or the fallback value, if the slot is not bound)
+  T* get() const {
+    auto value = Context::thread_values_[index_];
+    if (value == nullptr) {
+      value = Context::default_values_[index_].load(std::memory_order_relaxed);
+      if (value == nullptr)
+        return fallback_;
+    }
+    return static_cast<T*>(value);
+  }
+
+  T* operator->() const {
+    auto value = get();
+    assert(value != nullptr);
+    return value;
+  }
+
+  T& operator*() const { return *operator->(); }
+
+ private:
+  const int index_;
+  T* const fallback_;
+};
+
+//! Installs a context on the current thread, for the duration of the scope
+//! (the previous context is restored at the end of the scope)
+class ContextScope : public core::NonCopyable {
+ public:
+  explicit ContextScope(const Context& context);
+  ~ContextScope();
+
+ private:
+  Context saved_context_;
+};
+
+//! Installs a copy of the current context, for the duration of the scope
+//!
+//! Unlike a ContextScope, the slot defaults are also restored at the end of the scope,
+//! so the bindings made inside the scope (ex. by a population constructor) are not
+//! visible outside it. This is used for the auxiliary instances which must not replace
+//! the experiment state (the later unbind() calls leave the restored defaults alone).
+//!
+class IsolatedContextScope : public core::NonCopyable {
+ public:
+  IsolatedContextScope();
+  ~IsolatedContextScope();
+
+ private:
+  ContextScope context_scope_{ Context::current() };
+  void* saved_defaults_[Context::kMaxSlots] = {};
+};
+
+}  // namespace core
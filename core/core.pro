@@ -10,6 +10,8 @@ CONFIG += create_prl
 
 SOURCES += \
     ann_utils.cpp \
+    context.cpp \
+    evaluation_workers.cpp \
     darwin.cpp \
     logging.cpp \
     math_2d.cpp \
@@ -20,8 +22,15 @@ SOURCES += \
     sim/car.cpp \
     universe.cpp \
     evolution.cpp \
+    tracing.cpp \
+    genealogy.cpp \
+    island_model.cpp \
+    steady_state.cpp \
+    racing.cpp \
+    multi_fidelity.cpp \
     ann_activation_functions.cpp \
     parallel_for_each.cpp \
+    perf_counters.cpp \
     thread_pool.cpp \
     ann_dynamic.cpp \
     utils.cpp \
@@ -30,8 +39,12 @@ SOURCES += \
     truncation_selection.cpp \
     simple_tournament.cpp \
     swiss_tournament.cpp \
+    tournament.cpp \
     sim/accelerometer.cpp \
     sim/camera.cpp \
+    sim/cart_pole_batch.cpp \
+    sim/ray_caster.cpp \
+    sim/resettable_world.cpp \
     sim/compass.cpp \
     sim/scene.cpp \
     sim/misc.cpp \
@@ -43,6 +56,8 @@ SOURCES += \
 
 HEADERS += \
     ann_utils.h \
+    context.h \
+    evaluation_workers.h \
     darwin.h \
     ann_dynamic.h \
     global_initializer.h \
@@ -66,8 +81,15 @@ HEADERS += \
     format.h \
     universe.h \
     evolution.h \
+    tracing.h \
+    genealogy.h \
+    island_model.h \
+    steady_state.h \
+    racing.h \
+    multi_fidelity.h \
     ann_activation_functions.h \
     parallel_for_each.h \
+    perf_counters.h \
     thread_pool.h \
     utils.h \
     pp_utils.h \
@@ -82,6 +104,10 @@ HEADERS += \
     swiss_tournament.h \
     sim/accelerometer.h \
     sim/camera.h \
+    sim/cart_pole_batch.h \
+    sim/ray_caster.h \
+    sim/resettable_world.h \
+    sim/world_pool.h \
     sim/compass.h \
     sim/scene.h \
     sim/misc.h \
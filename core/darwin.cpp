@@ -15,8 +15,37 @@
 #include "darwin.h"
 #include "logging.h"
 
+#include <random>
+
 namespace darwin {
 
+// the current evaluation seed (see EvaluationSeedScope)
+static core::ContextSlot<uint64_t> g_evaluation_seed;
+
+// SplitMix64 finalizer (mixes the seed with the stream index)
+static uint64_t mixSeed(uint64_t seed, uint64_t stream) {
+  uint64_t z = seed + (stream + 1) * 0x9e3779b97f4a7c15ull;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+  return z ^ (z >> 31);
+}
+
+uint64_t evaluationSeed(uint64_t stream) {
+  if (const auto seed = g_evaluation_seed.get())
+    return mixSeed(*seed, stream);
+  random_device rd;
+  return (uint64_t(rd()) << 32) | rd();
+}
+
+EvaluationSeedScope::EvaluationSeedScope(uint64_t seed)
+    : seed_(seed), context_scope_(seededContext(&seed_)) {}
+
+core::Context EvaluationSeedScope::seededContext(uint64_t* seed) {
+  auto context = core::Context::current();
+  context.set(g_evaluation_seed, seed);
+  return context;
+}
+
 Experiment::Experiment(const optional<string>& name,
                        const ExperimentSetup& setup,
                        const optional<db::RowId>& base_variation_id,
@@ -15,6 +15,7 @@
 #pragma once
 
 #include "ann_utils.h"
+#include "context.h"
 #include "utils.h"
 #include "modules.h"
 #include "properties.h"
@@ -213,6 +214,44 @@ class PopulationFactory : public core::ModuleFactory {
   virtual unique_ptr<core::PropertySet> defaultConfig(ComplexityHint hint) const = 0;
 };
 
+//! A domain configuration property which controls the evaluation fidelity
+//! (ex. the maximum episode length, or the number of test worlds)
+//!
+//! \sa Domain::fidelityKnobs()
+//!
+struct FidelityKnob {
+  //! The name of the (integer) domain configuration property
+  string property;
+
+  //! The lowest useful value (a reduced fidelity never goes below it)
+  int min_value = 1;
+};
+
+//! The random seed for the evaluation environments (ex. the domain's test worlds)
+//!
+//! The evaluations which share an EvaluationSeedScope sample the same environments,
+//! even if they are split over multiple Domain::evaluatePopulation() calls (or worker
+//! processes). Outside of such a scope, every call returns a new random seed.
+//!
+//! \param stream - selects one of the independent environments of an evaluation
+//!   (ex. the test world index)
+//!
+uint64_t evaluationSeed(uint64_t stream);
+
+//! Fixes the evaluation seed (see evaluationSeed()) for the duration of the scope
+//! \note The seed also applies to the parallel work submitted from the current thread
+class EvaluationSeedScope : public core::NonCopyable {
+ public:
+  explicit EvaluationSeedScope(uint64_t seed);
+
+ private:
+  static core::Context seededContext(uint64_t* seed);
+
+ private:
+  uint64_t seed_ = 0;
+  core::ContextScope context_scope_;
+};
+
 //! Interface to a domain implementation
 //! 
 //! A domain defines a problem to be solved, including the environment for plugging in
@@ -251,6 +290,21 @@ class Domain : public core::NonCopyable {
   //! 
   virtual bool evaluatePopulation(Population* population) const = 0;
 
+  //! Returns true if the fitness of a genotype doesn't depend on the other genotypes
+  //!
+  //! Domains with independent evaluations (as opposed to tournaments or racing, for
+  //! example) can evaluate the population in separate batches (see EvaluationWorkers)
+  //!
+  virtual bool independentEvaluation() const { return false; }
+
+  //! Optional: the configuration properties which trade evaluation accuracy for speed
+  //!
+  //! The knobs are scaled down to create cheaper, reduced fidelity instances of the
+  //! domain (see MultiFidelityEvaluation). They must not change the inputs or the outputs
+  //! of the brains (so sensor resolutions are not valid knobs)
+  //!
+  virtual vector<FidelityKnob> fidelityKnobs() const { return {}; }
+
   //! Optional: additional fitness metrics
   //! (normally not used in the population evaluation, _ie_ a _test set_)
   virtual unique_ptr<core::PropertySet> calibrateGenotype([
@@ -68,6 +68,19 @@ void Statement::bindValue(int index, double value) {
     throw core::Exception("Failed to bind SQL parameter");
 }
 
+void Statement::bindValue(int index, const Blob& value) {
+  // (binding a null data pointer would result in a NULL value instead of an empty blob)
+  const int rc = value.empty()
+                     ? sqlite3_bind_zeroblob(stmt_, index, 0)
+                     : sqlite3_bind_blob(stmt_,
+                                         index,
+                                         value.data(),
+                                         int(value.size()),
+                                         SQLITE_TRANSIENT);
+  if (rc != SQLITE_OK)
+    throw core::Exception("Failed to bind SQL parameter");
+}
+
 bool Statement::step() {
   int rc = sqlite3_step(stmt_);
   switch (rc) {
@@ -159,6 +172,27 @@ void Statement::columnValue(int column, optional<double>& value) const {
   }
 }
 
+void Statement::columnValue(int column, optional<Blob>& value) const {
+  if (column >= columnCount())
+    throw core::Exception("Invalid column index");
+
+  switch (sqlite3_column_type(stmt_, column)) {
+    case SQLITE_BLOB: {
+      // sqlite3_column_bytes() must be called after sqlite3_column_blob()
+      auto data = static_cast<const uint8_t*>(sqlite3_column_blob(stmt_, column));
+      const int size = sqlite3_column_bytes(stmt_, column);
+      value = Blob(data, data + size);
+    } break;
+
+    case SQLITE_NULL:
+      value.reset();
+      break;
+
+    default:
+      throw core::Exception("Unexpected column data type");
+  }
+}
+
 static int schemaVersionCheck(void* data, int argc, char* argv[], char*[]) {
   CHECK(data == nullptr);
   return (argc == 1 && string(argv[0]) == "0") ? 0 : SQLITE_ERROR;
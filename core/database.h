@@ -18,6 +18,7 @@
 #include "exception.h"
 
 #include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 #include <tuple>
@@ -43,6 +44,9 @@ enum class OpenMode {
 //! Represents the ID of a row in the database
 using RowId = int64_t;
 
+//! Binary data (maps to the Sqlite BLOB type)
+using Blob = vector<uint8_t>;
+
 //! A prepared Sqlite statement
 class Statement {
  public:
@@ -66,6 +70,7 @@ class Statement {
   void bindValue(int index, const string& value);
   void bindValue(int index, const char* value);
   void bindValue(int index, double value);
+  void bindValue(int index, const Blob& value);
 
   // use std::nullopt for NULL values
   void bindValue(int index, nullptr_t) = delete;
@@ -90,6 +95,7 @@ class Statement {
   void columnValue(int column, optional<int64_t>& value) const;
   void columnValue(int column, optional<string>& value) const;
   void columnValue(int column, optional<double>& value) const;
+  void columnValue(int column, optional<Blob>& value) const;
 
  private:
   template <class T, class... PARAMS>
@@ -0,0 +1,408 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "evaluation_workers.h"
+#include "ann_dynamic.h"
+#include "ann_utils.h"
+#include "evolution.h"
+#include "exception.h"
+#include "logging.h"
+#include "thread_pool.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <algorithm>
+#include <deque>
+#include <memory>
+using namespace std;
+
+namespace darwin {
+
+static const char kWorkerArg[] = "--darwin_evaluation_worker";
+static const char kWorkerThreadsArg[] = "--darwin_worker_threads=";
+
+// upper limit for the size of a single message (a sanity check)
+constexpr uint32_t kMaxMessageSize = 1u << 30;
+
+// messages are encoded as a 32bit size followed by the MessagePack-encoded JSON
+static bool sendMessage(int socket, const json& message) {
+  const auto payload = json::to_msgpack(message);
+  CHECK(payload.size() <= kMaxMessageSize);
+  const uint32_t size = uint32_t(payload.size());
+  return pal::socketSend(socket, &size, sizeof(size)) &&
+         pal::socketSend(socket, payload.data(), payload.size());
+}
+
+static bool receiveMessage(int socket, json* message) {
+  uint32_t size = 0;
+  if (!pal::socketReceive(socket, &size, sizeof(size)) || size > kMaxMessageSize)
+    return false;
+  vector<uint8_t> payload(size);
+  if (!pal::socketReceive(socket, payload.data(), payload.size()))
+    return false;
+  try {
+    *message = json::from_msgpack(payload);
+  } catch (const json::exception&) {
+    return false;
+  }
+  return true;
+}
+
+// the worker process state: a domain (and a population, used as the container for
+// the evaluated genotypes) created from the experiment configuration
+class EvaluationWorker : public core::NonCopyable {
+ public:
+  ~EvaluationWorker() {
+    population_.reset();
+    domain_.reset();
+    ann::g_config.unbind(&core_config_);
+  }
+
+  // a setup failure is reported as the reply to the first evaluation request
+  void setup(const json& message) {
+    try {
+      setupDomain(message);
+    } catch (const std::exception& e) {
+      setup_error_ = e.what();
+    }
+  }
+
+  json evaluate(const json& message) {
+    if (setup_error_)
+      throw core::Exception("Evaluation worker setup failed: %s", *setup_error_);
+    CHECK(domain_ != nullptr);
+
+    const auto& genotypes = message.at("genotypes");
+    const size_t size = genotypes.size();
+    CHECK(size > 0);
+
+    // the population is only recreated if the batch size changes
+    if (population_ == nullptr || population_->size() != size) {
+      population_.reset();
+      population_ = population_factory_->create(*population_config_, *domain_);
+      population_->createPrimordialGeneration(int(size));
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      population_->genotype(i)->load(genotypes[i]);
+    }
+
+    // the batches of a generation share the evaluation seed
+    EvaluationSeedScope seed_scope(message.at("seed").get<uint64_t>());
+
+    json reply;
+    reply["stop"] = domain_->evaluatePopulation(population_.get());
+    auto& fitness = reply["fitness"] = json::array();
+    for (size_t i = 0; i < size; ++i) {
+      fitness.push_back(population_->genotype(i)->fitness);
+    }
+    return reply;
+  }
+
+ private:
+  void setupDomain(const json& message) {
+    CHECK(domain_ == nullptr);
+
+    ExperimentSetup setup;
+    setup.fromJson(message.at("setup"));
+
+    core_config_.fromJson(message.at("core"));
+    ann::g_config.bind(&core_config_);
+
+    auto domain_factory = registry()->domains.find(setup.domain_name);
+    if (domain_factory == nullptr)
+      throw core::Exception("Unknown domain '%s'", setup.domain_name);
+    domain_config_ = domain_factory->defaultConfig(setup.domain_hint);
+    domain_config_->fromJson(message.at("domain"));
+
+    population_factory_ = registry()->populations.find(setup.population_name);
+    if (population_factory_ == nullptr)
+      throw core::Exception("Unknown population '%s'", setup.population_name);
+    population_config_ = population_factory_->defaultConfig(setup.population_hint);
+    population_config_->fromJson(message.at("population"));
+
+    domain_ = domain_factory->create(*domain_config_);
+  }
+
+ private:
+  ann::Config core_config_;
+  unique_ptr<core::PropertySet> domain_config_;
+  unique_ptr<core::PropertySet> population_config_;
+  PopulationFactory* population_factory_ = nullptr;
+  unique_ptr<Domain> domain_;
+  unique_ptr<Population> population_;
+  optional<string> setup_error_;
+};
+
+EvaluationWorkers::EvaluationWorkers(const Experiment& experiment,
+                                     const EvolutionConfig& config) {
+  CHECK(config.evaluation_workers > 0);
+  CHECK(config.evaluation_batch_size >= 0);
+  CHECK(config.evaluation_batch_timeout >= 0);
+
+  executable_ = config.evaluation_worker.empty() ? pal::currentExecutablePath()
+                                                 : config.evaluation_worker;
+
+  // the worker threads are split between the worker processes
+  auto thread_pool = pp::ParallelForSupport::threadPool();
+  const int threads_count = thread_pool != nullptr ? thread_pool->threadsCount() : 1;
+  const int worker_threads = max(1, threads_count / config.evaluation_workers);
+  args_ = { kWorkerArg, kWorkerThreadsArg + to_string(worker_threads) };
+
+  setup_message_["type"] = "setup";
+  setup_message_["setup"] = experiment.setup()->toJson();
+  setup_message_["core"] = experiment.coreConfig()->toJson();
+  setup_message_["domain"] = experiment.domainConfig()->toJson();
+  setup_message_["population"] = experiment.populationConfig()->toJson();
+
+  batch_size_ = config.evaluation_batch_size;
+  batch_timeout_ = config.evaluation_batch_timeout;
+
+  workers_.resize(config.evaluation_workers);
+  try {
+    for (auto& worker : workers_) {
+      startWorker(&worker);
+    }
+  } catch (...) {
+    for (auto& worker : workers_) {
+      pal::killChildProcess(&worker.process);
+    }
+    throw;
+  }
+
+  core::log("Started %d evaluation workers (%d threads each)\n\n",
+            config.evaluation_workers,
+            worker_threads);
+}
+
+EvaluationWorkers::~EvaluationWorkers() {
+  for (auto& worker : workers_) {
+    pal::killChildProcess(&worker.process);
+  }
+}
+
+void EvaluationWorkers::startWorker(Worker* worker) {
+  CHECK(worker->process.pid < 0);
+  CHECK(!worker->batch);
+  worker->process = pal::spawnChildProcess(executable_, args_);
+
+  // a failed send here means that the worker process exited already,
+  // which is detected (and handled) as part of the first batch evaluation
+  sendMessage(worker->process.socket, setup_message_);
+}
+
+bool EvaluationWorkers::evaluatePopulation(Population* population) {
+  const size_t size = population->size();
+  CHECK(size > 0);
+
+  // by default, a few batches per worker process (for load balancing)
+  const size_t batches_target = workers_.size() * 4;
+  size_t batch_size = (size + batches_target - 1) / batches_target;
+  if (batch_size_ > 0)
+    batch_size = size_t(batch_size_);
+
+  struct Batch {
+    size_t first = 0;
+    size_t last = 0;
+    int attempts = 0;
+  };
+
+  vector<Batch> batches;
+  deque<size_t> pending_batches;
+  for (size_t first = 0; first < size; first += batch_size) {
+    pending_batches.push_back(batches.size());
+    batches.push_back({ first, min(first + batch_size, size) });
+  }
+
+  StageScope stage("Evaluate population", size);
+
+  const int generation = population->generation();
+  core::log("\n. generation %d (%zu batches)\n", generation, batches.size());
+
+  // the same evaluation environments for all the batches (see evaluationSeed())
+  const uint64_t seed = evaluationSeed(uint64_t(generation));
+
+  // kills the worker process and schedules its batch for another attempt
+  // (the worker process is restarted when a new batch is dispatched)
+  auto workerFailed = [&](Worker* worker) {
+    core::log("Evaluation worker (pid %d) failed\n", worker->process.pid);
+    pal::killChildProcess(&worker->process);
+    ++restarts_count_;
+    auto& batch = batches[*worker->batch];
+    worker->batch.reset();
+    if (++batch.attempts >= kMaxBatchAttempts) {
+      throw core::Exception("Failed to evaluate genotypes [%zu, %zu) (%d attempts)",
+                            batch.first,
+                            batch.last,
+                            batch.attempts);
+    }
+    pending_batches.push_front(&batch - batches.data());
+  };
+
+  bool stop = false;
+  size_t completed_batches = 0;
+
+  try {
+    while (completed_batches < batches.size()) {
+      // dispatch the pending batches to the idle workers
+      for (auto& worker : workers_) {
+        if (worker.batch || pending_batches.empty())
+          continue;
+
+        if (worker.process.pid < 0)
+          startWorker(&worker);
+
+        worker.batch = pending_batches.front();
+        pending_batches.pop_front();
+
+        const auto& batch = batches[*worker.batch];
+        json message;
+        message["type"] = "evaluate";
+        message["seed"] = seed;
+        auto& genotypes = message["genotypes"] = json::array();
+        for (size_t i = batch.first; i < batch.last; ++i) {
+          genotypes.push_back(population->genotype(i)->save());
+        }
+
+        worker.deadline = chrono::steady_clock::now() + chrono::seconds(batch_timeout_);
+        if (!sendMessage(worker.process.socket, message))
+          workerFailed(&worker);
+      }
+
+      // wait for results
+      vector<Worker*> busy_workers;
+      vector<int> sockets;
+      for (auto& worker : workers_) {
+        if (worker.batch) {
+          busy_workers.push_back(&worker);
+          sockets.push_back(worker.process.socket);
+        }
+      }
+
+      for (int index : pal::socketPoll(sockets, kPollTimeoutMs)) {
+        Worker* worker = busy_workers[index];
+        json reply;
+        if (!receiveMessage(worker->process.socket, &reply)) {
+          workerFailed(worker);
+          continue;
+        }
+
+        const auto& batch = batches[*worker->batch];
+        worker->batch.reset();
+
+        if (reply.contains("error")) {
+          throw core::Exception("Evaluation worker error: %s",
+                                reply["error"].get<string>());
+        }
+
+        const auto& fitness = reply.at("fitness");
+        CHECK(fitness.size() == batch.last - batch.first);
+        for (size_t i = batch.first; i < batch.last; ++i) {
+          population->genotype(i)->fitness = fitness[i - batch.first].get<float>();
+        }
+        stop = stop || reply.at("stop").get<bool>();
+
+        ++completed_batches;
+        ProgressManager::reportProgress(batch.last - batch.first);
+      }
+
+      // the workers which didn't reply in time are restarted
+      if (batch_timeout_ > 0) {
+        const auto now = chrono::steady_clock::now();
+        for (auto& worker : workers_) {
+          if (worker.batch && now >= worker.deadline) {
+            core::log("Evaluation worker (pid %d) timed out\n", worker.process.pid);
+            workerFailed(&worker);
+          }
+        }
+      }
+
+      // allow pausing or canceling the evolution
+      // (the time spent paused doesn't count towards the batch deadlines)
+      if (auto controller = pp::g_controller.get()) {
+        const auto checkpoint_start = chrono::steady_clock::now();
+        controller->checkpoint();
+        const auto paused_time = chrono::steady_clock::now() - checkpoint_start;
+        for (auto& worker : workers_) {
+          worker.deadline += paused_time;
+        }
+      }
+    }
+  } catch (...) {
+    // the busy workers are stopped, so the in-flight results are not
+    // mixed with the next evaluation
+    for (auto& worker : workers_) {
+      if (worker.batch) {
+        pal::killChildProcess(&worker.process);
+        worker.batch.reset();
+      }
+    }
+    throw;
+  }
+
+  core::log("\n");
+  return stop;
+}
+
+vector<int> EvaluationWorkers::workerProcessIds() const {
+  vector<int> pids;
+  for (const auto& worker : workers_) {
+    if (worker.process.pid > 0)
+      pids.push_back(worker.process.pid);
+  }
+  return pids;
+}
+
+bool EvaluationWorkers::isWorkerProcess(int argc, char* argv[]) {
+  return argc > 1 && strcmp(argv[1], kWorkerArg) == 0;
+}
+
+int EvaluationWorkers::workerMain(int argc, char* argv[]) {
+  CHECK(isWorkerProcess(argc, argv));
+
+  int threads_count = pp::ThreadPool::kAutoThreadCount;
+  for (int i = 2; i < argc; ++i) {
+    const size_t prefix_length = strlen(kWorkerThreadsArg);
+    if (strncmp(argv[i], kWorkerThreadsArg, prefix_length) == 0)
+      threads_count = max(1, atoi(argv[i] + prefix_length));
+  }
+
+  ann::initAnnLibrary();
+  pp::ParallelForSupport::init(nullptr, threads_count);
+
+  EvaluationWorker worker;
+  const int socket = pal::kChildProcessSocket;
+
+  // the worker process exits when the parent process closes the socket
+  json message;
+  while (receiveMessage(socket, &message)) {
+    json reply;
+    try {
+      if (message.at("type") == "setup") {
+        worker.setup(message);
+        continue;
+      }
+      reply = worker.evaluate(message);
+    } catch (const std::exception& e) {
+      reply = json::object();
+      reply["error"] = e.what();
+    }
+    if (!sendMessage(socket, reply))
+      break;
+  }
+
+  return 0;
+}
+
+}  // namespace darwin
@@ -0,0 +1,110 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "darwin.h"
+#include "platform_abstraction_layer.h"
+#include "utils.h"
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace darwin {
+
+struct EvolutionConfig;
+
+//! Evaluates the population using a set of worker processes
+//!
+//! The population is split into batches, which are evaluated by the worker processes
+//! (each worker process has its own domain instance, created from the experiment
+//! configuration). The batches are sent over local sockets, as serialized genotypes, and
+//! the workers reply with the fitness values.
+//!
+//! A worker process which crashes, disconnects or doesn't reply in time (see
+//! EvolutionConfig::evaluation_batch_timeout) is restarted and its batch is dispatched
+//! again, so a single failure doesn't abort the evolution.
+//!
+//! \note Only domains with independent evaluations can be evaluated in batches
+//!   (see Domain::independentEvaluation())
+//!
+//! All the batches of a generation share the same evaluation seed, so the domains
+//! which randomize the evaluation environment (ex. random test worlds) evaluate all the
+//! genotypes in the same environments (see darwin::evaluationSeed())
+//!
+class EvaluationWorkers : public core::NonCopyable {
+  static constexpr int kMaxBatchAttempts = 3;
+  static constexpr int kPollTimeoutMs = 100;
+
+ public:
+  //! Starts the worker processes
+  //! \throws core::Exception if the worker processes can't be started
+  EvaluationWorkers(const Experiment& experiment, const EvolutionConfig& config);
+
+  //! Stops the worker processes
+  ~EvaluationWorkers();
+
+  //! Assigns fitness values to every genotype (see Domain::evaluatePopulation())
+  //! \throws core::Exception if a batch can't be evaluated
+  bool evaluatePopulation(Population* population);
+
+  //! The process IDs of the current worker processes
+  vector<int> workerProcessIds() const;
+
+  //! The number of worker processes restarted so far
+  int restartsCount() const { return restarts_count_; }
+
+  //! Returns true if the command line is for an evaluation worker process
+  static bool isWorkerProcess(int argc, char* argv[]);
+
+  //! Entry point for the evaluation worker processes
+  //!
+  //! This must be called from main(), before any other initialization except
+  //! the domains and populations registration:
+  //!
+  //! ```cpp
+  //! if (darwin::EvaluationWorkers::isWorkerProcess(argc, argv)) {
+  //!   registry::init();
+  //!   return darwin::EvaluationWorkers::workerMain(argc, argv);
+  //! }
+  //! ```
+  //!
+  static int workerMain(int argc, char* argv[]);
+
+ private:
+  struct Worker {
+    pal::ChildProcess process;
+    optional<size_t> batch;
+    chrono::steady_clock::time_point deadline;
+  };
+
+  void startWorker(Worker* worker);
+
+ private:
+  string executable_;
+  vector<string> args_;
+  json setup_message_;
+  int batch_size_ = 0;
+  int batch_timeout_ = 0;
+  vector<Worker> workers_;
+  int restarts_count_ = 0;
+};
+
+}  // namespace darwin
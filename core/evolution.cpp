@@ -13,14 +13,21 @@
 // limitations under the License.
 
 #include "evolution.h"
+#include "evaluation_workers.h"
+#include "genealogy.h"
+#include "island_model.h"
 #include "logging.h"
+#include "runtime.h"
 #include "scope_guard.h"
+#include "steady_state.h"
+#include "tracing.h"
 
 #include <assert.h>
 #include <math.h>
 #include <time.h>
 #include <algorithm>
 #include <fstream>
+#include <future>
 #include <limits>
 #include <memory>
 #include <sstream>
@@ -30,7 +37,12 @@ using namespace std;
 
 namespace darwin {
 
-ProgressMonitor* ProgressManager::progress_monitor_ = nullptr;
+core::ContextSlot<ProgressMonitor> ProgressManager::progress_monitor_;
+thread_local bool ProgressManager::background_thread_ = false;
+
+static int progressPercent(size_t progress, size_t size) {
+  return size > 0 ? int(double(progress) / size * 100.0) : 0;
+}
 
 GenerationSummary::GenerationSummary(const Population* population,
                                      shared_ptr<core::PropertySet> calibration_fitness)
@@ -124,34 +136,29 @@ GenerationSummary EvolutionTrace::addGeneration(
     const Population* population,
     shared_ptr<core::PropertySet> calibration_fitness,
     const EvolutionStage& top_stage) {
-  GenerationSummary summary(population, calibration_fitness);
+  return addGeneration(captureGeneration(population, top_stage), calibration_fitness);
+}
 
-  // record the generation summary
-  {
-    unique_lock<mutex> guard(lock_);
-    CHECK(summary.generation == int(generations_.size()));
-    generations_.push_back(summary);
-  }
+EvolutionTrace::PendingGeneration EvolutionTrace::captureGeneration(
+    const Population* population,
+    const EvolutionStage& top_stage) const {
+  PendingGeneration pending;
+  pending.summary = GenerationSummary(population, nullptr);
+
+  const auto& summary = pending.summary;
+  auto& db_generation = pending.db_generation;
+  auto& json_summary = pending.json_summary;
 
   // save the generation results
-  DbGeneration db_generation;
   db_generation.trace_id = db_trace_->id;
   db_generation.generation = summary.generation;
 
-  json json_summary;
   json json_details;
 
   json_summary["best_fitness"] = summary.best_fitness;
   json_summary["median_fitness"] = summary.median_fitness;
   json_summary["worst_fitness"] = summary.worst_fitness;
 
-  if (summary.calibration_fitness) {
-    json json_calibration;
-    for (auto property : summary.calibration_fitness->properties())
-      json_calibration[property->name()] = property->nativeValue<float>();
-    json_summary["calibration_fitness"] = json_calibration;
-  }
-
   // detailed fitness information
   switch (config_.fitness_information) {
     case FitnessInfoKind::SamplesOnly:
@@ -183,15 +190,26 @@ GenerationSummary EvolutionTrace::addGeneration(
 
   // capture genealogy information
   if (config_.save_genealogy) {
-    json json_full_genealogy;
-    for (size_t i = 0; i < population->size(); ++i) {
-      const auto& genealogy = population->genotype(i)->genealogy;
-      json json_genealogy_entry;
-      if (!genealogy.genetic_operator.empty())
-        json_genealogy_entry[genealogy.genetic_operator] = genealogy.parents;
-      json_full_genealogy.push_back(json_genealogy_entry);
+    switch (config_.genealogy_format) {
+      case GenealogyFormat::Json: {
+        json json_full_genealogy;
+        for (size_t i = 0; i < population->size(); ++i) {
+          const auto& genealogy = population->genotype(i)->genealogy;
+          json json_genealogy_entry;
+          if (!genealogy.genetic_operator.empty())
+            json_genealogy_entry[genealogy.genetic_operator] = genealogy.parents;
+          json_full_genealogy.push_back(json_genealogy_entry);
+        }
+        json_details["genealogy"] = json_full_genealogy;
+      } break;
+
+      case GenealogyFormat::Compact:
+        db_generation.genealogy = CompactGenealogy::encode(population);
+        break;
+
+      default:
+        FATAL("Unexpected genealogy format");
     }
-    json_details["genealogy"] = json_full_genealogy;
   }
 
   // champion genotype
@@ -210,6 +228,8 @@ GenerationSummary EvolutionTrace::addGeneration(
 
     case ProfileInfoKind::AllStages:
       json_profile["stages"] = top_stage;
+      if (top_stage.perfCounters().has_value())
+        json_profile["counters"] = top_stage.perfCounters().value();
       break;
 
     default:
@@ -217,23 +237,86 @@ GenerationSummary EvolutionTrace::addGeneration(
   }
   db_generation.profile = json_profile.dump();
 
-  // summary
-  CHECK(!json_summary.empty());
-  db_generation.summary = json_summary.dump();
-
   // details
   if (!json_details.empty()) {
     db_generation.details = json_details.dump();
   }
 
+  return pending;
+}
+
+GenerationSummary EvolutionTrace::addGeneration(
+    PendingGeneration pending,
+    shared_ptr<core::PropertySet> calibration_fitness) {
+  auto& summary = pending.summary;
+  auto& db_generation = pending.db_generation;
+  auto& json_summary = pending.json_summary;
+
+  summary.calibration_fitness = calibration_fitness;
+
+  // record the generation summary
+  {
+    unique_lock<mutex> guard(lock_);
+    CHECK(summary.generation == int(generations_.size()));
+    generations_.push_back(summary);
+  }
+
+  if (summary.calibration_fitness) {
+    json json_calibration;
+    for (auto property : summary.calibration_fitness->properties())
+      json_calibration[property->name()] = property->nativeValue<float>();
+    json_summary["calibration_fitness"] = json_calibration;
+  }
+
+  // summary
+  CHECK(!json_summary.empty());
+  db_generation.summary = json_summary.dump();
+
   // save the new generation to the universe database
   experiment_->universe()->newGeneration(db_generation);
 
   return summary;
 }
 
-void Evolution::init() {
-  new std::thread(&Evolution::mainThread, evolution());
+atomic<int> Evolution::created_instances_ = 0;
+
+Evolution::Evolution(bool default_instance) : default_instance_(default_instance) {
+  if (default_instance_)
+    ProgressManager::registerMonitor(this);
+}
+
+Evolution::~Evolution() {
+  {
+    unique_lock<mutex> guard(lock_);
+    CHECK(state_ == State::Initializing || state_ == State::Stopped);
+    shutting_down_ = true;
+    state_cv_.notify_all();
+  }
+
+  if (main_thread_.joinable())
+    main_thread_.join();
+
+  ann::g_config.unbind(&ann_config_);
+
+  if (!default_instance_)
+    --created_instances_;
+}
+
+void Evolution::init(int threads_count) {
+  auto instance = evolution();
+  instance->default_threads_count_ = threads_count;
+  instance->threads_count_ = threads_count;
+  pp::ParallelForSupport::init(instance, threads_count);
+  CHECK(!instance->main_thread_.joinable());
+  instance->main_thread_ = std::thread(&Evolution::mainThread, instance);
+}
+
+unique_ptr<Evolution> Evolution::create() {
+  CHECK(pp::ParallelForSupport::threadPool() != nullptr);
+  unique_ptr<Evolution> instance(new Evolution(false));
+  ++created_instances_;
+  instance->main_thread_ = std::thread(&Evolution::mainThread, instance.get());
+  return instance;
 }
 
 bool Evolution::newExperiment(shared_ptr<Experiment> experiment,
@@ -242,6 +325,7 @@ bool Evolution::newExperiment(shared_ptr<Experiment> experiment,
             experiment->setup()->population_size);
 
   CHECK(config.max_generations >= 0);
+  CHECK(config.threads >= 0);
 
   {
     unique_lock<mutex> guard(lock_);
@@ -254,8 +338,21 @@ bool Evolution::newExperiment(shared_ptr<Experiment> experiment,
     // sanity checks (make sure we have a clean state)
     CHECK(stage_stack_.empty());
 
-    // setup the shared ANN library
-    ann::g_config.copyFrom(*experiment->coreConfig());
+    // setup the thread pool (before any domain or population setup)
+    if (default_instance_) {
+      configureThreadPool(config.threads > 0 ? config.threads : default_threads_count_,
+                          config.thread_affinity);
+    } else if (config.threads != 0 ||
+               config.thread_affinity != pp::ThreadAffinity::None) {
+      core::log("The thread pool is shared, the threads configuration is ignored\n");
+    }
+
+    // the experiment state is bound to a fresh context, captured below
+    core::ContextScope experiment_scope{ core::Context() };
+
+    // setup the ANN library
+    ann_config_.copyFrom(*experiment->coreConfig());
+    ann::g_config.bind(&ann_config_);
 
     try {
       // setup the domain
@@ -267,13 +364,56 @@ bool Evolution::newExperiment(shared_ptr<Experiment> experiment,
       auto population =
           population_factory->create(*experiment->populationConfig(), *domain);
 
+      // setup the evaluation worker processes, if requested
+      unique_ptr<EvaluationWorkers> evaluation_workers;
+      if (config.evaluation_workers > 0) {
+        if (!domain->independentEvaluation()) {
+          throw core::Exception("Domain '%s' can't be evaluated by worker processes",
+                                experiment->setup()->domain_name);
+        }
+        evaluation_workers = make_unique<EvaluationWorkers>(*experiment, config);
+      }
+
+      // steady-state evolution evaluates the children one at a time
+      if (config.steady_state) {
+        if (!domain->independentEvaluation()) {
+          throw core::Exception("Domain '%s' doesn't support steady-state evolution",
+                                experiment->setup()->domain_name);
+        }
+        if (config.evaluation_workers > 0) {
+          throw core::Exception(
+              "Steady-state evolution doesn't support evaluation worker processes");
+        }
+      }
+
+      // multi-fidelity evaluation, with a reduced fidelity instance of the domain
+      unique_ptr<MultiFidelityEvaluation> multi_fidelity;
+      if (config.evaluation_fidelity.tag() == EvaluationFidelity::MultiFidelity) {
+        if (config.steady_state || config.evaluation_workers > 0) {
+          throw core::Exception(
+              "Multi-fidelity evaluation doesn't support steady-state evolution or "
+              "evaluation worker processes");
+        }
+        const auto& multi_fidelity_config = config.evaluation_fidelity.multi_fidelity;
+        auto low_fidelity_domain = createLowFidelityDomain(
+            experiment.get(), domain.get(), multi_fidelity_config.low_fidelity);
+        multi_fidelity = make_unique<MultiFidelityEvaluation>(
+            domain.get(), std::move(low_fidelity_domain), multi_fidelity_config);
+      }
+
       domain_ = std::move(domain);
       population_ = std::move(population);
+      evaluation_workers_ = std::move(evaluation_workers);
+      multi_fidelity_ = std::move(multi_fidelity);
     } catch (const std::exception& e) {
       core::log("Failed to create the domain or the population: %s\n", e.what());
       throw;
     }
 
+    context_ = core::Context::current();
+    context_.set(pp::g_controller, static_cast<pp::Controller*>(this));
+    context_.set(ProgressManager::progress_monitor_, static_cast<ProgressMonitor*>(this));
+
     config_.copyFrom(config);
 
     CHECK(experiment_ == nullptr);
@@ -282,8 +422,19 @@ bool Evolution::newExperiment(shared_ptr<Experiment> experiment,
 
     trace_ = make_shared<EvolutionTrace>(experiment_, config_);
 
-    state_ = State::Paused;
-    state_cv_.notify_all();
+    // the hardware counters are only captured for the full stages profile
+    if (config_.profile_information == ProfileInfoKind::AllStages)
+      perf_counters_ = core::PerfCounters::enable();
+    else
+      core::PerfCounters::disable();
+
+    core::Tracing::clear();
+    if (config_.chrome_trace != ChromeTraceKind::None)
+      core::Tracing::enable();
+    else
+      core::Tracing::disable();
+
+    setState(State::Paused);
   }
 
   events.publish(EventFlag::ProgressUpdate | EventFlag::StateChanged |
@@ -298,8 +449,27 @@ void Evolution::mainThread() {
     main_thread_id_ = std::this_thread::get_id();
   }
 
+  core::Tracing::setThreadName("Evolution");
+  core::PerfCounters::registerThread();
+  SCOPE_EXIT { core::PerfCounters::unregisterThread(); };
+
   // the "evolution as a service" loop
   for (;;) {
+    core::Context context;
+
+    // wait for a new experiment (or the shutdown request)
+    {
+      unique_lock<mutex> guard(lock_);
+      while (state_ == State::Initializing || state_ == State::Stopped) {
+        if (shutting_down_)
+          return;
+        state_cv_.wait(guard);
+      }
+      context = context_;
+    }
+
+    core::ContextScope context_scope(context);
+
     bool canceled = false;
 
     try {
@@ -310,12 +480,14 @@ void Evolution::mainThread() {
       canceled = true;
     }
 
+    if (trace_ && config_.chrome_trace == ChromeTraceKind::PerRun)
+      exportChromeTrace("run");
+
     // stop the evolution
     {
       unique_lock<mutex> guard(lock_);
       CHECK(!canceled || state_ == State::Canceling);
-      state_ = State::Stopped;
-      state_cv_.notify_all();
+      setState(State::Stopped);
     }
 
     uint32_t event_flags = EventFlag::StateChanged;
@@ -343,65 +515,205 @@ void Evolution::evolutionCycle() {
 
   core::log("\nEvolution started:\n\n");
 
+  // the generation waiting for the background calibration of its champion
+  // (only used if overlap_calibration is set)
+  //
+  // NOTE: if the evolution is canceled, the future's destructor
+  //  waits for the background calibration to complete
+  //
+  struct PendingCalibration {
+    EvolutionTrace::PendingGeneration generation;
+    future<unique_ptr<core::PropertySet>> calibration_fitness;
+  };
+  optional<PendingCalibration> pending_calibration;
+
+  auto recordGeneration = [&](EvolutionTrace::PendingGeneration generation,
+                              shared_ptr<core::PropertySet> calibration_fitness) {
+    auto summary = trace_->addGeneration(std::move(generation), calibration_fitness);
+
+    // publish the generation results
+    generation_summary.publish(summary);
+    events.publish(EventFlag::EndGeneration);
+  };
+
+  auto recordPendingCalibration = [&] {
+    if (pending_calibration) {
+      auto calibration_fitness = pending_calibration->calibration_fitness.get();
+      recordGeneration(std::move(pending_calibration->generation),
+                       std::move(calibration_fitness));
+      pending_calibration.reset();
+    }
+  };
+
+  // steady-state evolution (if enabled) starts after the initial generation,
+  // and the evaluator threads are stopped at the end of the evolution cycle
+  SCOPE_EXIT {
+    unique_ptr<SteadyStateEvolution> steady_state;
+    {
+      unique_lock<mutex> guard(lock_);
+      steady_state = std::move(steady_state_);
+    }
+  };
+
   // main evolution loop
   for (int generation = 0; generation < config_.max_generations; ++generation) {
+    Population* population = population_.get();
+
     // explicit scope for the top generation stage
     {
       StageScope stage(
           "Evolve one generation", 0, EvolutionStage::Annotation::Generation);
 
-      // create the generation's genotypes
-      if (generation == 0) {
-        population_->createPrimordialGeneration(experiment_->setup()->population_size);
+      bool stop = false;
+      if (config_.steady_state && generation > 0) {
+        if (!steady_state_) {
+          // the breeders must not replace the experiment's context slot bindings
+          // (ex. the population configuration)
+          unique_ptr<Population> breeders[2];
+          {
+            core::IsolatedContextScope breeders_scope;
+            for (auto& breeder : breeders) {
+              breeder = experiment_->populationFactory()->create(
+                  *experiment_->populationConfig(), *domain_);
+              breeder->createPrimordialGeneration(int(population_->size()));
+            }
+          }
+          auto steady_state =
+              make_unique<SteadyStateEvolution>(population_.get(),
+                                                std::move(breeders[0]),
+                                                std::move(breeders[1]),
+                                                domain_.get(),
+                                                config_.steady_state_replacement);
+          unique_lock<mutex> guard(lock_);
+          steady_state_ = std::move(steady_state);
+        }
+
+        // the next population size children, evaluated asynchronously
+        stop = steady_state_->evolveGeneration();
+        population = steady_state_->pool();
       } else {
-        population_->createNextGeneration();
+        // create the generation's genotypes
+        if (generation == 0) {
+          population_->createPrimordialGeneration(experiment_->setup()->population_size);
+        } else {
+          population_->createNextGeneration();
+        }
+
+        // domain specific evaluation of the genotypes
+        if (evaluation_workers_) {
+          stop = evaluation_workers_->evaluatePopulation(population_.get());
+        } else if (multi_fidelity_) {
+          stop = multi_fidelity_->evaluatePopulation(population_.get());
+        } else {
+          stop = domain_->evaluatePopulation(population_.get());
+        }
       }
 
       // TODO: remove generation tracking from darwin::Population?
-      CHECK(population_->generation() == generation);
+      CHECK(population->generation() == generation);
 
-      // domain specific evaluation of the genotypes
-      if (domain_->evaluatePopulation(population_.get()))
+      if (stop)
         break;
+
+      // island model: exchange genotypes with the other islands
+      if (island_model_ &&
+          (generation + 1) % island_model_->config().migration_interval == 0) {
+        StageScope stage("Migration");
+        const int immigrants = island_model_->migrate(island_, population);
+        core::log("Island %d: received %d immigrant(s)\n", island_, immigrants);
+      }
     }
 
     // validate the fitness values
-    const auto& ranking_index = population_->rankingIndex();
+    const auto& ranking_index = population->rankingIndex();
     for (size_t i = 0; i < ranking_index.size(); ++i) {
-      const float fitness_value = population_->genotype(ranking_index[i])->fitness;
+      const float fitness_value = population->genotype(ranking_index[i])->fitness;
       CHECK(isfinite(fitness_value));
       if (i > 0) {
         // values should be ranked in descending fitness order
-        const float prev_value = population_->genotype(ranking_index[i - 1])->fitness;
+        const float prev_value = population->genotype(ranking_index[i - 1])->fitness;
         CHECK(fitness_value <= prev_value);
       }
     }
 
+    auto pending_generation = trace_->captureGeneration(population, last_top_stage);
+
+    // the generation's trace is exported when it's captured, since recording it
+    // may be deferred until the next generation is evaluated (overlap_calibration)
+    if (config_.chrome_trace == ChromeTraceKind::PerGeneration)
+      exportChromeTrace(core::format("gen_%d", pending_generation.summary.generation));
+
+    // the previous generation (if any) was calibrated while evaluating this one
+    recordPendingCalibration();
+
     // extra fitness values (optional)
-    const auto champion_index = ranking_index[0];
-    const Genotype* champion = population_->genotype(champion_index);
-    shared_ptr<core::PropertySet> calibration_fitness =
-        domain_->calibrateGenotype(champion);
+    if (config_.overlap_calibration) {
+      // calibrate the champion clone, since the population will move on
+      auto champion = pending_generation.summary.champion;
+      core::Context background_context = context_;
+      background_context.set(pp::g_controller,
+                             static_cast<pp::Controller*>(&background_controller_));
+      auto calibrate = [this, champion, background_context] {
+        core::ContextScope context_scope(background_context);
+        ProgressManager::setBackgroundThread(true);
+        return domain_->calibrateGenotype(champion.get());
+      };
+      auto calibration_fitness = std::async(std::launch::async, calibrate);
+      pending_calibration = PendingCalibration{ std::move(pending_generation),
+                                                std::move(calibration_fitness) };
+    } else {
+      const Genotype* champion = population->genotype(ranking_index[0]);
+      shared_ptr<core::PropertySet> calibration_fitness =
+          domain_->calibrateGenotype(champion);
+      recordGeneration(std::move(pending_generation), calibration_fitness);
+    }
 
-    // record the generation
-    auto summary =
-        trace_->addGeneration(population_.get(), calibration_fitness, last_top_stage);
+    // don't leave the latest generation unrecorded while paused
+    checkpoint(recordPendingCalibration);
+  }
 
-    // publish the generation results
-    generation_summary.publish(summary);
-    events.publish(EventFlag::EndGeneration);
-    checkpoint();
+  recordPendingCalibration();
+}
+
+void Evolution::exportChromeTrace(const string& suffix) const {
+  CHECK(trace_);
+  const auto filename = core::format("trace_%lld_%s.json",
+                                     static_cast<long long>(trace_->dbTraceId()),
+                                     suffix);
+  const auto path = core::Runtime::darwinHomePath() / "traces" / filename;
+  try {
+    core::Tracing::exportChromeTrace(path);
+  } catch (const std::exception& e) {
+    core::log("Failed to export the Chrome trace: %s\n", e.what());
   }
 }
 
 void Evolution::checkpoint() {
+  checkpoint(nullptr);
+}
+
+void Evolution::checkpoint(const function<void()>& before_pause) {
+  // fast path: the evolution is running, nothing to do
+  // (a relaxed load is enough, pause/cancel requests don't need to be seen instantly)
+  if (running_.load(std::memory_order_relaxed))
+    return;
+
   unique_lock<mutex> guard(lock_);
 
+  bool pending_before_pause = bool(before_pause);
   while (state_ != State::Running) {
     // handle pause requests (Pausing -> Paused)
     if (state_ == State::Pausing) {
-      state_ = State::Paused;
-      state_cv_.notify_all();
+      if (pending_before_pause) {
+        pending_before_pause = false;
+        guard.unlock();
+        before_pause();
+        guard.lock();
+        // the state may have changed while the lock was released
+        continue;
+      }
+
+      setState(State::Paused);
 
       // annotate the current stage, if any
       if (!stage_stack_.empty())
@@ -424,14 +736,73 @@ void Evolution::checkpoint() {
   }
 }
 
+bool Evolution::tryCheckpoint() {
+  if (running_.load(std::memory_order_relaxed))
+    return true;
+
+  unique_lock<mutex> guard(lock_);
+  if (state_ == State::Canceling) {
+    // annotate the current stage, if any
+    if (!stage_stack_.empty())
+      stage_stack_.back().addAnnotations(EvolutionStage::Annotation::Canceled);
+
+    throw pp::CanceledException();
+  }
+
+  // any other state is handled by the (blocking) checkpoint on the submitting thread
+  return state_ == State::Running;
+}
+
+void Evolution::BackgroundController::checkpoint() {
+  if (evolution_->running_.load(std::memory_order_relaxed))
+    return;
+
+  unique_lock<mutex> guard(evolution_->lock_);
+  if (evolution_->state_ == State::Canceling)
+    throw pp::CanceledException();
+}
+
+void Evolution::setState(State state) {
+  state_ = state;
+  running_.store(state == State::Running, std::memory_order_relaxed);
+  state_cv_.notify_all();
+}
+
+void Evolution::configureThreadPool(int threads_count, pp::ThreadAffinity affinity) {
+  CHECK(state_ == State::Initializing);
+  if (threads_count == threads_count_ && affinity == thread_affinity_)
+    return;
+
+  // the other instances may be using the thread pool at any time
+  if (created_instances_ > 0) {
+    core::log("The thread pool is shared, the threads configuration is ignored\n");
+    return;
+  }
+
+  pp::ParallelForSupport::reconfigure(threads_count, affinity);
+  threads_count_ = threads_count;
+  thread_affinity_ = affinity;
+}
+
 void Evolution::beginStage(const string& name, size_t size, uint32_t annotations) {
   // must be called on the main thread
   CHECK(main_thread_id_ == std::this_thread::get_id());
 
   {
     unique_lock<mutex> guard(lock_);
+
+    // save the progress of the parent stage
+    if (!stage_stack_.empty())
+      stage_stack_.back().setProgress(stage_progress_);
+
     stage_stack_.emplace_back(name, size, annotations);
     stage_stack_.back().start();
+    if (perf_counters_)
+      stage_stack_.back().startPerfCounters(core::PerfCounters::read());
+
+    stage_progress_ = 0;
+    stage_size_ = size;
+    published_percent_ = 0;
   }
 
   events.publish(EventFlag::StateChanged);
@@ -450,19 +821,34 @@ void Evolution::finishStage(const string& name) {
     CHECK(!stage_stack_.empty());
     stage = stage_stack_.back();
     CHECK(stage.name() == name);
+    stage.setProgress(stage_progress_);
     stage.finish();
+    if (perf_counters_)
+      stage.finishPerfCounters(core::PerfCounters::read());
     stage_stack_.pop_back();
 
-    if (!stage_stack_.empty())
-      stage_stack_.back().recordSubStage(stage);
-    else
+    if (!stage_stack_.empty()) {
+      auto& parent_stage = stage_stack_.back();
+      parent_stage.recordSubStage(stage);
+
+      // restore the parent stage progress tracking
+      stage_progress_ = parent_stage.progress();
+      stage_size_ = parent_stage.size();
+      published_percent_ = parent_stage.progressPercent();
+    } else {
       top_stage = true;
+    }
   }
 
   if ((stage.annotations() & EvolutionStage::Annotation::Canceled) == 0) {
     core::log("Stage complete: %s, %.4f sec\n", stage.name(), stage.elapsed());
   }
 
+  if (core::Tracing::enabled()) {
+    core::Tracing::recordSpan(
+        stage.name(), "stage", stage.startTimestamp(), stage.finishTimestamp());
+  }
+
   if (top_stage) {
     top_stages.publish(stage);
   }
@@ -470,22 +856,27 @@ void Evolution::finishStage(const string& name) {
   events.publish(EventFlag::StateChanged);
 }
 
+// NOTE: this is called from the worker threads, so it must not take lock_
+//  (the stage stack is only updated from the main thread, at the stage boundaries,
+//  when there are no in-flight progress updates)
 void Evolution::reportProgress(size_t increment) {
-  bool progress_notification = false;
-
-  {
-    unique_lock<mutex> guard(lock_);
-
-    CHECK(!stage_stack_.empty());
+  CHECK(increment > 0);
 
-    auto& current_stage = stage_stack_.back();
-    int prev_progress_percent = current_stage.progressPercent();
-    current_stage.advanceProgress(increment);
-    progress_notification = current_stage.progressPercent() != prev_progress_percent;
+  const size_t size = stage_size_.load(memory_order_relaxed);
+  const size_t progress =
+      stage_progress_.fetch_add(increment, memory_order_relaxed) + increment;
+  CHECK(progress <= size);
+
+  // only one of the threads crossing a percent boundary publishes the update
+  const int percent = progressPercent(progress, size);
+  int published_percent = published_percent_.load(memory_order_relaxed);
+  while (percent > published_percent) {
+    if (published_percent_.compare_exchange_weak(
+            published_percent, percent, memory_order_relaxed)) {
+      events.publish(EventFlag::ProgressUpdate);
+      break;
+    }
   }
-
-  if (progress_notification)
-    events.publish(EventFlag::ProgressUpdate);
 }
 
 Evolution::Snapshot Evolution::snapshot() const {
@@ -493,10 +884,15 @@ Evolution::Snapshot Evolution::snapshot() const {
   Snapshot s;
   s.experiment = experiment_;
   s.trace = trace_;
-  s.generation = population_ ? population_->generation() : 0;
-  s.stage = stage_stack_.empty() ? EvolutionStage() : stage_stack_.back();
+  s.generation = steady_state_ ? steady_state_->pool()->generation()
+                 : population_  ? population_->generation()
+                                : 0;
+  if (!stage_stack_.empty()) {
+    s.stage = stage_stack_.back();
+    s.stage.setProgress(stage_progress_);
+  }
   s.state = state_;
-  s.population = population_.get();
+  s.population = steady_state_ ? steady_state_->pool() : population_.get();
   s.domain = domain_.get();
   return s;
 }
@@ -508,8 +904,7 @@ void Evolution::pause() {
   {
     unique_lock<mutex> guard(lock_);
     if (state_ == State::Running) {
-      state_ = State::Pausing;
-      state_cv_.notify_all();
+      setState(State::Pausing);
       update = true;
     }
   }
@@ -518,6 +913,18 @@ void Evolution::pause() {
     events.publish(EventFlag::StateChanged);
 }
 
+void Evolution::joinIslandModel(shared_ptr<IslandModel> island_model, int island) {
+  CHECK(island_model != nullptr);
+  CHECK(island >= 0 && island < island_model->config().islands);
+
+  unique_lock<mutex> guard(lock_);
+  CHECK(state_ == State::Paused);
+  CHECK(experiment_ != nullptr && trace_->size() == 0);
+  CHECK(island_model_ == nullptr);
+  island_model_ = island_model;
+  island_ = island;
+}
+
 void Evolution::run() {
   CHECK(experiment_ != nullptr);
 
@@ -526,8 +933,7 @@ void Evolution::run() {
   {
     unique_lock<mutex> guard(lock_);
     if (state_ == State::Paused) {
-      state_ = State::Running;
-      state_cv_.notify_all();
+      setState(State::Running);
       update = true;
     } else {
       CHECK(state_ == State::Running);
@@ -550,8 +956,7 @@ bool Evolution::reset() {
 
       case State::Paused:
         // requesting cancelation
-        state_ = State::Canceling;
-        state_cv_.notify_all();
+        setState(State::Canceling);
         break;
 
       case State::Stopped:
@@ -569,13 +974,21 @@ bool Evolution::reset() {
 
     // reset the evolution state
     stage_stack_.clear();
+    perf_counters_ = false;
+    stage_progress_ = 0;
+    stage_size_ = 0;
+    published_percent_ = 0;
     experiment_.reset();
     trace_.reset();
+    evaluation_workers_.reset();
+    multi_fidelity_.reset();
+    island_model_.reset();
+    island_ = -1;
     population_.reset();
     domain_.reset();
+    context_ = core::Context();
 
-    state_ = State::Initializing;
-    state_cv_.notify_all();
+    setState(State::Initializing);
   }
 
   core::log("\nThe evolution was reset.\n");
@@ -601,13 +1014,12 @@ void EvolutionStage::recordSubStage(const EvolutionStage& stage) {
 
 int EvolutionStage::progressPercent() const {
   assert(progress_ <= size_);
-  return size_ > 0 ? int(double(progress_) / size_ * 100.0) : 0;
+  return darwin::progressPercent(progress_, size_);
 }
 
-void EvolutionStage::advanceProgress(size_t increment) {
-  CHECK(increment > 0);
-  progress_ += increment;
-  CHECK(progress_ <= size_);
+void EvolutionStage::setProgress(size_t progress) {
+  CHECK(progress <= size_);
+  progress_ = progress;
 }
 
 double EvolutionStage::elapsed() const {
@@ -625,6 +1037,10 @@ void to_json(json& json_obj, const EvolutionStage& stage) {
   json_obj["name"] = stage.name();
   json_obj["elapsed"] = stage.elapsed();
 
+  if (stage.perfCounters().has_value()) {
+    json_obj["counters"] = stage.perfCounters().value();
+  }
+
   const auto& sub_stages = stage.subStages();
   if (!sub_stages.empty()) {
     json_obj["substages"] = sub_stages;
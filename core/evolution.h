@@ -14,16 +14,23 @@
 
 #pragma once
 
+#include "ann_utils.h"
+#include "context.h"
 #include "darwin.h"
+#include "multi_fidelity.h"
+#include "perf_counters.h"
 #include "pubsub.h"
 #include "thread_pool.h"
 
 #include <third_party/json/json.h>
 using nlohmann::json;
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <utility>
 #include <vector>
@@ -32,6 +39,9 @@ using namespace std;
 namespace darwin {
 
 class Evolution;
+class EvaluationWorkers;
+class IslandModel;
+class SteadyStateEvolution;
 
 //! Summary of a generation (fitness samples, best genotype, ...)
 struct GenerationSummary {
@@ -86,6 +96,20 @@ inline auto customStringify(core::TypeTag<FitnessInfoKind>) {
   return stringify;
 }
 
+//! The genealogy information encoding
+enum class GenealogyFormat {
+  Json,     //!< JSON array (indexed by genotype), saved in the generation details
+  Compact,  //!< Binary encoding (indexed by rank), see CompactGenealogy
+};
+
+inline auto customStringify(core::TypeTag<GenealogyFormat>) {
+  static auto stringify = new core::StringifyKnownValues<GenealogyFormat>{
+    { GenealogyFormat::Json, "json" },
+    { GenealogyFormat::Compact, "compact" },
+  };
+  return stringify;
+}
+
 //! The kind of captured profile data
 enum class ProfileInfoKind {
   GenerationOnly,  //!< Just the per-generation elapsed timings
@@ -100,6 +124,36 @@ inline auto customStringify(core::TypeTag<ProfileInfoKind>) {
   return stringify;
 }
 
+//! Chrome trace-event recording (stages and worker threads activity)
+enum class ChromeTraceKind {
+  None,           //!< No trace events are recorded
+  PerGeneration,  //!< Export one trace file for every generation
+  PerRun,         //!< Export one trace file for the whole evolution run
+};
+
+inline auto customStringify(core::TypeTag<ChromeTraceKind>) {
+  static auto stringify = new core::StringifyKnownValues<ChromeTraceKind>{
+    { ChromeTraceKind::None, "none" },
+    { ChromeTraceKind::PerGeneration, "per_generation" },
+    { ChromeTraceKind::PerRun, "per_run" },
+  };
+  return stringify;
+}
+
+//! Steady-state evolution: which genotype is replaced by a new child
+enum class SteadyStateReplacement {
+  Worst,   //!< The genotype with the lowest fitness
+  Oldest,  //!< The oldest genotype (except the current champion)
+};
+
+inline auto customStringify(core::TypeTag<SteadyStateReplacement>) {
+  static auto stringify = new core::StringifyKnownValues<SteadyStateReplacement>{
+    { SteadyStateReplacement::Worst, "worst" },
+    { SteadyStateReplacement::Oldest, "oldest" },
+  };
+  return stringify;
+}
+
 //! Settings for an evolution experiment run
 struct EvolutionConfig : public core::PropertySet {
   PROPERTY(max_generations,
@@ -122,10 +176,72 @@ struct EvolutionConfig : public core::PropertySet {
            false,
            "Save the genealogy information (can be very large!)");
 
+  PROPERTY(genealogy_format,
+           GenealogyFormat,
+           GenealogyFormat::Json,
+           "The genealogy encoding (if save_genealogy is set)");
+
   PROPERTY(profile_information,
            ProfileInfoKind,
            ProfileInfoKind::GenerationOnly,
            "Performance trace (counters/timings)");
+
+  PROPERTY(chrome_trace,
+           ChromeTraceKind,
+           ChromeTraceKind::None,
+           "Export Chrome trace events (saved under <darwin home>/traces)");
+
+  PROPERTY(overlap_calibration,
+           bool,
+           false,
+           "Calibrate each champion in the background, overlapping the next generation "
+           "(the generation summaries are published one generation late)");
+
+  PROPERTY(threads,
+           int,
+           0,
+           "The number of worker threads (0 = the default thread pool size)");
+
+  PROPERTY(thread_affinity,
+           pp::ThreadAffinity,
+           pp::ThreadAffinity::None,
+           "Worker threads placement (pinning to cores or NUMA nodes)");
+
+  PROPERTY(evaluation_workers,
+           int,
+           0,
+           "The number of evaluation worker processes (0 = in-process evaluation)");
+
+  PROPERTY(evaluation_worker,
+           string,
+           "",
+           "The evaluation worker executable (empty = the current executable)");
+
+  PROPERTY(evaluation_batch_size,
+           int,
+           0,
+           "The number of genotypes sent to a worker process at once (0 = auto)");
+
+  PROPERTY(evaluation_batch_timeout,
+           int,
+           3600,
+           "Seconds before a worker process which didn't reply is restarted "
+           "(0 = no timeout)");
+
+  PROPERTY(steady_state,
+           bool,
+           false,
+           "Asynchronous steady-state evolution (independent evaluation domains only)");
+
+  PROPERTY(steady_state_replacement,
+           SteadyStateReplacement,
+           SteadyStateReplacement::Worst,
+           "Which genotype is replaced by a new child (worst or oldest)");
+
+  VARIANT(evaluation_fidelity,
+          FidelityVariant,
+          EvaluationFidelity::Full,
+          "Optional low fidelity pre-screening (independent evaluation domains only)");
 };
 
 vector<CompressedFitnessValue> compressFitness(const Population* population);
@@ -160,14 +276,42 @@ class EvolutionStage {
   //! Stage elapsed time in seconds
   double elapsed() const;
 
+  //! The stage start timestamp
+  Clock::time_point startTimestamp() const { return start_timestamp_; }
+
+  //! The stage finish timestamp
+  Clock::time_point finishTimestamp() const { return finish_timestamp_; }
+
   //! Progress percent [0..100]
   int progressPercent() const;
 
+  //! Stage size (in whatever units/increments are appropriate), or 0 if unknown
+  size_t size() const { return size_; }
+
+  //! Current progress, relative to the stage size
+  size_t progress() const { return progress_; }
+
+  //! Hardware performance counters for the stage (aggregated across all threads)
+  //! \note Only available if ProfileInfoKind::AllStages is selected (and supported)
+  const optional<core::PerfCountersValues>& perfCounters() const {
+    return perf_counters_;
+  }
+
+  //! Records the performance counters values at the start of the stage
+  void startPerfCounters(const core::PerfCountersValues& values) {
+    perf_counters_start_ = values;
+  }
+
+  //! Records the performance counters values at the finish of the stage
+  void finishPerfCounters(const core::PerfCountersValues& values) {
+    perf_counters_ = values - perf_counters_start_;
+  }
+
   //! List of sub-stages, if any
   const vector<EvolutionStage>& subStages() const { return sub_stages_; }
 
   void recordSubStage(const EvolutionStage& stage);
-  void advanceProgress(size_t increment);
+  void setProgress(size_t progress);
   void addAnnotations(uint32_t annotations);
   uint32_t annotations() const { return annotations_; }
 
@@ -180,6 +324,8 @@ class EvolutionStage {
   Clock::time_point start_timestamp_;
   Clock::time_point finish_timestamp_;
   uint32_t annotations_ = 0;
+  core::PerfCountersValues perf_counters_start_;
+  optional<core::PerfCountersValues> perf_counters_;
   vector<EvolutionStage> sub_stages_;
 };
 
@@ -194,10 +340,32 @@ class EvolutionTrace : public core::NonCopyable {
   //! Indexed access to a recorded generation summary
   GenerationSummary generationSummary(int generation) const;
 
+  //! Universe database Id of the trace
+  db::RowId dbTraceId() const { return db_trace_->id; }
+
+  //! A generation captured by captureGeneration(), not yet recorded
+  struct PendingGeneration {
+    GenerationSummary summary;
+    DbGeneration db_generation;
+    json json_summary;
+  };
+
   GenerationSummary addGeneration(const Population* population,
                                   shared_ptr<core::PropertySet> calibration_fitness,
                                   const EvolutionStage& top_stage);
 
+  //! Captures the generation results (while the population is still current)
+  //!
+  //! The generation is recorded later, by addGeneration(), once the
+  //! calibration fitness is available.
+  //!
+  PendingGeneration captureGeneration(const Population* population,
+                                      const EvolutionStage& top_stage) const;
+
+  //! Records a previously captured generation
+  GenerationSummary addGeneration(PendingGeneration pending,
+                                  shared_ptr<core::PropertySet> calibration_fitness);
+
  private:
   mutable mutex lock_;
 
@@ -236,11 +404,18 @@ class ProgressMonitor {
   //!
   //! \param increment - number of units processed, relative to stage size
   //!
+  //! \note This is normally called from the worker threads (once for every
+  //!   processed item) so the implementations should avoid any locking
+  //!
   virtual void reportProgress(size_t increment) = 0;
 };
 
 //! Connects the progress updates with a registered progress monitor
 //!
+//! The progress monitor is a context slot (core::ContextSlot), so each Evolution
+//! instance receives the progress updates from its own experiment. The registered
+//! monitor is the default, for the threads without an Evolution context.
+//!
 //! \note The synchronization between registration and
 //!    updates is external (ProgressManager is not responsible of it)
 //!
@@ -248,39 +423,64 @@ class ProgressMonitor {
 //! \sa EvolutionStage
 //!
 class ProgressManager {
+  friend class Evolution;
+  friend class SteadyStateEvolution;
+
  public:
   //! Reports the start of a stage
   static void beginStage(const string& name, size_t size, uint32_t annotations) {
-    if (progress_monitor_ != nullptr) {
-      progress_monitor_->beginStage(name, size, annotations);
+    auto progress_monitor = progress_monitor_.get();
+    if (progress_monitor != nullptr && !background_thread_) {
+      progress_monitor->beginStage(name, size, annotations);
     }
   }
 
   //! Reports the finish of a stage
   static void finishStage(const string& name) {
-    if (progress_monitor_ != nullptr) {
-      progress_monitor_->finishStage(name);
+    auto progress_monitor = progress_monitor_.get();
+    if (progress_monitor != nullptr && !background_thread_) {
+      progress_monitor->finishStage(name);
     }
   }
 
-  //! Reports stage progress
+  //! Reports stage progress (safe to call from any thread)
   static void reportProgress(size_t increment = 1) {
-    if (progress_monitor_ != nullptr) {
-      progress_monitor_->reportProgress(increment);
+    auto progress_monitor = progress_monitor_.get();
+    if (progress_monitor != nullptr) {
+      progress_monitor->reportProgress(increment);
     }
   }
 
-  //! Registers a ProgressMonitor implementation
+  //! Registers the default ProgressMonitor implementation
   static void registerMonitor(ProgressMonitor* monitor) {
-    CHECK(progress_monitor_ == nullptr);
-    progress_monitor_ = monitor;
+    CHECK(progress_monitor_.get() == nullptr);
+    progress_monitor_.setDefault(monitor);
   }
 
+  //! Marks the current thread as a background thread
+  //!
+  //! The stages started on a background thread (ex. the champion calibration,
+  //! overlapping the next generation) are not reported, since the progress
+  //! monitor tracks the stages of the main evolution thread.
+  //!
+  static void setBackgroundThread(bool background) { background_thread_ = background; }
+
  private:
-  static ProgressMonitor* progress_monitor_;
+  static core::ContextSlot<ProgressMonitor> progress_monitor_;
+  static thread_local bool background_thread_;
 };
 
 //! The controller for running evolution experiments
+//!
+//! Normally there's a single Evolution instance (see evolution()), but additional
+//! instances can be created with Evolution::create(), running independent experiments
+//! concurrently. All the instances share the pp::for_each thread pool, and the
+//! per-experiment state (the ANN library, the domain and population configurations)
+//! is bound to each instance's context (see core::ContextSlot).
+//!
+//! \note The Chrome trace events and the hardware performance counters are
+//!   process-wide, so they are not reliable if multiple experiments run concurrently
+//!
 class Evolution : public core::NonCopyable,
                   public pp::Controller,
                   public ProgressMonitor {
@@ -355,12 +555,25 @@ class Evolution : public core::NonCopyable,
   };
 
  public:
-  static void init();
+  //! Initializes the evolution singleton (and the thread pool used by pp::for_each)
+  //! \param threads_count - the number of worker threads, or
+  //!   pp::ThreadPool::kAutoThreadCount
+  static void init(int threads_count = pp::ThreadPool::kAutoThreadCount);
+
+  //! Creates an additional evolution instance, sharing the thread pool
+  //! (init() must be called first)
+  static unique_ptr<Evolution> create();
+
+  //! Stops the evolution main thread
+  //! \note The evolution must be stopped (or not started)
+  ~Evolution() override;
 
   //! Sets up a new evolution experiment
   //!
   //! \param experiment - the Experiment model/state
-  //! \param config - evolution runtime settings
+  //! \param config - evolution runtime settings (the thread pool is recreated
+  //!   if the requested threads count or affinity differ from the current ones,
+  //!   except for the additional instances, which don't own the thread pool)
   //!
   //! \todo Copy the experiment instead of shared_ptr?
   //!
@@ -375,6 +588,19 @@ class Evolution : public core::NonCopyable,
   //! Accessor to the associated EvolutionConfig instance
   const EvolutionConfig& config() const { return config_; }
 
+  //! Accessor to the evaluation worker processes
+  //! (nullptr if the population is evaluated in-process)
+  const EvaluationWorkers* evaluationWorkers() const { return evaluation_workers_.get(); }
+
+  //! Joins an island model, as the specified island
+  //!
+  //! At the island model migration intervals, this evolution instance will exchange
+  //! genotypes with the other islands (see IslandModel::migrate())
+  //!
+  //! \note Must be called after newExperiment(), before the evolution starts
+  //!
+  void joinIslandModel(shared_ptr<IslandModel> island_model, int island);
+
   //! Start/Resume the evolution
   //! \sa State
   void run();
@@ -396,17 +622,28 @@ class Evolution : public core::NonCopyable,
   void waitForState(State target_state) const;
 
  private:
-  Evolution() {
-    pp::ParallelForSupport::init(this);
-    ProgressManager::registerMonitor(this);
-  }
+  explicit Evolution(bool default_instance);
 
   void mainThread();
 
   void evolutionCycle();
 
+  void exportChromeTrace(const string& suffix) const;
+
+  // updates the state (must be called with the lock held)
+  void setState(State state);
+
+  // recreates the thread pool, if the requested configuration is different
+  // (the thread pool must be idle)
+  void configureThreadPool(int threads_count, pp::ThreadAffinity affinity);
+
   // pp::Controller interface
   void checkpoint() override;
+  bool tryCheckpoint() override;
+
+  // the checkpoint for the main evolution thread, calling `before_pause`
+  // (without holding the lock) before the evolution is paused
+  void checkpoint(const function<void()>& before_pause);
 
   // ProgressMonitor interface
   void beginStage(const string& name, size_t size, uint32_t annotations) override;
@@ -414,7 +651,38 @@ class Evolution : public core::NonCopyable,
   void reportProgress(size_t increment = 1) override;
 
  private:
+  // true for the evolution() singleton
+  const bool default_instance_;
+
+  // the number of Evolution::create() instances (sharing the thread pool)
+  static atomic<int> created_instances_;
+
+  std::thread main_thread_;
   std::thread::id main_thread_id_;
+  bool shutting_down_ = false;
+
+  // the experiment context (installed on the main thread while running)
+  core::Context context_;
+
+  // the pp::Controller for the background work (ex. the overlapped calibration)
+  //
+  // it only handles cancellation: the main evolution thread may be waiting for the
+  // background work, so pausing it would block the main thread before it's paused
+  //
+  class BackgroundController : public pp::Controller {
+   public:
+    explicit BackgroundController(Evolution* evolution) : evolution_(evolution) {}
+
+    void checkpoint() override;
+
+   private:
+    Evolution* evolution_ = nullptr;
+  };
+
+  BackgroundController background_controller_{ this };
+
+  // the ANN library configuration (bound to context_)
+  ann::Config ann_config_;
 
   mutable mutex lock_;
   mutable condition_variable state_cv_;
@@ -422,19 +690,56 @@ class Evolution : public core::NonCopyable,
   State state_ = State::Initializing;
   vector<EvolutionStage> stage_stack_;
 
+  // mirrors (state_ == State::Running), so the checkpoints called from
+  // the worker threads don't need the lock while the evolution is running
+  atomic<bool> running_ = false;
+
+  // the progress of the current (inner-most) stage is tracked separately, which
+  // allows lock-free reportProgress() calls from the worker threads
+  // (it's folded back into stage_stack_.back() at the stage boundaries)
+  atomic<size_t> stage_progress_ = 0;
+  atomic<size_t> stage_size_ = 0;
+
+  // true if the hardware performance counters are recorded for each stage
+  bool perf_counters_ = false;
+
+  // the last published progress percent for the current stage
+  // (limits the ProgressUpdate notifications to at most one per percent)
+  atomic<int> published_percent_ = 0;
+
   EvolutionConfig config_;
 
+  // the default thread pool size (passed to init())
+  int default_threads_count_ = pp::ThreadPool::kAutoThreadCount;
+
+  // the current thread pool configuration
+  int threads_count_ = pp::ThreadPool::kAutoThreadCount;
+  pp::ThreadAffinity thread_affinity_ = pp::ThreadAffinity::None;
+
   // population & domain
   unique_ptr<Population> population_;
   unique_ptr<Domain> domain_;
 
+  // optional out-of-process evaluation (see EvolutionConfig::evaluation_workers)
+  unique_ptr<EvaluationWorkers> evaluation_workers_;
+
+  // the steady-state evolution state, while evolving (see EvolutionConfig::steady_state)
+  unique_ptr<SteadyStateEvolution> steady_state_;
+
+  // optional multi-fidelity evaluation (see EvolutionConfig::evaluation_fidelity)
+  unique_ptr<MultiFidelityEvaluation> multi_fidelity_;
+
+  // optional genotypes migration (see joinIslandModel())
+  shared_ptr<IslandModel> island_model_;
+  int island_ = -1;
+
   shared_ptr<Experiment> experiment_;
   shared_ptr<EvolutionTrace> trace_;
 };
 
 //! Accessor to the Evolution singleton instance
 inline Evolution* evolution() {
-  static Evolution* instance = new Evolution();
+  static Evolution* instance = new Evolution(true);
   return instance;
 }
 
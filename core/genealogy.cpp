@@ -0,0 +1,282 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "genealogy.h"
+#include "exception.h"
+
+#include <algorithm>
+#include <limits>
+#include <unordered_map>
+using namespace std;
+
+namespace darwin {
+
+constexpr uint32_t kCompactGenealogyVersion = 1;
+
+static void writeVarint(db::Blob& data, uint64_t value) {
+  while (value >= 0x80) {
+    data.push_back(uint8_t(value | 0x80));
+    value >>= 7;
+  }
+  data.push_back(uint8_t(value));
+}
+
+static void writeZigzag(db::Blob& data, int64_t value) {
+  writeVarint(data, (uint64_t(value) << 1) ^ uint64_t(value >> 63));
+}
+
+// simple cursor over the encoded genealogy data
+class VarintReader {
+ public:
+  explicit VarintReader(const db::Blob& data) : data_(data) {}
+
+  uint64_t readVarint() {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+      if (offset_ >= data_.size())
+        throw core::Exception("Unexpected end of the genealogy data");
+      const uint8_t byte = data_[offset_++];
+      value |= uint64_t(byte & 0x7f) << shift;
+      if ((byte & 0x80) == 0)
+        return value;
+    }
+    throw core::Exception("Invalid varint value in the genealogy data");
+  }
+
+  int readInt() {
+    const auto value = readVarint();
+    if (value > uint64_t(numeric_limits<int>::max()))
+      throw core::Exception("Out of range value in the genealogy data");
+    return int(value);
+  }
+
+  int64_t readZigzag() {
+    const auto value = readVarint();
+    return int64_t(value >> 1) ^ -int64_t(value & 1);
+  }
+
+  string readString() {
+    const int length = readInt();
+    if (offset_ + length > data_.size())
+      throw core::Exception("Unexpected end of the genealogy data");
+    string str(data_.begin() + offset_, data_.begin() + offset_ + length);
+    offset_ += length;
+    return str;
+  }
+
+  bool done() const { return offset_ == data_.size(); }
+
+ private:
+  const db::Blob& data_;
+  size_t offset_ = 0;
+};
+
+const string& GenerationGenealogy::geneticOperator(int rank) const {
+  static const string kEmpty;
+  const int code = operator_codes_[rank];
+  return code == kNoOperator ? kEmpty : operators_[code];
+}
+
+Genealogy GenerationGenealogy::entry(int rank) const {
+  Genealogy genealogy;
+  genealogy.genetic_operator = geneticOperator(rank);
+  genealogy.parents.assign(parents_.begin() + parents_offsets_[rank],
+                           parents_.begin() + parents_offsets_[rank + 1]);
+  return genealogy;
+}
+
+db::Blob CompactGenealogy::encode(const Population* population) {
+  const auto ranking_index = population->rankingIndex();
+  CHECK(ranking_index.size() == population->size());
+
+  // build the operators dictionary
+  vector<string> operators;
+  unordered_map<string, int> operator_codes;
+  for (auto genotype_index : ranking_index) {
+    const auto& genetic_operator =
+        population->genotype(genotype_index)->genealogy.genetic_operator;
+    if (!genetic_operator.empty() && operator_codes.count(genetic_operator) == 0) {
+      operator_codes[genetic_operator] = int(operators.size());
+      operators.push_back(genetic_operator);
+    }
+  }
+
+  db::Blob data;
+  data.reserve(ranking_index.size() * 4);
+
+  writeVarint(data, kCompactGenealogyVersion);
+  writeVarint(data, ranking_index.size());
+
+  writeVarint(data, operators.size());
+  for (const auto& genetic_operator : operators) {
+    writeVarint(data, genetic_operator.size());
+    data.insert(data.end(), genetic_operator.begin(), genetic_operator.end());
+  }
+
+  int prev_first_parent = 0;
+  for (auto genotype_index : ranking_index) {
+    const auto& genealogy = population->genotype(genotype_index)->genealogy;
+
+    if (genealogy.genetic_operator.empty()) {
+      CHECK(genealogy.parents.empty());
+      writeVarint(data, 0);
+      continue;
+    }
+
+    writeVarint(data, operator_codes[genealogy.genetic_operator] + 1);
+    writeVarint(data, genealogy.parents.size());
+
+    for (size_t i = 0; i < genealogy.parents.size(); ++i) {
+      const int parent = genealogy.parents[i];
+      CHECK(parent >= 0);
+      if (i == 0) {
+        writeZigzag(data, int64_t(parent) - prev_first_parent);
+        prev_first_parent = parent;
+      } else {
+        writeZigzag(data, int64_t(parent) - genealogy.parents[i - 1]);
+      }
+    }
+  }
+
+  return data;
+}
+
+GenerationGenealogy CompactGenealogy::decode(const db::Blob& data) {
+  VarintReader reader(data);
+
+  if (reader.readVarint() != kCompactGenealogyVersion)
+    throw core::Exception("Unsupported genealogy format version");
+
+  GenerationGenealogy genealogy;
+
+  const int size = reader.readInt();
+  genealogy.operator_codes_.reserve(size);
+  genealogy.parents_offsets_.reserve(size + 1);
+  genealogy.parents_offsets_.push_back(0);
+
+  const int operators_count = reader.readInt();
+  for (int i = 0; i < operators_count; ++i) {
+    genealogy.operators_.push_back(reader.readString());
+  }
+
+  int64_t prev_first_parent = 0;
+  for (int rank = 0; rank < size; ++rank) {
+    const int code = reader.readInt() - 1;
+    if (code >= operators_count)
+      throw core::Exception("Invalid genetic operator code");
+    genealogy.operator_codes_.push_back(code);
+
+    if (code != GenerationGenealogy::kNoOperator) {
+      const int parents_count = reader.readInt();
+      int64_t parent = 0;
+      for (int i = 0; i < parents_count; ++i) {
+        if (i == 0) {
+          parent = prev_first_parent + reader.readZigzag();
+          prev_first_parent = parent;
+        } else {
+          parent += reader.readZigzag();
+        }
+        if (parent < 0 || parent > numeric_limits<int>::max())
+          throw core::Exception("Invalid parent rank");
+        genealogy.parents_.push_back(int(parent));
+      }
+    }
+
+    genealogy.parents_offsets_.push_back(int(genealogy.parents_.size()));
+  }
+
+  if (!reader.done())
+    throw core::Exception("Unexpected trailing genealogy data");
+
+  return genealogy;
+}
+
+GenealogyReader::GenealogyReader(const Universe* universe, db::RowId trace_id) {
+  CHECK(universe != nullptr);
+
+  for (const auto& data : universe->loadGenealogy(trace_id)) {
+    if (!data.has_value()) {
+      throw core::Exception(
+          "Missing compact genealogy information (generation %d, trace %lld)",
+          generations(),
+          static_cast<long long>(trace_id));
+    }
+    generations_.push_back(CompactGenealogy::decode(data.value()));
+  }
+}
+
+const GenerationGenealogy& GenealogyReader::generation(int generation) const {
+  if (generation < 0 || generation >= generations())
+    throw core::Exception("Generation %d is not available", generation);
+  return generations_[generation];
+}
+
+vector<LineageNode> GenealogyReader::lineage(int generation, int rank) const {
+  vector<LineageNode> chain;
+
+  for (;;) {
+    const auto& generation_genealogy = this->generation(generation);
+    if (rank < 0 || rank >= generation_genealogy.size())
+      throw core::Exception("Invalid rank %d (generation %d)", rank, generation);
+
+    LineageNode node;
+    node.generation = generation;
+    node.rank = rank;
+    node.genetic_operator = generation_genealogy.geneticOperator(rank);
+    chain.push_back(node);
+
+    if (generation == 0 || generation_genealogy.parentsCount(rank) == 0)
+      break;
+
+    rank = generation_genealogy.parent(rank, 0);
+    --generation;
+  }
+
+  return chain;
+}
+
+vector<vector<int>> GenealogyReader::ancestors(int generation,
+                                               int rank,
+                                               int max_depth) const {
+  CHECK(max_depth >= 0);
+
+  vector<vector<int>> ancestors;
+  vector<int> current = { rank };
+
+  for (int depth = 0; depth < max_depth && generation > 0; ++depth, --generation) {
+    const auto& generation_genealogy = this->generation(generation);
+
+    vector<int> parents;
+    for (int index : current) {
+      if (index < 0 || index >= generation_genealogy.size())
+        throw core::Exception("Invalid rank %d (generation %d)", index, generation);
+      for (int i = 0; i < generation_genealogy.parentsCount(index); ++i) {
+        parents.push_back(generation_genealogy.parent(index, i));
+      }
+    }
+
+    sort(parents.begin(), parents.end());
+    parents.erase(unique(parents.begin(), parents.end()), parents.end());
+
+    if (parents.empty())
+      break;
+
+    ancestors.push_back(parents);
+    current = std::move(parents);
+  }
+
+  return ancestors;
+}
+
+}  // namespace darwin
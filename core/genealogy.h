@@ -0,0 +1,158 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "darwin.h"
+#include "database.h"
+#include "universe.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace darwin {
+
+//! The decoded genealogy information for one generation
+//!
+//! The entries are indexed by rank (not by genotype index), which matches the
+//! parent indexes recorded in Genealogy::parents. This means that the parents of
+//! the entry `rank` in generation `g` are directly indexing the entries of
+//! generation `g - 1`.
+//!
+//! The genetic operators are represented as small integer codes, indexing into the
+//! per-generation operators dictionary (kNoOperator if no genealogy information is
+//! available, for example the primordial generation)
+//!
+//! \sa CompactGenealogy
+//!
+class GenerationGenealogy {
+ public:
+  //! Operator code used when the genotype has no genealogy information
+  static constexpr int kNoOperator = -1;
+
+ public:
+  //! Number of entries (the population size)
+  int size() const { return int(operator_codes_.size()); }
+
+  //! The operator code for the specified rank
+  int operatorCode(int rank) const { return operator_codes_[rank]; }
+
+  //! The name of the genetic operator for the specified rank (or empty string)
+  const string& geneticOperator(int rank) const;
+
+  //! The number of parents for the specified rank
+  int parentsCount(int rank) const {
+    return parents_offsets_[rank + 1] - parents_offsets_[rank];
+  }
+
+  //! Indexed access to the parent ranks (from the previous generation)
+  int parent(int rank, int parent_index) const {
+    return parents_[parents_offsets_[rank] + parent_index];
+  }
+
+  //! The genetic operators dictionary
+  const vector<string>& operators() const { return operators_; }
+
+  //! Expands the specified entry into a Genealogy instance
+  Genealogy entry(int rank) const;
+
+ private:
+  vector<string> operators_;
+  vector<int> operator_codes_;
+
+  // the parents for entry `i` are parents_[parents_offsets_[i] .. parents_offsets_[i+1])
+  vector<int> parents_offsets_;
+  vector<int> parents_;
+
+  friend class CompactGenealogy;
+};
+
+//! Compact (binary) encoding of the genealogy information for one generation
+//!
+//! The encoding is a sequence of unsigned LEB128 varints:
+//!
+//! ```
+//! format version
+//! entries count
+//! operators count, followed by { length, characters } for each operator
+//! for each entry, in rank order:
+//!   operator code + 1 (0 means no genealogy information)
+//!   parents count
+//!   zigzag(first parent - previous entry's first parent)
+//!   zigzag(parent[i] - parent[i - 1]) for the remaining parents
+//! ```
+//!
+//! Consecutive offspring tend to share (or have close) parent ranks, so most of the
+//! deltas fit in a single byte.
+//!
+class CompactGenealogy {
+ public:
+  //! Encodes the genealogy of the current generation
+  static db::Blob encode(const Population* population);
+
+  //! Decodes a compact genealogy blob
+  //! \throws core::Exception if the encoded data is malformed
+  static GenerationGenealogy decode(const db::Blob& data);
+};
+
+//! One step in a lineage chain
+struct LineageNode {
+  //! Generation number
+  int generation = -1;
+
+  //! Rank in the generation
+  int rank = -1;
+
+  //! The genetic operator used to create the genotype (or empty string)
+  string genetic_operator;
+};
+
+//! Reconstructs lineage information from the compact genealogy records
+//! saved in a Universe database
+//!
+//! \note The genealogy is only available if the evolution trace was recorded with
+//!   EvolutionConfig::save_genealogy set and GenealogyFormat::Compact
+//!
+class GenealogyReader {
+ public:
+  //! Loads the genealogy records for the specified evolution trace
+  GenealogyReader(const Universe* universe, db::RowId trace_id);
+
+  //! Number of generations with genealogy information
+  int generations() const { return int(generations_.size()); }
+
+  //! Decoded genealogy for the specified generation
+  const GenerationGenealogy& generation(int generation) const;
+
+  //! The lineage chain, following the first parent back to the oldest generation
+  //!
+  //! \returns The chain of ancestors, starting with the specified genotype
+  //!
+  vector<LineageNode> lineage(int generation, int rank) const;
+
+  //! All the ancestors of the specified genotype, as sorted sets of ranks
+  //!
+  //! \param max_depth - the max number of generations to go back
+  //! \returns A vector of ranks sets, one for each generation (going back in time,
+  //!   starting with the generation before the specified one)
+  //!
+  vector<vector<int>> ancestors(int generation, int rank, int max_depth) const;
+
+ private:
+  vector<GenerationGenealogy> generations_;
+};
+
+}  // namespace darwin
@@ -0,0 +1,131 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "island_model.h"
+#include "exception.h"
+
+#include <algorithm>
+using namespace std;
+
+namespace darwin {
+
+IslandModel::IslandModel(const IslandModelConfig& config) {
+  if (config.islands < 1)
+    throw core::Exception("Invalid number of islands: %d", config.islands);
+  if (config.migration_interval < 1)
+    throw core::Exception("Invalid migration interval: %d", config.migration_interval);
+  if (config.migrants < 0)
+    throw core::Exception("Invalid number of migrants: %d", config.migrants);
+
+  config_.copyFrom(config);
+
+  islands_.resize(config_.islands);
+  for (auto& island : islands_) {
+    island.received_versions.resize(config_.islands, 0);
+  }
+}
+
+// must be called with the lock held
+vector<int> IslandModel::sourceIslands(int island) {
+  const int islands_count = int(islands_.size());
+  if (islands_count < 2)
+    return {};
+
+  switch (config_.topology) {
+    case MigrationTopology::Ring:
+      return { (island + islands_count - 1) % islands_count };
+
+    case MigrationTopology::FullyConnected: {
+      vector<int> sources;
+      for (int source = 0; source < islands_count; ++source) {
+        if (source != island)
+          sources.push_back(source);
+      }
+      return sources;
+    }
+
+    case MigrationTopology::Random: {
+      uniform_int_distribution<int> dist(0, islands_count - 2);
+      const int source = dist(rnd_);
+      return { source < island ? source : source + 1 };
+    }
+
+    default:
+      FATAL("Unexpected migration topology");
+  }
+}
+
+int IslandModel::migrate(int island, Population* population) {
+  CHECK(island >= 0 && island < int(islands_.size()));
+
+  const size_t size = population->size();
+  const auto ranking_index = population->rankingIndex();
+
+  // the top genotypes are never replaced by immigrants
+  const size_t migrants_count = min(size_t(config_.migrants), size - 1);
+
+  // serialize the emigrants outside the lock
+  vector<Migrant> emigrants(migrants_count);
+  for (size_t i = 0; i < migrants_count; ++i) {
+    const auto genotype = population->genotype(ranking_index[i]);
+    emigrants[i].genotype = genotype->save();
+    emigrants[i].fitness = genotype->fitness;
+  }
+
+  vector<Migrant> immigrants;
+  {
+    unique_lock<mutex> guard(lock_);
+
+    auto& current = islands_[island];
+    current.emigrants = std::move(emigrants);
+    ++current.version;
+
+    for (int source : sourceIslands(island)) {
+      const auto& source_island = islands_[source];
+      if (source_island.version > current.received_versions[source]) {
+        current.received_versions[source] = source_island.version;
+        immigrants.insert(immigrants.end(),
+                          source_island.emigrants.begin(),
+                          source_island.emigrants.end());
+      }
+    }
+
+    // keep the best immigrants, if there are more than the available slots
+    std::stable_sort(
+        immigrants.begin(), immigrants.end(), [](const Migrant& a, const Migrant& b) {
+          return a.fitness > b.fitness;
+        });
+    immigrants.resize(min(immigrants.size(), size - migrants_count));
+
+    current.immigrants_count += int(immigrants.size());
+  }
+
+  // the immigrants replace the worst genotypes
+  // (keeping the fitness values from the source islands)
+  for (size_t i = 0; i < immigrants.size(); ++i) {
+    const auto genotype = population->genotype(ranking_index[size - 1 - i]);
+    genotype->load(immigrants[i].genotype);
+    genotype->fitness = immigrants[i].fitness;
+  }
+
+  return int(immigrants.size());
+}
+
+int IslandModel::immigrantsCount(int island) const {
+  unique_lock<mutex> guard(lock_);
+  CHECK(island >= 0 && island < int(islands_.size()));
+  return islands_[island].immigrants_count;
+}
+
+}  // namespace darwin
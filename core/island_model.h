@@ -0,0 +1,122 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "darwin.h"
+#include "properties.h"
+#include "stringify.h"
+#include "utils.h"
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <mutex>
+#include <random>
+#include <vector>
+using namespace std;
+
+namespace darwin {
+
+//! Which islands receive the migrants of an island
+enum class MigrationTopology {
+  Ring,            //!< Island i sends migrants to island (i + 1) % islands
+  FullyConnected,  //!< Every island sends migrants to all the other islands
+  Random,          //!< Each migration receives the migrants of a random island
+};
+
+inline auto customStringify(core::TypeTag<MigrationTopology>) {
+  static auto stringify = new core::StringifyKnownValues<MigrationTopology>{
+    { MigrationTopology::Ring, "ring" },
+    { MigrationTopology::FullyConnected, "fully_connected" },
+    { MigrationTopology::Random, "random" },
+  };
+  return stringify;
+}
+
+//! Island model configuration
+struct IslandModelConfig : public core::PropertySet {
+  PROPERTY(islands, int, 4, "The number of islands (independent populations)");
+
+  PROPERTY(topology,
+           MigrationTopology,
+           MigrationTopology::Ring,
+           "The migration topology (ring, fully_connected or random)");
+
+  PROPERTY(migration_interval, int, 10, "The number of generations between migrations");
+
+  PROPERTY(migrants, int, 2, "The number of genotypes (top ranked) sent by an island");
+};
+
+//! Exchanges genotypes between independent populations (the island model)
+//!
+//! Each island is a separate Evolution instance (see Evolution::joinIslandModel()),
+//! evolving its own population. At the migration intervals, an island publishes copies
+//! of its top genotypes (the emigrants) and replaces its worst genotypes with the
+//! latest emigrants from the source islands, as defined by the migration topology.
+//!
+//! The migration is asynchronous: an island never waits for the other islands, it just
+//! receives the emigrants published since its previous migration, if any. So the islands
+//! evolve at their own pace, without a global barrier per generation.
+//!
+//! \note The islands must use the same population type and configuration
+//!
+class IslandModel : public core::NonCopyable {
+  struct Migrant {
+    json genotype;
+    float fitness = 0;
+  };
+
+  struct Island {
+    // the latest emigrants, and the number of times they were published
+    vector<Migrant> emigrants;
+    int version = 0;
+
+    // the emigrants versions already received from each source island
+    vector<int> received_versions;
+
+    // total number of immigrants received by this island
+    int immigrants_count = 0;
+  };
+
+ public:
+  explicit IslandModel(const IslandModelConfig& config);
+
+  //! The island model configuration
+  const IslandModelConfig& config() const { return config_; }
+
+  //! Exchanges genotypes with the other islands
+  //!
+  //! The population must be evaluated (the migrants are selected based on
+  //! their fitness values, which are carried over to the receiving islands)
+  //!
+  //! \returns the number of immigrants
+  //!
+  int migrate(int island, Population* population);
+
+  //! The total number of genotypes received by an island
+  int immigrantsCount(int island) const;
+
+ private:
+  vector<int> sourceIslands(int island);
+
+ private:
+  IslandModelConfig config_;
+
+  mutable mutex lock_;
+  vector<Island> islands_;
+  default_random_engine rnd_{ random_device{}() };
+};
+
+}  // namespace darwin
@@ -0,0 +1,312 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "multi_fidelity.h"
+#include "evolution.h"
+#include "exception.h"
+#include "logging.h"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+using namespace std;
+
+namespace darwin {
+
+namespace {
+
+// a subset of a population's genotypes
+class PopulationSubset : public Population {
+ public:
+  PopulationSubset(Population* population, const vector<size_t>& indexes)
+      : population_(population), indexes_(indexes) {}
+
+  size_t size() const override { return indexes_.size(); }
+
+  Genotype* genotype(size_t index) override {
+    return population_->genotype(indexes_.at(index));
+  }
+
+  const Genotype* genotype(size_t index) const override {
+    return population_->genotype(indexes_.at(index));
+  }
+
+  vector<size_t> rankingIndex() const override {
+    vector<size_t> ranking_index(indexes_.size());
+    for (size_t i = 0; i < ranking_index.size(); ++i) {
+      ranking_index[i] = i;
+    }
+    std::stable_sort(ranking_index.begin(), ranking_index.end(), [&](size_t a, size_t b) {
+      return genotype(a)->fitness > genotype(b)->fitness;
+    });
+    return ranking_index;
+  }
+
+  int generation() const override { return population_->generation(); }
+  void createPrimordialGeneration(int) override { FATAL("Not supported"); }
+  void createNextGeneration() override { FATAL("Not supported"); }
+
+ private:
+  Population* population_ = nullptr;
+  const vector<size_t>& indexes_;
+};
+
+// fractional ranks (the ties get the average of their ranks)
+vector<double> ranks(const vector<double>& values) {
+  vector<size_t> order(values.size());
+  for (size_t i = 0; i < order.size(); ++i) {
+    order[i] = i;
+  }
+  std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+    return values[a] < values[b];
+  });
+
+  vector<double> ranks(values.size());
+  for (size_t i = 0; i < order.size();) {
+    size_t j = i + 1;
+    while (j < order.size() && values[order[j]] == values[order[i]])
+      ++j;
+    const double rank = (i + j - 1) / 2.0;
+    for (size_t k = i; k < j; ++k) {
+      ranks[order[k]] = rank;
+    }
+    i = j;
+  }
+  return ranks;
+}
+
+// Pearson correlation (0 if either series is constant)
+double pearsonCorrelation(const vector<double>& x, const vector<double>& y) {
+  CHECK(x.size() == y.size());
+  const size_t n = x.size();
+  if (n < 2)
+    return 0;
+
+  double mean_x = 0;
+  double mean_y = 0;
+  for (size_t i = 0; i < n; ++i) {
+    mean_x += x[i];
+    mean_y += y[i];
+  }
+  mean_x /= n;
+  mean_y /= n;
+
+  double cov = 0;
+  double var_x = 0;
+  double var_y = 0;
+  for (size_t i = 0; i < n; ++i) {
+    cov += (x[i] - mean_x) * (y[i] - mean_y);
+    var_x += (x[i] - mean_x) * (x[i] - mean_x);
+    var_y += (y[i] - mean_y) * (y[i] - mean_y);
+  }
+  if (var_x == 0 || var_y == 0)
+    return 0;
+  return cov / sqrt(var_x * var_y);
+}
+
+}  // namespace
+
+unique_ptr<Domain> createLowFidelityDomain(const Experiment* experiment,
+                                           const Domain* domain,
+                                           float fidelity) {
+  CHECK(experiment != nullptr);
+  CHECK(domain != nullptr);
+
+  const auto knobs = domain->fidelityKnobs();
+  if (knobs.empty()) {
+    throw core::Exception("Domain '%s' doesn't support multi-fidelity evaluation",
+                          experiment->setup()->domain_name);
+  }
+
+  auto domain_factory = experiment->domainFactory();
+  auto config = domain_factory->defaultConfig(experiment->setup()->domain_hint);
+  config->copyFrom(*experiment->domainConfig());
+
+  for (const auto& knob : knobs) {
+    core::Property* property = nullptr;
+    for (auto candidate : config->properties()) {
+      if (candidate->name() == knob.property) {
+        property = candidate;
+        break;
+      }
+    }
+    CHECK(property != nullptr, "Unknown fidelity knob: '%s'", knob.property.c_str());
+
+    // scale the knob down, but never below its min value (or above the full value)
+    const int full_value = core::fromString<int>(property->value());
+    const int low_value = int(lround(full_value * double(fidelity)));
+    const int value = min(full_value, max(knob.min_value, low_value));
+    property->setValue(core::toString(value));
+  }
+
+  auto low_fidelity_domain = domain_factory->create(*config);
+  if (low_fidelity_domain->inputs() != domain->inputs() ||
+      low_fidelity_domain->outputs() != domain->outputs()) {
+    throw core::Exception("The fidelity knobs must not change the domain interface");
+  }
+  return low_fidelity_domain;
+}
+
+MultiFidelityEvaluation::MultiFidelityEvaluation(const Domain* domain,
+                                                 unique_ptr<Domain> low_fidelity_domain,
+                                                 const MultiFidelityConfig& config)
+    : domain_(domain), low_fidelity_domain_(std::move(low_fidelity_domain)) {
+  CHECK(domain_ != nullptr);
+  CHECK(low_fidelity_domain_);
+  config_.copyFrom(config);
+
+  if (!domain_->independentEvaluation())
+    throw core::Exception("Multi-fidelity evaluation requires independent evaluations");
+  if (!(config_.low_fidelity > 0 && config_.low_fidelity <= 1))
+    throw core::Exception("Invalid multi-fidelity configuration: low_fidelity");
+  if (config_.calibration_samples < 3)
+    throw core::Exception("Invalid multi-fidelity configuration: calibration_samples");
+  if (!(config_.min_correlation >= -1 && config_.min_correlation <= 1))
+    throw core::Exception("Invalid multi-fidelity configuration: min_correlation");
+  if (!(config_.promote_fraction > 0 && config_.promote_fraction <= 1))
+    throw core::Exception("Invalid multi-fidelity configuration: promote_fraction");
+}
+
+bool MultiFidelityEvaluation::evaluatePopulation(Population* population) {
+  const size_t size = population->size();
+  full_evaluations_ = 0;
+
+  // the same test worlds for all the evaluation passes (see evaluationSeed())
+  EvaluationSeedScope seed_scope(evaluationSeed(uint64_t(population->generation())));
+
+  // low fidelity pre-screening (all the genotypes)
+  {
+    StageScope stage("Low fidelity screening");
+    low_fidelity_domain_->evaluatePopulation(population);
+  }
+
+  vector<double> low_fitness(size);
+  vector<size_t> low_ranking(size);
+  for (size_t i = 0; i < size; ++i) {
+    low_fitness[i] = population->genotype(i)->fitness;
+    low_ranking[i] = i;
+  }
+  std::stable_sort(low_ranking.begin(), low_ranking.end(), [&](size_t a, size_t b) {
+    return low_fitness[a] > low_fitness[b];
+  });
+
+  // the calibration sample, evenly spread over the low fidelity ranking
+  const size_t samples = min(size, size_t(config_.calibration_samples));
+  vector<size_t> calibration(samples);
+  vector<bool> full_fidelity(size, false);
+  for (size_t i = 0; i < samples; ++i) {
+    calibration[i] = low_ranking[i * size / samples];
+    full_fidelity[calibration[i]] = true;
+  }
+
+  bool goal_reached = evaluateFullFidelity(population, calibration);
+
+  vector<double> calibration_low(samples);
+  vector<double> calibration_full(samples);
+  for (size_t i = 0; i < samples; ++i) {
+    calibration_low[i] = low_fitness[calibration[i]];
+    calibration_full[i] = population->genotype(calibration[i])->fitness;
+  }
+
+  // Spearman's rank correlation
+  correlation_ = pearsonCorrelation(ranks(calibration_low), ranks(calibration_full));
+
+  fallback_ = correlation_ < config_.min_correlation;
+
+  // the low fidelity threshold for full fidelity evaluations
+  double threshold = -numeric_limits<double>::infinity();
+  if (!fallback_) {
+    vector<size_t> calibration_ranking(samples);
+    for (size_t i = 0; i < samples; ++i) {
+      calibration_ranking[i] = i;
+    }
+    std::stable_sort(calibration_ranking.begin(),
+                     calibration_ranking.end(),
+                     [&](size_t a, size_t b) {
+                       return calibration_full[a] > calibration_full[b];
+                     });
+    const double promoted_estimate = samples * double(config_.promote_fraction) - 1e-4;
+    const size_t promoted = max(size_t(1), size_t(ceil(promoted_estimate)));
+    threshold = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < promoted; ++i) {
+      threshold = min(threshold, calibration_low[calibration_ranking[i]]);
+    }
+  }
+
+  // full fidelity evaluation of the genotypes above the threshold
+  vector<size_t> promoted;
+  for (size_t i = 0; i < size; ++i) {
+    if (!full_fidelity[i] && low_fitness[i] >= threshold) {
+      promoted.push_back(i);
+      full_fidelity[i] = true;
+    }
+  }
+  goal_reached = evaluateFullFidelity(population, promoted) || goal_reached;
+
+  // estimate the full fidelity fitness of the genotypes below the threshold
+  if (full_evaluations_ < size) {
+    // linear fit of the full fidelity fitness over the calibration sample
+    double mean_low = 0;
+    double mean_full = 0;
+    for (size_t i = 0; i < samples; ++i) {
+      mean_low += calibration_low[i];
+      mean_full += calibration_full[i];
+    }
+    mean_low /= samples;
+    mean_full /= samples;
+    double cov = 0;
+    double var_low = 0;
+    for (size_t i = 0; i < samples; ++i) {
+      cov += (calibration_low[i] - mean_low) * (calibration_full[i] - mean_full);
+      var_low += (calibration_low[i] - mean_low) * (calibration_low[i] - mean_low);
+    }
+    const double slope = var_low > 0 ? cov / var_low : 0;
+
+    // never rank above the genotypes which passed the threshold
+    double bound = numeric_limits<double>::infinity();
+    for (size_t i = 0; i < size; ++i) {
+      if (full_fidelity[i] && low_fitness[i] >= threshold)
+        bound = min(bound, double(population->genotype(i)->fitness));
+    }
+
+    for (size_t i = 0; i < size; ++i) {
+      if (full_fidelity[i])
+        continue;
+      double estimate = mean_full + slope * (low_fitness[i] - mean_low);
+      if (!isfinite(estimate) || estimate > bound)
+        estimate = bound;
+      population->genotype(i)->fitness = float(estimate);
+    }
+  }
+
+  core::log("Multi-fidelity: rank correlation %.3f, %zu/%zu full evaluations%s\n",
+            correlation_,
+            full_evaluations_,
+            size,
+            fallback_ ? " (fallback)" : "");
+
+  return goal_reached;
+}
+
+bool MultiFidelityEvaluation::evaluateFullFidelity(Population* population,
+                                                   const vector<size_t>& indexes) {
+  if (indexes.empty())
+    return false;
+  StageScope stage("Full fidelity evaluation");
+  PopulationSubset subset(population, indexes);
+  full_evaluations_ += indexes.size();
+  return domain_->evaluatePopulation(&subset);
+}
+
+}  // namespace darwin
@@ -0,0 +1,141 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "darwin.h"
+#include "properties.h"
+#include "stringify.h"
+#include "utils.h"
+
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace darwin {
+
+//! Evaluation fidelity type
+enum class EvaluationFidelity {
+  Full,           //!< Every genotype is evaluated with the full domain fidelity
+  MultiFidelity,  //!< Low fidelity pre-screening, full fidelity for the top genotypes
+};
+
+inline auto customStringify(core::TypeTag<EvaluationFidelity>) {
+  static auto stringify = new core::StringifyKnownValues<EvaluationFidelity>{
+    { EvaluationFidelity::Full, "full" },
+    { EvaluationFidelity::MultiFidelity, "multi_fidelity" },
+  };
+  return stringify;
+}
+
+//! Full fidelity evaluation (no configuration)
+struct FullFidelityConfig : public core::PropertySet {};
+
+//! Multi-fidelity evaluation configuration
+struct MultiFidelityConfig : public core::PropertySet {
+  PROPERTY(low_fidelity,
+           float,
+           0.25f,
+           "The pre-screening fidelity (scales the domain's fidelity knobs)");
+
+  PROPERTY(calibration_samples,
+           int,
+           20,
+           "Number of genotypes evaluated with both fidelities, in every generation");
+
+  PROPERTY(min_correlation,
+           float,
+           0.5f,
+           "Full evaluation of all genotypes below this rank correlation");
+
+  PROPERTY(promote_fraction,
+           float,
+           0.3f,
+           "The top fraction of the calibration genotypes used to learn the threshold");
+};
+
+//! Evaluation fidelity configurations
+struct FidelityVariant : public core::PropertySetVariant<EvaluationFidelity> {
+  CASE(EvaluationFidelity::Full, full, FullFidelityConfig);
+  CASE(EvaluationFidelity::MultiFidelity, multi_fidelity, MultiFidelityConfig);
+};
+
+//! Creates a reduced fidelity instance of the experiment domain
+//!
+//! The domain's fidelity knobs (see Domain::fidelityKnobs()) are scaled by `fidelity`,
+//! without going below the knob's min value
+//!
+//! \throws core::Exception if the domain doesn't declare any fidelity knobs
+//!
+unique_ptr<Domain> createLowFidelityDomain(const Experiment* experiment,
+                                           const Domain* domain,
+                                           float fidelity);
+
+//! Multi-fidelity population evaluation, with low fidelity pre-screening
+//!
+//! Every generation:
+//! 1. All the genotypes are evaluated with the cheap, low fidelity domain
+//! 2. A calibration sample (evenly spread over the low fidelity ranking) is also
+//!    evaluated with full fidelity, measuring the rank correlation between the fidelities
+//! 3. If the correlation is too low, the rest of the population gets full fidelity
+//!    evaluations as well. Otherwise, the threshold is learned from the calibration: the
+//!    lowest low fidelity fitness of the top `promote_fraction` calibration genotypes
+//!    (ranked by their full fidelity fitness)
+//! 4. Only the genotypes above the threshold are promoted to full fidelity evaluations
+//!
+//! The genotypes below the threshold get an estimated fitness: a linear fit of the full
+//! fidelity fitness (over the calibration sample), capped so they never rank above
+//! the promoted genotypes.
+//!
+//! All the evaluations of a generation (both fidelities, the calibration sample and the
+//! promoted genotypes) use the same test worlds (see darwin::evaluationSeed()), so the
+//! fitness values are comparable across the evaluation passes.
+//!
+//! \note Only domains with independent evaluations are supported
+//!   (see Domain::independentEvaluation())
+//!
+class MultiFidelityEvaluation : public core::NonCopyable {
+ public:
+  //! Sets up the multi-fidelity evaluation
+  //! \throws core::Exception if the configuration is invalid
+  MultiFidelityEvaluation(const Domain* domain,
+                          unique_ptr<Domain> low_fidelity_domain,
+                          const MultiFidelityConfig& config);
+
+  //! Assigns fitness values to every genotype (see Domain::evaluatePopulation())
+  bool evaluatePopulation(Population* population);
+
+  //! The rank correlation between the fidelities, in the last evaluated generation
+  double correlation() const { return correlation_; }
+
+  //! The number of full fidelity evaluations in the last evaluated generation
+  size_t fullEvaluations() const { return full_evaluations_; }
+
+  //! True if the last generation fell back to full fidelity evaluations
+  bool fallback() const { return fallback_; }
+
+ private:
+  bool evaluateFullFidelity(Population* population, const vector<size_t>& indexes);
+
+ private:
+  const Domain* domain_ = nullptr;
+  unique_ptr<Domain> low_fidelity_domain_;
+  MultiFidelityConfig config_;
+
+  double correlation_ = 0;
+  size_t full_evaluations_ = 0;
+  bool fallback_ = false;
+};
+
+}  // namespace darwin
@@ -72,34 +72,27 @@ void for_each(T& array, const Body& loop_body) {
   constexpr int kShardsGranularity = 100;
 
   const int size = int(array.size());
-  const int shards_count = thread_pool->threadsCount() * kShardsGranularity;
+  const int shards_count = min(size, thread_pool->threadsCount() * kShardsGranularity);
   const int shard_size = size / shards_count;
   const int remainder = size % shards_count;
 
-  // create a batch for all the shards
-  auto batch = make_unique<WorkBatch>();
+  // the first `remainder` shards have an extra index
+  auto shard_body = [&](int shard) {
+    g_inside_parallel_for = true;
+    SCOPE_EXIT { g_inside_parallel_for = false; };
 
-  int index = 0;
-  for (int i = 0; i < shards_count && index < size; ++i) {
-    int actual_shard_size = i < remainder ? (shard_size + 1) : shard_size;
-    CHECK(actual_shard_size > 0);
-    batch->pushWork([&, beginIndex = index, endIndex = index + actual_shard_size] {
-      g_inside_parallel_for = true;
-      SCOPE_EXIT { g_inside_parallel_for = false; };
+    const int begin_index = shard * shard_size + min(shard, remainder);
+    const int end_index = begin_index + shard_size + (shard < remainder ? 1 : 0);
+    CHECK(begin_index < end_index && end_index <= size);
 
-      CHECK(beginIndex < endIndex);
+    for (int i = begin_index; i < end_index; ++i) {
+      loop_body(i, array[i]);
+    }
+  };
 
-      for (int i = beginIndex; i < endIndex; ++i) {
-        loop_body(i, array[i]);
-      }
-    });
-
-    index += actual_shard_size;
-  }
-  CHECK(index == size);
-
-  // push work and wait for completition
-  thread_pool->processBatch(std::move(batch));
+  // process all the shards (no allocations, the batch lives on the stack)
+  WorkBatch batch(shards_count, shard_body);
+  thread_pool->processBatch(&batch);
 }
 
 }  // namespace pp
@@ -0,0 +1,278 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "perf_counters.h"
+#include "logging.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+using namespace std;
+
+#ifdef DARWIN_OS_LINUX
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // DARWIN_OS_LINUX
+
+namespace core {
+
+PerfCountersValues& PerfCountersValues::operator+=(const PerfCountersValues& other) {
+  cycles += other.cycles;
+  instructions += other.instructions;
+  cache_misses += other.cache_misses;
+  branch_misses += other.branch_misses;
+  return *this;
+}
+
+PerfCountersValues PerfCountersValues::operator-(const PerfCountersValues& other) const {
+  auto delta = [](uint64_t a, uint64_t b) { return a > b ? a - b : 0; };
+  PerfCountersValues result;
+  result.cycles = delta(cycles, other.cycles);
+  result.instructions = delta(instructions, other.instructions);
+  result.cache_misses = delta(cache_misses, other.cache_misses);
+  result.branch_misses = delta(branch_misses, other.branch_misses);
+  return result;
+}
+
+void to_json(json& json_obj, const PerfCountersValues& values) {
+  json_obj["cycles"] = values.cycles;
+  json_obj["instructions"] = values.instructions;
+  json_obj["cache_misses"] = values.cache_misses;
+  json_obj["branch_misses"] = values.branch_misses;
+}
+
+#ifdef DARWIN_OS_LINUX
+
+namespace {
+
+// the order must match the PerfCountersValues fields
+constexpr int kCountersCount = 4;
+
+constexpr uint64_t kCounterConfigs[kCountersCount] = {
+  PERF_COUNT_HW_CPU_CYCLES,
+  PERF_COUNT_HW_INSTRUCTIONS,
+  PERF_COUNT_HW_CACHE_MISSES,
+  PERF_COUNT_HW_BRANCH_MISSES,
+};
+
+// the counters for one thread
+struct ThreadCounters {
+  pid_t tid = 0;
+
+  // the first counter (cycles) is the group leader
+  // (-1 if the counter is not available)
+  int fds[kCountersCount] = { -1, -1, -1, -1 };
+
+  // true if at least the group leader was opened
+  bool open(bool report_errors);
+  void close();
+  PerfCountersValues read() const;
+};
+
+struct CountersRegistry {
+  mutex lock;
+  vector<ThreadCounters> threads;
+  bool enabled = false;
+};
+
+CountersRegistry* countersRegistry() {
+  static auto registry = new CountersRegistry;
+  return registry;
+}
+
+int perfEventOpen(uint64_t config, pid_t tid, int group_fd) {
+  perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.disabled = (group_fd == -1) ? 1 : 0;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID |
+                     PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return int(syscall(__NR_perf_event_open, &attr, tid, -1, group_fd, 0));
+}
+
+bool ThreadCounters::open(bool report_errors) {
+  CHECK(fds[0] == -1);
+
+  fds[0] = perfEventOpen(kCounterConfigs[0], tid, -1);
+  if (fds[0] == -1) {
+    if (report_errors) {
+      core::log("Hardware performance counters are not available (%s)\n",
+                strerror(errno));
+    }
+    return false;
+  }
+
+  // the rest of the counters are optional
+  for (int i = 1; i < kCountersCount; ++i) {
+    fds[i] = perfEventOpen(kCounterConfigs[i], tid, fds[0]);
+  }
+
+  ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+  ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+  return true;
+}
+
+void ThreadCounters::close() {
+  // close the group members first
+  for (int i = kCountersCount - 1; i >= 0; --i) {
+    if (fds[i] != -1) {
+      ::close(fds[i]);
+      fds[i] = -1;
+    }
+  }
+}
+
+PerfCountersValues ThreadCounters::read() const {
+  PerfCountersValues values;
+  if (fds[0] == -1)
+    return values;
+
+  // PERF_FORMAT_GROUP layout:
+  //  nr, time_enabled, time_running, { value, id } x nr
+  uint64_t buffer[3 + 2 * kCountersCount] = {};
+  if (::read(fds[0], buffer, sizeof(buffer)) <= 0)
+    return values;
+
+  const uint64_t nr = buffer[0];
+  const uint64_t time_enabled = buffer[1];
+  const uint64_t time_running = buffer[2];
+  CHECK(nr <= kCountersCount);
+
+  // scale the values if the counters were multiplexed
+  const double scale = (time_running > 0 && time_running < time_enabled)
+                           ? double(time_enabled) / time_running
+                           : 1.0;
+
+  // map the values to the counters (the group may be missing some of the counters)
+  uint64_t counters[kCountersCount] = {};
+  int value_index = 0;
+  for (int i = 0; i < kCountersCount && value_index < int(nr); ++i) {
+    if (fds[i] != -1) {
+      counters[i] = uint64_t(buffer[3 + 2 * value_index] * scale);
+      ++value_index;
+    }
+  }
+
+  values.cycles = counters[0];
+  values.instructions = counters[1];
+  values.cache_misses = counters[2];
+  values.branch_misses = counters[3];
+  return values;
+}
+
+}  // namespace
+
+void PerfCounters::registerThread() {
+  auto registry = countersRegistry();
+  unique_lock<mutex> guard(registry->lock);
+
+  ThreadCounters thread_counters;
+  thread_counters.tid = pid_t(syscall(SYS_gettid));
+  if (registry->enabled)
+    thread_counters.open(false);
+  registry->threads.push_back(thread_counters);
+}
+
+void PerfCounters::unregisterThread() {
+  auto registry = countersRegistry();
+  unique_lock<mutex> guard(registry->lock);
+
+  const auto tid = pid_t(syscall(SYS_gettid));
+  auto& threads = registry->threads;
+  auto it = find_if(threads.begin(), threads.end(), [&](const ThreadCounters& counters) {
+    return counters.tid == tid;
+  });
+  CHECK(it != threads.end());
+  it->close();
+  threads.erase(it);
+}
+
+bool PerfCounters::enable() {
+  auto registry = countersRegistry();
+  unique_lock<mutex> guard(registry->lock);
+
+  if (registry->enabled)
+    return true;
+
+  for (auto& thread_counters : registry->threads) {
+    if (!thread_counters.open(true)) {
+      for (auto& opened_counters : registry->threads)
+        opened_counters.close();
+      return false;
+    }
+  }
+
+  registry->enabled = true;
+  return true;
+}
+
+void PerfCounters::disable() {
+  auto registry = countersRegistry();
+  unique_lock<mutex> guard(registry->lock);
+
+  for (auto& thread_counters : registry->threads)
+    thread_counters.close();
+
+  registry->enabled = false;
+}
+
+bool PerfCounters::enabled() {
+  auto registry = countersRegistry();
+  unique_lock<mutex> guard(registry->lock);
+  return registry->enabled;
+}
+
+PerfCountersValues PerfCounters::read() {
+  auto registry = countersRegistry();
+  unique_lock<mutex> guard(registry->lock);
+
+  PerfCountersValues values;
+  for (const auto& thread_counters : registry->threads)
+    values += thread_counters.read();
+  return values;
+}
+
+#else
+
+void PerfCounters::registerThread() {}
+
+void PerfCounters::unregisterThread() {}
+
+bool PerfCounters::enable() {
+  core::log("Hardware performance counters are not supported on this platform\n");
+  return false;
+}
+
+void PerfCounters::disable() {}
+
+bool PerfCounters::enabled() {
+  return false;
+}
+
+PerfCountersValues PerfCounters::read() {
+  return PerfCountersValues();
+}
+
+#endif  // DARWIN_OS_LINUX
+
+}  // namespace core
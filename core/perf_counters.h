@@ -0,0 +1,82 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <cstdint>
+using namespace std;
+
+namespace core {
+
+//! A set of hardware performance counters values
+struct PerfCountersValues {
+  //! CPU cycles
+  uint64_t cycles = 0;
+
+  //! Retired instructions
+  uint64_t instructions = 0;
+
+  //! Last level cache misses
+  uint64_t cache_misses = 0;
+
+  //! Mispredicted branches
+  uint64_t branch_misses = 0;
+
+  PerfCountersValues& operator+=(const PerfCountersValues& other);
+
+  //! The delta between two samples
+  //! \note The result is clamped to zero (multiplexed counters are scaled estimates)
+  PerfCountersValues operator-(const PerfCountersValues& other) const;
+
+  friend void to_json(json& json_obj, const PerfCountersValues& values);
+};
+
+//! Optional hardware performance counters, aggregated across multiple threads
+//!
+//! The threads which should be included in the measurements must be registered by
+//! calling registerThread() from each thread (ex. the pp::ThreadPool workers). Once
+//! enabled, read() returns the sum of the counters for all the registered threads.
+//!
+//! \note This is currently implemented only for Linux, using `perf_event_open()`.
+//!   The counters may also be unavailable if restricted by `perf_event_paranoid`, or
+//!   if the hardware (or the VM) doesn't expose a PMU. In all these cases enable()
+//!   returns `false` and read() returns zero values.
+//!
+class PerfCounters {
+ public:
+  //! Adds the current thread to the set of measured threads
+  static void registerThread();
+
+  //! Removes the current thread from the set of measured threads
+  //! (must be called before a registered thread exits)
+  static void unregisterThread();
+
+  //! Starts counting (for all the registered threads)
+  //! \returns `true` if the hardware counters are available
+  static bool enable();
+
+  //! Stops counting and releases the counters
+  static void disable();
+
+  //! Returns `true` if the counters are enabled
+  static bool enabled();
+
+  //! Reads the current values, aggregated across all the registered threads
+  static PerfCountersValues read();
+};
+
+}  // namespace core
@@ -16,12 +16,34 @@
 #include "utils.h"
 #include "exception.h"
 
+#include <stdio.h>
 #include <stdlib.h>
 
 #ifdef DARWIN_COMPILER_MSVC
 #include <intrin.h>
 #endif  // DARWIN_COMPILER_MSVC
 
+#ifdef DARWIN_OS_LINUX
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif  // DARWIN_OS_LINUX
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
 #include <filesystem>
 namespace fs = std::filesystem;
 
@@ -83,4 +105,196 @@ void setenv(const char* name, const char* value) {
 #endif
 }
 
+#ifdef DARWIN_OS_LINUX
+// parses a Linux CPU list (ex. "0-3,8-11")
+static vector<int> parseCpuList(const string& cpu_list) {
+  vector<int> cpus;
+  stringstream ss(cpu_list);
+  string range;
+  while (getline(ss, range, ',')) {
+    int first = -1;
+    int last = -1;
+    const int fields = sscanf(range.c_str(), "%d-%d", &first, &last);
+    if (fields == 1)
+      last = first;
+    else if (fields != 2 || first < 0 || last < first)
+      continue;
+    for (int cpu = first; cpu <= last; ++cpu)
+      cpus.push_back(cpu);
+  }
+  return cpus;
+}
+#endif  // DARWIN_OS_LINUX
+
+vector<vector<int>> numaNodes() {
+  vector<vector<int>> nodes;
+
+#ifdef DARWIN_OS_LINUX
+  const fs::path sysfs_nodes = "/sys/devices/system/node";
+  error_code error;
+  for (int node = 0;; ++node) {
+    const auto node_path = sysfs_nodes / ("node" + to_string(node));
+    if (!fs::is_directory(node_path, error))
+      break;
+    ifstream cpu_list_file(node_path / "cpulist");
+    string cpu_list;
+    getline(cpu_list_file, cpu_list);
+    auto cpus = parseCpuList(cpu_list);
+    // nodes without CPUs (ex. memory only) are not interesting here
+    if (!cpus.empty())
+      nodes.push_back(std::move(cpus));
+  }
+#endif  // DARWIN_OS_LINUX
+
+  if (nodes.empty()) {
+    const int cpus_count = max(1, int(thread::hardware_concurrency()));
+    nodes.emplace_back(cpus_count);
+    for (int cpu = 0; cpu < cpus_count; ++cpu)
+      nodes[0][cpu] = cpu;
+  }
+
+  return nodes;
+}
+
+bool setThreadAffinity(const vector<int>& cpus) {
+  CHECK(!cpus.empty());
+#ifdef DARWIN_OS_LINUX
+  cpu_set_t cpu_set;
+  CPU_ZERO(&cpu_set);
+  for (int cpu : cpus) {
+    CHECK(cpu >= 0 && cpu < CPU_SETSIZE);
+    CPU_SET(cpu, &cpu_set);
+  }
+  return pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set) == 0;
+#else
+  return false;
+#endif  // DARWIN_OS_LINUX
+}
+
+string currentExecutablePath() {
+#ifdef DARWIN_OS_LINUX
+  error_code error;
+  const auto path = fs::read_symlink("/proc/self/exe", error);
+  if (!error)
+    return path.string();
+#endif  // DARWIN_OS_LINUX
+  throw core::Exception("Can't locate the current executable");
+}
+
+ChildProcess spawnChildProcess(const string& executable, const vector<string>& args) {
+#ifdef DARWIN_OS_LINUX
+  int sockets[2] = {};
+  if (::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, sockets) != 0)
+    throw core::Exception("Can't create the socket pair: %s", strerror(errno));
+
+  // dup2() clears the close-on-exec flag, except when the source and the target
+  // are the same file descriptor
+  int child_socket = sockets[1];
+  if (child_socket == kChildProcessSocket) {
+    child_socket = ::fcntl(sockets[1], F_DUPFD_CLOEXEC, kChildProcessSocket + 1);
+    ::close(sockets[1]);
+    CHECK(child_socket >= 0);
+  }
+
+  posix_spawn_file_actions_t actions;
+  CHECK(::posix_spawn_file_actions_init(&actions) == 0);
+  CHECK(::posix_spawn_file_actions_adddup2(&actions, child_socket, kChildProcessSocket) ==
+        0);
+  CHECK(::posix_spawn_file_actions_addopen(
+            &actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0) == 0);
+
+  vector<char*> argv;
+  argv.push_back(const_cast<char*>(executable.c_str()));
+  for (const auto& arg : args)
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  pid_t pid = -1;
+  const int status =
+      ::posix_spawn(&pid, executable.c_str(), &actions, nullptr, argv.data(), environ);
+  ::posix_spawn_file_actions_destroy(&actions);
+  ::close(child_socket);
+
+  if (status != 0) {
+    ::close(sockets[0]);
+    throw core::Exception("Can't start '%s': %s", executable, strerror(status));
+  }
+
+  ChildProcess process;
+  process.pid = pid;
+  process.socket = sockets[0];
+  return process;
+#else
+  throw core::Exception("Child processes are not supported on this platform");
+#endif  // DARWIN_OS_LINUX
+}
+
+void killChildProcess(ChildProcess* process) {
+#ifdef DARWIN_OS_LINUX
+  if (process->socket >= 0)
+    ::close(process->socket);
+  if (process->pid > 0) {
+    ::kill(process->pid, SIGKILL);
+    while (::waitpid(process->pid, nullptr, 0) < 0 && errno == EINTR)
+      ;
+  }
+#endif  // DARWIN_OS_LINUX
+  *process = ChildProcess();
+}
+
+bool socketSend(int socket, const void* data, size_t size) {
+#ifdef DARWIN_OS_LINUX
+  auto ptr = static_cast<const char*>(data);
+  while (size > 0) {
+    const auto sent = ::send(socket, ptr, size, MSG_NOSIGNAL);
+    if (sent < 0 && errno == EINTR)
+      continue;
+    if (sent <= 0)
+      return false;
+    ptr += sent;
+    size -= sent;
+  }
+  return true;
+#else
+  return false;
+#endif  // DARWIN_OS_LINUX
+}
+
+bool socketReceive(int socket, void* data, size_t size) {
+#ifdef DARWIN_OS_LINUX
+  auto ptr = static_cast<char*>(data);
+  while (size > 0) {
+    const auto received = ::recv(socket, ptr, size, 0);
+    if (received < 0 && errno == EINTR)
+      continue;
+    if (received <= 0)
+      return false;
+    ptr += received;
+    size -= received;
+  }
+  return true;
+#else
+  return false;
+#endif  // DARWIN_OS_LINUX
+}
+
+vector<int> socketPoll(const vector<int>& sockets, int timeout_ms) {
+  vector<int> ready;
+#ifdef DARWIN_OS_LINUX
+  vector<pollfd> poll_fds(sockets.size());
+  for (size_t i = 0; i < sockets.size(); ++i) {
+    poll_fds[i].fd = sockets[i];
+    poll_fds[i].events = POLLIN;
+  }
+  const int count = ::poll(poll_fds.data(), poll_fds.size(), timeout_ms);
+  if (count < 0 && errno != EINTR)
+    throw core::Exception("Socket poll failed: %s", strerror(errno));
+  for (size_t i = 0; i < poll_fds.size() && count > 0; ++i) {
+    if (poll_fds[i].revents != 0)
+      ready.push_back(int(i));
+  }
+#endif  // DARWIN_OS_LINUX
+  return ready;
+}
+
 }  // namespace pal
@@ -17,6 +17,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 using namespace std;
 
 namespace pal {
@@ -30,4 +31,48 @@ bool detectAvx2();
 //! Sets an enviroment variable
 void setenv(const char* name, const char* value);
 
+//! Returns the logical CPUs of each NUMA node
+//! (a single node with all the CPUs, if the NUMA topology is not available)
+vector<vector<int>> numaNodes();
+
+//! Restricts the calling thread to the specified logical CPUs
+//! \returns false if the thread affinity is not supported
+bool setThreadAffinity(const vector<int>& cpus);
+
+//! The file descriptor of the socket passed to the child processes
+constexpr int kChildProcessSocket = 3;
+
+//! A child process, connected to the parent process through a local socket
+struct ChildProcess {
+  int pid = -1;
+  int socket = -1;
+};
+
+//! Returns the path of the current executable
+string currentExecutablePath();
+
+//! Starts a child process, connected through a local (Unix domain) socket pair
+//!
+//! The child process end of the socket is passed as file descriptor
+//! kChildProcessSocket, and the standard output of the child process is discarded.
+//!
+//! \throws core::Exception if the child process can't be started
+//!
+ChildProcess spawnChildProcess(const string& executable, const vector<string>& args);
+
+//! Kills the child process (waiting for it to exit) and closes its socket
+void killChildProcess(ChildProcess* process);
+
+//! Sends the full buffer
+//! \returns false if the socket is closed or the send fails
+bool socketSend(int socket, const void* data, size_t size);
+
+//! Receives exactly `size` bytes
+//! \returns false if the socket is closed or the receive fails
+bool socketReceive(int socket, void* data, size_t size);
+
+//! Waits for incoming data on any of the sockets (or until the timeout expires)
+//! \returns the indexes of the ready sockets (including the closed sockets)
+vector<int> socketPoll(const vector<int>& sockets, int timeout_ms);
+
 }  // namespace pal
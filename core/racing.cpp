@@ -0,0 +1,146 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "racing.h"
+#include "exception.h"
+
+#include <algorithm>
+#include <limits>
+#include <math.h>
+using namespace std;
+
+namespace darwin {
+
+RacingEvaluation::RacingEvaluation(Population* population,
+                                   int test_worlds,
+                                   const RacingVariant& racing)
+    : population_(population), test_worlds_(test_worlds), racing_type_(racing.tag()) {
+  CHECK(population_ != nullptr);
+  CHECK(test_worlds_ >= 0);
+
+  switch (racing_type_) {
+    case RacingType::None:
+      rung_worlds_ = test_worlds_;
+      keep_fraction_ = 1.0f;
+      break;
+
+    case RacingType::SuccessiveHalving: {
+      const auto& config = racing.successive_halving;
+      if (config.rung_worlds < 1)
+        throw core::Exception("Invalid racing configuration: rung_worlds < 1");
+      if (!(config.keep_fraction > 0 && config.keep_fraction <= 1))
+        throw core::Exception("Invalid racing configuration: keep_fraction");
+      rung_worlds_ = config.rung_worlds;
+      keep_fraction_ = config.keep_fraction;
+    } break;
+
+    default:
+      FATAL("Unexpected racing type");
+  }
+
+  const size_t size = population_->size();
+  records_.resize(size);
+  contenders_.resize(size);
+  for (size_t i = 0; i < size; ++i) {
+    contenders_[i] = i;
+  }
+}
+
+void RacingEvaluation::recordEpisode(size_t genotype_index, float episode_fitness) {
+  CHECK(genotype_index < records_.size());
+  auto& record = records_[genotype_index];
+  CHECK(record.eliminated_rung < 0);
+  record.fitness_sum += episode_fitness;
+  record.worst_episode =
+      record.episodes > 0 ? min(record.worst_episode, episode_fitness) : episode_fitness;
+  ++record.episodes;
+}
+
+void RacingEvaluation::finishWorld() {
+  ++finished_worlds_;
+  CHECK(finished_worlds_ <= test_worlds_);
+
+  for (size_t index : contenders_) {
+    CHECK(records_[index].episodes == finished_worlds_);
+  }
+
+  // end of a rung? (nothing to eliminate after the last test world)
+  if (racing_type_ == RacingType::None || finished_worlds_ % rung_worlds_ != 0 ||
+      finished_worlds_ == test_worlds_ || contenders_.size() < 2) {
+    return;
+  }
+
+  // rank the contenders (they have the same number of episodes)
+  std::stable_sort(contenders_.begin(), contenders_.end(), [&](size_t a, size_t b) {
+    return records_[a].fitness_sum > records_[b].fitness_sum;
+  });
+
+  const size_t count = contenders_.size();
+  // (the tolerance avoids rounding up because of the float representation,
+  //  ex. 20 * 0.3f is slightly above 6)
+  const double keep_estimate = count * double(keep_fraction_) - 1e-4;
+  const size_t keep = max(size_t(1), size_t(ceil(keep_estimate)));
+  for (size_t i = keep; i < count; ++i) {
+    records_[contenders_[i]].eliminated_rung = rungs_;
+  }
+  contenders_.resize(keep);
+  ++rungs_;
+
+  // keep the contenders in the population order
+  std::sort(contenders_.begin(), contenders_.end());
+}
+
+void RacingEvaluation::finish() {
+  // the worst episode in this evaluation
+  float worst_episode = 0;
+  bool any_episode = false;
+  for (const auto& record : records_) {
+    if (record.episodes > 0) {
+      worst_episode = any_episode ? min(worst_episode, record.worst_episode)
+                                  : record.worst_episode;
+      any_episode = true;
+    }
+  }
+
+  // the genotypes which completed the race
+  float bound = numeric_limits<float>::infinity();
+  for (size_t index : contenders_) {
+    const auto& record = records_[index];
+    const float fitness =
+        record.episodes > 0 ? float(record.fitness_sum / record.episodes) : 0.0f;
+    population_->genotype(index)->fitness = fitness;
+    bound = min(bound, fitness);
+  }
+
+  // the eliminated genotypes, from the last rung to the first one
+  for (int rung = rungs_ - 1; rung >= 0; --rung) {
+    float rung_bound = bound;
+    for (size_t index = 0; index < records_.size(); ++index) {
+      const auto& record = records_[index];
+      if (record.eliminated_rung != rung)
+        continue;
+      CHECK(record.episodes > 0 && record.episodes < test_worlds_);
+      const int remaining_episodes = test_worlds_ - record.episodes;
+      const double estimate =
+          (record.fitness_sum + double(remaining_episodes) * worst_episode) /
+          test_worlds_;
+      const float fitness = min(float(estimate), bound);
+      population_->genotype(index)->fitness = fitness;
+      rung_bound = min(rung_bound, fitness);
+    }
+    bound = rung_bound;
+  }
+}
+
+}  // namespace darwin
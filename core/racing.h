@@ -0,0 +1,135 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "darwin.h"
+#include "properties.h"
+#include "stringify.h"
+#include "utils.h"
+
+#include <vector>
+using namespace std;
+
+namespace darwin {
+
+//! Racing (early termination of the weakest genotypes) type
+enum class RacingType {
+  None,               //!< Every genotype is evaluated on all the test worlds
+  SuccessiveHalving,  //!< Only the top genotypes advance to the next rung of worlds
+};
+
+inline auto customStringify(core::TypeTag<RacingType>) {
+  static auto stringify = new core::StringifyKnownValues<RacingType>{
+    { RacingType::None, "none" },
+    { RacingType::SuccessiveHalving, "successive_halving" },
+  };
+  return stringify;
+}
+
+//! No racing: full evaluation
+struct NoRacingConfig : public core::PropertySet {};
+
+//! Successive halving configuration
+struct SuccessiveHalvingConfig : public core::PropertySet {
+  PROPERTY(rung_worlds,
+           int,
+           1,
+           "Number of test worlds per rung (the contenders are ranked after each rung)");
+
+  PROPERTY(keep_fraction,
+           float,
+           0.5f,
+           "The fraction of the genotypes which advance to the next rung");
+};
+
+//! Racing configurations
+struct RacingVariant : public core::PropertySetVariant<RacingType> {
+  CASE(RacingType::None, none, NoRacingConfig);
+  CASE(RacingType::SuccessiveHalving, successive_halving, SuccessiveHalvingConfig);
+};
+
+//! Evaluates a population over a series of test worlds, with optional racing
+//!
+//! With successive halving, the genotypes still in the race (the contenders) are ranked
+//! after every rung of test worlds, and only the top fraction of them is evaluated on the
+//! next rung. So the hopeless genotypes don't use the full evaluation budget.
+//!
+//! The genotypes which complete the race get their average episode fitness. The
+//! eliminated genotypes get a pessimistic estimate: their remaining episodes are assumed
+//! to be as bad as the worst episode recorded in this evaluation. The estimates are
+//! capped so the ranking follows the race: a genotype eliminated at a given rung never
+//! ranks above a genotype which advanced past it.
+//!
+//! ```cpp
+//! darwin::RacingEvaluation race(population, config.test_worlds, config.racing);
+//! for (int world_index = 0; world_index < config.test_worlds; ++world_index) {
+//!   ... setup the test world ...
+//!   pp::for_each(race.contenders(), [&](int, size_t genotype_index) {
+//!     ... evaluate population->genotype(genotype_index) ...
+//!     race.recordEpisode(genotype_index, episode_fitness);
+//!   });
+//!   race.finishWorld();
+//! }
+//! race.finish();
+//! ```
+//!
+class RacingEvaluation : public core::NonCopyable {
+ public:
+  //! Starts a new evaluation (all the genotypes are contenders)
+  //! \throws core::Exception if the racing configuration is invalid
+  RacingEvaluation(Population* population,
+                   int test_worlds,
+                   const RacingVariant& racing);
+
+  //! The indexes of the genotypes to be evaluated on the current test world
+  const vector<size_t>& contenders() const { return contenders_; }
+
+  //! Records the fitness of a genotype on the current test world
+  //!
+  //! \note Safe to call concurrently, for different genotypes
+  //!
+  void recordEpisode(size_t genotype_index, float episode_fitness);
+
+  //! Marks the end of the current test world
+  //! (at the end of a rung, the weakest contenders are eliminated)
+  void finishWorld();
+
+  //! Assigns the final fitness values to all the genotypes
+  void finish();
+
+ private:
+  struct GenotypeRecord {
+    double fitness_sum = 0;
+    float worst_episode = 0;
+    int episodes = 0;
+
+    // the rung where the genotype was eliminated (-1 if it's still in the race)
+    int eliminated_rung = -1;
+  };
+
+ private:
+  Population* population_ = nullptr;
+  const int test_worlds_ = 0;
+  const RacingType racing_type_;
+  int rung_worlds_ = 0;
+  float keep_fraction_ = 1.0f;
+
+  vector<size_t> contenders_;
+  vector<GenotypeRecord> records_;
+  int finished_worlds_ = 0;
+  int rungs_ = 0;
+};
+
+}  // namespace darwin
@@ -16,6 +16,9 @@
 
 #include <core/utils.h>
 
+#include <memory>
+using namespace std;
+
 namespace sim {
 
 constexpr float kPi = 3.14159274101f;
@@ -82,23 +85,26 @@ Camera::Camera(b2Body* body, float fov, float near, float far, int resolution)
   CHECK(far_ > near_);
 }
 
-Receptor Camera::castRay(const b2Vec2& ray_start,
-                         const b2Vec2& ray_end,
-                         float min_fraction) const {
-  const auto world = body_->GetWorld();
-  RayCastCallback raycast(min_fraction, filter_id_);
-  world->RayCast(&raycast, ray_start, ray_end);
+void Camera::setShadowAttenuation(float shadow_attenuation) {
+  CHECK(shadow_attenuation >= 0 && shadow_attenuation <= 1);
+  shadow_attenuation_ = shadow_attenuation;
+}
 
+template <class ShadowTest>
+Receptor Camera::shade(const Ray& ray,
+                       const RayHit& hit,
+                       const ShadowTest& shadow_test) const {
   // if no intersection, return the background color
-  if (raycast.fixture == nullptr) {
+  if (hit.fixture == nullptr) {
     return Receptor(b2Color(0, 0, 0), 1.0f);
   }
 
-  const b2Body* body = raycast.fixture->GetBody();
-  const b2Material& material = raycast.fixture->GetMaterial();
-  const b2Vec2 local_point = body->GetLocalPoint(raycast.point);
-  const b2Vec2 local_normal = body->GetLocalVector(raycast.normal);
-  const b2Vec2 V = body->GetLocalVector(ray_start - ray_end).Normalized();
+  const auto world = body_->GetWorld();
+  const b2Body* body = hit.fixture->GetBody();
+  const b2Material& material = hit.fixture->GetMaterial();
+  const b2Vec2 local_point = body->GetLocalPoint(hit.point);
+  const b2Vec2 local_normal = body->GetLocalVector(hit.normal);
+  const b2Vec2 V = body->GetLocalVector(ray.start - ray.end).Normalized();
 
   b2Color color = ambient_light_;
   b2Color specular_color;
@@ -110,7 +116,9 @@ Receptor Camera::castRay(const b2Vec2& ray_start,
   }
 
   // basic illumination (diffuse, specular), including shadows
-  for (auto light = world->GetLightList(); light != nullptr; light = light->GetNext()) {
+  int light_index = 0;
+  for (auto light = world->GetLightList(); light != nullptr;
+       light = light->GetNext(), ++light_index) {
     const auto& ldef = light->GetDef();
     assert(ldef.intensity >= 0);
 
@@ -124,12 +132,8 @@ Receptor Camera::castRay(const b2Vec2& ray_start,
 
     // shadow?
     assert(shadow_attenuation_ >= 0 && shadow_attenuation_ <= 1);
-    if (shadow_attenuation_ < 1) {
-      ShadowRayCastCallback shadow_raycast(raycast.fixture);
-      world->RayCast(&shadow_raycast, raycast.point, global_light_pos);
-      if (shadow_raycast.intersection) {
-        light_intensity *= shadow_attenuation_;
-      }
+    if (shadow_attenuation_ < 1 && shadow_test(global_light_pos, light_index)) {
+      light_intensity *= shadow_attenuation_;
     }
 
     // diffuse lighting
@@ -150,24 +154,92 @@ Receptor Camera::castRay(const b2Vec2& ray_start,
   color = color * material.color + specular_color;
 
   // distance-from-camera attenuation
-  color = color * (1 - raycast.fraction);
+  color = color * (1 - hit.fraction);
 
   // saturation
   color.r = fminf(color.r, 1.0f);
   color.g = fminf(color.g, 1.0f);
   color.b = fminf(color.b, 1.0f);
 
-  assert(raycast.fraction > 0 && raycast.fraction <= 1);
-  return Receptor(color, raycast.fraction);
+  assert(hit.fraction > 0 && hit.fraction <= 1);
+  return Receptor(color, hit.fraction);
+}
+
+void Camera::renderReference(const vector<Ray>& rays, vector<Receptor>& image) const {
+  const auto world = body_->GetWorld();
+  const float near_far_ratio = near_ / far_;
+
+  for (size_t i = 0; i < rays.size(); ++i) {
+    RayCastCallback raycast(near_far_ratio, filter_id_);
+    world->RayCast(&raycast, rays[i].start, rays[i].end);
+
+    RayHit hit;
+    hit.fixture = raycast.fixture;
+    hit.point = raycast.point;
+    hit.normal = raycast.normal;
+    hit.fraction = raycast.fraction;
+
+    auto shadow_test = [&](const b2Vec2& light_pos, int /*light_index*/) {
+      ShadowRayCastCallback shadow_raycast(raycast.fixture);
+      world->RayCast(&shadow_raycast, raycast.point, light_pos);
+      return shadow_raycast.intersection;
+    };
+
+    image[i] = shade(rays[i], hit, shadow_test);
+  }
+}
+
+void Camera::renderBatched(const vector<Ray>& rays, vector<Receptor>& image) const {
+  const auto world = body_->GetWorld();
+  const float near_far_ratio = near_ / far_;
+
+  // the world geometry snapshot (so render() doesn't mutate the camera state)
+  RayCaster ray_caster;
+  ray_caster.update(world);
+
+  vector<RayHit> hits(rays.size());
+  ray_caster.castRays(
+      rays.data(), int(rays.size()), near_far_ratio, filter_id_, hits.data());
+
+  // batch all the shadow rays (one for each hit, for each light)
+  vector<Ray> shadow_rays;
+  vector<int> shadow_exclude;
+  vector<int> first_shadow_ray(rays.size(), 0);
+  if (shadow_attenuation_ < 1) {
+    vector<b2Vec2> lights;
+    for (auto light = world->GetLightList(); light != nullptr; light = light->GetNext()) {
+      const auto& ldef = light->GetDef();
+      lights.push_back(ldef.body->GetWorldPoint(ldef.position));
+    }
+    for (size_t i = 0; i < hits.size(); ++i) {
+      first_shadow_ray[i] = int(shadow_rays.size());
+      if (hits[i].fixture != nullptr) {
+        for (const auto& light_pos : lights) {
+          shadow_rays.push_back({ hits[i].point, light_pos });
+          shadow_exclude.push_back(hits[i].fixture_index);
+        }
+      }
+    }
+  }
+
+  unique_ptr<bool[]> occluded(new bool[shadow_rays.size() + 1]);
+  ray_caster.testOcclusion(
+      shadow_rays.data(), shadow_exclude.data(), int(shadow_rays.size()), occluded.get());
+
+  for (size_t i = 0; i < rays.size(); ++i) {
+    auto shadow_test = [&](const b2Vec2& /*light_pos*/, int light_index) {
+      return occluded[first_shadow_ray[i] + light_index];
+    };
+    image[i] = shade(rays[i], hits[i], shadow_test);
+  }
 }
 
 vector<Receptor> Camera::render() const {
-  vector<Receptor> image(resolution_);
+  vector<Ray> rays(resolution_);
 
   const b2Vec2 ray_start = body_->GetWorldPoint(position_);
 
   const float far_near_ratio = far_ / near_;
-  const float near_far_ratio = near_ / far_;
 
   const float fov_radians = fov_ * kDegreesToRadians;
   const float slice_angle = fov_radians / (resolution_ - 1);
@@ -177,11 +249,17 @@ vector<Receptor> Camera::render() const {
     const float near_y = cosf(ray_angle) * near_;
     const float far_x = near_x * far_near_ratio;
     const float far_y = near_y * far_near_ratio;
-    const b2Vec2 ray_end = body_->GetWorldPoint(b2Vec2(far_x, far_y));
-    image[i] = castRay(ray_start, ray_end, near_far_ratio);
+    rays[i].start = ray_start;
+    rays[i].end = body_->GetWorldPoint(b2Vec2(far_x, far_y));
     ray_angle += slice_angle;
   }
 
+  vector<Receptor> image(resolution_);
+  if (batched_raycasting_) {
+    renderBatched(rays, image);
+  } else {
+    renderReference(rays, image);
+  }
   return image;
 }
 
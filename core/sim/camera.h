@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "ray_caster.h"
+
 #include <third_party/box2d/box2d.h>
 
 #include <vector>
@@ -47,6 +49,16 @@ class Camera {
   
   void setFilterId(const void* filter_id) { filter_id_ = filter_id; }
 
+  //! Sets the shadow attenuation factor (1 disables the shadow rays)
+  void setShadowAttenuation(float shadow_attenuation);
+
+  //! Selects between the reference implementation (one b2World::RayCast() per ray,
+  //! the default) and the batched ray casting (sim::RayCaster)
+  //!
+  //! \note The batched ray casting results may differ slightly (rounding)
+  void setBatchedRaycasting(bool enabled) { batched_raycasting_ = enabled; }
+  bool batchedRaycasting() const { return batched_raycasting_; }
+
   b2Body* body() const { return body_; }
 
   float fov() const { return fov_; }
@@ -55,9 +67,11 @@ class Camera {
   int resolution() const { return resolution_; }
 
  private:
-  Receptor castRay(const b2Vec2& ray_start,
-                   const b2Vec2& ray_end,
-                   float min_fraction) const;
+  void renderReference(const vector<Ray>& rays, vector<Receptor>& image) const;
+  void renderBatched(const vector<Ray>& rays, vector<Receptor>& image) const;
+
+  template <class ShadowTest>
+  Receptor shade(const Ray& ray, const RayHit& hit, const ShadowTest& shadow_test) const;
 
  private:
   b2Body* body_ = nullptr;
@@ -86,6 +100,8 @@ class Camera {
   // optionally filter all the fixture with a particular filter ID
   // (currently stored in fixture's user data - hack alert)
   const void* filter_id_ = nullptr;
+
+  bool batched_raycasting_ = false;
 };
 
 }  // namespace sim
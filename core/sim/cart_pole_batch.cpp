@@ -0,0 +1,291 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "cart_pole_batch.h"
+
+#include <core/platform_abstraction_layer.h>
+#include <core/utils.h>
+
+#include <math.h>
+
+#include <algorithm>
+using namespace std;
+
+#ifndef DARWIN_OS_WASM
+#include <immintrin.h>
+#endif
+
+namespace sim {
+
+void CartPoleModel::setCartBox(float width, float height, float density) {
+  CHECK(width > 0 && height > 0);
+  CHECK(density >= 0);
+  cart_mass = density > 0 ? width * height * density : 1.0f;
+}
+
+void CartPoleModel::addPoleBox(float width, float length, float density) {
+  CHECK(width > 0 && length > 0);
+  CHECK(density > 0);
+  Pole pole;
+  pole.mass = width * length * density;
+  pole.com_distance = length / 2;
+  const float com_inertia = pole.mass * (width * width + length * length) / 12;
+  pole.hinge_inertia = com_inertia + pole.mass * pole.com_distance * pole.com_distance;
+  poles.push_back(pole);
+}
+
+// The sin/cos approximation (Cephes sinf/cosf: range reduction to [-pi/4, pi/4]
+// and minimax polynomials) is shared by the scalar and the AVX2 kernels, so the
+// results are consistent regardless of the kernel selection (or the lane of a cart).
+// The error is within a few ULPs as long as the angles are not huge (|x| < 8192)
+struct CartPoleKernels {
+  static constexpr float kTwoOverPi = 0.636619772367581343f;
+  static constexpr float kPiOver2_1 = 1.5703125f;
+  static constexpr float kPiOver2_2 = 4.837512969970703125e-4f;
+  static constexpr float kPiOver2_3 = 7.54978995489188216e-8f;
+
+  static constexpr float kSin1 = -1.6666654611e-1f;
+  static constexpr float kSin2 = 8.3321608736e-3f;
+  static constexpr float kSin3 = -1.9515295891e-4f;
+
+  static constexpr float kCos1 = 4.166664568298827e-2f;
+  static constexpr float kCos2 = -1.388731625493765e-3f;
+  static constexpr float kCos3 = 2.443315711809948e-5f;
+
+  static void sinCos(float x, float* sin_x, float* cos_x) {
+    const float q = nearbyintf(x * kTwoOverPi);
+    const float r = ((x - q * kPiOver2_1) - q * kPiOver2_2) - q * kPiOver2_3;
+    const float r2 = r * r;
+    const float s = r + r * r2 * (kSin1 + r2 * (kSin2 + r2 * kSin3));
+    const float c = 1 - 0.5f * r2 + r2 * r2 * (kCos1 + r2 * (kCos2 + r2 * kCos3));
+    switch (int(q) & 3) {
+      case 0:
+        *sin_x = s;
+        *cos_x = c;
+        break;
+      case 1:
+        *sin_x = c;
+        *cos_x = -s;
+        break;
+      case 2:
+        *sin_x = -s;
+        *cos_x = -c;
+        break;
+      default:
+        *sin_x = -c;
+        *cos_x = s;
+        break;
+    }
+  }
+
+  // advances the carts in the [begin, end) range
+  static void step_cpu(CartPoleBatch* batch, int begin, int end, float dt) {
+    const int poles_count = batch->polesCount();
+    const int stride = batch->stride_;
+    const float g = batch->gravity_;
+
+    for (int i = begin; i < end; ++i) {
+      float sin_angle[CartPoleBatch::kMaxPoles];
+      float cos_angle[CartPoleBatch::kMaxPoles];
+
+      // cart acceleration
+      float num = batch->force_[i];
+      float den = batch->total_mass_;
+      for (int p = 0; p < poles_count; ++p) {
+        const auto& pole = batch->poles_[p];
+        const float omega = batch->omega_[p * stride + i];
+        sinCos(batch->angle_[p * stride + i], &sin_angle[p], &cos_angle[p]);
+        const float s = sin_angle[p];
+        const float c = cos_angle[p];
+        num += pole.ml * s * (g * c * pole.k - omega * omega);
+        den -= pole.ml * pole.k * c * c;
+      }
+      const float cart_acc = num / den;
+
+      // semi-implicit Euler: velocities first, then the positions
+      for (int p = 0; p < poles_count; ++p) {
+        const auto& pole = batch->poles_[p];
+        const float s = sin_angle[p];
+        const float c = cos_angle[p];
+        const float pole_acc = pole.k * (c * cart_acc + g * s);
+        const float omega = batch->omega_[p * stride + i] + dt * pole_acc;
+        batch->omega_[p * stride + i] = omega;
+        batch->angle_[p * stride + i] += dt * omega;
+      }
+      const float v = batch->v_[i] + dt * cart_acc;
+      batch->v_[i] = v;
+      batch->x_[i] += dt * v;
+    }
+  }
+
+#ifndef DARWIN_OS_WASM
+
+  static void sinCosAvx(__m256 x, __m256* sin_x, __m256* cos_x) {
+    const __m256 q = _mm256_round_ps(_mm256_mul_ps(x, _mm256_set1_ps(kTwoOverPi)),
+                                     _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256 r = _mm256_sub_ps(x, _mm256_mul_ps(q, _mm256_set1_ps(kPiOver2_1)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(kPiOver2_2)));
+    r = _mm256_sub_ps(r, _mm256_mul_ps(q, _mm256_set1_ps(kPiOver2_3)));
+    const __m256 r2 = _mm256_mul_ps(r, r);
+
+    __m256 s = _mm256_mul_ps(r2, _mm256_set1_ps(kSin3));
+    s = _mm256_mul_ps(r2, _mm256_add_ps(_mm256_set1_ps(kSin2), s));
+    s = _mm256_add_ps(_mm256_set1_ps(kSin1), s);
+    s = _mm256_add_ps(r, _mm256_mul_ps(_mm256_mul_ps(r, r2), s));
+
+    __m256 c = _mm256_mul_ps(r2, _mm256_set1_ps(kCos3));
+    c = _mm256_mul_ps(r2, _mm256_add_ps(_mm256_set1_ps(kCos2), c));
+    c = _mm256_add_ps(_mm256_set1_ps(kCos1), c);
+    c = _mm256_mul_ps(_mm256_mul_ps(r2, r2), c);
+    const __m256 half_r2 = _mm256_mul_ps(_mm256_set1_ps(0.5f), r2);
+    c = _mm256_add_ps(_mm256_sub_ps(_mm256_set1_ps(1), half_r2), c);
+
+    // quadrant selection
+    const __m256i quadrant =
+        _mm256_and_si256(_mm256_cvtps_epi32(q), _mm256_set1_epi32(3));
+    const __m256 swap = _mm256_castsi256_ps(
+        _mm256_cmpeq_epi32(_mm256_and_si256(quadrant, _mm256_set1_epi32(1)),
+                           _mm256_set1_epi32(1)));
+    const __m256 sin_negate = _mm256_castsi256_ps(
+        _mm256_slli_epi32(_mm256_srli_epi32(quadrant, 1), 31));
+    const __m256 cos_negate = _mm256_castsi256_ps(_mm256_slli_epi32(
+        _mm256_srli_epi32(_mm256_add_epi32(quadrant, _mm256_set1_epi32(1)), 1), 31));
+    *sin_x = _mm256_xor_ps(_mm256_blendv_ps(s, c, swap), sin_negate);
+    *cos_x = _mm256_xor_ps(_mm256_blendv_ps(c, s, swap), cos_negate);
+  }
+
+  // advances kLanes carts, starting with `begin`
+  static void step_avx(CartPoleBatch* batch, int begin, float dt) {
+    const int poles_count = batch->polesCount();
+    const int stride = batch->stride_;
+    const __m256 g = _mm256_set1_ps(batch->gravity_);
+    const __m256 dt_v = _mm256_set1_ps(dt);
+
+    __m256 sin_angle[CartPoleBatch::kMaxPoles];
+    __m256 cos_angle[CartPoleBatch::kMaxPoles];
+
+    // cart acceleration
+    __m256 num = _mm256_loadu_ps(&batch->force_[begin]);
+    __m256 den = _mm256_set1_ps(batch->total_mass_);
+    for (int p = 0; p < poles_count; ++p) {
+      const auto& pole = batch->poles_[p];
+      const __m256 ml = _mm256_set1_ps(pole.ml);
+      const __m256 k = _mm256_set1_ps(pole.k);
+      const __m256 omega = _mm256_loadu_ps(&batch->omega_[p * stride + begin]);
+      sinCosAvx(_mm256_loadu_ps(&batch->angle_[p * stride + begin]),
+                &sin_angle[p],
+                &cos_angle[p]);
+      const __m256 s = sin_angle[p];
+      const __m256 c = cos_angle[p];
+      const __m256 gck = _mm256_mul_ps(_mm256_mul_ps(g, c), k);
+      const __m256 t = _mm256_sub_ps(gck, _mm256_mul_ps(omega, omega));
+      num = _mm256_add_ps(num, _mm256_mul_ps(_mm256_mul_ps(ml, s), t));
+      const __m256 mlkc = _mm256_mul_ps(_mm256_mul_ps(ml, k), c);
+      den = _mm256_sub_ps(den, _mm256_mul_ps(mlkc, c));
+    }
+    const __m256 cart_acc = _mm256_div_ps(num, den);
+
+    // semi-implicit Euler: velocities first, then the positions
+    for (int p = 0; p < poles_count; ++p) {
+      const auto& pole = batch->poles_[p];
+      const __m256 k = _mm256_set1_ps(pole.k);
+      const __m256 s = sin_angle[p];
+      const __m256 c = cos_angle[p];
+      const __m256 pole_acc = _mm256_mul_ps(
+          k, _mm256_add_ps(_mm256_mul_ps(c, cart_acc), _mm256_mul_ps(g, s)));
+      float* omega_ptr = &batch->omega_[p * stride + begin];
+      float* angle_ptr = &batch->angle_[p * stride + begin];
+      const __m256 omega =
+          _mm256_add_ps(_mm256_loadu_ps(omega_ptr), _mm256_mul_ps(dt_v, pole_acc));
+      _mm256_storeu_ps(omega_ptr, omega);
+      const __m256 angle =
+          _mm256_add_ps(_mm256_loadu_ps(angle_ptr), _mm256_mul_ps(dt_v, omega));
+      _mm256_storeu_ps(angle_ptr, angle);
+    }
+    const __m256 v = _mm256_add_ps(_mm256_loadu_ps(&batch->v_[begin]),
+                                   _mm256_mul_ps(dt_v, cart_acc));
+    _mm256_storeu_ps(&batch->v_[begin], v);
+    const __m256 x =
+        _mm256_add_ps(_mm256_loadu_ps(&batch->x_[begin]), _mm256_mul_ps(dt_v, v));
+    _mm256_storeu_ps(&batch->x_[begin], x);
+  }
+
+#endif  // DARWIN_OS_WASM
+
+  static bool useAvx2() {
+#ifdef DARWIN_OS_WASM
+    return false;
+#else
+    static const bool avx2 = pal::detectAvx2();
+    return avx2;
+#endif
+  }
+
+  static void step(CartPoleBatch* batch, float dt) {
+    int begin = 0;
+#ifndef DARWIN_OS_WASM
+    if (useAvx2()) {
+      constexpr int kLanes = CartPoleBatch::kLanes;
+      for (; begin + kLanes <= batch->size(); begin += kLanes) {
+        step_avx(batch, begin, dt);
+      }
+    }
+#endif
+    step_cpu(batch, begin, batch->size(), dt);
+  }
+};
+
+CartPoleBatch::CartPoleBatch(const CartPoleModel& model, int size)
+    : size_(size), stride_((size + kLanes - 1) / kLanes * kLanes) {
+  CHECK(size > 0);
+  CHECK(model.cart_mass > 0);
+  CHECK(!model.poles.empty() && int(model.poles.size()) <= kMaxPoles);
+
+  gravity_ = model.gravity;
+  total_mass_ = model.cart_mass;
+  for (const auto& pole : model.poles) {
+    CHECK(pole.mass > 0);
+    CHECK(pole.hinge_inertia > 0);
+    total_mass_ += pole.mass;
+    PoleTerms terms;
+    terms.ml = pole.mass * pole.com_distance;
+    terms.k = terms.ml / pole.hinge_inertia;
+    poles_.push_back(terms);
+  }
+
+  x_.resize(stride_, 0);
+  v_.resize(stride_, 0);
+  force_.resize(stride_, 0);
+  angle_.resize(poles_.size() * stride_, 0);
+  omega_.resize(poles_.size() * stride_, 0);
+}
+
+void CartPoleBatch::reset(int index, const vector<float>& pole_angles) {
+  CHECK(index >= 0 && index < size_);
+  CHECK(pole_angles.size() == poles_.size());
+  x_[index] = 0;
+  v_[index] = 0;
+  force_[index] = 0;
+  for (size_t p = 0; p < poles_.size(); ++p) {
+    angle_[p * stride_ + index] = pole_angles[p];
+    omega_[p * stride_ + index] = 0;
+  }
+}
+
+void CartPoleBatch::step(float time_step) {
+  CartPoleKernels::step(this, time_step);
+  std::fill(force_.begin(), force_.end(), 0.0f);
+}
+
+}  // namespace sim
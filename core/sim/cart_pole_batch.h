@@ -0,0 +1,140 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <core/stringify.h>
+
+#include <vector>
+using namespace std;
+
+namespace sim {
+
+//! The physics engine used by the cart-pole domains
+enum class CartPolePhysics {
+  Box2D,     //!< Box2D rigid body simulation
+  Analytic,  //!< Analytic equations of motion (sim::CartPoleBatch)
+};
+
+inline auto customStringify(core::TypeTag<CartPolePhysics>) {
+  static auto stringify = new core::StringifyKnownValues<CartPolePhysics>{
+    { CartPolePhysics::Box2D, "box2d" },
+    { CartPolePhysics::Analytic, "analytic" },
+  };
+  return stringify;
+}
+
+//! The physical parameters of a cart with one or more poles
+struct CartPoleModel {
+  struct Pole {
+    float mass = 0;
+
+    //! Distance from the hinge to the pole center of mass
+    float com_distance = 0;
+
+    //! Rotational inertia around the hinge
+    float hinge_inertia = 0;
+  };
+
+  float gravity = 0;
+  float cart_mass = 0;
+  vector<Pole> poles;
+
+  //! Sets the cart mass from the Box2D fixture dimensions and density
+  //! (Box2D dynamic bodies with zero density have a default mass of 1)
+  void setCartBox(float width, float height, float density);
+
+  //! Adds a pole, from the dimensions and density of the Box2D fixture
+  void addPoleBox(float width, float length, float density);
+};
+
+//! Analytic dynamics for a batch of independent carts, each with one or more poles
+//!
+//! The cart moves horizontally, without friction, and the poles are hinged
+//! at the cart center (independently, so the poles only interact through the cart).
+//! With `x` the cart position, `θi` the pole angles (counter-clockwise from vertical,
+//! matching the Box2D angles), `mi` the pole masses, `li` the distances to the
+//! poles center of mass and `Ji` the poles inertia around the hinge:
+//!
+//! ```
+//! (M + Σmi)·x'' - Σ mi·li·(cos(θi)·θi'' - sin(θi)·θi'²) = F
+//! Ji·θi'' - mi·li·(cos(θi)·x'' + g·sin(θi)) = 0
+//! ```
+//!
+//! The equations are integrated using semi-implicit Euler, which is also the Box2D
+//! integration scheme. At 50Hz, and as long as the poles are balanced, the cart
+//! positions and the pole angles track the equivalent Box2D worlds within 1e-3
+//! (the differences grow as the poles fall, reaching ~1e-2 for the angles of
+//! short, fast falling poles).
+//!
+//! The state is stored as SoA (one array per state variable), so all the carts are
+//! advanced together (in groups of kLanes carts, using AVX2 if available).
+//!
+class CartPoleBatch {
+ public:
+  static constexpr int kLanes = 8;
+  static constexpr int kMaxPoles = 4;
+
+  CartPoleBatch(const CartPoleModel& model, int size);
+
+  //! Puts a cart back to the center, at rest, with the specified pole angles (radians)
+  void reset(int index, const vector<float>& pole_angles);
+
+  //! Sets the horizontal force applied to the cart during the next step()
+  void setForce(int index, float force) { force_[index] = force; }
+
+  //! Advances all the carts one time step (then clears the forces)
+  void step(float time_step);
+
+  int size() const { return size_; }
+  int polesCount() const { return int(poles_.size()); }
+
+  float cartPosition(int index) const { return x_[index]; }
+  float cartVelocity(int index) const { return v_[index]; }
+
+  float poleAngle(int index, int pole) const { return angle_[pole * stride_ + index]; }
+
+  float poleAngularVelocity(int index, int pole) const {
+    return omega_[pole * stride_ + index];
+  }
+
+ private:
+  friend struct CartPoleKernels;
+
+  // the per-pole constants used by the equations of motion
+  struct PoleTerms {
+    float ml = 0;  // mi·li
+    float k = 0;   // mi·li / Ji
+  };
+
+ private:
+  const int size_;
+
+  // the size rounded up to a multiple of kLanes
+  const int stride_;
+
+  float gravity_ = 0;
+  float total_mass_ = 0;
+  vector<PoleTerms> poles_;
+
+  vector<float> x_;
+  vector<float> v_;
+  vector<float> force_;
+
+  // [pole * stride_ + index]
+  vector<float> angle_;
+  vector<float> omega_;
+};
+
+}  // namespace sim
@@ -0,0 +1,905 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "ray_caster.h"
+
+#include <core/platform_abstraction_layer.h>
+#include <core/utils.h>
+
+#include <assert.h>
+#include <math.h>
+
+#include <algorithm>
+using namespace std;
+
+#ifndef DARWIN_OS_WASM
+#include <immintrin.h>
+#endif
+
+namespace sim {
+
+// The intersection tests mirror the b2Shape::RayCast() implementations
+// (b2CircleShape, b2PolygonShape and b2EdgeShape), including the order of the
+// floating point operations. The traversal mirrors b2World::RayCast(), with a
+// callback which clips the ray to the closest accepted intersection.
+//
+// The queries are used through a static interface:
+//
+//  bool skip(int fixture) : filter out a fixture (for all the rays in the batch)
+//  maxFraction()          : the current ray clipping fraction
+//  bool report(...)       : an intersection (returns true to stop the traversal)
+//
+struct RayCasterKernels {
+  using RayBatch = RayCaster::RayBatch;
+  using HitBatch = RayCaster::HitBatch;
+
+  // the closest intersection for a single ray
+  struct ClosestQuery {
+    const float min_fraction;
+    const void* const filter_id;
+    const vector<const void*>& user_data;
+
+    float fraction = 1;
+    int type = RayCaster::kNone;
+    int index = 0;
+    int detail = 0;
+
+    ClosestQuery(float min_fraction,
+                 const void* filter_id,
+                 const vector<const void*>& user_data)
+        : min_fraction(min_fraction), filter_id(filter_id), user_data(user_data) {}
+
+    bool skip(int fixture) const {
+      return filter_id != nullptr && user_data[fixture] == filter_id;
+    }
+
+    float maxFraction() const { return fraction; }
+
+    bool report(int type, int index, int detail, int /*fixture*/, float fraction) {
+      if (fraction >= min_fraction) {
+        this->fraction = fraction;
+        this->type = type;
+        this->index = index;
+        this->detail = detail;
+      }
+      return false;
+    }
+  };
+
+  // any intersection for a single ray
+  struct OcclusionQuery {
+    const int exclude;
+    bool occluded = false;
+
+    explicit OcclusionQuery(int exclude) : exclude(exclude) {}
+
+    bool skip(int fixture) const { return fixture == exclude; }
+
+    float maxFraction() const { return 1; }
+
+    bool report(int /*type*/, int /*index*/, int /*detail*/, int /*fixture*/, float) {
+      occluded = true;
+      return true;
+    }
+  };
+
+  // b2CircleShape::RayCast() (the circle position is in world coordinates)
+  static bool circleTest(const RayCaster::Circles& circles,
+                         int index,
+                         float x1,
+                         float y1,
+                         float x2,
+                         float y2,
+                         float max_fraction,
+                         float* fraction) {
+    const float sx = x1 - circles.x[index];
+    const float sy = y1 - circles.y[index];
+    const float radius = circles.radius[index];
+    const float b = sx * sx + sy * sy - radius * radius;
+
+    const float rx = x2 - x1;
+    const float ry = y2 - y1;
+    const float c = sx * rx + sy * ry;
+    const float rr = rx * rx + ry * ry;
+    const float sigma = c * c - rr * b;
+
+    if (sigma < 0 || rr < b2_epsilon)
+      return false;
+
+    const float a = -(c + sqrtf(sigma));
+    if (0 <= a && a <= max_fraction * rr) {
+      *fraction = a / rr;
+      return true;
+    }
+    return false;
+  }
+
+  // b2PolygonShape::RayCast() (the ray is in body coordinates)
+  static bool polygonTest(const RayCaster::Polygons& polygons,
+                          int index,
+                          float x1,
+                          float y1,
+                          float dx,
+                          float dy,
+                          float max_fraction,
+                          float* fraction,
+                          int* side) {
+    float lower = 0;
+    float upper = max_fraction;
+    int lower_side = -1;
+
+    const int first_side = polygons.first_side[index];
+    const int last_side = first_side + polygons.sides_count[index];
+    for (int i = first_side; i < last_side; ++i) {
+      const float nx = polygons.nx[i];
+      const float ny = polygons.ny[i];
+      const float numerator = nx * (polygons.vx[i] - x1) + ny * (polygons.vy[i] - y1);
+      const float denominator = nx * dx + ny * dy;
+      if (denominator == 0) {
+        if (numerator < 0)
+          return false;
+      } else if (denominator < 0 && numerator < lower * denominator) {
+        lower = numerator / denominator;
+        lower_side = i;
+      } else if (denominator > 0 && numerator < upper * denominator) {
+        upper = numerator / denominator;
+      }
+      if (upper < lower)
+        return false;
+    }
+
+    if (lower_side >= 0) {
+      *fraction = lower;
+      *side = lower_side;
+      return true;
+    }
+    return false;
+  }
+
+  // b2EdgeShape::RayCast() (the ray is in body coordinates)
+  static bool edgeTest(const RayCaster::Edges& edges,
+                       int index,
+                       float x1,
+                       float y1,
+                       float dx,
+                       float dy,
+                       float max_fraction,
+                       float* fraction,
+                       int* flip) {
+    const float nx = edges.nx[index];
+    const float ny = edges.ny[index];
+    const float v1x = edges.x1[index];
+    const float v1y = edges.y1[index];
+    const float numerator = nx * (v1x - x1) + ny * (v1y - y1);
+    const float denominator = nx * dx + ny * dy;
+    if (denominator == 0)
+      return false;
+
+    const float t = numerator / denominator;
+    if (t < 0 || max_fraction < t)
+      return false;
+
+    const float qx = x1 + t * dx;
+    const float qy = y1 + t * dy;
+    const float rx = edges.x2[index] - v1x;
+    const float ry = edges.y2[index] - v1y;
+    const float rr = rx * rx + ry * ry;
+    if (rr == 0)
+      return false;
+
+    const float s = ((qx - v1x) * rx + (qy - v1y) * ry) / rr;
+    if (s < 0 || 1 < s)
+      return false;
+
+    *fraction = t;
+    *flip = numerator > 0 ? 1 : 0;
+    return true;
+  }
+
+  // b2MulT(xf, p) components
+  static float localX(const b2Transform& xf, float x, float y) {
+    return xf.q.c * (x - xf.p.x) + xf.q.s * (y - xf.p.y);
+  }
+
+  static float localY(const b2Transform& xf, float x, float y) {
+    return -xf.q.s * (x - xf.p.x) + xf.q.c * (y - xf.p.y);
+  }
+
+  // casts a single ray (one batch lane)
+  template <class Query>
+  static void traverse(const RayCaster* ray_caster,
+                       const RayBatch& rays,
+                       int lane,
+                       Query& query) {
+    const float x1 = rays.x1[lane];
+    const float y1 = rays.y1[lane];
+    const float x2 = rays.x2[lane];
+    const float y2 = rays.y2[lane];
+
+    const auto& circles = ray_caster->circles_;
+    for (int i = 0; i < int(circles.fixture.size()); ++i) {
+      const int fixture = circles.fixture[i];
+      if (!b2TestOverlap(circles.aabb[i], rays.aabb) || query.skip(fixture))
+        continue;
+      float fraction = 0;
+      if (circleTest(circles, i, x1, y1, x2, y2, query.maxFraction(), &fraction)) {
+        if (query.report(RayCaster::kCircle, i, 0, fixture, fraction))
+          return;
+      }
+    }
+
+    const auto& polygons = ray_caster->polygons_;
+    for (int i = 0; i < int(polygons.fixture.size()); ++i) {
+      const int fixture = polygons.fixture[i];
+      if (!b2TestOverlap(polygons.aabb[i], rays.aabb) || query.skip(fixture))
+        continue;
+      const auto& xf = ray_caster->bodies_[polygons.body[i]];
+      const float lx1 = localX(xf, x1, y1);
+      const float ly1 = localY(xf, x1, y1);
+      const float ldx = localX(xf, x2, y2) - lx1;
+      const float ldy = localY(xf, x2, y2) - ly1;
+      float fraction = 0;
+      int side = 0;
+      const float max_fraction = query.maxFraction();
+      if (polygonTest(polygons, i, lx1, ly1, ldx, ldy, max_fraction, &fraction, &side)) {
+        if (query.report(RayCaster::kPolygon, i, side, fixture, fraction))
+          return;
+      }
+    }
+
+    const auto& edges = ray_caster->edges_;
+    for (int i = 0; i < int(edges.fixture.size()); ++i) {
+      const int fixture = edges.fixture[i];
+      if (!b2TestOverlap(edges.aabb[i], rays.aabb) || query.skip(fixture))
+        continue;
+      const auto& xf = ray_caster->bodies_[edges.body[i]];
+      const float lx1 = localX(xf, x1, y1);
+      const float ly1 = localY(xf, x1, y1);
+      const float ldx = localX(xf, x2, y2) - lx1;
+      const float ldy = localY(xf, x2, y2) - ly1;
+      float fraction = 0;
+      int flip = 0;
+      if (edgeTest(edges, i, lx1, ly1, ldx, ldy, query.maxFraction(), &fraction, &flip)) {
+        if (query.report(RayCaster::kEdge, i, flip, fixture, fraction))
+          return;
+      }
+    }
+  }
+
+  static void closest_cpu(const RayCaster* ray_caster,
+                          const RayBatch& rays,
+                          float min_fraction,
+                          const void* filter_id,
+                          HitBatch* hits) {
+    for (int lane = 0; lane < RayCaster::kBatchSize; ++lane) {
+      ClosestQuery query(min_fraction, filter_id, ray_caster->fixtures_user_data_);
+      traverse(ray_caster, rays, lane, query);
+      hits->fraction[lane] = query.fraction;
+      hits->type[lane] = query.type;
+      hits->index[lane] = query.index;
+      hits->detail[lane] = query.detail;
+    }
+  }
+
+  static void occlusion_cpu(const RayCaster* ray_caster,
+                            const RayBatch& rays,
+                            bool* occluded) {
+    for (int lane = 0; lane < RayCaster::kBatchSize; ++lane) {
+      OcclusionQuery query(rays.exclude[lane]);
+      traverse(ray_caster, rays, lane, query);
+      occluded[lane] = query.occluded;
+    }
+  }
+
+#ifndef DARWIN_OS_WASM
+
+  // the closest intersections for a batch of rays (AVX2)
+  struct ClosestQueryAvx {
+    const __m256 min_fraction;
+    const void* const filter_id;
+    const vector<const void*>& user_data;
+
+    __m256 fraction = _mm256_set1_ps(1);
+    __m256i type = _mm256_setzero_si256();
+    __m256i index = _mm256_setzero_si256();
+    __m256i detail = _mm256_setzero_si256();
+
+    ClosestQueryAvx(float min_fraction,
+                    const void* filter_id,
+                    const vector<const void*>& user_data)
+        : min_fraction(_mm256_set1_ps(min_fraction)),
+          filter_id(filter_id),
+          user_data(user_data) {}
+
+    bool skip(int fixture) const {
+      return filter_id != nullptr && user_data[fixture] == filter_id;
+    }
+
+    __m256 maxFraction() const { return fraction; }
+
+    bool report(__m256 mask, int type, int index, __m256i detail, int, __m256 fraction) {
+      mask = _mm256_and_ps(mask, _mm256_cmp_ps(fraction, min_fraction, _CMP_GE_OQ));
+      const __m256i imask = _mm256_castps_si256(mask);
+      this->fraction = _mm256_blendv_ps(this->fraction, fraction, mask);
+      this->type = _mm256_blendv_epi8(this->type, _mm256_set1_epi32(type), imask);
+      this->index = _mm256_blendv_epi8(this->index, _mm256_set1_epi32(index), imask);
+      this->detail = _mm256_blendv_epi8(this->detail, detail, imask);
+      return false;
+    }
+  };
+
+  // any intersection for a batch of rays (AVX2)
+  struct OcclusionQueryAvx {
+    const __m256i exclude;
+    __m256 occluded = _mm256_setzero_ps();
+
+    explicit OcclusionQueryAvx(const int* exclude)
+        : exclude(_mm256_load_si256(reinterpret_cast<const __m256i*>(exclude))) {}
+
+    bool skip(int) const { return false; }
+
+    __m256 maxFraction() const { return _mm256_set1_ps(1); }
+
+    bool report(__m256 mask, int, int, __m256i, int fixture, __m256) {
+      const __m256i excluded = _mm256_cmpeq_epi32(exclude, _mm256_set1_epi32(fixture));
+      mask = _mm256_andnot_ps(_mm256_castsi256_ps(excluded), mask);
+      occluded = _mm256_or_ps(occluded, mask);
+      return _mm256_movemask_ps(occluded) == 0xff;
+    }
+  };
+
+  // the ray batch transformed to body coordinates (b2MulT)
+  struct LocalRays {
+    __m256 x1;
+    __m256 y1;
+    __m256 dx;
+    __m256 dy;
+
+    LocalRays()
+        : x1(_mm256_setzero_ps()),
+          y1(_mm256_setzero_ps()),
+          dx(_mm256_setzero_ps()),
+          dy(_mm256_setzero_ps()) {}
+
+    LocalRays(const b2Transform& xf, __m256 x1, __m256 y1, __m256 x2, __m256 y2) {
+      const __m256 px = _mm256_set1_ps(xf.p.x);
+      const __m256 py = _mm256_set1_ps(xf.p.y);
+      const __m256 c = _mm256_set1_ps(xf.q.c);
+      const __m256 s = _mm256_set1_ps(xf.q.s);
+      const __m256 neg_s = _mm256_set1_ps(-xf.q.s);
+
+      const __m256 dx1 = _mm256_sub_ps(x1, px);
+      const __m256 dy1 = _mm256_sub_ps(y1, py);
+      const __m256 dx2 = _mm256_sub_ps(x2, px);
+      const __m256 dy2 = _mm256_sub_ps(y2, py);
+
+      this->x1 = _mm256_add_ps(_mm256_mul_ps(c, dx1), _mm256_mul_ps(s, dy1));
+      this->y1 = _mm256_add_ps(_mm256_mul_ps(neg_s, dx1), _mm256_mul_ps(c, dy1));
+      const __m256 lx2 = _mm256_add_ps(_mm256_mul_ps(c, dx2), _mm256_mul_ps(s, dy2));
+      const __m256 ly2 = _mm256_add_ps(_mm256_mul_ps(neg_s, dx2), _mm256_mul_ps(c, dy2));
+      dx = _mm256_sub_ps(lx2, this->x1);
+      dy = _mm256_sub_ps(ly2, this->y1);
+    }
+  };
+
+  static __m256 circleTestAvx(const RayCaster::Circles& circles,
+                              int index,
+                              __m256 x1,
+                              __m256 y1,
+                              __m256 rx,
+                              __m256 ry,
+                              __m256 rr,
+                              __m256 max_fraction,
+                              __m256* fraction) {
+    const float radius = circles.radius[index];
+    const __m256 sx = _mm256_sub_ps(x1, _mm256_set1_ps(circles.x[index]));
+    const __m256 sy = _mm256_sub_ps(y1, _mm256_set1_ps(circles.y[index]));
+    const __m256 ss = _mm256_add_ps(_mm256_mul_ps(sx, sx), _mm256_mul_ps(sy, sy));
+    const __m256 b = _mm256_sub_ps(ss, _mm256_set1_ps(radius * radius));
+    const __m256 c = _mm256_add_ps(_mm256_mul_ps(sx, rx), _mm256_mul_ps(sy, ry));
+    const __m256 sigma = _mm256_sub_ps(_mm256_mul_ps(c, c), _mm256_mul_ps(rr, b));
+
+    // !(sigma < 0 || rr < b2_epsilon)
+    const __m256 epsilon = _mm256_set1_ps(b2_epsilon);
+    __m256 mask = _mm256_and_ps(_mm256_cmp_ps(sigma, _mm256_setzero_ps(), _CMP_NLT_UQ),
+                                _mm256_cmp_ps(rr, epsilon, _CMP_NLT_UQ));
+    if (_mm256_movemask_ps(mask) == 0)
+      return mask;
+
+    // a = -(c + sqrt(sigma))
+    const __m256 a = _mm256_xor_ps(_mm256_add_ps(c, _mm256_sqrt_ps(sigma)),
+                                   _mm256_set1_ps(-0.0f));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GE_OQ));
+    const __m256 max_a = _mm256_mul_ps(max_fraction, rr);
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(a, max_a, _CMP_LE_OQ));
+    *fraction = _mm256_div_ps(a, rr);
+    return mask;
+  }
+
+  static __m256 polygonTestAvx(const RayCaster::Polygons& polygons,
+                               int index,
+                               const LocalRays& ray,
+                               __m256 max_fraction,
+                               __m256* fraction,
+                               __m256i* side) {
+    const __m256 zero = _mm256_setzero_ps();
+    __m256 lower = zero;
+    __m256 upper = max_fraction;
+    __m256i lower_side = _mm256_set1_epi32(-1);
+    __m256 rejected = zero;
+
+    const int first_side = polygons.first_side[index];
+    const int last_side = first_side + polygons.sides_count[index];
+    for (int i = first_side; i < last_side; ++i) {
+      const __m256 nx = _mm256_set1_ps(polygons.nx[i]);
+      const __m256 ny = _mm256_set1_ps(polygons.ny[i]);
+      const __m256 vx = _mm256_set1_ps(polygons.vx[i]);
+      const __m256 vy = _mm256_set1_ps(polygons.vy[i]);
+      const __m256 numerator =
+          _mm256_add_ps(_mm256_mul_ps(nx, _mm256_sub_ps(vx, ray.x1)),
+                        _mm256_mul_ps(ny, _mm256_sub_ps(vy, ray.y1)));
+      const __m256 denominator =
+          _mm256_add_ps(_mm256_mul_ps(nx, ray.dx), _mm256_mul_ps(ny, ray.dy));
+
+      // parallel to the side, and outside?
+      const __m256 parallel = _mm256_cmp_ps(denominator, zero, _CMP_EQ_OQ);
+      rejected = _mm256_or_ps(
+          rejected, _mm256_and_ps(parallel, _mm256_cmp_ps(numerator, zero, _CMP_LT_OQ)));
+
+      const __m256 t = _mm256_div_ps(numerator, denominator);
+
+      // entering the half-plane
+      const __m256 enter =
+          _mm256_and_ps(_mm256_cmp_ps(denominator, zero, _CMP_LT_OQ),
+                        _mm256_cmp_ps(numerator, _mm256_mul_ps(lower, denominator),
+                                      _CMP_LT_OQ));
+      lower = _mm256_blendv_ps(lower, t, enter);
+      lower_side = _mm256_blendv_epi8(lower_side, _mm256_set1_epi32(i),
+                                      _mm256_castps_si256(enter));
+
+      // exiting the half-plane
+      const __m256 exit =
+          _mm256_and_ps(_mm256_cmp_ps(denominator, zero, _CMP_GT_OQ),
+                        _mm256_cmp_ps(numerator, _mm256_mul_ps(upper, denominator),
+                                      _CMP_LT_OQ));
+      upper = _mm256_blendv_ps(upper, t, exit);
+
+      rejected = _mm256_or_ps(rejected, _mm256_cmp_ps(upper, lower, _CMP_LT_OQ));
+      if (_mm256_movemask_ps(rejected) == 0xff)
+        return zero;
+    }
+
+    const __m256i has_side = _mm256_cmpgt_epi32(lower_side, _mm256_set1_epi32(-1));
+    *fraction = lower;
+    *side = lower_side;
+    return _mm256_andnot_ps(rejected, _mm256_castsi256_ps(has_side));
+  }
+
+  static __m256 edgeTestAvx(const RayCaster::Edges& edges,
+                            int index,
+                            const LocalRays& ray,
+                            __m256 max_fraction,
+                            __m256* fraction,
+                            __m256i* flip) {
+    const float v1x = edges.x1[index];
+    const float v1y = edges.y1[index];
+    const float rx = edges.x2[index] - v1x;
+    const float ry = edges.y2[index] - v1y;
+    const float rr = rx * rx + ry * ry;
+    if (rr == 0)
+      return _mm256_setzero_ps();
+
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 nx = _mm256_set1_ps(edges.nx[index]);
+    const __m256 ny = _mm256_set1_ps(edges.ny[index]);
+    const __m256 v1x_v = _mm256_set1_ps(v1x);
+    const __m256 v1y_v = _mm256_set1_ps(v1y);
+    const __m256 numerator =
+        _mm256_add_ps(_mm256_mul_ps(nx, _mm256_sub_ps(v1x_v, ray.x1)),
+                      _mm256_mul_ps(ny, _mm256_sub_ps(v1y_v, ray.y1)));
+    const __m256 denominator =
+        _mm256_add_ps(_mm256_mul_ps(nx, ray.dx), _mm256_mul_ps(ny, ray.dy));
+
+    const __m256 t = _mm256_div_ps(numerator, denominator);
+    __m256 mask = _mm256_cmp_ps(denominator, zero, _CMP_NEQ_OQ);
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, zero, _CMP_GE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(t, max_fraction, _CMP_LE_OQ));
+    if (_mm256_movemask_ps(mask) == 0)
+      return mask;
+
+    const __m256 qx = _mm256_add_ps(ray.x1, _mm256_mul_ps(t, ray.dx));
+    const __m256 qy = _mm256_add_ps(ray.y1, _mm256_mul_ps(t, ray.dy));
+    const __m256 s_dot =
+        _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(qx, v1x_v), _mm256_set1_ps(rx)),
+                      _mm256_mul_ps(_mm256_sub_ps(qy, v1y_v), _mm256_set1_ps(ry)));
+    const __m256 s = _mm256_div_ps(s_dot, _mm256_set1_ps(rr));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(s, zero, _CMP_GE_OQ));
+    mask = _mm256_and_ps(mask, _mm256_cmp_ps(s, _mm256_set1_ps(1), _CMP_LE_OQ));
+
+    *fraction = t;
+    const __m256 positive = _mm256_cmp_ps(numerator, zero, _CMP_GT_OQ);
+    *flip = _mm256_and_si256(_mm256_castps_si256(positive), _mm256_set1_epi32(1));
+    return mask;
+  }
+
+  // casts all the rays in the batch
+  template <class Query>
+  static void traverseAvx(const RayCaster* ray_caster,
+                          const RayBatch& rays,
+                          Query& query) {
+    const __m256 x1 = _mm256_load_ps(rays.x1);
+    const __m256 y1 = _mm256_load_ps(rays.y1);
+    const __m256 x2 = _mm256_load_ps(rays.x2);
+    const __m256 y2 = _mm256_load_ps(rays.y2);
+    const __m256 rx = _mm256_sub_ps(x2, x1);
+    const __m256 ry = _mm256_sub_ps(y2, y1);
+    const __m256 rr = _mm256_add_ps(_mm256_mul_ps(rx, rx), _mm256_mul_ps(ry, ry));
+    const __m256i no_detail = _mm256_setzero_si256();
+
+    const auto& circles = ray_caster->circles_;
+    for (int i = 0; i < int(circles.fixture.size()); ++i) {
+      const int fixture = circles.fixture[i];
+      if (!b2TestOverlap(circles.aabb[i], rays.aabb) || query.skip(fixture))
+        continue;
+      __m256 fraction;
+      const __m256 mask =
+          circleTestAvx(circles, i, x1, y1, rx, ry, rr, query.maxFraction(), &fraction);
+      if (_mm256_movemask_ps(mask) != 0) {
+        if (query.report(mask, RayCaster::kCircle, i, no_detail, fixture, fraction))
+          return;
+      }
+    }
+
+    // the polygons and edges are grouped by body, so the ray batch
+    // is transformed to body coordinates only when the body changes
+    int body = -1;
+    LocalRays local_rays;
+
+    const auto& polygons = ray_caster->polygons_;
+    for (int i = 0; i < int(polygons.fixture.size()); ++i) {
+      const int fixture = polygons.fixture[i];
+      if (!b2TestOverlap(polygons.aabb[i], rays.aabb) || query.skip(fixture))
+        continue;
+      if (polygons.body[i] != body) {
+        body = polygons.body[i];
+        local_rays = LocalRays(ray_caster->bodies_[body], x1, y1, x2, y2);
+      }
+      __m256 fraction;
+      __m256i side;
+      const __m256 mask =
+          polygonTestAvx(polygons, i, local_rays, query.maxFraction(), &fraction, &side);
+      if (_mm256_movemask_ps(mask) != 0) {
+        if (query.report(mask, RayCaster::kPolygon, i, side, fixture, fraction))
+          return;
+      }
+    }
+
+    body = -1;
+    const auto& edges = ray_caster->edges_;
+    for (int i = 0; i < int(edges.fixture.size()); ++i) {
+      const int fixture = edges.fixture[i];
+      if (!b2TestOverlap(edges.aabb[i], rays.aabb) || query.skip(fixture))
+        continue;
+      if (edges.body[i] != body) {
+        body = edges.body[i];
+        local_rays = LocalRays(ray_caster->bodies_[body], x1, y1, x2, y2);
+      }
+      __m256 fraction;
+      __m256i flip;
+      const __m256 mask =
+          edgeTestAvx(edges, i, local_rays, query.maxFraction(), &fraction, &flip);
+      if (_mm256_movemask_ps(mask) != 0) {
+        if (query.report(mask, RayCaster::kEdge, i, flip, fixture, fraction))
+          return;
+      }
+    }
+  }
+
+  static void closest_avx(const RayCaster* ray_caster,
+                          const RayBatch& rays,
+                          float min_fraction,
+                          const void* filter_id,
+                          HitBatch* hits) {
+    ClosestQueryAvx query(min_fraction, filter_id, ray_caster->fixtures_user_data_);
+    traverseAvx(ray_caster, rays, query);
+    _mm256_store_ps(hits->fraction, query.fraction);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hits->type), query.type);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hits->index), query.index);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(hits->detail), query.detail);
+  }
+
+  static void occlusion_avx(const RayCaster* ray_caster,
+                            const RayBatch& rays,
+                            bool* occluded) {
+    OcclusionQueryAvx query(rays.exclude);
+    traverseAvx(ray_caster, rays, query);
+    const int mask = _mm256_movemask_ps(query.occluded);
+    for (int lane = 0; lane < RayCaster::kBatchSize; ++lane) {
+      occluded[lane] = (mask & (1 << lane)) != 0;
+    }
+  }
+
+#endif  // DARWIN_OS_WASM
+
+  static bool useAvx2() {
+#ifdef DARWIN_OS_WASM
+    return false;
+#else
+    static const bool avx2 = pal::detectAvx2();
+    return avx2;
+#endif
+  }
+
+  static void closest(const RayCaster* ray_caster,
+                      const RayBatch& rays,
+                      float min_fraction,
+                      const void* filter_id,
+                      HitBatch* hits) {
+#ifndef DARWIN_OS_WASM
+    if (useAvx2()) {
+      closest_avx(ray_caster, rays, min_fraction, filter_id, hits);
+      return;
+    }
+#endif
+    closest_cpu(ray_caster, rays, min_fraction, filter_id, hits);
+  }
+
+  static void occlusion(const RayCaster* ray_caster,
+                        const RayBatch& rays,
+                        bool* occluded) {
+#ifndef DARWIN_OS_WASM
+    if (useAvx2()) {
+      occlusion_avx(ray_caster, rays, occluded);
+      return;
+    }
+#endif
+    occlusion_cpu(ray_caster, rays, occluded);
+  }
+};
+
+void RayCaster::Circles::clear() {
+  x.clear();
+  y.clear();
+  radius.clear();
+  fixture.clear();
+  aabb.clear();
+}
+
+void RayCaster::Polygons::clear() {
+  body.clear();
+  first_side.clear();
+  sides_count.clear();
+  fixture.clear();
+  aabb.clear();
+  vx.clear();
+  vy.clear();
+  nx.clear();
+  ny.clear();
+}
+
+void RayCaster::Edges::clear() {
+  body.clear();
+  x1.clear();
+  y1.clear();
+  x2.clear();
+  y2.clear();
+  nx.clear();
+  ny.clear();
+  fixture.clear();
+  aabb.clear();
+}
+
+// the primitive bounding boxes are used to cull the ray batches, so they are
+// slightly enlarged to account for rounding errors in the intersection tests
+static b2AABB primitiveAABB(const b2Shape* shape,
+                            const b2Transform& xf,
+                            int child_index) {
+  b2AABB aabb;
+  shape->ComputeAABB(&aabb, xf, child_index);
+  const b2Vec2 margin(b2_linearSlop, b2_linearSlop);
+  aabb.lowerBound -= margin;
+  aabb.upperBound += margin;
+  return aabb;
+}
+
+void RayCaster::update(b2World* world) {
+  bodies_.clear();
+  fixtures_.clear();
+  fixtures_user_data_.clear();
+  circles_.clear();
+  polygons_.clear();
+  edges_.clear();
+
+  for (b2Body* body = world->GetBodyList(); body != nullptr; body = body->GetNext()) {
+    const int body_index = int(bodies_.size());
+    const b2Transform& xf = body->GetTransform();
+    bodies_.push_back(xf);
+
+    for (b2Fixture* fixture = body->GetFixtureList(); fixture != nullptr;
+         fixture = fixture->GetNext()) {
+      const int fixture_index = int(fixtures_.size());
+      fixtures_.push_back(fixture);
+      fixtures_user_data_.push_back(fixture->GetUserData());
+
+      const b2Shape* shape = fixture->GetShape();
+      switch (fixture->GetType()) {
+        case b2Shape::e_circle: {
+          auto circle = static_cast<const b2CircleShape*>(shape);
+          const b2Vec2 position = xf.p + b2Mul(xf.q, circle->m_p);
+          circles_.x.push_back(position.x);
+          circles_.y.push_back(position.y);
+          circles_.radius.push_back(circle->m_radius);
+          circles_.fixture.push_back(fixture_index);
+          circles_.aabb.push_back(primitiveAABB(shape, xf, 0));
+          break;
+        }
+        case b2Shape::e_polygon: {
+          auto polygon = static_cast<const b2PolygonShape*>(shape);
+          polygons_.body.push_back(body_index);
+          polygons_.first_side.push_back(int(polygons_.vx.size()));
+          polygons_.sides_count.push_back(polygon->m_count);
+          polygons_.fixture.push_back(fixture_index);
+          polygons_.aabb.push_back(primitiveAABB(shape, xf, 0));
+          for (int i = 0; i < polygon->m_count; ++i) {
+            polygons_.vx.push_back(polygon->m_vertices[i].x);
+            polygons_.vy.push_back(polygon->m_vertices[i].y);
+            polygons_.nx.push_back(polygon->m_normals[i].x);
+            polygons_.ny.push_back(polygon->m_normals[i].y);
+          }
+          break;
+        }
+        case b2Shape::e_edge:
+          addEdge(*static_cast<const b2EdgeShape*>(shape), xf, body_index, fixture_index);
+          break;
+        case b2Shape::e_chain: {
+          auto chain = static_cast<const b2ChainShape*>(shape);
+          for (int i = 0; i < chain->GetChildCount(); ++i) {
+            b2EdgeShape edge;
+            chain->GetChildEdge(&edge, i);
+            addEdge(edge, xf, body_index, fixture_index);
+          }
+          break;
+        }
+        default:
+          FATAL("Unexpected fixture shape");
+      }
+    }
+  }
+}
+
+void RayCaster::addEdge(const b2EdgeShape& shape,
+                        const b2Transform& xf,
+                        int body,
+                        int fixture) {
+  const b2Vec2& v1 = shape.m_vertex1;
+  const b2Vec2& v2 = shape.m_vertex2;
+  const b2Vec2 e = v2 - v1;
+  b2Vec2 normal(e.y, -e.x);
+  normal.Normalize();
+
+  edges_.body.push_back(body);
+  edges_.x1.push_back(v1.x);
+  edges_.y1.push_back(v1.y);
+  edges_.x2.push_back(v2.x);
+  edges_.y2.push_back(v2.y);
+  edges_.nx.push_back(normal.x);
+  edges_.ny.push_back(normal.y);
+  edges_.fixture.push_back(fixture);
+  edges_.aabb.push_back(primitiveAABB(&shape, xf, 0));
+}
+
+void RayCaster::loadBatch(const Ray* rays,
+                          const int* exclude,
+                          int count,
+                          RayBatch* batch) {
+  assert(count > 0 && count <= kBatchSize);
+
+  batch->aabb.lowerBound = b2Min(rays[0].start, rays[0].end);
+  batch->aabb.upperBound = b2Max(rays[0].start, rays[0].end);
+
+  // the unused lanes replicate the last ray
+  for (int lane = 0; lane < kBatchSize; ++lane) {
+    const int index = min(lane, count - 1);
+    const Ray& ray = rays[index];
+    batch->x1[lane] = ray.start.x;
+    batch->y1[lane] = ray.start.y;
+    batch->x2[lane] = ray.end.x;
+    batch->y2[lane] = ray.end.y;
+    batch->exclude[lane] = exclude != nullptr ? exclude[index] : -1;
+    batch->aabb.lowerBound = b2Min(batch->aabb.lowerBound, b2Min(ray.start, ray.end));
+    batch->aabb.upperBound = b2Max(batch->aabb.upperBound, b2Max(ray.start, ray.end));
+  }
+}
+
+RayHit RayCaster::resolveHit(const RayBatch& rays, const HitBatch& hits, int lane) const {
+  RayHit hit;
+  const int index = hits.index[lane];
+  switch (hits.type[lane]) {
+    case kNone:
+      return hit;
+
+    case kCircle: {
+      const b2Vec2 p1(rays.x1[lane], rays.y1[lane]);
+      const b2Vec2 p2(rays.x2[lane], rays.y2[lane]);
+      const b2Vec2 position(circles_.x[index], circles_.y[index]);
+      hit.normal = (p1 - position) + hits.fraction[lane] * (p2 - p1);
+      hit.normal.Normalize();
+      hit.fixture_index = circles_.fixture[index];
+      break;
+    }
+
+    case kPolygon: {
+      const int side = hits.detail[lane];
+      const auto& xf = bodies_[polygons_.body[index]];
+      hit.normal = b2Mul(xf.q, b2Vec2(polygons_.nx[side], polygons_.ny[side]));
+      hit.fixture_index = polygons_.fixture[index];
+      break;
+    }
+
+    case kEdge: {
+      const auto& xf = bodies_[edges_.body[index]];
+      const b2Vec2 normal = b2Mul(xf.q, b2Vec2(edges_.nx[index], edges_.ny[index]));
+      hit.normal = hits.detail[lane] ? -normal : normal;
+      hit.fixture_index = edges_.fixture[index];
+      break;
+    }
+
+    default:
+      FATAL("Unexpected primitive type");
+  }
+
+  // same as b2World::RayCast()
+  const float fraction = hits.fraction[lane];
+  const b2Vec2 p1(rays.x1[lane], rays.y1[lane]);
+  const b2Vec2 p2(rays.x2[lane], rays.y2[lane]);
+  hit.point = (1.0f - fraction) * p1 + fraction * p2;
+  hit.fraction = fraction;
+  hit.fixture = fixtures_[hit.fixture_index];
+  return hit;
+}
+
+void RayCaster::castRays(const Ray* rays,
+                         int count,
+                         float min_fraction,
+                         const void* filter_id,
+                         RayHit* hits) const {
+  RayBatch batch;
+  HitBatch hit_batch;
+  for (int first = 0; first < count; first += kBatchSize) {
+    const int batch_size = min(kBatchSize, count - first);
+    loadBatch(rays + first, nullptr, batch_size, &batch);
+    RayCasterKernels::closest(this, batch, min_fraction, filter_id, &hit_batch);
+    for (int lane = 0; lane < batch_size; ++lane) {
+      hits[first + lane] = resolveHit(batch, hit_batch, lane);
+    }
+  }
+}
+
+void RayCaster::testOcclusion(const Ray* rays,
+                              const int* exclude,
+                              int count,
+                              bool* occluded) const {
+  RayBatch batch;
+  bool batch_occluded[kBatchSize];
+  for (int first = 0; first < count; first += kBatchSize) {
+    const int batch_size = min(kBatchSize, count - first);
+    loadBatch(rays + first, exclude + first, batch_size, &batch);
+    RayCasterKernels::occlusion(this, batch, batch_occluded);
+    for (int lane = 0; lane < batch_size; ++lane) {
+      occluded[first + lane] = batch_occluded[lane];
+    }
+  }
+}
+
+}  // namespace sim
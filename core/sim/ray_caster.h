@@ -0,0 +1,169 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <third_party/box2d/box2d.h>
+
+#include <vector>
+using namespace std;
+
+namespace sim {
+
+//! A ray segment (from start to end)
+struct Ray {
+  b2Vec2 start;
+  b2Vec2 end;
+};
+
+//! The closest intersection along a ray
+struct RayHit {
+  //! The intersected fixture (nullptr if there's no intersection)
+  b2Fixture* fixture = nullptr;
+
+  //! The fixture index, used to exclude the fixture from occlusion tests
+  int fixture_index = -1;
+
+  b2Vec2 point{ 0, 0 };
+  b2Vec2 normal{ 0, 0 };
+  float fraction = 1;
+};
+
+//! Batched ray casting against a snapshot of the world geometry
+//!
+//! The world fixtures (circles, polygons and edges) are extracted into flat arrays,
+//! then the rays are intersected in batches of kBatchSize (using AVX2 if available).
+//! The intersection tests follow b2World::RayCast(), although the results may differ
+//! slightly (ex. rounding differences)
+//!
+//! \note The snapshot must be refreshed (update()) after the world bodies move
+//!
+class RayCaster {
+ public:
+  static constexpr int kBatchSize = 8;
+
+  //! Extracts the current world geometry
+  void update(b2World* world);
+
+  //! Finds the closest intersections for a set of rays
+  //!
+  //! Intersections closer than `min_fraction` are ignored, together with the
+  //! fixtures which have the user data set to `filter_id` (if not nullptr).
+  //!
+  void castRays(const Ray* rays,
+                int count,
+                float min_fraction,
+                const void* filter_id,
+                RayHit* hits) const;
+
+  //! Checks if the rays intersect any fixture (except for the excluded ones)
+  //!
+  //! `exclude` is the list of fixture indexes (RayHit::fixture_index) to be ignored,
+  //! one for each ray (-1 means no exclusion).
+  //!
+  void testOcclusion(const Ray* rays,
+                     const int* exclude,
+                     int count,
+                     bool* occluded) const;
+
+  int fixturesCount() const { return int(fixtures_.size()); }
+
+ private:
+  friend struct RayCasterKernels;
+
+  // a batch of rays, in SoA layout
+  struct RayBatch {
+    alignas(32) float x1[kBatchSize];
+    alignas(32) float y1[kBatchSize];
+    alignas(32) float x2[kBatchSize];
+    alignas(32) float y2[kBatchSize];
+    alignas(32) int exclude[kBatchSize];
+
+    // the bounding box of all the ray segments in the batch
+    b2AABB aabb;
+  };
+
+  // the closest intersections for a batch of rays
+  struct HitBatch {
+    alignas(32) float fraction[kBatchSize];
+    alignas(32) int type[kBatchSize];
+    alignas(32) int index[kBatchSize];
+
+    // polygon side index (polygons) or normal direction (edges)
+    alignas(32) int detail[kBatchSize];
+  };
+
+  enum PrimitiveType { kNone = 0, kCircle, kPolygon, kEdge };
+
+  // circles, in world coordinates
+  struct Circles {
+    vector<float> x;
+    vector<float> y;
+    vector<float> radius;
+    vector<int> fixture;
+    vector<b2AABB> aabb;
+
+    void clear();
+  };
+
+  // convex polygons, in body coordinates
+  // (each side is described by a vertex and the outward normal)
+  struct Polygons {
+    vector<int> body;
+    vector<int> first_side;
+    vector<int> sides_count;
+    vector<int> fixture;
+    vector<b2AABB> aabb;
+
+    vector<float> vx;
+    vector<float> vy;
+    vector<float> nx;
+    vector<float> ny;
+
+    void clear();
+  };
+
+  // two-sided edges, in body coordinates
+  struct Edges {
+    vector<int> body;
+    vector<float> x1;
+    vector<float> y1;
+    vector<float> x2;
+    vector<float> y2;
+    vector<float> nx;
+    vector<float> ny;
+    vector<int> fixture;
+    vector<b2AABB> aabb;
+
+    void clear();
+  };
+
+ private:
+  void addEdge(const b2EdgeShape& shape, const b2Transform& xf, int body, int fixture);
+
+  static void loadBatch(const Ray* rays, const int* exclude, int count, RayBatch* batch);
+
+  RayHit resolveHit(const RayBatch& rays, const HitBatch& hits, int lane) const;
+
+ private:
+  vector<b2Transform> bodies_;
+  vector<b2Fixture*> fixtures_;
+  vector<const void*> fixtures_user_data_;
+
+  Circles circles_;
+  Polygons polygons_;
+  Edges edges_;
+};
+
+}  // namespace sim
@@ -0,0 +1,100 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "resettable_world.h"
+
+#include <core/utils.h>
+
+namespace sim {
+
+void ResettableWorld::recordInitialState() {
+  CHECK(!IsLocked());
+
+  initial_state_.clear();
+  for (b2Body* body = GetBodyList(); body != nullptr; body = body->GetNext()) {
+    BodyState state;
+    state.body = body;
+    state.position = body->GetPosition();
+    state.angle = body->GetAngle();
+    state.linear_velocity = body->GetLinearVelocity();
+    state.angular_velocity = body->GetAngularVelocity();
+    state.awake = body->IsAwake();
+    state.active = body->IsActive();
+    initial_state_.push_back(state);
+  }
+
+  initial_joints_count_ = GetJointCount();
+  warm_starting_ = GetWarmStarting();
+  skip_warm_starting_ = false;
+  recorded_ = true;
+}
+
+void ResettableWorld::reset() {
+  CHECK(recorded_, "The initial state was not recorded");
+  CHECK(!IsLocked());
+
+  // new bodies are always inserted at the head of the bodies list,
+  // so everything in front of the first recorded body was created after
+  // the initial state was recorded
+  b2Body* first_recorded = initial_state_.empty() ? nullptr : initial_state_.front().body;
+  while (GetBodyList() != first_recorded) {
+    CHECK(GetBodyList() != nullptr, "A recorded body was destroyed");
+    DestroyBody(GetBodyList());
+  }
+  CHECK(GetBodyCount() == int(initial_state_.size()));
+  CHECK(GetJointCount() == initial_joints_count_);
+
+  // deactivating the bodies destroys all their contacts (and broad-phase proxies),
+  // so nothing from the previous episode survives the reset
+  for (const auto& state : initial_state_) {
+    state.body->SetActive(false);
+  }
+
+  for (const auto& state : initial_state_) {
+    b2Body* body = state.body;
+    if (body->GetPosition() != state.position || body->GetAngle() != state.angle) {
+      body->SetTransform(state.position, state.angle);
+    }
+    body->SetActive(state.active);
+    if (body->GetType() != b2_staticBody) {
+      // putting the body to sleep clears the velocities, forces and the sleep timer
+      body->SetAwake(false);
+      body->SetAwake(state.awake);
+      body->SetLinearVelocity(state.linear_velocity);
+      body->SetAngularVelocity(state.angular_velocity);
+    }
+  }
+
+  // a new world starts without warm starting (there are no previous impulses)
+  SetWarmStarting(false);
+  skip_warm_starting_ = true;
+
+  // b2Body::SetActive() doesn't create the new contacts until the end of the
+  // next step, while a new world creates them at the start of the first step.
+  // The contacts are found right away instead, from the re-created proxies
+  // (b2World only exposes its own contact manager as const)
+  const_cast<b2ContactManager&>(GetContactManager()).FindNewContacts();
+}
+
+void ResettableWorld::step(float32 time_step,
+                           int32 velocity_iterations,
+                           int32 position_iterations) {
+  Step(time_step, velocity_iterations, position_iterations);
+  if (skip_warm_starting_) {
+    SetWarmStarting(warm_starting_);
+    skip_warm_starting_ = false;
+  }
+}
+
+}  // namespace sim
@@ -0,0 +1,73 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <third_party/box2d/box2d.h>
+
+#include <vector>
+using namespace std;
+
+namespace sim {
+
+//! A b2World which can be reset to a recorded initial state
+//!
+//! Resetting reuses the existing bodies, fixtures and joints (and the Box2D
+//! allocators memory) instead of building a new world for every episode:
+//!
+//! - The recorded bodies are restored to the initial transforms and velocities
+//! - Any bodies created after recordInitialState() are destroyed
+//! - All the contacts are dropped and found again, as in a new world
+//!   (so the contact events are reported again, from the first step)
+//! - The solver warm starting is skipped for the next step(), so the
+//!   impulses from the previous episode don't leak into the new one
+//!
+//! \note The recorded bodies (and joints) must not be destroyed
+//! \note If an island has multiple contacts, the solver order may differ from
+//!   a new world (within rounding errors)
+//!
+class ResettableWorld : public b2World {
+ public:
+  explicit ResettableWorld(const b2Vec2& gravity) : b2World(gravity) {}
+
+  //! Records the current state as the initial state
+  void recordInitialState();
+
+  //! Restores the recorded initial state
+  void reset();
+
+  //! Advances the simulation (b2World::Step() plus the reset bookkeeping)
+  void step(float32 time_step, int32 velocity_iterations, int32 position_iterations);
+
+ private:
+  struct BodyState {
+    b2Body* body = nullptr;
+    b2Vec2 position;
+    float32 angle = 0;
+    b2Vec2 linear_velocity;
+    float32 angular_velocity = 0;
+    bool awake = false;
+    bool active = true;
+  };
+
+  // in b2World::GetBodyList() order
+  vector<BodyState> initial_state_;
+  int initial_joints_count_ = 0;
+  bool recorded_ = false;
+
+  bool warm_starting_ = true;
+  bool skip_warm_starting_ = false;
+};
+
+}  // namespace sim
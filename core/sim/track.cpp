@@ -19,6 +19,13 @@ namespace sim {
 Track::Track(Track::Seed seed, const TrackConfig& config) : rnd_(seed), config_(config) {
   CHECK(config_.complexity >= 3);
   generateTrackPath();
+
+  // prebuild the fixture shapes
+  buildCurb(inner_curb_, b2Color(1, 0, 0), inner_outline_, -config_.curb_width);
+  buildCurb(outer_curb_, b2Color(0, 0, 1), outer_outline_, config_.curb_width);
+  if (config_.gates) {
+    buildGates();
+  }
 }
 
 int Track::updateTrackDistance(int old_distance, const b2Vec2& pos) const {
@@ -97,82 +104,94 @@ static b2Vec2 toBox2dVec(const math::Vector2d& v) {
   return b2Vec2(float(v.x), float(v.y));
 }
 
-void Track::createCurb(b2World* world,
-                       const b2Color& color,
-                       const math::Outline& outline,
-                       float curb_width) const {
+void Track::buildCurb(vector<CurbSegment>& curb,
+                      const b2Color& color,
+                      const math::Outline& outline,
+                      float curb_width) const {
   auto& nodes = outline.nodes();
   CHECK(nodes.size() >= 3);
-
-  b2BodyDef body_def;
-  auto curb_body = world->CreateBody(&body_def);
+  CHECK(curb.empty());
 
   const b2Color white(1, 1, 1);
 
-  bool primary_color = true;
+  curb.resize(nodes.size());
   for (size_t i = 0; i < nodes.size(); ++i) {
     const size_t next_i = (i + 1) % nodes.size();
 
     b2Vec2 points[4];
-    b2PolygonShape shape;
     points[0] = toBox2dVec(nodes[i].p);
     points[1] = toBox2dVec(nodes[next_i].p);
     points[2] = toBox2dVec(nodes[next_i].offset(curb_width));
     points[3] = toBox2dVec(nodes[i].offset(curb_width));
-    shape.Set(points, 4);
-
-    b2FixtureDef fixture_def;
-    fixture_def.shape = &shape;
-    fixture_def.friction = config_.curb_friction;
-    fixture_def.restitution = 0.5f;
-    fixture_def.material.emit_intensity = 0;
-    fixture_def.material.color = primary_color ? color : white;
-    primary_color = !primary_color;
-
-    curb_body->CreateFixture(&fixture_def);
+    curb[i].shape.Set(points, 4);
+    curb[i].color = (i % 2 == 0) ? color : white;
   }
 }
 
-void Track::createGates(b2World* world) const {
-  b2BodyDef body_def;
-  auto gates_body = world->CreateBody(&body_def);
+void Track::buildGates() {
+  CHECK(gate_posts_.empty());
 
   b2CircleShape shape;
   shape.m_radius = config_.curb_width * 1.5f;
 
-  b2FixtureDef fixture_def;
-  fixture_def.shape = &shape;
-  fixture_def.friction = config_.curb_friction;
-  fixture_def.restitution = 0.5f;
-  fixture_def.material.emit_intensity = 0.8f;
-  fixture_def.material.color = b2Color(0, 1, 0);
-
-  if (!config_.solid_gate_posts) {
-    fixture_def.filter.maskBits = 0;
-  }
-
   const auto& nodes = outer_outline_.nodes();
   const size_t gate_gap = max(nodes.size() / config_.complexity, size_t(1));
   const double mid_offset = config_.curb_width / 2;
   for (size_t i = 0; i < nodes.size(); i += gate_gap) {
-    fixture_def.material.color = (i == 0 ? b2Color(0, 1, 0) : b2Color(0.7f, 0.7f, 0));
+    const auto color = (i == 0 ? b2Color(0, 1, 0) : b2Color(0.7f, 0.7f, 0));
 
     // right (outer curb)
     const auto& outer_node = nodes[i];
     shape.m_p = toBox2dVec(outer_node.offset(mid_offset));
-    gates_body->CreateFixture(&fixture_def);
+    gate_posts_.push_back({ shape, color });
 
     // left (inner curb)
     const auto& inner_node =
         inner_outline_.findClosestNode(outer_node.offset(-config_.width));
     shape.m_p = toBox2dVec(inner_node.offset(-mid_offset));
+    gate_posts_.push_back({ shape, color });
+  }
+}
+
+void Track::createCurb(b2World* world, const vector<CurbSegment>& curb) const {
+  b2BodyDef body_def;
+  auto curb_body = world->CreateBody(&body_def);
+
+  b2FixtureDef fixture_def;
+  fixture_def.friction = config_.curb_friction;
+  fixture_def.restitution = 0.5f;
+  fixture_def.material.emit_intensity = 0;
+
+  for (const auto& segment : curb) {
+    fixture_def.shape = &segment.shape;
+    fixture_def.material.color = segment.color;
+    curb_body->CreateFixture(&fixture_def);
+  }
+}
+
+void Track::createGates(b2World* world) const {
+  b2BodyDef body_def;
+  auto gates_body = world->CreateBody(&body_def);
+
+  b2FixtureDef fixture_def;
+  fixture_def.friction = config_.curb_friction;
+  fixture_def.restitution = 0.5f;
+  fixture_def.material.emit_intensity = 0.8f;
+
+  if (!config_.solid_gate_posts) {
+    fixture_def.filter.maskBits = 0;
+  }
+
+  for (const auto& gate_post : gate_posts_) {
+    fixture_def.shape = &gate_post.shape;
+    fixture_def.material.color = gate_post.color;
     gates_body->CreateFixture(&fixture_def);
   }
 }
 
 void Track::createFixtures(b2World* world) const {
-  createCurb(world, b2Color(1, 0, 0), inner_outline_, -config_.curb_width);
-  createCurb(world, b2Color(0, 0, 1), outer_outline_, config_.curb_width);
+  createCurb(world, inner_curb_);
+  createCurb(world, outer_curb_);
   if (config_.gates) {
     createGates(world);
   }
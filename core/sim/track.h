@@ -37,6 +37,11 @@ struct TrackConfig {
   float curb_friction = 0.5f;    //!< Curb friction
 };
 
+//! A procedurally generated, closed loop track
+//!
+//! The track geometry is immutable once constructed, so a single Track instance
+//! can be shared by multiple scenes (including concurrent use from multiple threads)
+//!
 class Track : public core::NonCopyable {
  public:
   using Seed = std::random_device::result_type;
@@ -48,6 +53,11 @@ class Track : public core::NonCopyable {
   int updateTrackDistance(int old_distance, const b2Vec2& pos) const;
   const math::Outline::Node& distanceToNode(int distance) const;
 
+  //! Instantiates the track's static bodies and fixtures into a Box2D world
+  //!
+  //! The fixture shapes are precomputed when the track is created, so this
+  //! just copies the prebuilt shapes (no geometry calculations)
+  //!
   void createFixtures(b2World* world) const;
 
   // mostly intended for rendering tracks, everything else
@@ -55,15 +65,31 @@ class Track : public core::NonCopyable {
   const math::Outline& innerOutline() const { return inner_outline_; }
   const math::Outline& outerOutline() const { return outer_outline_; }
 
+ private:
+  // a prebuilt curb segment fixture
+  struct CurbSegment {
+    b2PolygonShape shape;
+    b2Color color;
+  };
+
+  // a prebuilt gate post fixture
+  struct GatePost {
+    b2CircleShape shape;
+    b2Color color;
+  };
+
  private:
   int distanceToNodeIndex(int distance) const;
   void generateTrackPath();
 
-  void createCurb(b2World* world,
-                  const b2Color& color,
-                  const math::Outline& outline,
-                  float curb_width) const;
+  void buildCurb(vector<CurbSegment>& curb,
+                 const b2Color& color,
+                 const math::Outline& outline,
+                 float curb_width) const;
 
+  void buildGates();
+
+  void createCurb(b2World* world, const vector<CurbSegment>& curb) const;
   void createGates(b2World* world) const;
 
  private:
@@ -72,6 +98,11 @@ class Track : public core::NonCopyable {
 
   math::Outline inner_outline_;
   math::Outline outer_outline_;
+
+  // the static geometry, shared by all the worlds instantiating the track
+  vector<CurbSegment> inner_curb_;
+  vector<CurbSegment> outer_curb_;
+  vector<GatePost> gate_posts_;
 };
 
 }  // namespace sim
@@ -0,0 +1,90 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <core/utils.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+using namespace std;
+
+namespace sim {
+
+//! A per-thread cache of reusable simulation worlds
+//!
+//! Instead of building a new world for every episode, the first acquire() call
+//! on each thread creates a world instance (using the factory), and the subsequent
+//! calls reset the same instance (T::reset() must restore the initial state,
+//! usually through sim::ResettableWorld::reset()).
+//!
+//! For example, evaluating a population in a world with a fixed configuration:
+//!
+//! ```
+//! sim::WorldPool<World> world_pool([&] { return make_unique<World>(config, this); });
+//! pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
+//!   World* world = world_pool.acquire();
+//!   ...
+//! });
+//! ```
+//!
+//! \note The pool owns the instances, so it must outlive their use
+//!
+template <class T>
+class WorldPool : public core::NonCopyable {
+ public:
+  using Factory = function<unique_ptr<T>()>;
+
+  explicit WorldPool(const Factory& factory) : factory_(factory) {}
+
+  //! Returns the calling thread's world instance, in the initial state
+  T* acquire() {
+    const auto thread_id = this_thread::get_id();
+    {
+      unique_lock<mutex> guard(lock_);
+      auto it = instances_.find(thread_id);
+      if (it != instances_.end()) {
+        // no other thread is using this instance, so it can be reset without the lock
+        T* world = it->second.get();
+        guard.unlock();
+        world->reset();
+        return world;
+      }
+    }
+
+    auto instance = factory_();
+    CHECK(instance);
+    T* world = instance.get();
+
+    unique_lock<mutex> guard(lock_);
+    instances_[thread_id] = std::move(instance);
+    return world;
+  }
+
+  //! The number of instances created so far
+  int size() const {
+    unique_lock<mutex> guard(lock_);
+    return int(instances_.size());
+  }
+
+ private:
+  const Factory factory_;
+  unordered_map<thread::id, unique_ptr<T>> instances_;
+  mutable mutex lock_;
+};
+
+}  // namespace sim
@@ -17,6 +17,10 @@
 #include <core/evolution.h>
 #include <core/parallel_for_each.h>
 
+#include <random>
+#include <vector>
+using namespace std;
+
 namespace tournament {
 
 SimpleTournament::SimpleTournament(const core::PropertySet& config) {
@@ -25,40 +29,94 @@ SimpleTournament::SimpleTournament(const core::PropertySet& config) {
 
 void SimpleTournament::evaluatePopulation(darwin::Population* population,
                                           GameRules* game_rules) {
-  darwin::StageScope stage("Tournament", population->size());
-  pp::for_each(*population, [&](int index, darwin::Genotype* genotype) {
-    random_device rd;
-    default_random_engine rnd(rd());
-    uniform_int_distribution<size_t> dist_opponent(0, population->size() - 1);
+  const BrainCache brains(population, game_rules);
 
-    float score = 0;
-    int eval_games = 0;
+  // each genotype plays eval_games games against random (but different) opponents
+  vector<Game> games = randomGames(population->size());
 
-    for (int i = 0; i < config_.eval_games; ++i) {
-      // pick a random (but different) opponent
-      size_t opponent_index = dist_opponent(rnd);
-      while (opponent_index == size_t(index)) {
-        opponent_index = dist_opponent(rnd);
-      }
+  // the games are scheduled in rounds, such that a brain is used by at most one
+  // game in each round (so the rounds can be played in parallel, without locking)
+  vector<vector<Game*>> rounds = scheduleRounds(&games, population->size());
 
-      auto opponent_genotype = population->genotype(opponent_index);
+  darwin::StageScope stage("Tournament", games.size());
+  for (auto& round : rounds) {
+    pp::for_each(round, [&](int, Game* game) {
+      const auto player = brains.contestant(game->player);
+      const auto opponent = brains.contestant(game->opponent);
 
-      auto outcome = game_rules->play(genotype, opponent_genotype);
-      score += game_rules->scores(outcome).player1_score;
-      ++eval_games;
+      auto outcome = game_rules->play(player, opponent);
+      game->score = game_rules->scores(outcome).player1_score;
 
       if (config_.rematches) {
-        auto rematch_outcome = game_rules->play(opponent_genotype, genotype);
-        score += game_rules->scores(rematch_outcome).player2_score;
-        ++eval_games;
+        auto rematch_outcome = game_rules->play(opponent, player);
+        game->score += game_rules->scores(rematch_outcome).player2_score;
       }
-    }
 
-    // normalize the fitness to make it invariant to the number of played games
-    genotype->fitness = score / eval_games;
+      darwin::ProgressManager::reportProgress();
+    });
+  }
+
+  vector<float> scores(population->size(), 0.0f);
+  for (const auto& game : games) {
+    scores[game.player] += game.score;
+  }
+
+  // normalize the fitness to make it invariant to the number of played games
+  const int eval_games = config_.eval_games * (config_.rematches ? 2 : 1);
+  for (size_t i = 0; i < population->size(); ++i) {
+    population->genotype(i)->fitness = scores[i] / eval_games;
+  }
+}
+
+vector<SimpleTournament::Game> SimpleTournament::randomGames(
+    size_t population_size) const {
+  CHECK(population_size > 1);
 
-    darwin::ProgressManager::reportProgress();
-  });
+  random_device rd;
+  default_random_engine rnd(rd());
+  uniform_int_distribution<size_t> dist_opponent(0, population_size - 1);
+
+  vector<Game> games;
+  games.reserve(population_size * config_.eval_games);
+  for (size_t index = 0; index < population_size; ++index) {
+    for (int i = 0; i < config_.eval_games; ++i) {
+      // pick a random (but different) opponent
+      size_t opponent_index = dist_opponent(rnd);
+      while (opponent_index == index) {
+        opponent_index = dist_opponent(rnd);
+      }
+      games.push_back({ index, opponent_index, 0 });
+    }
+  }
+  return games;
+}
+
+vector<vector<SimpleTournament::Game*>> SimpleTournament::scheduleRounds(
+    vector<Game>* games,
+    size_t population_size) {
+  // greedy edge coloring: each game is scheduled in the first round where
+  // both contestants are available (so the number of rounds is less than
+  // twice the max number of games played by a contestant)
+  vector<vector<Game*>> rounds;
+  vector<vector<bool>> busy(population_size);
+  for (auto& game : *games) {
+    auto& player_busy = busy[game.player];
+    auto& opponent_busy = busy[game.opponent];
+    size_t round = 0;
+    while ((round < player_busy.size() && player_busy[round]) ||
+           (round < opponent_busy.size() && opponent_busy[round])) {
+      ++round;
+    }
+    for (auto contestant_busy : { &player_busy, &opponent_busy }) {
+      if (contestant_busy->size() <= round)
+        contestant_busy->resize(round + 1, false);
+      (*contestant_busy)[round] = true;
+    }
+    if (rounds.size() <= round)
+      rounds.resize(round + 1);
+    rounds[round].push_back(&game);
+  }
+  return rounds;
 }
 
 }  // namespace tournament
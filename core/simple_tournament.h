@@ -18,6 +18,9 @@
 #include <core/properties.h>
 #include <core/tournament.h>
 
+#include <vector>
+using namespace std;
+
 namespace tournament {
 
 //! SimpleTournament configuration
@@ -40,6 +43,19 @@ class SimpleTournament : public Tournament {
 
   void evaluatePopulation(darwin::Population* population, GameRules* game_rules) override;
 
+ private:
+  // a game between a player and one of its random opponents
+  struct Game {
+    size_t player = 0;
+    size_t opponent = 0;
+    float score = 0;  // the player's score (including the rematch)
+  };
+
+  vector<Game> randomGames(size_t population_size) const;
+
+  static vector<vector<Game*>> scheduleRounds(vector<Game>* games,
+                                              size_t population_size);
+
  private:
   SimpleTournamentConfig config_;
 };
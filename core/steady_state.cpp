@@ -0,0 +1,367 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "steady_state.h"
+#include "evolution.h"
+#include "parallel_for_each.h"
+#include "tracing.h"
+
+#include <chrono>
+using namespace std;
+
+namespace darwin {
+
+namespace {
+
+// the evaluators evaluate one child at a time
+class SingleGenotype : public Population {
+ public:
+  SingleGenotype(Genotype* genotype, int generation)
+      : genotype_(genotype), generation_(generation) {}
+
+  size_t size() const override { return 1; }
+
+  Genotype* genotype(size_t index) override {
+    CHECK(index == 0);
+    return genotype_;
+  }
+
+  const Genotype* genotype(size_t index) const override {
+    CHECK(index == 0);
+    return genotype_;
+  }
+
+  vector<size_t> rankingIndex() const override { return { 0 }; }
+  int generation() const override { return generation_; }
+  void createPrimordialGeneration(int) override { FATAL("Not supported"); }
+  void createNextGeneration() override { FATAL("Not supported"); }
+
+ private:
+  Genotype* genotype_ = nullptr;
+  int generation_ = 0;
+};
+
+// the evaluators don't report their stages (the evolution stages
+// are tracked on the main evolution thread)
+class NullProgressMonitor : public ProgressMonitor {
+ public:
+  void beginStage(const string&, size_t, uint32_t) override {}
+  void finishStage(const string&) override {}
+  void reportProgress(size_t) override {}
+};
+
+NullProgressMonitor g_null_progress_monitor;
+
+}  // namespace
+
+SteadyStateEvolution::SteadyStateEvolution(Population* population,
+                                           unique_ptr<Population> breeder,
+                                           unique_ptr<Population> spare_breeder,
+                                           const Domain* domain,
+                                           SteadyStateReplacement replacement)
+    : pool_(population),
+      population_(population),
+      breeders_{ std::move(breeder), std::move(spare_breeder) },
+      domain_(domain),
+      replacement_(replacement) {
+  CHECK(population_ != nullptr);
+  for (const auto& breeder : breeders_) {
+    CHECK(breeder != nullptr);
+    CHECK(breeder->size() == population_->size());
+  }
+  CHECK(domain_ != nullptr);
+
+  pool_.setGeneration(population_->generation());
+
+  // there are no children until the first generation
+  next_child_ = population_->size();
+
+  // the initial genotypes are all equally old
+  birth_.resize(population_->size(), 0);
+
+  progress_monitor_ = ProgressManager::progress_monitor_.get();
+  context_ = core::Context::current();
+  context_.set(ProgressManager::progress_monitor_,
+               static_cast<ProgressMonitor*>(&g_null_progress_monitor));
+
+  evaluation_controller_ = make_unique<EvaluationController>(pp::g_controller.get());
+  evaluation_context_ = context_;
+  evaluation_context_.set(pp::g_controller,
+                          static_cast<pp::Controller*>(evaluation_controller_.get()));
+}
+
+SteadyStateEvolution::~SteadyStateEvolution() {
+  {
+    unique_lock<mutex> guard(lock_);
+    shutting_down_ = true;
+  }
+  cv_.notify_all();
+  for (auto& evaluation_thread : evaluation_threads_) {
+    if (evaluation_thread.joinable())
+      evaluation_thread.join();
+  }
+}
+
+bool SteadyStateEvolution::evolveGeneration() {
+  StageScope stage("Evaluate children", population_->size());
+
+  // unfreeze the pool, inserting the children evaluated in the meantime
+  {
+    unique_lock<mutex> guard(lock_);
+    CHECK(inserted_count_ == insertion_limit_);
+    pool_.setGeneration(pool_.generation() + 1);
+    generation_seed_ = evaluationSeed(uint64_t(pool_.generation()));
+    insertion_limit_ += population_->size();
+    size_t inserted = 0;
+    while (inserted < pending_children_.size() && insertionAllowed()) {
+      insertChild(pending_children_[inserted++]);
+    }
+    pending_children_.erase(pending_children_.begin(),
+                            pending_children_.begin() + inserted);
+  }
+
+  // start the evaluators, if needed
+  for (auto& evaluation_thread : evaluation_threads_) {
+    if (!evaluation_thread.joinable())
+      evaluation_thread = thread(&SteadyStateEvolution::evaluationThread, this);
+  }
+
+  // wait for the generation's insertions (while handling the pause/cancel requests),
+  // breeding the next batch of children whenever the evaluators moved on to it
+  unique_lock<mutex> guard(lock_);
+  for (;;) {
+    if (evaluator_error_)
+      std::rethrow_exception(evaluator_error_);
+    if (goal_reached_ || inserted_count_ == insertion_limit_)
+      break;
+    if (!next_batch_ready_) {
+      guard.unlock();
+      breedNextBatch();
+      guard.lock();
+      continue;
+    }
+    cv_.wait_for(guard, chrono::milliseconds(100));
+    guard.unlock();
+    pp::g_controller->checkpoint();
+    guard.lock();
+  }
+  return goal_reached_;
+}
+
+int64_t SteadyStateEvolution::evaluationsCount() const {
+  unique_lock<mutex> guard(lock_);
+  return inserted_count_;
+}
+
+// breeds the children into the breeder which is not handing out children
+// (the evaluators don't touch it until it's marked as ready)
+void SteadyStateEvolution::breedNextBatch() {
+  // the evaluators report their progress to the current stage, so the breeding
+  // doesn't report its own stages (or progress)
+  core::ContextScope context_scope(context_);
+  core::TraceScope trace_scope("breed children", "steady_state");
+
+  Population* breeder = nullptr;
+
+  // the breeder starts from a snapshot of the current pool
+  {
+    unique_lock<mutex> guard(lock_);
+    CHECK(!next_batch_ready_);
+    breeder = breeders_[1 - current_breeder_].get();
+    for (size_t i = 0; i < population_->size(); ++i) {
+      const auto genotype = population_->genotype(i);
+      auto breeder_genotype = breeder->genotype(i);
+      breeder_genotype->load(genotype->save());
+      breeder_genotype->fitness = genotype->fitness;
+    }
+  }
+
+  breeder->createNextGeneration();
+
+  {
+    unique_lock<mutex> guard(lock_);
+    next_batch_ready_ = true;
+  }
+  cv_.notify_all();
+}
+
+// the evaluators are submitted to the thread pool while there are children to evaluate
+void SteadyStateEvolution::evaluationThread() {
+  core::ContextScope context_scope(context_);
+  core::Tracing::setThreadName("Steady-state evaluation");
+
+  auto thread_pool = pp::ParallelForSupport::threadPool();
+  const auto shard_body = [&](int) { evaluateChild(); };
+
+  try {
+    for (;;) {
+      {
+        unique_lock<mutex> guard(lock_);
+        while (!shutting_down_ && !evaluator_error_ && !goal_reached_ &&
+               !childAvailable()) {
+          cv_.wait(guard);
+        }
+        if (shutting_down_ || evaluator_error_ || goal_reached_)
+          return;
+      }
+
+      // blocks while the evolution is paused
+      pp::g_controller->checkpoint();
+
+      pp::WorkBatch batch(thread_pool->threadsCount(), shard_body);
+      thread_pool->processBatch(&batch);
+    }
+  } catch (const pp::CanceledException&) {
+    // the cancellation is handled by the main evolution thread
+  } catch (...) {
+    {
+      unique_lock<mutex> guard(lock_);
+      if (!evaluator_error_)
+        evaluator_error_ = std::current_exception();
+    }
+    cv_.notify_all();
+  }
+}
+
+// a thread pool shard: evaluates the next child, if any, and inserts it into the pool
+// (or sets it aside, if the pool is frozen)
+void SteadyStateEvolution::evaluateChild() {
+  try {
+    // take the next child, moving on to the next batch if the current one is exhausted
+    unique_ptr<Genotype> child;
+    int generation = 0;
+    uint64_t seed = 0;
+    {
+      unique_lock<mutex> guard(lock_);
+      if (shutting_down_ || evaluator_error_ || goal_reached_)
+        return;
+      if (next_child_ == population_->size() && next_batch_ready_) {
+        current_breeder_ = 1 - current_breeder_;
+        next_child_ = 0;
+        next_batch_ready_ = false;
+        cv_.notify_all();
+      }
+      if (next_child_ == population_->size())
+        return;
+      child = breeders_[current_breeder_]->genotype(next_child_++)->clone();
+      generation = pool_.generation();
+      seed = generation_seed_;
+    }
+
+    EvaluatedChild evaluated_child;
+    {
+      core::ContextScope context_scope(evaluation_context_);
+      EvaluationSeedScope seed_scope(seed);
+      SingleGenotype evaluation(child.get(), generation);
+      evaluated_child.goal_reached = domain_->evaluatePopulation(&evaluation);
+    }
+    evaluated_child.json_genotype = child->save();
+    evaluated_child.genotype = std::move(child);
+
+    // insert the evaluated child, unless the pool is frozen
+    {
+      unique_lock<mutex> guard(lock_);
+      if (shutting_down_)
+        return;
+      if (insertionAllowed()) {
+        insertChild(evaluated_child);
+      } else {
+        pending_children_.push_back(std::move(evaluated_child));
+      }
+    }
+    cv_.notify_all();
+  } catch (const pp::CanceledException&) {
+    throw;
+  } catch (...) {
+    {
+      unique_lock<mutex> guard(lock_);
+      if (!evaluator_error_)
+        evaluator_error_ = std::current_exception();
+    }
+    cv_.notify_all();
+  }
+}
+
+// must be called with the lock held
+bool SteadyStateEvolution::childAvailable() const {
+  return next_child_ < population_->size() || next_batch_ready_;
+}
+
+// a paused evolution returns false, which is ignored: the child evaluation completes
+// (and the next evaluations are held back by the evaluation threads)
+void SteadyStateEvolution::EvaluationController::checkpoint() {
+  if (controller_ != nullptr)
+    controller_->tryCheckpoint();
+}
+
+// must be called with the lock held
+bool SteadyStateEvolution::insertionAllowed() const {
+  return inserted_count_ < insertion_limit_ && !goal_reached_;
+}
+
+// must be called with the lock held
+void SteadyStateEvolution::insertChild(const EvaluatedChild& child) {
+  const size_t slot = replacementSlot();
+  auto genotype = population_->genotype(slot);
+  genotype->load(child.json_genotype);
+  genotype->fitness = child.genotype->fitness;
+  genotype->genealogy = child.genotype->genealogy;
+  birth_[slot] = ++births_count_;
+  ++inserted_count_;
+  goal_reached_ = child.goal_reached;
+  if (progress_monitor_ != nullptr)
+    progress_monitor_->reportProgress(1);
+}
+
+// must be called with the lock held
+size_t SteadyStateEvolution::replacementSlot() const {
+  const size_t size = population_->size();
+  const auto fitness = [&](size_t index) {
+    return population_->genotype(index)->fitness;
+  };
+
+  switch (replacement_) {
+    case SteadyStateReplacement::Worst: {
+      // the lowest fitness (the oldest genotype, if there are ties)
+      size_t worst = 0;
+      for (size_t i = 1; i < size; ++i) {
+        if (fitness(i) < fitness(worst) ||
+            (fitness(i) == fitness(worst) && birth_[i] < birth_[worst])) {
+          worst = i;
+        }
+      }
+      return worst;
+    }
+
+    case SteadyStateReplacement::Oldest: {
+      // the oldest genotype, except the current champion
+      size_t champion = 0;
+      for (size_t i = 1; i < size; ++i) {
+        if (fitness(i) > fitness(champion))
+          champion = i;
+      }
+      size_t oldest = champion == 0 && size > 1 ? 1 : 0;
+      for (size_t i = 0; i < size; ++i) {
+        if (i != champion && birth_[i] < birth_[oldest])
+          oldest = i;
+      }
+      return oldest;
+    }
+
+    default:
+      FATAL("Unexpected replacement policy");
+  }
+}
+
+}  // namespace darwin
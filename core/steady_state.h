@@ -0,0 +1,212 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "context.h"
+#include "darwin.h"
+#include "thread_pool.h"
+#include "utils.h"
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace darwin {
+
+enum class SteadyStateReplacement;
+class ProgressMonitor;
+
+//! Asynchronous steady-state evolution (see EvolutionConfig::steady_state)
+//!
+//! A set of evaluators continuously pull new children, evaluate them one at a time and
+//! insert each one into the pool (the evolution population) as soon as it's evaluated,
+//! replacing the worst or the oldest genotype. So a slow evaluation only delays its own
+//! insertion, instead of stalling a whole generation.
+//!
+//! The children are created by the population's own reproduction rules, from a snapshot
+//! of the pool, in batches of `population size` children. There are two breeder
+//! populations: the evaluators take the children from the current batch while the next
+//! one is bred ahead, on the main evolution thread, and they move on to the next batch
+//! as soon as the current one is exhausted.
+//!
+//! A virtual generation is reported after each `population size` insertions. The pool
+//! is frozen while the generation is recorded, but the evaluators don't wait for it:
+//! the children evaluated in the meantime are inserted when the next generation starts.
+//! The children evaluated during a virtual generation share the same test worlds
+//! (see darwin::evaluationSeed()).
+//!
+//! The evaluators run as thread pool work: each shard evaluates a single child, so the
+//! worker threads go back to the queue between the children and share their time with
+//! the domain's own parallel loops and with the breeding. The batches are submitted by
+//! two evaluation threads, so one of them keeps the worker threads busy while the other
+//! waits for its slowest child.
+//!
+//! The children are evaluated under a controller which only handles cancellation, so
+//! the domain's parallel loops (submitted from the worker threads) never block
+//! in a checkpoint. A pause takes effect between the children.
+//!
+//! \note Only domains with independent evaluations are supported
+//!   (see Domain::independentEvaluation())
+//!
+class SteadyStateEvolution : public core::NonCopyable {
+  // the pool, with the virtual generation number
+  class Pool : public Population {
+   public:
+    explicit Pool(Population* population) : population_(population) {}
+
+    size_t size() const override { return population_->size(); }
+    Genotype* genotype(size_t index) override { return population_->genotype(index); }
+    const Genotype* genotype(size_t index) const override {
+      return population_->genotype(index);
+    }
+    vector<size_t> rankingIndex() const override { return population_->rankingIndex(); }
+    int generation() const override { return generation_; }
+    void createPrimordialGeneration(int) override { FATAL("Not supported"); }
+    void createNextGeneration() override { FATAL("Not supported"); }
+
+    void setGeneration(int generation) { generation_ = generation; }
+
+   private:
+    Population* population_ = nullptr;
+
+    // the generation number is also read by Evolution::snapshot()
+    atomic<int> generation_ = 0;
+  };
+
+ public:
+  //! Sets up a steady-state evolution, starting from an evaluated population
+  //!
+  //! \param population - the evaluated population (the pool)
+  //! \param breeder - a population instance used to create the children
+  //! \param spare_breeder - a second population instance (the next batch of children)
+  //! \param domain - the domain used to evaluate the children
+  //! \param replacement - which genotype is replaced by a new child
+  //!
+  //! \note The evaluators inherit the context of the calling thread, except for
+  //!   the progress monitor: the progress is reported once per inserted child
+  //!
+  SteadyStateEvolution(Population* population,
+                       unique_ptr<Population> breeder,
+                       unique_ptr<Population> spare_breeder,
+                       const Domain* domain,
+                       SteadyStateReplacement replacement);
+
+  //! Stops the evaluators (waits for the evaluations in flight)
+  ~SteadyStateEvolution();
+
+  //! Evolves the next virtual generation
+  //!
+  //! Returns after `population size` new children were inserted into the pool, which
+  //! is then frozen until the next call. The evaluators (started by the first call)
+  //! keep evaluating new children in the meantime.
+  //!
+  //! \returns `true` if the evolution goal was reached (see Domain::evaluatePopulation())
+  //! \throws the first exception raised by an evaluator thread, if any
+  //!
+  bool evolveGeneration();
+
+  //! The pool (reporting the virtual generation number)
+  Population* pool() { return &pool_; }
+
+  //! The total number of evaluated children
+  int64_t evaluationsCount() const;
+
+ private:
+  // the controller for the child evaluations: it never blocks (a paused evolution
+  // lets the children in flight complete), but it passes on the cancellation
+  class EvaluationController : public pp::Controller {
+   public:
+    explicit EvaluationController(pp::Controller* controller)
+        : controller_(controller) {}
+
+    void checkpoint() override;
+
+   private:
+    pp::Controller* controller_ = nullptr;
+  };
+
+  // an evaluated child, waiting for the pool to be unfrozen
+  struct EvaluatedChild {
+    unique_ptr<Genotype> genotype;
+    json json_genotype;
+    bool goal_reached = false;
+  };
+
+ private:
+  void breedNextBatch();
+  void evaluationThread();
+  void evaluateChild();
+  bool childAvailable() const;
+  bool insertionAllowed() const;
+  void insertChild(const EvaluatedChild& child);
+  size_t replacementSlot() const;
+
+ private:
+  Pool pool_;
+  Population* population_ = nullptr;
+  unique_ptr<Population> breeders_[2];
+  const Domain* domain_ = nullptr;
+  const SteadyStateReplacement replacement_;
+
+  core::Context context_;
+  ProgressMonitor* progress_monitor_ = nullptr;
+
+  // the context for the child evaluations (context_, with the evaluation controller)
+  unique_ptr<EvaluationController> evaluation_controller_;
+  core::Context evaluation_context_;
+
+  mutable mutex lock_;
+  condition_variable cv_;
+
+  // the breeder handing out the current batch, and the next child to evaluate from it
+  // (the batch is exhausted if next_child_ == size)
+  int current_breeder_ = 0;
+  size_t next_child_ = 0;
+
+  // set when the next batch (the other breeder) is ready
+  bool next_batch_ready_ = false;
+
+  // the test worlds seed for the current virtual generation
+  uint64_t generation_seed_ = 0;
+
+  // the children evaluated while the pool was frozen
+  vector<EvaluatedChild> pending_children_;
+
+  // the number of inserted children, and the limit for the current generation
+  int64_t inserted_count_ = 0;
+  int64_t insertion_limit_ = 0;
+
+  // the insertion order of the genotypes in the pool (for the oldest replacement)
+  vector<int64_t> birth_;
+  int64_t births_count_ = 0;
+
+  bool goal_reached_ = false;
+  bool shutting_down_ = false;
+  exception_ptr evaluator_error_;
+
+  // submit the evaluators to the thread pool (started by the first generation)
+  thread evaluation_threads_[2];
+};
+
+}  // namespace darwin
@@ -20,6 +20,7 @@
 
 #include <assert.h>
 #include <initializer_list>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <string>
@@ -65,6 +66,22 @@ class GenericStringify : public Stringify<T> {
   }
 
   T fromString(const string& str) const override {
+    if constexpr (is_floating_point_v<T>) {
+      // operator<< writes the special values as "inf", "-inf" or "nan",
+      // which can't be parsed back by operator>>
+      stringstream ss(str);
+      string token;
+      ss >> token >> std::ws;
+      if (ss.eof()) {
+        if (token == "inf" || token == "+inf")
+          return numeric_limits<T>::infinity();
+        if (token == "-inf")
+          return -numeric_limits<T>::infinity();
+        if (token == "nan" || token == "-nan")
+          return numeric_limits<T>::quiet_NaN();
+      }
+    }
+
     stringstream ss(str);
     T value = {};
     ss >> std::boolalpha >> value;
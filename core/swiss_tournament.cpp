@@ -21,17 +21,28 @@
 
 #include <algorithm>
 #include <random>
+#include <utility>
 #include <vector>
 using namespace std;
 
 namespace tournament {
 
-class SwissTournament::PairingLog {
+namespace {
+
+struct Pairing {
+  int p1 = -1;
+  int p2 = -1;
+};
+
+// the pairings played so far
+//
+// (a player only meets `rounds` opponents, so short per-player lists are faster to
+// search than a hashed set of pairs)
+//
+class PairingLog {
  public:
-  PairingLog(size_t population_size) : log_(population_size) {}
+  explicit PairingLog(size_t population_size) : log_(population_size) {}
 
-  // calling it with different players (p1', p2') pairs
-  // doesn't result in a data race
   void recordPairing(int p1, int p2) {
     CHECK(p1 != p2);
     if (p1 > p2) {
@@ -40,6 +51,7 @@ class SwissTournament::PairingLog {
     log_[p1].push_back(p2);
   }
 
+  // safe to call concurrently (as long as there are no concurrent updates)
   bool alreadyPaired(int p1, int p2) const {
     if (p1 > p2) {
       std::swap(p1, p2);
@@ -57,17 +69,104 @@ class SwissTournament::PairingLog {
   vector<vector<int>> log_;
 };
 
+// a range of consecutive ranked players, paired independently
+struct PairingGroup {
+  size_t begin = 0;
+  size_t end = 0;
+  vector<Pairing> pairings;
+  vector<int> unpaired;
+};
+
+// the pairing groups are built from whole score groups (players with the same
+// score), unless a score group is larger than kMaxGroupSize
+constexpr size_t kMinGroupSize = 256;
+constexpr size_t kMaxGroupSize = kMinGroupSize * 4;
+
+// the pairing of two players, with the weaker ranked player making the first move
+// (ranks[p] is the position of player p in the current ranking)
+Pairing rankedPairing(int p1, int p2, const vector<int>& ranks) {
+  return ranks[p1] > ranks[p2] ? Pairing{ p1, p2 } : Pairing{ p2, p1 };
+}
+
+// tries to avoid a rematch between p1 and p2 by swapping opponents with
+// one of the existing pairings (starting with the most recent ones)
+bool swapOpponents(int p1,
+                   int p2,
+                   const PairingLog& pairing_log,
+                   const vector<int>& ranks,
+                   vector<Pairing>* pairings) {
+  for (auto it = pairings->rbegin(); it != pairings->rend(); ++it) {
+    const int a = it->p1;
+    const int b = it->p2;
+    if (!pairing_log.alreadyPaired(p1, a) && !pairing_log.alreadyPaired(p2, b)) {
+      *it = rankedPairing(p1, a, ranks);
+      pairings->push_back(rankedPairing(p2, b, ranks));
+      return true;
+    }
+    if (!pairing_log.alreadyPaired(p1, b) && !pairing_log.alreadyPaired(p2, a)) {
+      *it = rankedPairing(p1, b, ranks);
+      pairings->push_back(rankedPairing(p2, a, ranks));
+      return true;
+    }
+  }
+  return false;
+}
+
+// greedy pairing of the ranked players: each player is paired with the next ranked
+// player it hasn't played yet. If there's no such opponent, the player is
+// either left unpaired or, if allow_rematches is true, paired with the next player
+// (unless the rematch can be avoided by swapping opponents with an existing pairing)
+//
+// returns the number of unintentional rematches
+//
+int pairPlayers(vector<int> players,
+                const PairingLog& pairing_log,
+                const vector<int>& ranks,
+                bool allow_rematches,
+                vector<Pairing>* pairings,
+                vector<int>* unpaired) {
+  int unintentional_rematches = 0;
+  for (size_t i = 0; i < players.size();) {
+    const int p1 = players[i++];
+    // find the first opponent which hasn't already been paired with p1
+    bool found_new_opponent = false;
+    for (size_t j = i; j < players.size(); ++j) {
+      if (!pairing_log.alreadyPaired(p1, players[j])) {
+        std::swap(players[i], players[j]);
+        found_new_opponent = true;
+        break;
+      }
+    }
+
+    if (!found_new_opponent) {
+      if (!allow_rematches || i == players.size()) {
+        unpaired->push_back(p1);
+        continue;
+      }
+      if (swapOpponents(p1, players[i], pairing_log, ranks, pairings)) {
+        ++i;
+        continue;
+      }
+      ++unintentional_rematches;
+    }
+
+    const int p2 = players[i++];
+
+    // note that we setup the game in reverse order,
+    // so p2 (ranked weaker) will make the first move
+    pairings->push_back({ p2, p1 });
+  }
+  return unintentional_rematches;
+}
+
+}  // namespace
+
 SwissTournament::SwissTournament(const core::PropertySet& config) {
   config_.copyFrom(config);
 }
 
 void SwissTournament::evaluatePopulation(darwin::Population* population,
                                          GameRules* game_rules) {
-  struct Pairing {
-    int p1 = -1;
-    int p2 = -1;
-  };
-
   if (population->size() % 2 != 0)
     throw core::Exception("Swiss tournament requires an even population size");
 
@@ -80,6 +179,11 @@ void SwissTournament::evaluatePopulation(darwin::Population* population,
     pairing_index[i] = i;
   }
 
+  vector<float> scores(population->size());
+
+  // the ranking position of each player (the inverse of the pairing index)
+  vector<int> ranks(population->size());
+
   // reset fitness values
   for (size_t i = 0; i < population->size(); ++i) {
     population->genotype(i)->fitness = 0;
@@ -87,6 +191,8 @@ void SwissTournament::evaluatePopulation(darwin::Population* population,
 
   PairingLog pairing_log(population->size());
 
+  const BrainCache brains(population, game_rules);
+
   darwin::StageScope stage("Tournament", config_.rounds);
   for (int round = 0; round < config_.rounds; ++round) {
     vector<Pairing> pairings;
@@ -95,36 +201,66 @@ void SwissTournament::evaluatePopulation(darwin::Population* population,
     {
       darwin::StageScope stage("Pairing");
 
+      // a snapshot of the current scores (cheaper to sort than the genotypes)
+      for (size_t i = 0; i < scores.size(); ++i) {
+        scores[i] = population->genotype(i)->fitness;
+      }
+
       if (round == 0) {
         // random pairings for the first round
         std::shuffle(pairing_index.begin(), pairing_index.end(), rnd);
       } else {
         std::sort(pairing_index.begin(), pairing_index.end(), [&](int a, int b) {
-          return population->genotype(a)->fitness > population->genotype(b)->fitness;
+          return scores[a] > scores[b];
         });
       }
 
-      for (size_t i = 0; i < pairing_index.size();) {
-        const int p1 = pairing_index[i++];
-        // find the first opponent which hasn't already been paired with p1
-        bool found_new_opponent = false;
-        for (size_t j = i; j < pairing_index.size(); ++j) {
-          if (!pairing_log.alreadyPaired(p1, pairing_index[j])) {
-            std::swap(pairing_index[i], pairing_index[j]);
-            found_new_opponent = true;
+      for (int i = 0; i < int(pairing_index.size()); ++i) {
+        ranks[pairing_index[i]] = i;
+      }
+
+      // split the ranked players into groups
+      vector<PairingGroup> groups;
+      for (size_t begin = 0; begin < pairing_index.size();) {
+        size_t end = begin + 1;
+        for (; end < pairing_index.size(); ++end) {
+          const size_t group_size = end - begin;
+          const bool same_score =
+              scores[pairing_index[end]] == scores[pairing_index[end - 1]];
+          if (group_size >= kMaxGroupSize || (group_size >= kMinGroupSize && !same_score))
             break;
-          }
         }
-        const int p2 = pairing_index[i++];
+        groups.push_back(PairingGroup{ begin, end, {}, {} });
+        begin = end;
+      }
+
+      // pair the players within each group (in parallel)
+      pp::for_each(groups, [&](int, PairingGroup& group) {
+        vector<int> players(pairing_index.begin() + group.begin,
+                            pairing_index.begin() + group.end);
+        pairPlayers(std::move(players),
+                    pairing_log,
+                    ranks,
+                    false,
+                    &group.pairings,
+                    &group.unpaired);
+      });
+
+      // the players left unpaired (in ranking order) are paired across the groups
+      vector<int> unpaired;
+      for (auto& group : groups) {
+        pairings.insert(pairings.end(), group.pairings.begin(), group.pairings.end());
+        unpaired.insert(unpaired.end(), group.unpaired.begin(), group.unpaired.end());
+      }
 
-        // note that we setup the game in reverse order,
-        // so p2 (ranked weaker) will make the first move
-        pairings.push_back({ p2, p1 });
+      vector<int> not_paired;
+      unintentional_rematches = pairPlayers(
+          std::move(unpaired), pairing_log, ranks, true, &pairings, &not_paired);
+      CHECK(not_paired.empty());
 
-        if (found_new_opponent) {
-          pairing_log.recordPairing(p2, p1);
-        } else {
-          ++unintentional_rematches;
+      for (const auto& pairing : pairings) {
+        if (!pairing_log.alreadyPaired(pairing.p1, pairing.p2)) {
+          pairing_log.recordPairing(pairing.p1, pairing.p2);
         }
       }
     }
@@ -134,20 +270,24 @@ void SwissTournament::evaluatePopulation(darwin::Population* population,
 
     {
       darwin::StageScope stage("Tournament round", pairings.size());
+      // each player is part of a single pairing, so the brains don't need locking
       pp::for_each(pairings, [&](int, const Pairing& pairing) {
+        auto p1 = brains.contestant(pairing.p1);
+        auto p2 = brains.contestant(pairing.p2);
         auto p1_genotype = population->genotype(pairing.p1);
         auto p2_genotype = population->genotype(pairing.p2);
 
         const float score_scale = 1.0f / (config_.rounds * (config_.rematches ? 2 : 1));
 
-        auto outcome = game_rules->play(p1_genotype, p2_genotype);
+        auto outcome = game_rules->play(p1, p2);
         auto scores = game_rules->scores(outcome);
         p1_genotype->fitness += scores.player1_score * score_scale;
         p2_genotype->fitness += scores.player2_score * score_scale;
 
         if (config_.rematches) {
+          std::swap(p1, p2);
           std::swap(p1_genotype, p2_genotype);
-          auto rematch_outcome = game_rules->play(p1_genotype, p2_genotype);
+          auto rematch_outcome = game_rules->play(p1, p2);
           auto rematch_scores = game_rules->scores(rematch_outcome);
           p1_genotype->fitness += rematch_scores.player1_score * score_scale;
           p2_genotype->fitness += rematch_scores.player2_score * score_scale;
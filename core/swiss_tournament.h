@@ -28,8 +28,6 @@ struct SwissTournamentConfig : public core::PropertySet {
 
 //! [Swiss-style tournament](https://en.wikipedia.org/wiki/Swiss-system_tournament)
 class SwissTournament : public Tournament {
-  class PairingLog;
-  
  public:
   explicit SwissTournament(const core::PropertySet& config);
 
@@ -13,16 +13,31 @@
 // limitations under the License.
 
 #include "thread_pool.h"
+#include "format.h"
 #include "logging.h"
+#include "perf_counters.h"
+#include "platform_abstraction_layer.h"
+#include "scope_guard.h"
+#include "tracing.h"
 
 namespace pp {
 
 atomic<ThreadPool*> ParallelForSupport::thread_pool_ = nullptr;
 
-ThreadPool::ThreadPool(int threads_count, Controller* controller)
-    : controller_(controller) {
+core::ContextSlot<Controller> g_controller;
+
+ThreadPool::ThreadPool(int threads_count, Controller* controller, ThreadAffinity affinity)
+    : controller_(controller), affinity_(affinity) {
   CHECK(threads_count > 0 || threads_count == kAutoThreadCount);
 
+  if (threads_count == kAutoThreadCount) {
+    if (const char* env_threads = getenv("DARWIN_THREADS")) {
+      threads_count = atoi(env_threads);
+      if (threads_count < 1)
+        throw core::Exception("Invalid DARWIN_THREADS value: '%s'", env_threads);
+    }
+  }
+
   if (threads_count == kAutoThreadCount) {
     // number of threads per core
     // TODO: review/evaluate if a different value makes more sense (1.2?)
@@ -37,75 +52,271 @@ ThreadPool::ThreadPool(int threads_count, Controller* controller)
     core::log("New thread pool: using %d thread(s)\n", threads_count);
   }
 
+  if (affinity_ != ThreadAffinity::None) {
+    numa_nodes_ = pal::numaNodes();
+    core::log("Thread affinity: %s (%d NUMA node(s))\n",
+              core::toString(affinity_).c_str(),
+              int(numa_nodes_.size()));
+  }
+
   for (int i = 0; i < threads_count; ++i) {
-    worker_threads_.emplace_back(&ThreadPool::workerThread, this);
+    worker_threads_.emplace_back(&ThreadPool::workerThread, this, i);
   }
 }
 
-void ThreadPool::processBatch(unique_ptr<WorkBatch> batch) {
-  unique_lock<mutex> guard(lock_);
+ThreadPool::~ThreadPool() {
+  {
+    unique_lock<mutex> guard(lock_);
+    CHECK(batches_.empty());
+    shutting_down_ = true;
+    queue_cv_.notify_all();
+  }
 
-  CHECK(!worker_threads_.empty());
+  for (auto& worker_thread : worker_threads_) {
+    worker_thread.join();
+  }
+}
 
-  CHECK(!batch->canceled);
-  CHECK(batch->work_left == 0);
-  batch->work_left = batch->work_items.size();
-  CHECK(batch->work_left > 0);
+void ThreadPool::processBatch(WorkBatch* batch) {
+  CHECK(batch != nullptr);
 
-  if (work_items_.empty())
-    queue_cv_.notify_all();
+  {
+    unique_lock<mutex> guard(lock_);
+
+    CHECK(!worker_threads_.empty());
 
-  // push all work items from the batch
-  for (auto& work_item : batch->work_items) {
-    CHECK(work_item->batch() == batch.get());
-    work_items_.push_back(std::move(work_item));
+    CHECK(!batch->canceled_);
+    CHECK(batch->partitions_count_ == 0);
+    CHECK(batch->work_left_ == 0);
+
+    batch->context_ = core::Context::current();
+    batch->controller_ = g_controller.get();
+    if (batch->controller_ == nullptr)
+      batch->controller_ = controller_;
+
+    // split the shards into contiguous partitions, one for each NUMA node
+    const int shards_count = batch->shards_count_;
+    const int partitions_count =
+        min({ nodesCount(), WorkBatch::kMaxPartitions, shards_count });
+    for (int i = 0; i < partitions_count; ++i) {
+      batch->next_shard_[i] = int(int64_t(shards_count) * i / partitions_count);
+      batch->end_shard_[i] = int(int64_t(shards_count) * (i + 1) / partitions_count);
+    }
+    batch->partitions_count_ = partitions_count;
+    batch->unclaimed_ = shards_count;
+    batch->work_left_ = shards_count;
+
+    // (the queue may hold paused batches only, so the workers are always notified)
+    batches_.push_back(batch);
+    queue_cv_.notify_all();
   }
-  batch->work_items.clear();
 
-  // wait for the completition of all work items in the batch
-  while (batch->work_left > 0)
-    results_cv_.wait(guard);
+  {
+    // wait for the completition of the shards claimed by the worker threads
+    // (the batch must outlive its shards, even if a shard throws on this thread)
+    SCOPE_EXIT {
+      unique_lock<mutex> guard(lock_);
+      // if a shard threw on this thread, the unclaimed shards are dropped
+      if (batch->unclaimed_ > 0) {
+        auto it = find(batches_.begin(), batches_.end(), batch);
+        if (it != batches_.end())
+          batches_.erase(it);
+        batch->work_left_ -= batch->unclaimed_;
+        batch->unclaimed_ = 0;
+        batch->deferred_shards_.clear();
+      }
+      while (batch->work_left_ > 0)
+        results_cv_.wait(guard);
+    };
+
+    // help with the batch shards, while there are any left
+    // (including the shards deferred by the worker threads)
+    int shard = 0;
+    while (acquireShard(batch, &shard)) {
+      executeShard(batch, shard, true);
+    }
+  }
 
-  if (batch->canceled)
+  if (batch->canceled_)
     throw CanceledException();
 }
 
-void ThreadPool::executeOneItem() {
-  auto work_item = acquireWork();
+// the worker threads never block in a checkpoint: if the batch is paused, the shard
+// is handed back to the submitting thread (which blocks in the checkpoint instead)
+void ThreadPool::executeShard(WorkBatch* batch, int shard, bool submitting_thread) {
+  bool deferred = false;
+  SCOPE_EXIT {
+    if (!deferred)
+      finishedWork(batch);
+  };
+
+  core::ContextScope context_scope(batch->context_);
 
   try {
-    if (controller_ != nullptr)
-      controller_->checkpoint();
+    if (auto controller = batch->controller_) {
+      if (submitting_thread) {
+        controller->checkpoint();
+        if (batch->deferred_)
+          resumeBatch(batch);
+      } else if (!controller->tryCheckpoint()) {
+        deferShard(batch, shard);
+        deferred = true;
+        return;
+      }
+    }
 
-    work_item->execute();
+    core::TraceScope trace_scope("work item", "pp");
+    batch->run_shard_(batch->shard_body_, shard);
   } catch (const CanceledException&) {
-    work_item->batch()->canceled = true;
+    batch->canceled_ = true;
   }
-
-  finishedWork(work_item->batch());
 }
 
-unique_ptr<WorkItem> ThreadPool::acquireWork() {
+// worker threads: claims the next shard from the first batch in the queue which
+// is not paused, then moves the batch to the back of the queue (round-robin between
+// batches). Returns nullptr if the thread pool is shutting down
+WorkBatch* ThreadPool::acquireWork(int node, int* shard) {
   unique_lock<mutex> guard(lock_);
-  while (work_items_.empty())
+  auto it = batches_.end();
+  for (;;) {
+    it = find_if(batches_.begin(), batches_.end(), [](const WorkBatch* batch) {
+      return !batch->deferred_;
+    });
+    if (it != batches_.end())
+      break;
+    if (shutting_down_)
+      return nullptr;
     queue_cv_.wait(guard);
-  auto work_item = std::move(work_items_.back());
-  work_items_.pop_back();
-  return work_item;
+  }
+  auto batch = *it;
+  claimShard(batch, node, shard);
+  if (batches_.size() > 1) {
+    it = find(batches_.begin(), batches_.end(), batch);
+    if (it != batches_.end()) {
+      batches_.erase(it);
+      batches_.push_back(batch);
+    }
+  }
+  return batch;
+}
+
+// the submitting thread: claims the next shard from its own batch, if any left
+// (the submitting thread is not pinned, so it simply starts with the first partition)
+//
+// it also waits for the shards claimed by the worker threads, since they may
+// be handed back (see Controller::tryCheckpoint())
+//
+bool ThreadPool::acquireShard(WorkBatch* batch, int* shard) {
+  unique_lock<mutex> guard(lock_);
+  while (batch->unclaimed_ == 0 && batch->work_left_ > 0)
+    results_cv_.wait(guard);
+  if (batch->unclaimed_ == 0)
+    return false;
+  claimShard(batch, 0, shard);
+  return true;
+}
+
+// a worker thread hands a shard back (the batch is paused)
+void ThreadPool::deferShard(WorkBatch* batch, int shard) {
+  unique_lock<mutex> guard(lock_);
+  batch->deferred_shards_.push_back(shard);
+  batch->deferred_ = true;
+  if (batch->unclaimed_++ == 0) {
+    batches_.push_back(batch);
+    queue_cv_.notify_all();
+  }
+  results_cv_.notify_all();
+}
+
+// the submitting thread passed a checkpoint, so the worker threads can resume
+void ThreadPool::resumeBatch(WorkBatch* batch) {
+  unique_lock<mutex> guard(lock_);
+  batch->deferred_ = false;
+  queue_cv_.notify_all();
+}
+
+// claims the next shard from the node's own partition, if any left, otherwise
+// steals the last shard from the partition with the most unclaimed shards
+//
+// a batch stays in the queue only as long as it has unclaimed shards
+// (must be called with the lock held)
+void ThreadPool::claimShard(WorkBatch* batch, int node, int* shard) {
+  CHECK(batch->unclaimed_ > 0);
+  const int partition = node % batch->partitions_count_;
+  if (!batch->deferred_shards_.empty()) {
+    *shard = batch->deferred_shards_.back();
+    batch->deferred_shards_.pop_back();
+  } else if (batch->next_shard_[partition] < batch->end_shard_[partition]) {
+    *shard = batch->next_shard_[partition]++;
+  } else {
+    int victim = -1;
+    int victim_unclaimed = 0;
+    for (int i = 0; i < batch->partitions_count_; ++i) {
+      const int unclaimed = batch->end_shard_[i] - batch->next_shard_[i];
+      if (unclaimed > victim_unclaimed) {
+        victim = i;
+        victim_unclaimed = unclaimed;
+      }
+    }
+    CHECK(victim != -1);
+    *shard = --batch->end_shard_[victim];
+  }
+  if (--batch->unclaimed_ == 0) {
+    auto it = find(batches_.begin(), batches_.end(), batch);
+    CHECK(it != batches_.end());
+    batches_.erase(it);
+  }
 }
 
 void ThreadPool::finishedWork(WorkBatch* batch) {
   CHECK(batch != nullptr);
 
   unique_lock<mutex> guard(lock_);
-  CHECK(batch->work_left > 0);
-  if (--batch->work_left == 0)
+  CHECK(batch->work_left_ > 0);
+  if (--batch->work_left_ == 0)
     results_cv_.notify_all();
 }
 
-void ThreadPool::workerThread() {
+// worker `i` is placed on the NUMA node `i % nodes_count`
+void ThreadPool::placeWorkerThread(int worker_index) {
+  if (numa_nodes_.empty())
+    return;
+
+  const int nodes_count = int(numa_nodes_.size());
+  const auto& node_cpus = numa_nodes_[worker_index % nodes_count];
+
+  bool placed = false;
+  switch (affinity_) {
+    case ThreadAffinity::Cores: {
+      const int cpu = node_cpus[(worker_index / nodes_count) % node_cpus.size()];
+      placed = pal::setThreadAffinity({ cpu });
+      break;
+    }
+    case ThreadAffinity::NumaNodes:
+      placed = pal::setThreadAffinity(node_cpus);
+      break;
+    default:
+      FATAL("Unexpected thread affinity");
+  }
+
+  if (!placed && worker_index == 0)
+    core::log("Thread affinity is not supported, ignored\n");
+}
+
+void ThreadPool::workerThread(int worker_index) {
+  core::Tracing::setThreadName(core::format("Worker #%d", worker_index));
+  core::PerfCounters::registerThread();
+  SCOPE_EXIT { core::PerfCounters::unregisterThread(); };
+
+  placeWorkerThread(worker_index);
+
+  const int node = worker_index % nodesCount();
   for (;;) {
-    executeOneItem();
+    int shard = 0;
+    auto batch = acquireWork(node, &shard);
+    if (batch == nullptr)
+      break;
+    executeShard(batch, shard, false);
   }
 }
 
@@ -14,6 +14,8 @@
 
 #pragma once
 
+#include "context.h"
+#include "stringify.h"
 #include "utils.h"
 
 #include <assert.h>
@@ -32,69 +34,101 @@ using namespace std;
 
 namespace pp {
 
-struct WorkBatch;
+class Controller;
 
-//! Generic work item interface
-//! \sa WorkBatch
-class WorkItem {
- public:
-  WorkItem(WorkBatch* batch) : batch_(batch) {}
-  virtual ~WorkItem() = default;
-  
-  //! Runs the work item implementation
-  virtual bool execute() = 0;
+//! Worker threads placement
+enum class ThreadAffinity {
+  None,       //!< No explicit placement, the OS scheduler decides
+  Cores,      //!< Each worker thread is pinned to a single logical CPU
+  NumaNodes,  //!< Worker threads are distributed (round-robin) across the NUMA nodes
+};
 
-  //! The associated (parent) WorkBatch
-  WorkBatch* batch() const { return batch_; }
+inline auto customStringify(core::TypeTag<ThreadAffinity>) {
+  static auto stringify = new core::StringifyKnownValues<ThreadAffinity>{
+    { ThreadAffinity::None, "none" },
+    { ThreadAffinity::Cores, "cores" },
+    { ThreadAffinity::NumaNodes, "numa_nodes" },
+  };
+  return stringify;
+}
 
- private:
-  // parent work batch
-  WorkBatch* const batch_ = nullptr;
-};
+//! A set of work shards to be processed in a fork/join fashion
+//!
+//! The shards are identified by their index, in the [0, shards_count) range,
+//! and they are all executed by the same (shared) shard body, so submitting
+//! a batch doesn't allocate any memory.
+//!
+//! The uses must follow the pattern:
+//!  1. Create a WorkBatch instance (normally on the stack)
+//!  2. Call ThreadPool::processBatch()
+//!
+//! The context of the submitting thread (core::Context) is captured by processBatch()
+//! and installed on the threads executing the batch shards.
+//!
+//! If the thread pool spans multiple NUMA nodes, the shards are split into contiguous
+//! partitions, one per node, and the worker threads prefer the shards from their own
+//! node's partition. So, for example, a genotype created (first-touched) by the shard
+//! `i` of a loop will likely be evaluated on the same node by the shard `i` of a later
+//! loop over the same population.
+//!
+//! \sa ThreadPool
+//!
+class WorkBatch : public core::NonCopyable {
+  friend class ThreadPool;
+
+  // the max number of shard partitions (NUMA nodes beyond this share partitions)
+  static constexpr int kMaxPartitions = 8;
 
-// A work item wrapping a closure object (aka function objects)
-template <class Body>
-class ClosureWorkItem : public WorkItem {
  public:
-  ClosureWorkItem(WorkBatch* batch, const Body& item_body)
-      : WorkItem(batch), item_body_(item_body) {}
+  //! Creates a batch of shards, each executed as `shard_body(shard_index)`
+  //! \note The shard body is not copied, so it must outlive the batch
+  template <class Body>
+  WorkBatch(int shards_count, const Body& shard_body)
+      : shards_count_(shards_count),
+        shard_body_(&shard_body),
+        run_shard_(&runShard<Body>) {
+    CHECK(shards_count > 0);
+  }
 
-  bool execute() override {
-    item_body_();
-    return true;
+  //! The number of shards
+  int shardsCount() const { return shards_count_; }
+
+  //! Cancellation support
+  bool canceled() const { return canceled_; }
+
+ private:
+  template <class Body>
+  static void runShard(const void* shard_body, int shard) {
+    (*static_cast<const Body*>(shard_body))(shard);
   }
 
  private:
-  Body item_body_;
-};
+  const int shards_count_;
+  const void* const shard_body_;
+  void (*const run_shard_)(const void* shard_body, int shard);
 
-//! A collection of work items to be processed in a fork/join fashion
-//! 
-//! The uses must follow the pattern: 
-//!  1. Create an WorkBatch instance
-//!  2. Populate it using pushWork()
-//!  3. Call ThreadPool::processBatch()
-//! 
-//! \sa WorkItem
-//! \sa ThreadPool
-//! 
-struct WorkBatch {
-  //! The set of work items to be processed
-  vector<unique_ptr<WorkItem>> work_items;
+  // the context of the submitting thread
+  core::Context context_;
+  Controller* controller_ = nullptr;
 
-  //! Used by the work queue to track the progress
-  size_t work_left = 0;
+  // used by the thread pool to track the progress (guarded by ThreadPool::lock_)
+  int partitions_count_ = 0;
+  int next_shard_[kMaxPartitions] = {};
+  int end_shard_[kMaxPartitions] = {};
+  int unclaimed_ = 0;
+  int work_left_ = 0;
 
-  //! Cancellation support
-  atomic<bool> canceled = false;
+  // the shards handed back by the worker threads (see Controller::tryCheckpoint())
+  vector<int> deferred_shards_;
 
-  //! Appends a new WorkItem
-  template <class Body>
-  void pushWork(const Body& body) {
-    work_items.emplace_back(make_unique<ClosureWorkItem<Body>>(this, body));
-  }
+  // set while the batch is paused: the worker threads skip it until the submitting
+  // thread passes a checkpoint (written with ThreadPool::lock_ held)
+  atomic<bool> deferred_ = false;
+
+  atomic<bool> canceled_ = false;
 };
 
+//! Thrown from processBatch() if the batch was canceled
 class CanceledException {};
 
 //! An optional thread pool controller, which can be used to
@@ -108,19 +142,42 @@ class Controller {
  public:
   virtual ~Controller() = default;
 
-  //! Controller interface, called from the worker threads.
+  //! Controller interface, called from the threads submitting the batches
   //!
   //! Implementations may:
-  //! - Return (ie. allow worker threads to run)
-  //! - Block (ie. pause worker threads)
+  //! - Return (ie. allow the work to continue)
+  //! - Block (ie. pause the work)
   //! - Throw CanceledException
   //!
   virtual void checkpoint() = 0;
+
+  //! The non-blocking checkpoint, called from the thread pool worker threads
+  //!
+  //! Returns false if the work should be paused, in which case the thread pool
+  //! hands the shard back to the submitting thread (so a paused batch doesn't hold
+  //! any of the shared worker threads). It may also throw CanceledException.
+  //!
+  //! The default implementation simply calls checkpoint()
+  //!
+  virtual bool tryCheckpoint() {
+    checkpoint();
+    return true;
+  }
 };
 
+//! The controller for the batches submitted from the current context, if any
+//! (overrides the thread pool controller, see core::ContextSlot)
+extern core::ContextSlot<Controller> g_controller;
+
 //! A basic thread pool (managing a fixed number of threads)
-//! 
-//! \sa WorkItem
+//!
+//! The thread submitting a batch also executes shards from it, so it doesn't
+//! sit idle waiting for the workers.
+//!
+//! The worker threads take turns between the queued batches (one shard at a time),
+//! so concurrent batches (ex. from independent experiments sharing the thread pool)
+//! get a fair share of the workers.
+//!
 //! \sa WorkBatch
 //! \sa Controller
 //! 
@@ -132,28 +189,62 @@ class ThreadPool : public core::NonCopyable {
  public:
   //! Creates a new thread pool
   //! 
-  //! \param threads_count - the count of threads, or kAutoThreadCount
+  //! \param threads_count - the count of threads, or kAutoThreadCount (which uses
+  //!   the `DARWIN_THREADS` environment variable, if set, or the number of cores)
   //! \param controller - an optional thread pool controller
+  //! \param affinity - the worker threads placement
   //! 
-  ThreadPool(int threads_count, Controller* controller = nullptr);
+  ThreadPool(int threads_count,
+             Controller* controller = nullptr,
+             ThreadAffinity affinity = ThreadAffinity::None);
+
+  //! Stops and joins the worker threads
+  //! \note There must be no batches in flight
+  ~ThreadPool();
 
-  //! Queues the work items in the specified batch and waits for completition
+  //! Queues the shards in the specified batch and waits for completition
+  //!
+  //! The calling thread helps executing the shards, until all of them are claimed.
+  //! Different threads can submit batches concurrently.
+  //!
   //! \sa WorkBatch
-  void processBatch(unique_ptr<WorkBatch> batch);
+  //!
+  void processBatch(WorkBatch* batch);
 
   //! The number of threads managed by this thread pool
   int threadsCount() const { return int(worker_threads_.size()); }
 
+  //! The worker threads placement
+  ThreadAffinity affinity() const { return affinity_; }
+
+  //! The number of NUMA nodes spanned by the worker threads
+  int nodesCount() const { return max(1, int(numa_nodes_.size())); }
+
+  //! The associated controller (or nullptr)
+  //! \sa g_controller
+  Controller* controller() const { return controller_; }
+
  private:
-  void executeOneItem();
-  unique_ptr<WorkItem> acquireWork();
+  void executeShard(WorkBatch* batch, int shard, bool submitting_thread);
+  void deferShard(WorkBatch* batch, int shard);
+  void resumeBatch(WorkBatch* batch);
+  WorkBatch* acquireWork(int node, int* shard);
+  bool acquireShard(WorkBatch* batch, int* shard);
+  void claimShard(WorkBatch* batch, int node, int* shard);
   void finishedWork(WorkBatch* batch);
-  void workerThread();
+  void workerThread(int worker_index);
+  void placeWorkerThread(int worker_index);
 
  private:
-  deque<unique_ptr<WorkItem>> work_items_;
+  // the batches with unclaimed shards
+  deque<WorkBatch*> batches_;
   vector<thread> worker_threads_;
   Controller* controller_ = nullptr;
+  bool shutting_down_ = false;
+
+  // the logical CPUs for each NUMA node (empty if there's no explicit placement)
+  const ThreadAffinity affinity_;
+  vector<vector<int>> numa_nodes_;
 
   mutable mutex lock_;
   mutable condition_variable queue_cv_;
@@ -162,11 +253,25 @@ class ThreadPool : public core::NonCopyable {
 
 class ParallelForSupport {
  public:
-  static void init(Controller* controller) {
-    auto thread_pool = make_unique<ThreadPool>(ThreadPool::kAutoThreadCount, controller);
+  static void init(Controller* controller,
+                   int threads_count = ThreadPool::kAutoThreadCount,
+                   ThreadAffinity affinity = ThreadAffinity::None) {
+    auto thread_pool = make_unique<ThreadPool>(threads_count, controller, affinity);
     CHECK(thread_pool_.exchange(thread_pool.release()) == nullptr);
   }
 
+  //! Replaces the thread pool with a new one (using the same controller)
+  //! \warning The caller must ensure that the current thread pool is idle, and that
+  //!   there are no other users of the thread pool (ex. Evolution::create() instances)
+  static void reconfigure(int threads_count, ThreadAffinity affinity) {
+    auto old_thread_pool = thread_pool_.load();
+    CHECK(old_thread_pool != nullptr);
+    auto thread_pool =
+        make_unique<ThreadPool>(threads_count, old_thread_pool->controller(), affinity);
+    CHECK(thread_pool_.exchange(thread_pool.release()) == old_thread_pool);
+    delete old_thread_pool;
+  }
+
   static ThreadPool* threadPool() { return thread_pool_; }
 
  private:
@@ -0,0 +1,71 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tournament.h"
+
+#include <core/evolution.h>
+#include <core/parallel_for_each.h>
+
+#include <algorithm>
+using namespace std;
+
+namespace tournament {
+
+BrainCache::BrainCache(const darwin::Population* population,
+                       const GameRules* game_rules)
+    : population_(population),
+      brains_(population->size()) {
+  darwin::StageScope stage("Ontogenesis", brains_.size());
+  pp::for_each(brains_, [&](int index, unique_ptr<darwin::Brain>& brain) {
+    brain = game_rules->growBrain(population_->genotype(index));
+    CHECK(brain);
+    darwin::ProgressManager::reportProgress();
+  });
+}
+
+Contestant BrainCache::contestant(size_t index) const {
+  return { population_->genotype(index), brains_[index].get() };
+}
+
+ReplicatedBrain::ReplicatedBrain(const darwin::Genotype* genotype,
+                                 const GameRules* game_rules)
+    : genotype_(genotype), game_rules_(game_rules) {
+  CHECK(genotype_ != nullptr);
+  CHECK(game_rules_ != nullptr);
+}
+
+void ReplicatedBrain::playGames(
+    int games,
+    const function<void(int, const Contestant&)>& play_game) {
+  // one sequence of games for each worker thread (plus the submitting thread)
+  const int threads = pp::ParallelForSupport::threadPool()->threadsCount() + 1;
+  const int sequences = min(games, threads);
+  if (int(brains_.size()) < sequences)
+    brains_.resize(sequences);
+
+  vector<int> sequence_index(sequences);
+  pp::for_each(sequence_index, [&](int sequence, int&) {
+    auto& brain = brains_[sequence];
+    if (!brain) {
+      brain = game_rules_->growBrain(genotype_);
+      CHECK(brain);
+    }
+    const Contestant contestant{ genotype_, brain.get() };
+    for (int game = sequence; game < games; game += sequences) {
+      play_game(game, contestant);
+    }
+  });
+}
+
+}  // namespace tournament
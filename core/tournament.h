@@ -18,6 +18,11 @@
 #include <core/utils.h>
 #include <core/properties.h>
 
+#include <functional>
+#include <memory>
+#include <vector>
+using namespace std;
+
 namespace tournament {
 
 //! Final game scores
@@ -35,18 +40,78 @@ enum class GameOutcome {
   Draw,              //!< Game ended up in a draw
 };
 
+//! A tournament participant: a genotype and its (already grown) brain
+//! \sa BrainCache
+struct Contestant {
+  const darwin::Genotype* genotype = nullptr;
+  darwin::Brain* brain = nullptr;
+};
+
 //! Game rules abstraction (used to run the tournament)
 //! \sa Tournament
 class GameRules : public core::NonCopyable {
  public:
   virtual ~GameRules() = default;
 
-  //! Sets up a game between players "grown" from the argument genotypes  
-  virtual GameOutcome play(const darwin::Genotype* player1,
-                           const darwin::Genotype* player2) const = 0;
+  //! Sets up a game between the two contestants
+  //!
+  //! The brains are grown once per tournament and reused across games, so the players
+  //! must not take ownership of the brains (only reset their state for each game).
+  //!
+  virtual GameOutcome play(const Contestant& player1,
+                           const Contestant& player2) const = 0;
 
   //! Returns the final scores based on a game outcome
   virtual Scores scores(GameOutcome outcome) const = 0;
+
+  //! Grows the brain used by a contestant for the whole tournament
+  //!
+  //! The default is Genotype::grow(). The game rules can wrap the brain to attach
+  //! extra per-phenotype state (ex. a cache of the selected moves).
+  //!
+  virtual unique_ptr<darwin::Brain> growBrain(const darwin::Genotype* genotype) const {
+    return genotype->grow();
+  }
+};
+
+//! The brains for all the genotypes in a population (grown once, in parallel)
+//!
+//! A brain must not be used by concurrent games, so the tournaments must
+//! schedule the games accordingly (ex. disjoint pairings in each round)
+//!
+class BrainCache : public core::NonCopyable {
+ public:
+  BrainCache(const darwin::Population* population, const GameRules* game_rules);
+
+  size_t size() const { return brains_.size(); }
+
+  Contestant contestant(size_t index) const;
+
+ private:
+  const darwin::Population* population_ = nullptr;
+  vector<unique_ptr<darwin::Brain>> brains_;
+};
+
+//! The brains of a single genotype, for games played in parallel
+//! (ex. the calibration games of a champion)
+//!
+//! The games are split into one sequence per worker thread, and each sequence reuses
+//! the same brain, so the genotype is grown at most once per worker thread (instead of
+//! once per game). The brains are kept across playGames() calls.
+//!
+//! \note The players must reset the brain state for each game
+//!
+class ReplicatedBrain : public core::NonCopyable {
+ public:
+  ReplicatedBrain(const darwin::Genotype* genotype, const GameRules* game_rules);
+
+  //! Calls `play_game(game_index, contestant)` for each game (in parallel)
+  void playGames(int games, const function<void(int, const Contestant&)>& play_game);
+
+ private:
+  const darwin::Genotype* genotype_ = nullptr;
+  const GameRules* game_rules_ = nullptr;
+  vector<unique_ptr<darwin::Brain>> brains_;
 };
 
 //! Tournament interface
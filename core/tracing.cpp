@@ -0,0 +1,172 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "tracing.h"
+#include "exception.h"
+#include "utils.h"
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+using namespace std;
+
+namespace core {
+
+atomic<bool> Tracing::enabled_ = false;
+
+namespace {
+
+// the per-thread events buffer
+//
+// the buffer lock is normally uncontended: it's only shared between
+// the owner thread and the (infrequent) collectEvents() calls
+//
+struct ThreadEvents {
+  int thread_id = -1;
+  string thread_name;
+  mutex lock;
+  vector<TraceEvent> events;
+};
+
+// the registry of all the thread buffers
+struct ThreadsRegistry {
+  mutex lock;
+  vector<shared_ptr<ThreadEvents>> threads;
+
+  // the reference point for the exported timestamps
+  const Tracing::Clock::time_point epoch = Tracing::Clock::now();
+};
+
+ThreadsRegistry* threadsRegistry() {
+  static auto registry = new ThreadsRegistry;
+  return registry;
+}
+
+ThreadEvents* currentThreadEvents() {
+  // the registry keeps the buffer alive after the thread exits
+  thread_local shared_ptr<ThreadEvents> thread_events;
+  if (!thread_events) {
+    auto registry = threadsRegistry();
+    unique_lock<mutex> guard(registry->lock);
+    thread_events = make_shared<ThreadEvents>();
+    thread_events->thread_id = int(registry->threads.size());
+    registry->threads.push_back(thread_events);
+  }
+  return thread_events.get();
+}
+
+}  // namespace
+
+void Tracing::setThreadName(const string& name) {
+  auto thread_events = currentThreadEvents();
+  unique_lock<mutex> guard(thread_events->lock);
+  thread_events->thread_name = name;
+}
+
+void Tracing::recordSpan(const string& name,
+                         const char* category,
+                         Clock::time_point begin,
+                         Clock::time_point end) {
+  CHECK(category != nullptr);
+  CHECK(begin <= end);
+
+  auto thread_events = currentThreadEvents();
+  unique_lock<mutex> guard(thread_events->lock);
+  thread_events->events.push_back(
+      { name, category, thread_events->thread_id, begin, end });
+}
+
+vector<TraceEvent> Tracing::collectEvents() {
+  vector<shared_ptr<ThreadEvents>> threads;
+
+  {
+    auto registry = threadsRegistry();
+    unique_lock<mutex> guard(registry->lock);
+    threads = registry->threads;
+  }
+
+  vector<TraceEvent> events;
+  for (const auto& thread_events : threads) {
+    unique_lock<mutex> guard(thread_events->lock);
+    std::move(thread_events->events.begin(),
+              thread_events->events.end(),
+              back_inserter(events));
+    thread_events->events.clear();
+  }
+
+  std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) {
+    return a.begin < b.begin;
+  });
+
+  return events;
+}
+
+void Tracing::exportChromeTrace(const fs::path& path) {
+  const auto events = collectEvents();
+  const auto registry = threadsRegistry();
+
+  auto timestampUs = [&](Clock::time_point timestamp) {
+    return chrono::duration<double, micro>(timestamp - registry->epoch).count();
+  };
+
+  json json_events = json::array();
+
+  // thread names metadata
+  {
+    unique_lock<mutex> guard(registry->lock);
+    for (const auto& thread_events : registry->threads) {
+      unique_lock<mutex> thread_guard(thread_events->lock);
+      if (!thread_events->thread_name.empty()) {
+        json json_metadata;
+        json_metadata["name"] = "thread_name";
+        json_metadata["ph"] = "M";
+        json_metadata["pid"] = 0;
+        json_metadata["tid"] = thread_events->thread_id;
+        json_metadata["args"]["name"] = thread_events->thread_name;
+        json_events.push_back(json_metadata);
+      }
+    }
+  }
+
+  // the actual events ("complete" events)
+  for (const auto& event : events) {
+    json json_event;
+    json_event["name"] = event.name;
+    json_event["cat"] = event.category;
+    json_event["ph"] = "X";
+    json_event["pid"] = 0;
+    json_event["tid"] = event.thread_id;
+    json_event["ts"] = timestampUs(event.begin);
+    json_event["dur"] = timestampUs(event.end) - timestampUs(event.begin);
+    json_events.push_back(json_event);
+  }
+
+  json json_trace;
+  json_trace["traceEvents"] = json_events;
+  json_trace["displayTimeUnit"] = "ms";
+
+  if (path.has_parent_path())
+    fs::create_directories(path.parent_path());
+
+  ofstream file(path);
+  if (!file)
+    throw core::Exception("Can't create the trace file: '%s'", path.string());
+  file << json_trace.dump();
+}
+
+}  // namespace core
@@ -0,0 +1,124 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace core {
+
+//! A recorded span (a named time interval on a particular thread)
+struct TraceEvent {
+  using Clock = std::chrono::steady_clock;
+
+  //! Event name
+  string name;
+
+  //! Event category (must be a string literal)
+  const char* category = nullptr;
+
+  //! Tracing thread id (not the same as the OS thread id)
+  int thread_id = -1;
+
+  //! Span start timestamp
+  Clock::time_point begin;
+
+  //! Span finish timestamp
+  Clock::time_point end;
+};
+
+//! An opt-in, low overhead recorder of timed events
+//!
+//! The events are buffered per thread and they can be exported in the Chrome
+//! trace-event format, which can be loaded in `chrome://tracing` or
+//! https://ui.perfetto.dev
+//!
+//! When tracing is disabled, the overhead of the instrumentation points is just a
+//! relaxed atomic load.
+//!
+//! \sa TraceScope
+//!
+class Tracing {
+ public:
+  using Clock = TraceEvent::Clock;
+
+ public:
+  //! Starts recording events
+  static void enable() { enabled_.store(true, std::memory_order_relaxed); }
+
+  //! Stops recording events (the events recorded so far are not discarded)
+  static void disable() { enabled_.store(false, std::memory_order_relaxed); }
+
+  //! Returns true if the event recording is enabled
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  //! Sets the name of the current thread, as displayed by the trace viewers
+  static void setThreadName(const string& name);
+
+  //! Records a span on the current thread
+  static void recordSpan(const string& name,
+                         const char* category,
+                         Clock::time_point begin,
+                         Clock::time_point end);
+
+  //! Returns (and removes) all the recorded events, ordered by begin timestamp
+  static vector<TraceEvent> collectEvents();
+
+  //! Discards all the recorded events
+  static void clear() { collectEvents(); }
+
+  //! Exports (and removes) all the recorded events as a Chrome trace JSON file
+  static void exportChromeTrace(const fs::path& path);
+
+ private:
+  static atomic<bool> enabled_;
+};
+
+//! Scope-based span recording (only if tracing is enabled)
+class TraceScope {
+ public:
+  //! Starts a new span (the category must be a string literal)
+  TraceScope(const char* name, const char* category) {
+    if (Tracing::enabled()) {
+      name_ = name;
+      category_ = category;
+      begin_ = Tracing::Clock::now();
+    }
+  }
+
+  //! Records the span
+  ~TraceScope() {
+    if (name_ != nullptr) {
+      Tracing::recordSpan(name_, category_, begin_, Tracing::Clock::now());
+    }
+  }
+
+  // no copy/move semantics
+  TraceScope(const TraceScope&) = delete;
+  TraceScope& operator=(const TraceScope&) = delete;
+
+ private:
+  const char* name_ = nullptr;
+  const char* category_ = nullptr;
+  Tracing::Clock::time_point begin_;
+};
+
+}  // namespace core
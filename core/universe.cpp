@@ -16,14 +16,21 @@
 #include "format.h"
 #include "logging.h"
 
+#include <algorithm>
 #include <optional>
 using namespace std;
 
 namespace darwin {
 
 constexpr int32_t kSqlApplicationId = 0x47414e4e;
+
+// the base format (new universes are created with it, so they can be
+// opened by the older versions as long as the compact genealogy is not used)
 constexpr int32_t kSqlFormatVersion = 1;
 
+// format version 2 adds the compact genealogy (Generation.genealogy)
+constexpr int32_t kSqlCompactGenealogyVersion = 2;
+
 unique_ptr<Universe> Universe::create(const string& path) {
   core::log("Creating new universe: '%s'...\n", path.c_str());
   initializeUniverse(path);
@@ -41,7 +48,10 @@ Universe::Universe(const string& path)
   if (db_.exec<int>("pragma application_id").singleValue() != kSqlApplicationId)
     throw core::Exception("Invalid universe database (application id)");
 
-  if (db_.exec<int>("pragma user_version").singleValue() != kSqlFormatVersion)
+  // NOTE: the older formats are only upgraded when writing records which
+  //  need the newer format (so opening a universe doesn't modify it)
+  format_version_ = db_.exec<int>("pragma user_version").singleValue().value();
+  if (format_version_ > kSqlCompactGenealogyVersion || format_version_ < 1)
     throw core::Exception("Incompatible universe format");
 
   db_.exec("pragma quick_check");
@@ -97,6 +107,29 @@ void Universe::initializeUniverse(const string& path) {
   transaction.commit();
 }
 
+// must be called under the db_insert_lock_
+void Universe::upgradeFormat(int format_version) {
+  db::TransactionScope transaction(db_, db::TransactionOption::Exclusive);
+
+  // the universe may have been upgraded by a different process
+  const int current_version = db_.exec<int>("pragma user_version").singleValue().value();
+  if (current_version < format_version) {
+    core::log("Upgrading the universe format (%d -> %d)...\n",
+              current_version,
+              format_version);
+
+    // version 2: compact genealogy
+    if (current_version < 2) {
+      db_.exec("alter table Generation add column genealogy blob");
+    }
+
+    db_.exec(core::format("pragma user_version = %d", format_version));
+  }
+
+  transaction.commit();
+  format_version_ = max(current_version, format_version);
+}
+
 // 1. this is a private helper which must be called under the db_insert_lock_
 // 2. it doesn't create any transactions itself, so it can, and should be wrapped
 //    in a caller transaction (since it updates teh parent experiment as well)
@@ -357,6 +390,31 @@ unique_ptr<DbEvolutionTrace> Universe::newTrace(db::RowId variation_id,
 void Universe::newGeneration(const DbGeneration& db_generation) {
   unique_lock<mutex> guard(db_insert_lock_);
 
+  // the compact genealogy requires the format version 2
+  if (db_generation.genealogy && format_version_ < kSqlCompactGenealogyVersion)
+    upgradeFormat(kSqlCompactGenealogyVersion);
+
+  if (format_version_ < kSqlCompactGenealogyVersion) {
+    db_.exec(
+        R"(insert into Generation(
+            timestamp,
+            trace_id,
+            generation,
+            summary,
+            details,
+            genotypes,
+            profile)
+          values(?, ?, ?, ?, ?, ?, ?))",
+        int64_t(time(nullptr)),
+        db_generation.trace_id,
+        db_generation.generation,
+        db_generation.summary,
+        db_generation.details,
+        db_generation.genotypes,
+        db_generation.profile);
+    return;
+  }
+
   db_.exec(
       R"(insert into Generation(
           timestamp,
@@ -365,15 +423,46 @@ void Universe::newGeneration(const DbGeneration& db_generation) {
           summary,
           details,
           genotypes,
-          profile)
-        values(?, ?, ?, ?, ?, ?, ?))",
+          profile,
+          genealogy)
+        values(?, ?, ?, ?, ?, ?, ?, ?))",
       int64_t(time(nullptr)),
       db_generation.trace_id,
       db_generation.generation,
       db_generation.summary,
       db_generation.details,
       db_generation.genotypes,
-      db_generation.profile);
+      db_generation.profile,
+      db_generation.genealogy);
+}
+
+vector<optional<db::Blob>> Universe::loadGenealogy(db::RowId trace_id) const {
+  // no compact genealogy records before the format version 2
+  // (the universe may have been upgraded by a different process)
+  if (db_.exec<int>("pragma user_version").singleValue().value() <
+      kSqlCompactGenealogyVersion) {
+    auto results = db_.exec<int>(
+        "select generation from generation where trace_id = ? order by generation",
+        trace_id);
+    return vector<optional<db::Blob>>(results.size());
+  }
+
+  auto results = db_.exec<int, db::Blob>(
+      R"(select
+          generation,
+          genealogy
+        from generation
+          where trace_id = ?
+          order by generation)",
+      trace_id);
+
+  vector<optional<db::Blob>> genealogy;
+  for (const auto& [generation, data] : results) {
+    CHECK(generation.value() == int(genealogy.size()));
+    genealogy.push_back(data);
+  }
+
+  return genealogy;
 }
 
 string Universe::strftime(time_t timestamp, const string& format) const {
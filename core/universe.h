@@ -105,6 +105,10 @@ struct DbGeneration : public DbUniverseObject {
   
   //! Runtime profile data (json)
   optional<string> profile;
+
+  //! Compact genealogy information (binary)
+  //! \sa CompactGenealogy
+  optional<db::Blob> genealogy;
 };
 
 //! The persistent storage for all the experiments and variations
@@ -147,6 +151,10 @@ class Universe : public core::NonCopyable {
   //! Creates a new generation record
   void newGeneration(const DbGeneration& db_generation);
 
+  //! Loads the compact genealogy records for all the generations in a trace
+  //! (indexed by generation number, missing values are represented as `nullopt`)
+  vector<optional<db::Blob>> loadGenealogy(db::RowId trace_id) const;
+
   // yeah, doesn't really belong here, but the standard C++ library
   // support for formatting date/time is still broken (not thread safe)
   string strftime(time_t timestamp, const string& format) const;
@@ -156,6 +164,8 @@ class Universe : public core::NonCopyable {
 
   static void initializeUniverse(const string& path);
 
+  void upgradeFormat(int format_version);
+
   db::RowId createVariationHelper(db::RowId experiment_id,
                                   const optional<db::RowId> prev_variation_id,
                                   const string& config);
@@ -169,6 +179,9 @@ class Universe : public core::NonCopyable {
 
   // guards all inserts in order to reliably get the last inserted RowId
   mutex db_insert_lock_;
+
+  // the universe format version (guarded by db_insert_lock_ after construction)
+  int format_version_ = 0;
 };
 
 }  // namespace darwin
@@ -9,7 +9,9 @@ SUBDIRS += \
     domains \
     registry \
     darwin_studio \
+    darwin_cli \
     tests \
+    benchmarks \
     experimental \
     third_party
 
@@ -19,6 +21,8 @@ populations.depends = core core_ui
 domains.depends = core core_ui
 registry.depends = core populations domains
 darwin_studio.depends = core core_ui registry
+darwin_cli.depends = core registry
 tests.depends = core registry third_party
+benchmarks.depends = core registry third_party
 experimental.depends = core registry third_party
 bindings.depends = core registry
@@ -0,0 +1,214 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cli_options.h"
+
+#include <core/exception.h>
+#include <core/utils.h>
+
+#include <fstream>
+using namespace std;
+
+namespace darwin_cli {
+
+const char* const kUsage =
+    "Usage: darwin_cli --universe=<path> [options]\n"
+    "\n"
+    "Runs an evolution experiment, without a UI\n"
+    "\n"
+    "  --universe=<path>         Universe database (created if it doesn't exist)\n"
+    "  --experiment=<name>       Experiment name (reuses an existing experiment)\n"
+    "  --config=<file>           JSON configuration, with optional sections:\n"
+    "                            setup, core, domain, population and evolution\n"
+    "  --domain=<name>           Same as --set=setup.domain_name=<name>\n"
+    "  --population=<name>       Same as --set=setup.population_name=<name>\n"
+    "  --population_size=<n>     Same as --set=setup.population_size=<n>\n"
+    "  --generations=<n>         Same as --set=evolution.max_generations=<n>\n"
+    "  --set=<section.property>=<value>\n"
+    "                            Property override (can be repeated)\n"
+    "  --threads=<n>             Number of worker threads\n"
+    "                            (default: $DARWIN_THREADS, or one per core)\n"
+    "  --affinity=<placement>    Same as --set=evolution.thread_affinity=<placement>\n"
+    "                            (none, cores or numa_nodes)\n"
+    "  --sweep                   Run a hyperparameter sweep, as specified in the\n"
+    "                            sweep section of the configuration file\n"
+    "  --islands=<n>             Run an island model with n islands, same as\n"
+    "                            --set=islands.islands=<n> (the migration settings\n"
+    "                            are in the islands section of the configuration file)\n"
+    "  --json                    Output the generation summaries as JSON lines\n"
+    "  --verbose                 Echo the Darwin log messages to stderr\n"
+    "  --list                    List the available domains and populations\n";
+
+namespace {
+
+// matches "--name=value" arguments
+bool parseOption(const string& arg, const string& name, string* value) {
+  const auto prefix = "--" + name + "=";
+  if (arg.compare(0, prefix.size(), prefix) != 0)
+    return false;
+  *value = arg.substr(prefix.size());
+  return true;
+}
+
+// "<section>.<property path>=<value>"
+PropertyOverride parseOverride(const string& str) {
+  const auto dot_pos = str.find('.');
+  const auto eq_pos = str.find('=');
+  if (dot_pos == string::npos || eq_pos == string::npos || eq_pos < dot_pos)
+    throw core::Exception("Invalid property override: '%s'", str);
+
+  PropertyOverride property_override;
+  try {
+    property_override.section = core::fromString<Section>(str.substr(0, dot_pos));
+  } catch (const std::exception&) {
+    throw core::Exception("Invalid configuration section: '%s'", str.substr(0, dot_pos));
+  }
+  property_override.path = str.substr(dot_pos + 1, eq_pos - dot_pos - 1);
+  property_override.value = str.substr(eq_pos + 1);
+  return property_override;
+}
+
+// looks up a property using a dotted path (ex. "selection_algorithm.truncation.x")
+core::Property* lookupProperty(core::PropertySet* config, const string& path) {
+  const auto dot_pos = path.find('.');
+  const auto name = path.substr(0, dot_pos);
+
+  core::Property* property = nullptr;
+  for (auto candidate : config->properties()) {
+    if (candidate->name() == name) {
+      property = candidate;
+      break;
+    }
+  }
+
+  if (property == nullptr)
+    throw core::Exception("Unknown property: '%s'", name);
+
+  if (dot_pos == string::npos)
+    return property;
+
+  // nested property (the next path component selects the variant case)
+  const auto rest = path.substr(dot_pos + 1);
+  const auto case_pos = rest.find('.');
+  if (case_pos == string::npos)
+    throw core::Exception("Invalid property path: '%s'", path);
+
+  const auto case_name = rest.substr(0, case_pos);
+  if (property->value() != case_name)
+    property->setValue(case_name);
+
+  auto child_config = property->childPropertySet();
+  if (child_config == nullptr)
+    throw core::Exception("Property '%s' doesn't have nested properties", name);
+  return lookupProperty(child_config, rest.substr(case_pos + 1));
+}
+
+}  // namespace
+
+Options parseCommandLine(int argc, char* argv[]) {
+  Options options;
+  for (int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    string value;
+    if (arg == "--json") {
+      options.json_output = true;
+    } else if (arg == "--sweep") {
+      options.sweep = true;
+    } else if (arg == "--verbose") {
+      options.verbose = true;
+    } else if (arg == "--list") {
+      options.list = true;
+    } else if (parseOption(arg, "universe", &value)) {
+      options.universe_path = value;
+    } else if (parseOption(arg, "experiment", &value)) {
+      options.experiment_name = value;
+    } else if (parseOption(arg, "config", &value)) {
+      options.config_path = value;
+    } else if (parseOption(arg, "domain", &value)) {
+      options.overrides.push_back({ Section::Setup, "domain_name", value });
+    } else if (parseOption(arg, "population", &value)) {
+      options.overrides.push_back({ Section::Setup, "population_name", value });
+    } else if (parseOption(arg, "population_size", &value)) {
+      options.overrides.push_back({ Section::Setup, "population_size", value });
+    } else if (parseOption(arg, "generations", &value)) {
+      options.overrides.push_back({ Section::Evolution, "max_generations", value });
+    } else if (parseOption(arg, "affinity", &value)) {
+      options.overrides.push_back({ Section::Evolution, "thread_affinity", value });
+    } else if (parseOption(arg, "islands", &value)) {
+      options.islands = true;
+      options.overrides.push_back({ Section::Islands, "islands", value });
+    } else if (parseOption(arg, "set", &value)) {
+      options.overrides.push_back(parseOverride(value));
+    } else if (parseOption(arg, "threads", &value)) {
+      options.threads = core::fromString<int>(value);
+      if (options.threads < 0)
+        throw core::Exception("Invalid threads count: %d", options.threads);
+    } else {
+      throw core::Exception("Unexpected argument: '%s'", arg);
+    }
+  }
+
+  if (options.universe_path.empty() && !options.list)
+    throw core::Exception("Missing the universe path");
+
+  return options;
+}
+
+json loadConfig(const string& config_path) {
+  if (config_path.empty())
+    return json::object();
+
+  ifstream file(config_path);
+  if (!file)
+    throw core::Exception("Can't open the configuration file: '%s'", config_path);
+
+  json json_config;
+  try {
+    file >> json_config;
+  } catch (const std::exception& e) {
+    throw core::Exception("Invalid configuration file '%s': %s", config_path, e.what());
+  }
+
+  if (!json_config.is_object())
+    throw core::Exception("Invalid configuration file: '%s'", config_path);
+  return json_config;
+}
+
+void applyConfig(core::PropertySet* config,
+                 Section section,
+                 const json& json_config,
+                 const vector<PropertyOverride>& overrides) {
+  CHECK(config != nullptr);
+
+  auto json_it = json_config.find(core::toString(section));
+  if (json_it != json_config.end()) {
+    const auto& json_section = json_it.value();
+    if (!json_section.is_object())
+      throw core::Exception("Invalid '%s' configuration", core::toString(section));
+
+    // the PropertySet deserialization silently ignores unknown properties
+    for (const auto& item : json_section.items()) {
+      lookupProperty(config, item.key());
+    }
+
+    config->fromJson(json_section);
+  }
+
+  for (const auto& property_override : overrides) {
+    if (property_override.section == section) {
+      lookupProperty(config, property_override.path)->setValue(property_override.value);
+    }
+  }
+}
+
+}  // namespace darwin_cli
@@ -0,0 +1,115 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include <core/properties.h>
+#include <core/stringify.h>
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <optional>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace darwin_cli {
+
+//! A configuration section (the top level keys in the JSON configuration file,
+//! and the prefixes for the --set property overrides)
+enum class Section {
+  Setup,       //!< darwin::ExperimentSetup
+  Core,        //!< Core (shared) configuration
+  Domain,      //!< Domain configuration
+  Population,  //!< Population configuration
+  Evolution,   //!< darwin::EvolutionConfig
+  Sweep,       //!< Hyperparameter sweep configuration (darwin_cli --sweep)
+  Islands,     //!< darwin::IslandModelConfig (darwin_cli --islands)
+};
+
+inline auto customStringify(core::TypeTag<Section>) {
+  static auto stringify = new core::StringifyKnownValues<Section>{
+    { Section::Setup, "setup" },
+    { Section::Core, "core" },
+    { Section::Domain, "domain" },
+    { Section::Population, "population" },
+    { Section::Evolution, "evolution" },
+    { Section::Sweep, "sweep" },
+    { Section::Islands, "islands" },
+  };
+  return stringify;
+}
+
+//! A property override: `<section>.<property path>=<value>`
+//!
+//! The property path can reference properties nested in variants,
+//! for example: `population.selection_algorithm.truncation.elite_percentage=0.2`
+//!
+struct PropertyOverride {
+  Section section = Section::Setup;
+  string path;
+  string value;
+};
+
+//! The parsed command line
+struct Options {
+  //! Universe database (created if it doesn't exist)
+  string universe_path;
+
+  //! Experiment name (an existing experiment with this name is reused)
+  optional<string> experiment_name;
+
+  //! Optional JSON configuration file
+  string config_path;
+
+  //! Property overrides (applied in order, after the JSON configuration)
+  vector<PropertyOverride> overrides;
+
+  //! Worker threads count (0 = auto)
+  int threads = 0;
+
+  //! Run a hyperparameter sweep (the `sweep` configuration section)
+  bool sweep = false;
+
+  //! Run an island model (the `islands` configuration section)
+  bool islands = false;
+
+  //! Stream the generation summaries as JSON lines
+  bool json_output = false;
+
+  //! Echo the Darwin log messages to stderr
+  bool verbose = false;
+
+  //! Print the available domains and populations, then exit
+  bool list = false;
+};
+
+//! The usage message
+extern const char* const kUsage;
+
+//! Parses the command line arguments
+//! \throws core::Exception if the command line is invalid
+Options parseCommandLine(int argc, char* argv[]);
+
+//! Loads the JSON configuration file (or returns an empty object if the path is empty)
+json loadConfig(const string& config_path);
+
+//! Applies the JSON section, if present, then the matching property overrides
+void applyConfig(core::PropertySet* config,
+                 Section section,
+                 const json& json_config,
+                 const vector<PropertyOverride>& overrides);
+
+}  // namespace darwin_cli
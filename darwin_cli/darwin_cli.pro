@@ -0,0 +1,23 @@
+include(../common.pri)
+
+TARGET = darwin_cli
+TEMPLATE = app
+CONFIG += console
+CONFIG += thread
+CONFIG -= app_bundle
+CONFIG -= qt
+CONFIG += link_prl
+
+SOURCES += \
+    main.cpp \
+    cli_options.cpp \
+    islands.cpp \
+    sweep.cpp
+
+HEADERS += \
+    cli_options.h \
+    islands.h \
+    sweep.h
+
+addLibrary(../registry)
+addLibrary(../core)
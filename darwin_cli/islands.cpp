@@ -0,0 +1,153 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "islands.h"
+
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/island_model.h>
+#include <core/scope_guard.h>
+#include <core/utils.h>
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+#include <stdio.h>
+#include <vector>
+using namespace std;
+
+namespace darwin_cli {
+
+namespace {
+
+struct Island {
+  shared_ptr<darwin::Experiment> experiment;
+  unique_ptr<darwin::Evolution> evolution;
+
+  // progress (updated from the evolution notifications)
+  int generations = 0;
+  float best_fitness = -numeric_limits<float>::infinity();
+};
+
+void printIslandSummary(int island,
+                        const darwin::GenerationSummary& summary,
+                        bool json_output) {
+  if (json_output) {
+    json json_summary;
+    json_summary["island"] = island;
+    json_summary["generation"] = summary.generation;
+    json_summary["best_fitness"] = summary.best_fitness;
+    json_summary["median_fitness"] = summary.median_fitness;
+    json_summary["worst_fitness"] = summary.worst_fitness;
+    printf("%s\n", json_summary.dump().c_str());
+  } else {
+    printf("Island %3d, generation %5d: best = %10.4f, median = %10.4f, "
+           "worst = %10.4f\n",
+           island,
+           summary.generation,
+           summary.best_fitness,
+           summary.median_fitness,
+           summary.worst_fitness);
+  }
+  fflush(stdout);
+}
+
+}  // namespace
+
+int runIslands(const Options& options,
+               const json& json_config,
+               shared_ptr<darwin::Experiment> experiment,
+               darwin::Universe* universe) {
+  darwin::IslandModelConfig config;
+  applyConfig(&config, Section::Islands, json_config, options.overrides);
+  auto island_model = make_shared<darwin::IslandModel>(config);
+
+  darwin::EvolutionConfig evolution_config;
+  applyConfig(&evolution_config, Section::Evolution, json_config, options.overrides);
+
+  mutex lock;
+  vector<Island> islands(config.islands);
+
+  // stop the islands which were not started (ex. after a setup error)
+  bool started = false;
+  SCOPE_EXIT {
+    if (!started) {
+      for (auto& island : islands) {
+        if (island.evolution)
+          CHECK(island.evolution->reset());
+      }
+    }
+  };
+
+  for (int index = 0; index < config.islands; ++index) {
+    auto& island = islands[index];
+
+    // the first island saves the experiment variation, if needed,
+    // the rest of the islands reuse it (same configuration)
+    if (index == 0) {
+      island.experiment = experiment;
+    } else {
+      auto db_experiment = universe->loadExperiment(experiment->dbExperimentId());
+      island.experiment = make_shared<darwin::Experiment>(db_experiment.get(), universe);
+    }
+
+    island.evolution = darwin::Evolution::create();
+
+    // the notifications are delivered on the island's evolution main thread
+    island.evolution->generation_summary.subscribe(
+        [&, index](const darwin::GenerationSummary& summary) {
+          unique_lock<mutex> guard(lock);
+          auto& island = islands[index];
+          island.generations = summary.generation + 1;
+          island.best_fitness = max(island.best_fitness, summary.best_fitness);
+          printIslandSummary(index, summary, options.json_output);
+        });
+
+    if (!island.evolution->newExperiment(island.experiment, evolution_config))
+      throw core::Exception("Failed to start island %d", index);
+    island.evolution->joinIslandModel(island_model, index);
+  }
+
+  // the islands evolve independently, at their own pace
+  started = true;
+  for (auto& island : islands) {
+    island.evolution->run();
+  }
+
+  for (auto& island : islands) {
+    island.evolution->waitForState(darwin::Evolution::State::Stopped);
+  }
+
+  // final stats (stderr, so stdout contains only the generation summaries)
+  float best_fitness = -numeric_limits<float>::infinity();
+  fprintf(stderr, "\n");
+  for (int index = 0; index < config.islands; ++index) {
+    const auto& island = islands[index];
+    fprintf(stderr,
+            "Island %3d: %5d generation(s), best fitness = %10.4f, "
+            "%d immigrant(s) (trace id: %lld)\n",
+            index,
+            island.generations,
+            island.best_fitness,
+            island_model->immigrantsCount(index),
+            static_cast<long long>(island.evolution->snapshot().trace->dbTraceId()));
+    best_fitness = max(best_fitness, island.best_fitness);
+    CHECK(island.evolution->reset());
+  }
+  fprintf(stderr, "\nBest fitness: %.4f\n", best_fitness);
+  fprintf(stderr, "Universe: %s\n", universe->path().c_str());
+  return 0;
+}
+
+}  // namespace darwin_cli
@@ -0,0 +1,44 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "cli_options.h"
+
+#include <core/darwin.h>
+#include <core/universe.h>
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <memory>
+using namespace std;
+
+namespace darwin_cli {
+
+//! Runs an island model (darwin_cli --islands=<n>)
+//!
+//! Each island is an independent darwin::Evolution instance, evolving its own
+//! population (all the islands share the worker threads). The genotypes migration
+//! is configured by the `islands` configuration section (see darwin::IslandModelConfig).
+//!
+//! The islands are recorded as separate evolution traces of the same
+//! experiment variation.
+//!
+int runIslands(const Options& options,
+               const json& json_config,
+               shared_ptr<darwin::Experiment> experiment,
+               darwin::Universe* universe);
+
+}  // namespace darwin_cli
@@ -0,0 +1,241 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include "cli_options.h"
+#include "islands.h"
+#include "sweep.h"
+
+#include <core/chronometer.h>
+#include <core/darwin.h>
+#include <core/evaluation_workers.h>
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/logging.h>
+#include <core/runtime.h>
+#include <core/scope_guard.h>
+#include <core/universe.h>
+#include <registry/registry.h>
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <memory>
+#include <stdio.h>
+#include <string>
+using namespace std;
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace darwin_cli {
+
+// statistics for the completed generations
+struct RunStats {
+  int generations = 0;
+  double generations_time = 0;
+  float best_fitness = 0;
+  double last_generation_time = 0;
+};
+
+void listModules() {
+  printf("Domains:\n");
+  for (const auto& [name, factory] : darwin::registry()->domains) {
+    printf("  %s\n", name.c_str());
+  }
+  printf("\nPopulations:\n");
+  for (const auto& [name, factory] : darwin::registry()->populations) {
+    printf("  %s\n", name.c_str());
+  }
+}
+
+unique_ptr<darwin::Universe> openUniverse(const string& path) {
+  if (fs::exists(path))
+    return darwin::Universe::open(path);
+  return darwin::Universe::create(path);
+}
+
+shared_ptr<darwin::Experiment> setupExperiment(const Options& options,
+                                               const json& json_config,
+                                               darwin::Universe* universe) {
+  shared_ptr<darwin::Experiment> experiment;
+
+  // reuse the existing experiment, if any
+  if (options.experiment_name.has_value()) {
+    for (const auto& db_experiment : universe->experimentsList()) {
+      if (db_experiment.name == options.experiment_name) {
+        experiment = make_shared<darwin::Experiment>(&db_experiment, universe);
+        break;
+      }
+    }
+  }
+
+  if (experiment) {
+    bool setup_override = json_config.count(core::toString(Section::Setup)) > 0;
+    for (const auto& property_override : options.overrides) {
+      setup_override = setup_override || property_override.section == Section::Setup;
+    }
+    if (setup_override) {
+      throw core::Exception("The setup of an existing experiment ('%s') can't be changed",
+                            *options.experiment_name);
+    }
+  } else {
+    darwin::ExperimentSetup setup;
+    applyConfig(&setup, Section::Setup, json_config, options.overrides);
+    if (setup.domain_name.empty() || setup.population_name.empty())
+      throw core::Exception("The domain and the population names must be specified");
+    experiment = make_shared<darwin::Experiment>(
+        options.experiment_name, setup, nullopt, universe);
+  }
+
+  const auto& overrides = options.overrides;
+  applyConfig(experiment->coreConfig(), Section::Core, json_config, overrides);
+  applyConfig(experiment->domainConfig(), Section::Domain, json_config, overrides);
+  applyConfig(
+      experiment->populationConfig(), Section::Population, json_config, overrides);
+
+  // save a new variation if the configuration of an existing experiment was changed
+  bool config_changed = false;
+  for (auto section : { Section::Core, Section::Domain, Section::Population }) {
+    config_changed = config_changed || json_config.count(core::toString(section)) > 0;
+    for (const auto& property_override : overrides) {
+      config_changed = config_changed || property_override.section == section;
+    }
+  }
+  experiment->setModified(config_changed);
+  return experiment;
+}
+
+void printSummary(const darwin::GenerationSummary& summary,
+                  double elapsed,
+                  bool json_output) {
+  if (json_output) {
+    json json_summary;
+    json_summary["generation"] = summary.generation;
+    json_summary["best_fitness"] = summary.best_fitness;
+    json_summary["median_fitness"] = summary.median_fitness;
+    json_summary["worst_fitness"] = summary.worst_fitness;
+    json_summary["elapsed"] = elapsed;
+    if (summary.calibration_fitness)
+      json_summary["calibration_fitness"] = summary.calibration_fitness->toJson();
+    printf("%s\n", json_summary.dump().c_str());
+  } else {
+    printf("Generation %5d: best = %10.4f, median = %10.4f, worst = %10.4f  (%.3f sec)\n",
+           summary.generation,
+           summary.best_fitness,
+           summary.median_fitness,
+           summary.worst_fitness,
+           elapsed);
+  }
+  fflush(stdout);
+}
+
+int run(const Options& options) {
+  auto universe = openUniverse(options.universe_path);
+  const auto json_config = loadConfig(options.config_path);
+
+  if (options.sweep)
+    return runSweep(options, json_config, universe.get());
+
+  auto experiment = setupExperiment(options, json_config, universe.get());
+
+  if (options.islands)
+    return runIslands(options, json_config, experiment, universe.get());
+
+  darwin::EvolutionConfig evolution_config;
+  applyConfig(&evolution_config, Section::Evolution, json_config, options.overrides);
+
+  auto evolution = darwin::evolution();
+  RunStats stats;
+
+  // the notifications are delivered on the evolution main thread,
+  // (the top stage is always published before the generation summary)
+  auto stages_subscription = evolution->top_stages.subscribe(
+      [&](const darwin::EvolutionStage& stage) {
+        if ((stage.annotations() & darwin::EvolutionStage::Annotation::Generation) != 0)
+          stats.last_generation_time = stage.elapsed();
+      });
+
+  SCOPE_EXIT { evolution->top_stages.unsubscribe(stages_subscription); };
+
+  auto summary_subscription = evolution->generation_summary.subscribe(
+      [&](const darwin::GenerationSummary& summary) {
+        ++stats.generations;
+        stats.generations_time += stats.last_generation_time;
+        stats.best_fitness = summary.best_fitness;
+        printSummary(summary, stats.last_generation_time, options.json_output);
+      });
+
+  SCOPE_EXIT { evolution->generation_summary.unsubscribe(summary_subscription); };
+
+  double total_time_ms = 0;
+  {
+    core::Chronometer chronometer(&total_time_ms);
+    if (!evolution->newExperiment(experiment, evolution_config))
+      throw core::Exception("Failed to start the evolution");
+    evolution->run();
+    evolution->waitForState(darwin::Evolution::State::Stopped);
+  }
+
+  // final stats (stderr, so stdout contains only the generation summaries)
+  fprintf(stderr,
+          "\nCompleted %d generation(s) in %.3f sec (%.3f sec/generation)\n",
+          stats.generations,
+          total_time_ms / 1000,
+          stats.generations > 0 ? stats.generations_time / stats.generations : 0.0);
+  fprintf(stderr, "Best fitness: %.4f\n", stats.best_fitness);
+  fprintf(stderr,
+          "Universe: %s (trace id: %lld)\n",
+          universe->path().c_str(),
+          static_cast<long long>(evolution->snapshot().trace->dbTraceId()));
+  return 0;
+}
+
+}  // namespace darwin_cli
+
+int main(int argc, char* argv[]) {
+  // evaluation worker processes (see darwin::EvaluationWorkers)
+  if (darwin::EvaluationWorkers::isWorkerProcess(argc, argv)) {
+    registry::init();
+    return darwin::EvaluationWorkers::workerMain(argc, argv);
+  }
+
+  darwin_cli::Options options;
+  try {
+    options = darwin_cli::parseCommandLine(argc, argv);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "%s\n\n%s", e.what(), darwin_cli::kUsage);
+    return 2;
+  }
+
+  core::Runtime::init(argc, argv);
+
+  if (options.verbose) {
+    core::consoleOutput()->subscribe(
+        [](const string& message) { fputs(message.c_str(), stderr); });
+  }
+
+  registry::init();
+  darwin::Evolution::init(options.threads);
+
+  if (options.list) {
+    darwin_cli::listModules();
+    return 0;
+  }
+
+  try {
+    return darwin_cli::run(options);
+  } catch (const std::exception& e) {
+    fprintf(stderr, "\nError: %s\n", e.what());
+    return 1;
+  }
+}
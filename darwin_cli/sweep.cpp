@@ -0,0 +1,632 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "sweep.h"
+
+#include <core/ann_utils.h>
+#include <core/darwin.h>
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/format.h>
+#include <core/thread_pool.h>
+#include <core/utils.h>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <stdio.h>
+using namespace std;
+
+namespace darwin_cli {
+
+namespace {
+
+// a JSON scalar, formatted as a property value
+string valueString(const json& json_value) {
+  if (json_value.is_string())
+    return json_value.get<string>();
+  if (json_value.is_number() || json_value.is_boolean())
+    return json_value.dump();
+  throw core::Exception("Invalid sweep parameter value: '%s'", json_value.dump());
+}
+
+string overridesString(const vector<PropertyOverride>& overrides) {
+  string str;
+  for (const auto& property_override : overrides) {
+    if (!str.empty())
+      str += ", ";
+    str += core::format("%s.%s=%s",
+                        core::toString(property_override.section),
+                        property_override.path,
+                        property_override.value);
+  }
+  return str;
+}
+
+// samples a value from the parameter's range or the list of values
+string sampleValue(const SweepParameter& parameter, std::mt19937_64& rnd) {
+  if (!parameter.range) {
+    std::uniform_int_distribution<size_t> dist(0, parameter.values.size() - 1);
+    return parameter.values[dist(rnd)];
+  }
+
+  const auto& range = *parameter.range;
+  const double low = range.log ? std::log(range.min) : range.min;
+  const double high = range.log ? std::log(range.max) : range.max;
+  std::uniform_real_distribution<double> dist(low, high);
+  double value = dist(rnd);
+  if (range.log)
+    value = std::exp(value);
+
+  if (range.integer) {
+    const auto int_value = std::llround(std::clamp(value, range.min, range.max));
+    return to_string(int_value);
+  }
+  return json(value).dump();
+}
+
+// the state of one sweep variation
+struct Variation {
+  int index = 0;
+
+  // the swept property values
+  vector<PropertyOverride> overrides;
+
+  shared_ptr<darwin::Experiment> experiment;
+  unique_ptr<darwin::Evolution> evolution;
+
+  // the generations budget of the current rung
+  int target_generations = 0;
+
+  // progress (updated from the evolution notifications)
+  int generations = 0;
+  float best_fitness = -numeric_limits<float>::infinity();
+
+  // the evolution stopped before reaching the final rung (ex. the domain was solved)
+  bool finished = false;
+
+  // the variation didn't advance past the rung at the given index
+  optional<int> eliminated_at_rung;
+};
+
+// runs the sweep variations, using synchronous successive halving:
+//
+// 1. all the active variations run until they reach the rung's generations budget
+//    (at most `concurrency` variations are running at the same time, the rest
+//    are either waiting to start or are paused at the end of the rung)
+// 2. the top 1/eta variations (ranked by the best fitness so far) advance to
+//    the next rung, the rest are stopped
+//
+class SweepRunner : public core::NonCopyable {
+ public:
+  SweepRunner(const Options& options,
+              const json& json_config,
+              const SweepConfig& config,
+              darwin::Universe* universe)
+      : options_(options), json_config_(json_config), universe_(universe) {
+    config_.copyFrom(config);
+    applyConfig(&evolution_config_, Section::Evolution, json_config, options.overrides);
+
+    if (evolution_config_.max_generations < 1)
+      throw core::Exception("Invalid evolution.max_generations value");
+
+    concurrency_ = config_.concurrency;
+    if (concurrency_ == 0)
+      concurrency_ = pp::ParallelForSupport::threadPool()->threadsCount();
+    concurrency_ = max(concurrency_, 1);
+  }
+
+  ~SweepRunner() {
+    // stop the variations which are still running (ex. after an error)
+    for (auto& variation : variations_) {
+      if (variation->evolution)
+        stopVariation(variation.get());
+    }
+  }
+
+  void run(const vector<vector<PropertyOverride>>& variations_overrides) {
+    for (const auto& overrides : variations_overrides) {
+      auto variation = make_unique<Variation>();
+      variation->index = int(variations_.size());
+      variation->overrides = overrides;
+      variations_.push_back(std::move(variation));
+    }
+
+    vector<Variation*> active;
+    for (const auto& variation : variations_)
+      active.push_back(variation.get());
+
+    rungs_ = sweepRungs(config_, evolution_config_.max_generations);
+
+    for (int rung = 0; rung < int(rungs_.size()); ++rung) {
+      fprintf(stderr,
+              "\nRung %d: %d variation(s), %d generation(s) budget\n",
+              rung,
+              int(active.size()),
+              rungs_[rung]);
+
+      runRung(active, rungs_[rung]);
+
+      if (rung == int(rungs_.size()) - 1)
+        break;
+
+      // successive halving: only the top 1/eta variations advance
+      std::stable_sort(active.begin(), active.end(), [](const auto& a, const auto& b) {
+        return a->best_fitness > b->best_fitness;
+      });
+
+      const int eta = config_.halving_eta;
+      const size_t keep_count = max<size_t>(1, (active.size() + eta - 1) / eta);
+      for (size_t i = keep_count; i < active.size(); ++i) {
+        active[i]->eliminated_at_rung = rung;
+        stopVariation(active[i]);
+      }
+      active.resize(keep_count);
+    }
+
+    for (auto variation : active) {
+      if (variation->evolution)
+        stopVariation(variation);
+    }
+  }
+
+  void printResults() const {
+    vector<const Variation*> ranking;
+    for (const auto& variation : variations_)
+      ranking.push_back(variation.get());
+
+    // the variations which advanced further are ranked first
+    std::stable_sort(ranking.begin(), ranking.end(), [](const auto& a, const auto& b) {
+      if (a->generations != b->generations)
+        return a->generations > b->generations;
+      return a->best_fitness > b->best_fitness;
+    });
+
+    if (!options_.json_output)
+      printf("\n%4s  %9s  %11s  %12s  %s\n",
+             "Rank",
+             "Variation",
+             "Generations",
+             "Best fitness",
+             "Parameters");
+
+    int rank = 0;
+    for (auto variation : ranking) {
+      ++rank;
+      const auto variation_id = variation->experiment
+                                    ? static_cast<long long>(
+                                          variation->experiment->dbVariationId())
+                                    : -1LL;
+      if (options_.json_output) {
+        json json_result;
+        json_result["rank"] = rank;
+        json_result["variation_id"] = variation_id;
+        json_result["generations"] = variation->generations;
+        json_result["best_fitness"] = variation->best_fitness;
+        if (variation->eliminated_at_rung)
+          json_result["eliminated_at_rung"] = *variation->eliminated_at_rung;
+        json json_parameters = json::object();
+        for (const auto& property_override : variation->overrides) {
+          const auto path = core::format(
+              "%s.%s", core::toString(property_override.section), property_override.path);
+          json_parameters[path] = property_override.value;
+        }
+        json_result["parameters"] = json_parameters;
+        printf("%s\n", json_result.dump().c_str());
+      } else {
+        printf("%4d  %9lld  %11d  %12.4f  %s\n",
+               rank,
+               variation_id,
+               variation->generations,
+               variation->best_fitness,
+               overridesString(variation->overrides).c_str());
+      }
+    }
+    fflush(stdout);
+
+    // the generations saved by the early stopping
+    long long total_generations = 0;
+    for (const auto& variation : variations_)
+      total_generations += variation->generations;
+    const auto full_budget =
+        static_cast<long long>(variations_.size()) * evolution_config_.max_generations;
+    fprintf(stderr,
+            "\nSweep complete: %d variation(s), %lld generation(s) "
+            "(%.1f%% of the full budget)\n",
+            int(variations_.size()),
+            total_generations,
+            full_budget > 0 ? 100.0 * total_generations / full_budget : 0.0);
+  }
+
+ private:
+  // creates the experiment (or a new variation of an existing experiment)
+  shared_ptr<darwin::Experiment> variationExperiment(const Variation& variation) {
+    auto overrides = options_.overrides;
+    const auto& swept = variation.overrides;
+    overrides.insert(overrides.end(), swept.begin(), swept.end());
+
+    darwin::ExperimentSetup setup;
+    applyConfig(&setup, Section::Setup, json_config_, overrides);
+    if (setup.domain_name.empty() || setup.population_name.empty())
+      throw core::Exception("The domain and the population names must be specified");
+
+    const auto setup_json = setup.toJson();
+    const auto setup_key = setup_json.dump();
+
+    shared_ptr<darwin::Experiment> experiment;
+    auto experiment_it = experiments_.find(setup_key);
+    if (experiment_it != experiments_.end()) {
+      auto db_experiment = universe_->loadExperiment(experiment_it->second);
+      experiment = make_shared<darwin::Experiment>(db_experiment.get(), universe_);
+    } else {
+      // the swept setup values are part of the experiment name
+      auto name = options_.experiment_name;
+      vector<PropertyOverride> setup_overrides;
+      for (const auto& property_override : variation.overrides) {
+        if (property_override.section == Section::Setup)
+          setup_overrides.push_back(property_override);
+      }
+      if (name.has_value() && !setup_overrides.empty())
+        name = core::format("%s/%s", *name, overridesString(setup_overrides));
+
+      // reuse the existing experiment, if any
+      if (name.has_value()) {
+        for (const auto& db_experiment : universe_->experimentsList()) {
+          if (db_experiment.name == name) {
+            if (json::parse(db_experiment.setup) != setup_json) {
+              throw core::Exception(
+                  "The setup of an existing experiment ('%s') can't be changed", *name);
+            }
+            experiment = make_shared<darwin::Experiment>(&db_experiment, universe_);
+            break;
+          }
+        }
+      }
+
+      if (!experiment)
+        experiment = make_shared<darwin::Experiment>(name, setup, nullopt, universe_);
+      experiments_[setup_key] = experiment->dbExperimentId();
+    }
+
+    // start from the default configuration values
+    // (an existing experiment is loaded with the values of its latest variation)
+    experiment->coreConfig()->copyFrom(ann::Config());
+    experiment->domainConfig()->copyFrom(
+        *experiment->domainFactory()->defaultConfig(setup.domain_hint));
+    experiment->populationConfig()->copyFrom(
+        *experiment->populationFactory()->defaultConfig(setup.population_hint));
+
+    applyConfig(experiment->coreConfig(), Section::Core, json_config_, overrides);
+    applyConfig(experiment->domainConfig(), Section::Domain, json_config_, overrides);
+    applyConfig(
+        experiment->populationConfig(), Section::Population, json_config_, overrides);
+
+    // always save a new variation
+    experiment->setModified(true);
+    return experiment;
+  }
+
+  // starts (or resumes) a variation, which will pause at the target generation
+  void startVariation(Variation* variation, int target_generations) {
+    {
+      unique_lock<mutex> guard(lock_);
+      variation->target_generations = target_generations;
+    }
+
+    if (!variation->evolution) {
+      variation->experiment = variationExperiment(*variation);
+      variation->evolution = darwin::Evolution::create();
+      auto evolution = variation->evolution.get();
+
+      // the notifications are delivered on the evolution main thread
+      evolution->generation_summary.subscribe(
+          [this, variation, evolution](const darwin::GenerationSummary& summary) {
+            bool pause = false;
+            {
+              unique_lock<mutex> guard(lock_);
+              variation->generations = summary.generation + 1;
+              variation->best_fitness =
+                  max(variation->best_fitness, summary.best_fitness);
+              pause = variation->generations >= variation->target_generations &&
+                      variation->target_generations < evolution_config_.max_generations;
+            }
+            if (pause)
+              evolution->pause();
+          });
+
+      evolution->events.subscribe([this](uint32_t hints) {
+        if ((hints & darwin::Evolution::EventFlag::StateChanged) != 0) {
+          unique_lock<mutex> guard(lock_);
+          state_cv_.notify_all();
+        }
+      });
+
+      if (!evolution->newExperiment(variation->experiment, evolution_config_))
+        throw core::Exception("Failed to start the sweep variation %d", variation->index);
+    }
+
+    variation->evolution->run();
+  }
+
+  // stops the variation and releases the evolution instance
+  // (the generations recorded so far are already saved in the universe)
+  void stopVariation(Variation* variation) {
+    auto evolution = variation->evolution.get();
+    CHECK(evolution != nullptr);
+
+    evolution->pause();
+    {
+      unique_lock<mutex> guard(lock_);
+      state_cv_.wait(guard, [&] {
+        const auto state = evolution->snapshot().state;
+        return state == darwin::Evolution::State::Paused ||
+               state == darwin::Evolution::State::Stopped ||
+               state == darwin::Evolution::State::Initializing;
+      });
+    }
+
+    CHECK(evolution->reset());
+    variation->evolution.reset();
+  }
+
+  // checks if the variation reached the end of the current rung
+  // (must be called with the lock held)
+  bool rungCompleted(const Variation* variation) const {
+    const auto state = variation->evolution->snapshot().state;
+    if (state == darwin::Evolution::State::Stopped)
+      return true;
+    return state == darwin::Evolution::State::Paused &&
+           variation->generations >= variation->target_generations;
+  }
+
+  void runRung(const vector<Variation*>& variations, int target_generations) {
+    vector<Variation*> running;
+    size_t next_index = 0;
+
+    unique_lock<mutex> guard(lock_);
+    for (;;) {
+      while (int(running.size()) < concurrency_ && next_index < variations.size()) {
+        auto variation = variations[next_index++];
+        if (variation->finished)
+          continue;
+        guard.unlock();
+        startVariation(variation, target_generations);
+        guard.lock();
+        running.push_back(variation);
+      }
+
+      if (running.empty())
+        break;
+
+      state_cv_.wait(guard, [&] {
+        return std::any_of(running.begin(), running.end(), [&](const Variation* v) {
+          return rungCompleted(v);
+        });
+      });
+
+      for (auto it = running.begin(); it != running.end();) {
+        auto variation = *it;
+        if (rungCompleted(variation)) {
+          variation->finished =
+              variation->evolution->snapshot().state == darwin::Evolution::State::Stopped;
+          fprintf(stderr,
+                  "  Variation %3d: %5d generation(s), best fitness = %10.4f  (%s)\n",
+                  variation->index,
+                  variation->generations,
+                  variation->best_fitness,
+                  overridesString(variation->overrides).c_str());
+          it = running.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+  }
+
+ private:
+  const Options& options_;
+  const json& json_config_;
+  darwin::Universe* universe_ = nullptr;
+
+  SweepConfig config_;
+  darwin::EvolutionConfig evolution_config_;
+  int concurrency_ = 0;
+  vector<int> rungs_;
+
+  vector<unique_ptr<Variation>> variations_;
+
+  // setup (JSON) -> experiment
+  map<string, db::RowId> experiments_;
+
+  mutex lock_;
+  condition_variable state_cv_;
+};
+
+}  // namespace
+
+vector<SweepParameter> parseSweepParameters(const json& json_parameters) {
+  if (!json_parameters.is_object())
+    throw core::Exception("Invalid sweep parameters (expected a JSON object)");
+
+  vector<SweepParameter> parameters;
+  for (const auto& item : json_parameters.items()) {
+    const auto& key = item.key();
+    const auto& json_values = item.value();
+
+    const auto dot_pos = key.find('.');
+    if (dot_pos == string::npos)
+      throw core::Exception("Invalid sweep parameter: '%s'", key);
+
+    SweepParameter parameter;
+    try {
+      parameter.section = core::fromString<Section>(key.substr(0, dot_pos));
+    } catch (const std::exception&) {
+      throw core::Exception("Invalid configuration section: '%s'",
+                            key.substr(0, dot_pos));
+    }
+    parameter.path = key.substr(dot_pos + 1);
+
+    switch (parameter.section) {
+      case Section::Setup:
+      case Section::Core:
+      case Section::Domain:
+      case Section::Population:
+        break;
+      default:
+        // only the values recorded in the universe can be swept
+        throw core::Exception("The '%s' properties can't be swept",
+                              core::toString(parameter.section));
+    }
+
+    if (json_values.is_array()) {
+      if (json_values.empty())
+        throw core::Exception("Missing the values for the sweep parameter '%s'", key);
+      for (const auto& json_value : json_values)
+        parameter.values.push_back(valueString(json_value));
+    } else if (json_values.is_object()) {
+      const auto min_it = json_values.find("min");
+      const auto max_it = json_values.find("max");
+      if (min_it == json_values.end() || max_it == json_values.end() ||
+          !min_it->is_number() || !max_it->is_number()) {
+        throw core::Exception("Invalid range for the sweep parameter '%s'", key);
+      }
+      SweepParameter::Range range;
+      range.min = min_it->get<double>();
+      range.max = max_it->get<double>();
+      range.integer = min_it->is_number_integer() && max_it->is_number_integer();
+      range.log = json_values.value("log", false);
+      if (range.min > range.max || (range.log && range.min <= 0))
+        throw core::Exception("Invalid range for the sweep parameter '%s'", key);
+      parameter.range = range;
+    } else {
+      throw core::Exception("Invalid values for the sweep parameter '%s'", key);
+    }
+
+    parameters.push_back(parameter);
+  }
+  return parameters;
+}
+
+vector<vector<PropertyOverride>> sweepVariations(
+    const SweepConfig& config,
+    const vector<SweepParameter>& parameters) {
+  vector<vector<PropertyOverride>> variations;
+
+  switch (config.search) {
+    case SweepSearch::Grid: {
+      for (const auto& parameter : parameters) {
+        if (parameter.range) {
+          throw core::Exception(
+              "The sweep parameter '%s' is a range (only supported by random search)",
+              parameter.path);
+        }
+      }
+
+      // every combination (the last parameter varies the fastest)
+      vector<size_t> indexes(parameters.size(), 0);
+      for (;;) {
+        vector<PropertyOverride> overrides;
+        for (size_t i = 0; i < parameters.size(); ++i) {
+          const auto& parameter = parameters[i];
+          overrides.push_back(
+              { parameter.section, parameter.path, parameter.values[indexes[i]] });
+        }
+        variations.push_back(std::move(overrides));
+
+        int i = int(parameters.size()) - 1;
+        for (; i >= 0; --i) {
+          if (++indexes[i] < parameters[i].values.size())
+            break;
+          indexes[i] = 0;
+        }
+        if (i < 0)
+          break;
+      }
+      break;
+    }
+
+    case SweepSearch::Random: {
+      if (config.samples < 1)
+        throw core::Exception("Invalid sweep.samples value: %d", int(config.samples));
+      std::mt19937_64 rnd(config.seed);
+      for (int sample = 0; sample < config.samples; ++sample) {
+        vector<PropertyOverride> overrides;
+        for (const auto& parameter : parameters) {
+          overrides.push_back(
+              { parameter.section, parameter.path, sampleValue(parameter, rnd) });
+        }
+        variations.push_back(std::move(overrides));
+      }
+      break;
+    }
+
+    default:
+      FATAL("Unexpected sweep search kind");
+  }
+
+  return variations;
+}
+
+vector<int> sweepRungs(const SweepConfig& config, int max_generations) {
+  CHECK(max_generations > 0);
+  vector<int> rungs;
+  if (config.halving_eta > 1) {
+    if (config.min_generations < 1)
+      throw core::Exception("Invalid sweep.min_generations value");
+    for (long long budget = config.min_generations; budget < max_generations;
+         budget *= config.halving_eta) {
+      rungs.push_back(int(budget));
+    }
+  }
+  rungs.push_back(max_generations);
+  return rungs;
+}
+
+int runSweep(const Options& options,
+             const json& json_config,
+             darwin::Universe* universe) {
+  const auto json_sweep_it = json_config.find(core::toString(Section::Sweep));
+  if (json_sweep_it == json_config.end() || !json_sweep_it->is_object())
+    throw core::Exception("Missing the sweep configuration");
+  if (json_sweep_it->count("parameters") == 0)
+    throw core::Exception("Missing the sweep parameters");
+
+  const auto parameters = parseSweepParameters(json_sweep_it->at("parameters"));
+
+  // the sweep parameters are not properties of the SweepConfig
+  auto sweep_json_config = json::object();
+  sweep_json_config[core::toString(Section::Sweep)] = *json_sweep_it;
+  sweep_json_config[core::toString(Section::Sweep)].erase("parameters");
+
+  SweepConfig config;
+  applyConfig(&config, Section::Sweep, sweep_json_config, options.overrides);
+  if (config.concurrency < 0)
+    throw core::Exception("Invalid sweep.concurrency value: %d", int(config.concurrency));
+  if (config.halving_eta < 0)
+    throw core::Exception("Invalid sweep.halving_eta value: %d", int(config.halving_eta));
+
+  const auto variations = sweepVariations(config, parameters);
+
+  SweepRunner runner(options, json_config, config, universe);
+  runner.run(variations);
+  runner.printResults();
+  return 0;
+}
+
+}  // namespace darwin_cli
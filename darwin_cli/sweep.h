@@ -0,0 +1,132 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#include "cli_options.h"
+
+#include <core/properties.h>
+#include <core/stringify.h>
+#include <core/universe.h>
+
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <optional>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace darwin_cli {
+
+//! How the sweep variations are generated
+enum class SweepSearch {
+  Grid,    //!< Every combination of the parameter values
+  Random,  //!< A fixed number of random samples from the parameter values
+};
+
+inline auto customStringify(core::TypeTag<SweepSearch>) {
+  static auto stringify = new core::StringifyKnownValues<SweepSearch>{
+    { SweepSearch::Grid, "grid" },
+    { SweepSearch::Random, "random" },
+  };
+  return stringify;
+}
+
+//! Sweep configuration (the `sweep` section of the JSON configuration)
+//!
+//! The swept parameters are specified in the `sweep.parameters` object, mapping
+//! `<section>.<property path>` to the candidate values:
+//!
+//! ```json
+//! "sweep": {
+//!   "search": "grid",
+//!   "parameters": {
+//!     "setup.population_size": [ 100, 500 ],
+//!     "population.mutation_std_dev": [ 0.1, 0.5, 1.0 ],
+//!     "core.activation_function": [ "tanh", "relu" ]
+//!   }
+//! }
+//! ```
+//!
+//! With random search, a parameter can also be a numeric range
+//! (`{ "min": 0.01, "max": 1.0 }`, with an optional `"log": true`)
+//!
+struct SweepConfig : public core::PropertySet {
+  PROPERTY(search, SweepSearch, SweepSearch::Grid, "Grid or random search");
+
+  PROPERTY(samples, int, 10, "The number of variations (random search only)");
+
+  PROPERTY(seed, int, 1, "The random search seed");
+
+  PROPERTY(concurrency,
+           int,
+           0,
+           "The max number of variations running at the same time "
+           "(0 = the number of worker threads)");
+
+  PROPERTY(halving_eta,
+           int,
+           3,
+           "Successive halving: only the top 1/eta variations advance to the next rung "
+           "(0 or 1 = no early stopping)");
+
+  PROPERTY(min_generations,
+           int,
+           5,
+           "Successive halving: the generations budget of the first rung "
+           "(each rung multiplies the budget by eta, up to evolution.max_generations)");
+};
+
+//! A swept property and its candidate values
+struct SweepParameter {
+  Section section = Section::Setup;
+  string path;
+
+  //! Discrete values (grid or random search)
+  vector<string> values;
+
+  //! Numeric range (random search only)
+  struct Range {
+    double min = 0;
+    double max = 0;
+    bool integer = false;
+    bool log = false;
+  };
+  optional<Range> range;
+};
+
+//! Parses the `sweep.parameters` object
+//! \throws core::Exception if the parameters are invalid
+vector<SweepParameter> parseSweepParameters(const json& json_parameters);
+
+//! Generates the property overrides for each sweep variation
+vector<vector<PropertyOverride>> sweepVariations(
+    const SweepConfig& config,
+    const vector<SweepParameter>& parameters);
+
+//! The successive halving rungs (the generations budgets)
+vector<int> sweepRungs(const SweepConfig& config, int max_generations);
+
+//! Runs a hyperparameter sweep (darwin_cli --sweep)
+//!
+//! Each variation is recorded as an experiment variation in the universe (one
+//! experiment per distinct setup). The variations run concurrently, as independent
+//! darwin::Evolution instances sharing the worker threads.
+//!
+int runSweep(const Options& options,
+             const json& json_config,
+             darwin::Universe* universe);
+
+}  // namespace darwin_cli
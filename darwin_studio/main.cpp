@@ -18,6 +18,7 @@
 
 #include <core/utils.h>
 #include <core/darwin.h>
+#include <core/evaluation_workers.h>
 #include <core/evolution.h>
 #include <core/runtime.h>
 #include <core/logging.h>
@@ -27,6 +28,12 @@
 #include <QApplication>
 
 int main(int argc, char* argv[]) {
+  // evaluation worker processes (see darwin::EvaluationWorkers)
+  if (darwin::EvaluationWorkers::isWorkerProcess(argc, argv)) {
+    registry::init();
+    return darwin::EvaluationWorkers::workerMain(argc, argv);
+  }
+
   QApplication app(argc, argv);
   Q_INIT_RESOURCE(resources);
 
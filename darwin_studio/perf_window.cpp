@@ -92,4 +92,37 @@ void PerfWindow::updateChart(const darwin::EvolutionStage& stage) {
   y_axis->setRange(0, fmax(elapsed * kAutoRangeScale, y_axis->max()));
 
   ++stage_index_;
+
+  updateCounters(stage);
+}
+
+void PerfWindow::updateCounters(const darwin::EvolutionStage& stage) {
+  const auto& counters = stage.perfCounters();
+  if (!counters.has_value()) {
+    ui->counters_label->setVisible(false);
+    return;
+  }
+
+  auto formatCount = [](uint64_t value) {
+    if (value >= 1'000'000'000)
+      return QString("%1G").arg(value / 1e9, 0, 'f', 2);
+    if (value >= 1'000'000)
+      return QString("%1M").arg(value / 1e6, 0, 'f', 2);
+    if (value >= 1'000)
+      return QString("%1K").arg(value / 1e3, 0, 'f', 2);
+    return QString::number(value);
+  };
+
+  const double ipc =
+      counters->cycles > 0 ? double(counters->instructions) / counters->cycles : 0;
+
+  ui->counters_label->setText(
+      QString("Last generation: %1 cycles, %2 instructions (IPC %3), "
+              "%4 cache misses, %5 branch misses")
+          .arg(formatCount(counters->cycles))
+          .arg(formatCount(counters->instructions))
+          .arg(ipc, 0, 'f', 2)
+          .arg(formatCount(counters->cache_misses))
+          .arg(formatCount(counters->branch_misses)));
+  ui->counters_label->setVisible(true);
 }
@@ -43,6 +43,7 @@ class PerfWindow : public QFrame {
 
  private:
   void updateChart(const darwin::EvolutionStage& stage);
+  void updateCounters(const darwin::EvolutionStage& stage);
 
  private:
   Ui::PerfWindow* ui;
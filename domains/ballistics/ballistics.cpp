@@ -20,7 +20,9 @@
 #include <core/exception.h>
 #include <core/logging.h>
 #include <core/parallel_for_each.h>
+#include <core/sim/world_pool.h>
 
+#include <memory>
 #include <random>
 using namespace std;
 
@@ -54,11 +56,17 @@ bool Ballistics::evaluatePopulation(darwin::Population* population) const {
     darwin::StageScope stage("Evaluate one world", population->size());
     core::log(" ... world %d\n", world_index);
 
-    const b2Vec2 target_position = randomTargetPosition();
+    // the test world (see darwin::evaluationSeed())
+    default_random_engine rnd(darwin::evaluationSeed(world_index));
+    const b2Vec2 target_position = randomTargetPosition(rnd);
     const float target_distance = target_position.Length();
 
+    // one world instance per thread, reset for each episode
+    sim::WorldPool<World> world_pool(
+        [&] { return make_unique<World>(target_position, this); });
+
     pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
-      World world(target_position, this);
+      World& world = *world_pool.acquire();
 
       Agent agent(genotype);
       world.fireProjectile(agent.aim(target_position.x, target_position.y));
@@ -87,9 +95,7 @@ bool Ballistics::evaluatePopulation(darwin::Population* population) const {
   return false;
 }
 
-b2Vec2 Ballistics::randomTargetPosition() const {
-  random_device rd;
-  default_random_engine rnd(rd());
+b2Vec2 Ballistics::randomTargetPosition(default_random_engine& rnd) const {
   uniform_real_distribution<float> dist_x(config_.range_min_x, config_.range_max_x);
   uniform_real_distribution<float> dist_y(config_.range_min_y, config_.range_max_y);
   return b2Vec2(dist_x(rnd), dist_y(rnd));
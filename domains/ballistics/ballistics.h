@@ -18,6 +18,9 @@
 #include <core/properties.h>
 #include <third_party/box2d/box2d.h>
 
+#include <random>
+using namespace std;
+
 namespace ballistics {
 
 //! Ballistics domain configuration
@@ -79,10 +82,11 @@ class Ballistics : public darwin::Domain {
   size_t outputs() const override;
 
   bool evaluatePopulation(darwin::Population* population) const override;
+  bool independentEvaluation() const override { return true; }
   
   const Config& config() const { return config_; }
   
-  b2Vec2 randomTargetPosition() const;
+  b2Vec2 randomTargetPosition(default_random_engine& rnd) const;
   
  private:
   void validateConfiguration();
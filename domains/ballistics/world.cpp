@@ -36,6 +36,15 @@ World::World(b2Vec2 target_pos, const Ballistics* domain)
   
   // default vertical limit
   vertical_limit_ = target_pos.y - (config.target_radius + config.projectile_radius);
+  initial_vertical_limit_ = vertical_limit_;
+
+  b2_world_.recordInitialState();
+}
+
+void World::reset() {
+  b2_world_.reset();
+  projectile_ = nullptr;
+  vertical_limit_ = initial_vertical_limit_;
 }
 
 void World::fireProjectile(float aim_angle) {
@@ -69,7 +78,7 @@ bool World::simStep() {
   constexpr int32 kPositionIterations = 5;
 
   // box2d: simulate one step
-  b2_world_.Step(kTimeStep, kVelocityIterations, kPositionIterations);
+  b2_world_.step(kTimeStep, kVelocityIterations, kPositionIterations);
 
   const float y = projectile_->GetPosition().y;
   const float vy = projectile_->GetLinearVelocity().y;
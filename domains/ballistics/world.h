@@ -16,6 +16,7 @@
 
 #include "ballistics.h"
 
+#include <core/sim/resettable_world.h>
 #include <third_party/box2d/box2d.h>
 
 namespace ballistics {
@@ -24,6 +25,9 @@ class World {
  public:
   World(b2Vec2 target_pos, const Ballistics* domain);
 
+  // restores the initial state (removing the projectile)
+  void reset();
+
   // creates a projectile with the initial velocity and the given angle (radians)
   void fireProjectile(float aim_angle);
   
@@ -43,11 +47,12 @@ class World {
   b2World* box2dWorld() { return &b2_world_; }
  
  private:
-  b2World b2_world_;
+  sim::ResettableWorld b2_world_;
   b2Body* target_ = nullptr;
   b2Body* projectile_ = nullptr;
   
   float vertical_limit_ = 0;
+  float initial_vertical_limit_ = 0;
   
   const Ballistics* domain_ = nullptr;
 };
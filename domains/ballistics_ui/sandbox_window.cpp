@@ -23,6 +23,7 @@
 #include <QString>
 
 #include <algorithm>
+#include <random>
 using namespace std;
 
 namespace ballistics_ui {
@@ -72,7 +73,8 @@ bool SandboxWindow::setup() {
 }
 
 void SandboxWindow::newScene() {
-  setupScene(domain_->randomTargetPosition());
+  default_random_engine rnd(random_device{}());
+  setupScene(domain_->randomTargetPosition(rnd));
 }
 
 void SandboxWindow::singleStep() {
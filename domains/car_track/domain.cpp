@@ -62,15 +62,13 @@ bool CarTrack::evaluatePopulation(darwin::Population* population) const {
   const int generation = population->generation();
   core::log("\n. generation %d\n", generation);
 
-  // reset the fitness values
-  pp::for_each(*population,
-               [&](int, darwin::Genotype* genotype) { genotype->fitness = 0; });
+  darwin::RacingEvaluation race(population, config_.test_worlds, config_.racing);
 
   // evaluate each genotype (over N worlds)
   for (int world_index = 0; world_index < config_.test_worlds; ++world_index) {
     darwin::StageScope stage(
         core::format("World %d/%d", world_index + 1, config_.test_worlds),
-        population->size());
+        race.contenders().size());
     core::log(" ... world %d\n", world_index);
 
     // create track
@@ -84,10 +82,11 @@ bool CarTrack::evaluatePopulation(darwin::Population* population) const {
     track_config.curb_friction = config_.curb_friction;
     track_config.gates = config_.track_gates;
     track_config.solid_gate_posts = config_.solid_gate_posts;
-    const auto random_seed = std::random_device{}();
-    const sim::Track track(random_seed, track_config);
+    const auto random_seed = darwin::evaluationSeed(world_index);
+    const sim::Track track(sim::Track::Seed(random_seed), track_config);
 
-    pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
+    pp::for_each(race.contenders(), [&](int, size_t genotype_index) {
+      const auto genotype = population->genotype(genotype_index);
       Scene scene(&track, this);
       sim::CarController agent(genotype, scene.car());
 
@@ -99,14 +98,17 @@ bool CarTrack::evaluatePopulation(darwin::Population* population) const {
         }
       }
 
-      // normalize the fitness to [0, 1], invariant to the number of test worlds
-      const float episode_fitness = scene.fitness() / config_.test_worlds;
-      genotype->fitness += episode_fitness;
+      // normalized to [0, 1] (the race averages the episodes over all test worlds)
+      race.recordEpisode(genotype_index, scene.fitness());
 
       darwin::ProgressManager::reportProgress();
     });
+
+    race.finishWorld();
   }
 
+  race.finish();
+
   core::log("\n");
   return false;
 }
@@ -16,6 +16,7 @@
 
 #include <core/darwin.h>
 #include <core/properties.h>
+#include <core/racing.h>
 #include <core/sim/car.h>
 
 #include <third_party/box2d/box2d.h>
@@ -49,6 +50,11 @@ struct Config : public core::PropertySet {
 
   PROPERTY(test_worlds, int, 3, "Number of test worlds per generation");
   PROPERTY(max_steps, int, 1000, "Maximum number of steps per episode");
+
+  VARIANT(racing,
+          darwin::RacingVariant,
+          darwin::RacingType::None,
+          "Early termination of the weakest genotypes (racing over the test worlds)");
 };
 
 //! Domain: Car Track
@@ -79,6 +85,15 @@ class CarTrack : public darwin::Domain {
   size_t outputs() const override;
 
   bool evaluatePopulation(darwin::Population* population) const override;
+  // racing ranks the genotypes against the rest of the evaluated population
+  bool independentEvaluation() const override {
+    return config_.racing.tag() == darwin::RacingType::None;
+  }
+  vector<darwin::FidelityKnob> fidelityKnobs() const override {
+    return { { "max_steps", 100 },
+             { "test_worlds", 1 },
+             { "track_resolution", config_.track_complexity * 10 } };
+  }
 
   const Config& config() const { return config_; }
   const sim::CarConfig& carConfig() const { return car_config_; }
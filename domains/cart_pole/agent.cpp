@@ -21,23 +21,34 @@ Agent::Agent(const darwin::Genotype* genotype, World* world)
     : world_(world), brain_(genotype->grow()) {}
 
 void Agent::simStep() {
-  const auto& config = world_->domain()->config();
-  
+  const float force = act(world_->domain()->config(),
+                          world_->poleAngle(),
+                          world_->poleAngularVelocity(),
+                          world_->cartDistance(),
+                          world_->cartVelocity());
+
+  // act based on the output values
+  world_->moveCart(force);
+}
+
+float Agent::act(const Config& config,
+                 float pole_angle,
+                 float angular_velocity,
+                 float cart_distance,
+                 float cart_velocity) {
   // setup inputs
   int input_index = 0;
   if (config.input_pole_angle)
-    brain_->setInput(input_index++, world_->poleAngle());
+    brain_->setInput(input_index++, pole_angle);
   if (config.input_angular_velocity)
-    brain_->setInput(input_index++, world_->poleAngularVelocity());
+    brain_->setInput(input_index++, angular_velocity);
   if (config.input_cart_distance)
-    brain_->setInput(input_index++, world_->cartDistance());
+    brain_->setInput(input_index++, cart_distance);
   if (config.input_cart_velocity)
-    brain_->setInput(input_index++, world_->cartVelocity());
+    brain_->setInput(input_index++, cart_velocity);
 
   brain_->think();
-  
-  // act based on the output values
-  world_->moveCart(brain_->output(0));
+  return brain_->output(0);
 }
 
 int Agent::inputs(const Config& config) {
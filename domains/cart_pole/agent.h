@@ -27,8 +27,16 @@ class World;
 
 class Agent {
  public:
+  // the world is optional (nullptr) if the agent is only used through act()
   Agent(const darwin::Genotype* genotype, World* world);
   void simStep();
+
+  // runs the brain for the given state, returning the raw output (force)
+  float act(const Config& config,
+            float pole_angle,
+            float angular_velocity,
+            float cart_distance,
+            float cart_velocity);
   
   static int inputs(const Config& config);
   static int outputs(const Config& config);
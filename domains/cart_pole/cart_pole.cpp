@@ -18,10 +18,15 @@
 
 #include <core/evolution.h>
 #include <core/parallel_for_each.h>
+#include <core/sim/world_pool.h>
 #include <core/logging.h>
 #include <core/exception.h>
+#include <core/math_2d.h>
 
+#include <algorithm>
+#include <memory>
 #include <random>
+#include <vector>
 using namespace std;
 
 namespace cart_pole {
@@ -45,19 +50,30 @@ bool CartPole::evaluatePopulation(darwin::Population* population) const {
   const int generation = population->generation();
   core::log("\n. generation %d\n", generation);
 
-  // reset the fitness values
-  pp::for_each(*population,
-               [&](int, darwin::Genotype* genotype) { genotype->fitness = 0; });
+  darwin::RacingEvaluation race(population, config_.test_worlds, config_.racing);
 
   // evaluate each genotype (over N worlds)
   for (int world_index = 0; world_index < config_.test_worlds; ++world_index) {
-    darwin::StageScope stage("Evaluate one world", population->size());
+    darwin::StageScope stage("Evaluate one world", race.contenders().size());
     core::log(" ... world %d\n", world_index);
 
-    const float initial_angle = randomInitialAngle();
+    // the test world (see darwin::evaluationSeed())
+    default_random_engine rnd(darwin::evaluationSeed(world_index));
+    const float initial_angle = randomInitialAngle(rnd);
 
-    pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
-      World world(initial_angle, this);
+    if (config_.physics == sim::CartPolePhysics::Analytic) {
+      evaluateAnalytic(population, &race, initial_angle);
+      race.finishWorld();
+      continue;
+    }
+
+    // one world instance per thread, reset for each episode
+    sim::WorldPool<World> world_pool(
+        [&] { return make_unique<World>(initial_angle, this); });
+
+    pp::for_each(race.contenders(), [&](int, size_t genotype_index) {
+      const auto genotype = population->genotype(genotype_index);
+      World& world = *world_pool.acquire();
       Agent agent(genotype, &world);
 
       // simulation loop
@@ -70,19 +86,123 @@ bool CartPole::evaluatePopulation(darwin::Population* population) const {
       CHECK(step > 0);
 
       // the fitness is the average number of steps over all test worlds
-      genotype->fitness += float(step) / config_.test_worlds;
+      race.recordEpisode(genotype_index, float(step));
 
       darwin::ProgressManager::reportProgress();
     });
+
+    race.finishWorld();
   }
 
+  race.finish();
+
   core::log("\n");
   return false;
 }
 
-float CartPole::randomInitialAngle() const {
-  random_device rd;
-  default_random_engine rnd(rd());
+void CartPole::evaluateAnalytic(darwin::Population* population,
+                                darwin::RacingEvaluation* race,
+                                float initial_angle) const {
+  // the contenders are split into batches of carts which are stepped together
+  constexpr int kBatchSize = 64;
+  const auto& contenders = race->contenders();
+  const int contenders_count = int(contenders.size());
+  vector<int> batches;
+  for (int index = 0; index < contenders_count; index += kBatchSize) {
+    batches.push_back(index);
+  }
+
+  const auto model = World::analyticModel(config_);
+  const vector<float> initial_angles = { float(math::degreesToRadians(initial_angle)) };
+
+  pp::for_each(batches, [&](int, int first_index) {
+    const int batch_size = min(kBatchSize, contenders_count - first_index);
+    sim::CartPoleBatch carts(model, batch_size);
+
+    vector<Agent> agents;
+    agents.reserve(batch_size);
+    for (int i = 0; i < batch_size; ++i) {
+      carts.reset(i, initial_angles);
+      agents.emplace_back((*population)[contenders[first_index + i]], nullptr);
+    }
+
+    // simulation loop
+    vector<int> steps(batch_size, 0);
+    vector<bool> active(batch_size, true);
+    int active_count = batch_size;
+    for (int step = 0; step < config_.max_steps && active_count > 0; ++step) {
+      for (int i = 0; i < batch_size; ++i) {
+        if (active[i]) {
+          const float output = agents[i].act(config_,
+                                             carts.poleAngle(i, 0),
+                                             carts.poleAngularVelocity(i, 0),
+                                             carts.cartPosition(i),
+                                             carts.cartVelocity(i));
+          carts.setForce(i, actuatorForce(output));
+        }
+      }
+
+      carts.step(World::kTimeStep);
+
+      for (int i = 0; i < batch_size; ++i) {
+        if (active[i]) {
+          if (withinLimits(carts.cartPosition(i), carts.poleAngle(i, 0))) {
+            ++steps[i];
+          } else {
+            active[i] = false;
+            --active_count;
+          }
+        }
+      }
+    }
+
+    for (int i = 0; i < batch_size; ++i) {
+      CHECK(steps[i] > 0);
+
+      // the fitness is the average number of steps over all test worlds
+      race->recordEpisode(contenders[first_index + i], float(steps[i]));
+
+      darwin::ProgressManager::reportProgress();
+    }
+  });
+}
+
+float CartPole::actuatorForce(float output) const {
+  CHECK(!isnan(output));
+
+  float force = output;
+
+  // discrete control forces?
+  if (config_.discrete_controls && force != 0) {
+    const auto magnitude = config_.discrete_force_magnitude;
+    force = force > 0 ? +magnitude : -magnitude;
+  }
+
+  // cap the maximum force magnitude
+  // (applies to the discrete inputs as well)
+  if (force < -config_.max_force) {
+    force = -config_.max_force;
+  } else if (force > config_.max_force) {
+    force = config_.max_force;
+  }
+
+  return force;
+}
+
+bool CartPole::withinLimits(float cart_distance, float pole_angle) const {
+  // check cart distance
+  if (cart_distance < -config_.max_distance || cart_distance > config_.max_distance)
+    return false;
+
+  // check pole angle
+  const auto max_angle = math::degreesToRadians(config_.max_angle);
+  if (pole_angle < -max_angle || pole_angle > max_angle)
+    return false;
+
+  return true;
+}
+
+float CartPole::randomInitialAngle(default_random_engine& rnd) const {
   uniform_real_distribution<float> dist(-config_.max_initial_angle,
                                         config_.max_initial_angle);
   return dist(rnd);
@@ -105,6 +225,9 @@ void CartPole::validateConfiguration()
     throw core::Exception("Invalid configuration: pole_density must be positive");
   if (config_.cart_density < 0)
     throw core::Exception("Invalid configuration: cart_density must be positive or 0");
+  if (config_.physics == sim::CartPolePhysics::Analytic && config_.cart_friction != 0)
+    throw core::Exception(
+        "Invalid configuration: cart_friction is not supported by the analytic physics");
 
   if (inputs() < 1)
     throw core::Exception("Invalid configuration: at least one input must be selected");
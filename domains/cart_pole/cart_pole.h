@@ -16,6 +16,11 @@
 
 #include <core/darwin.h>
 #include <core/properties.h>
+#include <core/racing.h>
+#include <core/sim/cart_pole_batch.h>
+
+#include <random>
+using namespace std;
 
 namespace cart_pole {
 
@@ -39,6 +44,16 @@ struct Config : public core::PropertySet {
   PROPERTY(test_worlds, int, 5, "Number of test worlds per generation");
   PROPERTY(max_steps, int, 1000, "Maximum number of steps per episode");
 
+  VARIANT(racing,
+          darwin::RacingVariant,
+          darwin::RacingType::None,
+          "Early termination of the weakest genotypes (racing over the test worlds)");
+
+  PROPERTY(physics,
+           sim::CartPolePhysics,
+           sim::CartPolePhysics::Box2D,
+           "Physics engine (the analytic engine doesn't support cart friction)");
+
   PROPERTY(discrete_controls,
            bool,
            true,
@@ -87,6 +102,13 @@ struct Config : public core::PropertySet {
 //! ------:|------
 //!      0 | force
 //!
+//! ### Physics
+//!
+//! By default the cart and the pole are simulated using Box2D. Alternatively,
+//! `physics = analytic` selects the analytic equations of motion (sim::CartPoleBatch),
+//! which track the Box2D simulation closely (see sim::CartPoleBatch for the tolerance)
+//! and evaluate the population in batches of carts stepped together.
+//!
 class CartPole : public darwin::Domain {
  public:
   explicit CartPole(const core::PropertySet& config);
@@ -95,14 +117,31 @@ class CartPole : public darwin::Domain {
   size_t outputs() const override;
 
   bool evaluatePopulation(darwin::Population* population) const override;
+  // racing ranks the genotypes against the rest of the evaluated population
+  bool independentEvaluation() const override {
+    return config_.racing.tag() == darwin::RacingType::None;
+  }
+  vector<darwin::FidelityKnob> fidelityKnobs() const override {
+    return { { "max_steps", 100 }, { "test_worlds", 1 } };
+  }
   
   const Config& config() const { return config_; }
   
-  float randomInitialAngle() const;
+  float randomInitialAngle(default_random_engine& rnd) const;
+
+  //! Maps the brain output to the force applied to the cart
+  float actuatorForce(float output) const;
+
+  //! Checks the cart position and the pole angle (radians) against the episode limits
+  bool withinLimits(float cart_distance, float pole_angle) const;
   
  private:
   void validateConfiguration();
 
+  void evaluateAnalytic(darwin::Population* population,
+                        darwin::RacingEvaluation* race,
+                        float initial_angle) const;
+
  private:
   Config config_;
 };
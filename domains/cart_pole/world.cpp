@@ -23,7 +23,6 @@ World::World(float initial_angle, const CartPole* domain)
   const auto& config = domain_->config();
 
   // ground
-  constexpr float kGroundY = 0.1f;
   b2EdgeShape ground_shape;
   ground_shape.Set(b2Vec2(-config.max_distance, 0), b2Vec2(config.max_distance, 0));
 
@@ -33,8 +32,6 @@ World::World(float initial_angle, const CartPole* domain)
   ground->CreateFixture(&ground_shape, 0.0f);
 
   // cart
-  constexpr float kCartHalfWidth = 0.2f;
-  constexpr float kCartHalfHeight = 0.05f;
   b2PolygonShape cart_shape;
   cart_shape.SetAsBox(kCartHalfWidth, kCartHalfHeight);
 
@@ -50,7 +47,6 @@ World::World(float initial_angle, const CartPole* domain)
   cart_->CreateFixture(&cart_fixture_def);
 
   // pole
-  constexpr float kPoleHalfWidth = 0.02f;
   const float kPoleHalfHeight = config.pole_length / 2;
   b2PolygonShape pole_shape;
   pole_shape.SetAsBox(kPoleHalfWidth, kPoleHalfHeight, b2Vec2(0, kPoleHalfHeight), 0.0f);
@@ -73,52 +69,34 @@ World::World(float initial_angle, const CartPole* domain)
   hinge_def.localAnchorA.Set(0.0f, 0.0f);
   hinge_def.localAnchorB.Set(0.0f, 0.0f);
   b2_world_.CreateJoint(&hinge_def);
+
+  b2_world_.recordInitialState();
+}
+
+sim::CartPoleModel World::analyticModel(const Config& config) {
+  sim::CartPoleModel model;
+  model.gravity = config.gravity;
+  model.setCartBox(kCartHalfWidth * 2, kCartHalfHeight * 2, config.cart_density);
+  model.addPoleBox(kPoleHalfWidth * 2, config.pole_length, config.pole_density);
+  return model;
+}
+
+void World::reset() {
+  b2_world_.reset();
 }
 
 bool World::simStep() {
-  constexpr float32 kTimeStep = 1.0f / 50.0f;
   constexpr int32 kVelocityIterations = 5;
   constexpr int32 kPositionIterations = 5;
 
-  const auto& config = domain_->config();
-
   // box2d: simulate one step
-  b2_world_.Step(kTimeStep, kVelocityIterations, kPositionIterations);
-
-  // check cart distance
-  const auto distance = cartDistance();
-  if (distance < -config.max_distance || distance > config.max_distance)
-    return false;
-
-  // check pole angle
-  const auto pole_angle = poleAngle();
-  const auto max_angle = math::degreesToRadians(config.max_angle);
-  if (pole_angle < -max_angle || pole_angle > max_angle)
-    return false;
+  b2_world_.step(kTimeStep, kVelocityIterations, kPositionIterations);
 
-  return true;
+  return domain_->withinLimits(cartDistance(), poleAngle());
 }
 
 void World::moveCart(float force) {
-  CHECK(!isnan(force));
-  
-  const auto& config = domain_->config();
-
-  // discrete control forces?
-  if (config.discrete_controls && force != 0) {
-    const auto magnitude = config.discrete_force_magnitude;
-    force = force > 0 ? +magnitude : -magnitude;
-  }
-  
-  // cap the maximum force magnitude
-  // (applies to the discrete inputs as well)
-  if (force < -config.max_force) {
-    force = -config.max_force;
-  } else if (force > config.max_force) {
-    force = config.max_force;
-  }
-  
-  cart_->ApplyForceToCenter(b2Vec2(force, 0), true);
+  cart_->ApplyForceToCenter(b2Vec2(domain_->actuatorForce(force), 0), true);
 }
 
 }  // namespace cart_pole
@@ -16,14 +16,30 @@
 
 #include "cart_pole.h"
 
+#include <core/sim/resettable_world.h>
 #include <third_party/box2d/box2d.h>
 
 namespace cart_pole {
 
 class World {
+  static constexpr float kCartHalfWidth = 0.2f;
+  static constexpr float kCartHalfHeight = 0.05f;
+  static constexpr float kPoleHalfWidth = 0.02f;
+  static constexpr float kGroundY = 0.1f;
+
+ public:
+  static constexpr float kTimeStep = 1.0f / 50.0f;
+
  public:
   World(float initial_angle, const CartPole* domain);
-  
+
+  // the physical parameters used by the analytic physics engine
+  // (matching the Box2D world)
+  static sim::CartPoleModel analyticModel(const Config& config);
+
+  // restores the initial state (reusing the Box2D world)
+  void reset();
+
   // advances the physical simulation one step, returning false
   // if the state reaches one of the termination conditions
   bool simStep();
@@ -42,7 +58,7 @@ class World {
   b2World* box2dWorld() { return &b2_world_; }
   
  private:
-  b2World b2_world_;
+  sim::ResettableWorld b2_world_;
 
   b2Body* cart_ = nullptr;
   b2Body* pole_ = nullptr;
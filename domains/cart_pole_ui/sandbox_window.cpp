@@ -22,6 +22,9 @@
 
 #include <QString>
 
+#include <random>
+using namespace std;
+
 namespace cart_pole_ui {
 
 bool SandboxWindow::setup() {
@@ -72,7 +75,8 @@ void SandboxWindow::newScene() {
   CHECK(cart_pole_ != nullptr);
   CHECK(max_steps_ > 0);
 
-  world_ = make_unique<cart_pole::World>(cart_pole_->randomInitialAngle(), cart_pole_);
+  default_random_engine rnd(random_device{}());
+  world_ = make_unique<cart_pole::World>(cart_pole_->randomInitialAngle(rnd), cart_pole_);
   agent_ = make_unique<cart_pole::Agent>(genotype_.get(), world_.get());
   step_ = 0;
 
@@ -72,10 +72,19 @@ string AnnPlayer::name() const {
 
 void AnnPlayer::grow(const darwin::Genotype* genotype) {
   assert(genotype != nullptr);
-  brain = genotype->grow();
+  owned_brain_ = genotype->grow();
+  brain = owned_brain_.get();
   this->genotype = genotype;
 }
 
+void AnnPlayer::attach(const tournament::Contestant& contestant) {
+  assert(contestant.genotype != nullptr);
+  assert(contestant.brain != nullptr);
+  owned_brain_.reset();
+  brain = contestant.brain;
+  genotype = contestant.genotype;
+}
+
 void AnnPlayer::newGame(const Game* game, Player::Side side) {
   assert(brain);
   assert(genotype != nullptr);
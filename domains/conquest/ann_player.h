@@ -18,12 +18,13 @@
 #include "player.h"
 
 #include <core/darwin.h>
+#include <core/tournament.h>
 
 namespace conquest {
 
 class AnnPlayer : public Player {
  public:
-  unique_ptr<darwin::Brain> brain;
+  darwin::Brain* brain = nullptr;
   const darwin::Genotype* genotype = nullptr;
   int generation = -1;
 
@@ -34,8 +35,14 @@ class AnnPlayer : public Player {
 
   void grow(const darwin::Genotype* genotype);
 
+  //! Uses an already grown brain (owned by the caller)
+  void attach(const tournament::Contestant& contestant);
+
   static size_t inputsCount(const Board* board);
   static size_t outputsCount(const Board* board);
+
+ private:
+  unique_ptr<darwin::Brain> owned_brain_;
 };
 
 }  // namespace conquest
@@ -21,9 +21,12 @@
 #include <core/darwin.h>
 #include <core/evolution.h>
 #include <core/logging.h>
+#include <core/parallel_for_each.h>
+#include <core/tournament.h>
 #include <core/tournament_implementations.h>
 
 #include <atomic>
+#include <numeric>
 #include <random>
 using namespace std;
 
@@ -33,14 +36,21 @@ void init() {
   darwin::registry()->domains.add<Factory>("conquest");
 }
 
-Conquest::Conquest() {
-  board_ = Board::getBoard(g_config.board);
+Conquest::Conquest(const core::PropertySet& config) {
+  config_.copyFrom(config);
+  g_config.bind(&config_);
+
+  board_ = Board::getBoard(config_.board);
   CHECK(board_ != nullptr);
 
   inputs_ = AnnPlayer::inputsCount(board_);
   outputs_ = AnnPlayer::outputsCount(board_);
 }
 
+Conquest::~Conquest() {
+  g_config.unbind(&config_);
+}
+
 bool Conquest::evaluatePopulation(darwin::Population* population) const {
   darwin::StageScope stage("Evaluate population");
 
@@ -48,7 +58,7 @@ bool Conquest::evaluatePopulation(darwin::Population* population) const {
   core::log("\n. generation %d\n", generation);
   
   ConquestRules rules(board_);
-  auto tournament = tournament::create(g_config.tournament_type);
+  auto tournament = tournament::create(g_config->tournament_type);
   tournament->evaluatePopulation(population, &rules);
   return false;
 }
@@ -58,21 +68,29 @@ struct CalibrationFitness : public core::PropertySet {
   PROPERTY(vs_handcrafted, float, 0, "Score vs. a handcrafted player");
 };
 
+// the calibration matches are played in parallel, each match using its own
+// instances of the players (the champion brain is reused across matches)
+template <class CalibrationPlayer>
 static float calibrationScore(const ConquestRules& rules,
-                              Player& subject_player,
-                              Player& calibration_player) {
-  float calibration_score = 0;
-  int calibration_games = 0;
+                              tournament::ReplicatedBrain* champion) {
+  vector<float> match_scores(g_config->calibration_matches);
+
+  auto play_match = [&](int match, const tournament::Contestant& contestant) {
+    AnnPlayer subject_player;
+    subject_player.attach(contestant);
+    CalibrationPlayer calibration_player;
 
-  for (int i = 0; i < g_config.calibration_matches; ++i) {
     auto outcome = rules.play(&subject_player, &calibration_player);
-    calibration_score += rules.scores(outcome).player1_score;
-    ++calibration_games;
+    match_scores[match] = rules.scores(outcome).player1_score;
 
     auto rematch_outcome = rules.play(&calibration_player, &subject_player);
-    calibration_score += rules.scores(rematch_outcome).player2_score;
-    ++calibration_games;
-  }
+    match_scores[match] += rules.scores(rematch_outcome).player2_score;
+  };
+  champion->playGames(int(match_scores.size()), play_match);
+
+  const float calibration_score =
+      accumulate(match_scores.begin(), match_scores.end(), 0.0f);
+  const int calibration_games = int(match_scores.size()) * 2;
 
   // normalize the fitness to make it invariant to the number of played games
   return calibration_score / calibration_games;
@@ -85,23 +103,20 @@ unique_ptr<core::PropertySet> Conquest::calibrateGenotype(
   ConquestRules rules(board_);
   auto calibration = make_unique<CalibrationFitness>();
 
-  AnnPlayer champion;
-  champion.grow(genotype);
+  // the champion brain is grown once per worker thread (not once per match)
+  tournament::ReplicatedBrain champion(genotype, &rules);
 
   // calibration: random player
-  RandomPlayer random_player;
-  calibration->vs_random_orders = calibrationScore(rules, champion, random_player);
+  calibration->vs_random_orders = calibrationScore<RandomPlayer>(rules, &champion);
 
   // calibration: handcrafted
-  HandcraftedPlayer handcrafted_player;
-  calibration->vs_handcrafted = calibrationScore(rules, champion, handcrafted_player);
+  calibration->vs_handcrafted = calibrationScore<HandcraftedPlayer>(rules, &champion);
 
   return calibration;
 }
 
 unique_ptr<darwin::Domain> Factory::create(const core::PropertySet& config) {
-  g_config.copyFrom(config);
-  return make_unique<Conquest>();
+  return make_unique<Conquest>(config);
 }
 
 unique_ptr<core::PropertySet> Factory::defaultConfig(darwin::ComplexityHint hint) const {
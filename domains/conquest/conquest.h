@@ -59,11 +59,12 @@ void init();
 //! The largest output signal, if greater than `kOutputThreshold`, indicates the intention
 //! to initiate an attack on the corresponding arch. The attack order is valid only if the
 //! source node is controlled by the player. An attack sends a configurable percentage of
-//! the units (`g_config.deploy_percent`) along the selected arc.
+//! the units (`Config::deploy_percent`) along the selected arc.
 //!
 class Conquest : public darwin::Domain {
  public:
-  Conquest();
+  explicit Conquest(const core::PropertySet& config);
+  ~Conquest() override;
 
   size_t inputs() const override { return inputs_; }
   size_t outputs() const override { return outputs_; }
@@ -74,6 +75,7 @@ class Conquest : public darwin::Domain {
       const darwin::Genotype* genotype) const override;
 
  private:
+  Config config_;
   const Board* board_ = nullptr;
   size_t inputs_ = 0;
   size_t outputs_ = 0;
@@ -26,7 +26,9 @@ using namespace std;
 
 namespace conquest {
 
-Config g_config;
+static Config g_default_config;
+
+core::ContextSlot<Config> g_config(&g_default_config);
 
 Game::Game(int max_steps, const Board* board) : max_steps_(max_steps), board_(board) {
   CHECK(board_ != nullptr);
@@ -46,8 +48,8 @@ void Game::resetGame() {
   for (auto& deployment : deployments_)
     deployment = {};
 
-  node_units_[blue_start_node_] = g_config.initial_units;
-  node_units_[red_start_node_] = -g_config.initial_units;
+  node_units_[blue_start_node_] = g_config->initial_units;
+  node_units_[red_start_node_] = -g_config->initial_units;
 
   blue_player_->newGame(this, Player::Side::Blue);
   red_player_->newGame(this, Player::Side::Red);
@@ -110,7 +112,7 @@ bool Game::gameStep() {
       continue;
 
     constexpr float kUnitSpeedFactor = 0.02f;
-    deployment.position += g_config.units_speed * kUnitSpeedFactor;
+    deployment.position += g_config->units_speed * kUnitSpeedFactor;
     if (deployment.position >= 1.0f) {
       node_units_[arc.dst] += deployment.size;
       deployment = {};
@@ -145,10 +147,10 @@ bool Game::gameStep() {
       continue;
 
     float units = fabsf(node);
-    if (units < g_config.production_cap) {
-      units += g_config.production_step;
-      if (units > g_config.production_cap)
-        units = g_config.production_cap;
+    if (units < g_config->production_cap) {
+      units += g_config->production_step;
+      if (units > g_config->production_cap)
+        units = g_config->production_cap;
     }
     node = (node > 0) ? units : -units;
   }
@@ -167,12 +169,12 @@ void Game::order(int arc_index) {
     return;
 
   float& units = node_units_[arc.src];
-  float size = units * g_config.deploy_percent;
+  float size = units * g_config->deploy_percent;
 
   // round deployment size
-  size = int(size / g_config.deploy_resolution) * g_config.deploy_resolution;
+  size = int(size / g_config->deploy_resolution) * g_config->deploy_resolution;
 
-  if (fabsf(size) >= g_config.deploy_min) {
+  if (fabsf(size) >= g_config->deploy_min) {
     units -= size;
     deployment.size = size;
     deployment.position = 0;
@@ -230,18 +232,18 @@ const Game::Deployment& Game::deployment(int index) const {
 tournament::Scores ConquestRules::scores(tournament::GameOutcome outcome) const {
   switch (outcome) {
     case tournament::GameOutcome::FirstPlayerWins:
-      return { g_config.points_win, g_config.points_lose };
+      return { g_config->points_win, g_config->points_lose };
     case tournament::GameOutcome::Draw:
-      return { g_config.points_draw, g_config.points_draw };
+      return { g_config->points_draw, g_config->points_draw };
     case tournament::GameOutcome::SecondPlayerWins:
-      return { g_config.points_lose, g_config.points_win };
+      return { g_config->points_lose, g_config->points_win };
     default:
       FATAL("unexpected outcome");
   }
 }
 
 tournament::GameOutcome ConquestRules::play(Player* player1, Player* player2) const {
-  Game game(g_config.max_steps, board_);
+  Game game(g_config->max_steps, board_);
   game.newGame(player1, player2);
 
   // play the game
@@ -260,14 +262,14 @@ tournament::GameOutcome ConquestRules::play(Player* player1, Player* player2) co
   }
 }
 
-tournament::GameOutcome ConquestRules::play(const darwin::Genotype* player1,
-                                            const darwin::Genotype* player2) const {
+tournament::GameOutcome ConquestRules::play(const tournament::Contestant& player1,
+                                            const tournament::Contestant& player2) const {
   AnnPlayer blue_player;
-  blue_player.grow(player1);
+  blue_player.attach(player1);
 
   AnnPlayer red_player;
-  red_player.grow(player2);
-  
+  red_player.attach(player2);
+
   return play(&blue_player, &red_player);
 }
 
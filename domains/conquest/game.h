@@ -16,6 +16,7 @@
 
 #include "board.h"
 
+#include <core/context.h>
 #include <core/properties.h>
 #include <core/tournament_implementations.h>
 
@@ -65,7 +66,9 @@ struct Config : public core::PropertySet {
           "Tournament type");
 };
 
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the domain instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 class Game : public core::NonCopyable {
  public:
@@ -145,8 +148,8 @@ class ConquestRules : public tournament::GameRules {
 
   tournament::GameOutcome play(Player* player1, Player* player2) const;
   
-  tournament::GameOutcome play(const darwin::Genotype* player1,
-                               const darwin::Genotype* player2) const override;
+  tournament::GameOutcome play(const tournament::Contestant& player1,
+                               const tournament::Contestant& player2) const override;
 
  private:
   const Board* board_ = nullptr;
@@ -263,7 +263,7 @@ void BoardWidget::paintDeployment(QPainter& painter, int arc_index) const {
   if (debug_)
     text = QString::asprintf("%.2f", size);
   else
-    text = QString::asprintf("%d", int(fabsf(size) * conquest::g_config.int_unit_scale));
+    text = QString::asprintf("%d", int(fabsf(size) * conquest::g_config->int_unit_scale));
   painter.setFont(QFont("Arial", 8));
   painter.drawText(rect, Qt::AlignHCenter | Qt::AlignVCenter, text);
 }
@@ -356,7 +356,7 @@ void BoardWidget::paintEvent(QPaintEvent*) {
       painter.drawText(rect, Qt::AlignHCenter | Qt::AlignVCenter, text);
     } else {
       auto text =
-          QString::asprintf("%d", int(fabsf(units) * conquest::g_config.int_unit_scale));
+          QString::asprintf("%d", int(fabsf(units) * conquest::g_config->int_unit_scale));
       painter.drawText(rect, Qt::AlignHCenter | Qt::AlignVCenter, text);
     }
   }
@@ -83,10 +83,10 @@ bool GameWindow::setup() {
     return false;
   }
 
-  board_ = conquest::Board::getBoard(conquest::g_config.board);
+  board_ = conquest::Board::getBoard(conquest::g_config->board);
   CHECK(board_ != nullptr);
 
-  game_ = make_unique<conquest::Game>(conquest::g_config.max_steps, board_);
+  game_ = make_unique<conquest::Game>(conquest::g_config->max_steps, board_);
   game_->newGame(blue_player_.get(), red_player_.get());
 
   ui->board_widget->setGame(game_.get());
@@ -21,27 +21,42 @@ Agent::Agent(const darwin::Genotype* genotype, World* world)
     : world_(world), brain_(genotype->grow()) {}
 
 void Agent::simStep() {
-  const auto& config = world_->domain()->config();
+  const float force = act(world_->domain()->config(),
+                          world_->pole1Angle(),
+                          world_->pole2Angle(),
+                          world_->pole1AngularVelocity(),
+                          world_->pole2AngularVelocity(),
+                          world_->cartDistance(),
+                          world_->cartVelocity());
 
+  // act based on the output values
+  world_->moveCart(force);
+}
+
+float Agent::act(const Config& config,
+                 float pole_1_angle,
+                 float pole_2_angle,
+                 float pole_1_angular_velocity,
+                 float pole_2_angular_velocity,
+                 float cart_distance,
+                 float cart_velocity) {
   // setup inputs
   int input_index = 0;
   if (config.input_pole_angle) {
-    brain_->setInput(input_index++, world_->pole1Angle());
-    brain_->setInput(input_index++, world_->pole2Angle());
+    brain_->setInput(input_index++, pole_1_angle);
+    brain_->setInput(input_index++, pole_2_angle);
   }
   if (config.input_angular_velocity) {
-    brain_->setInput(input_index++, world_->pole1AngularVelocity());
-    brain_->setInput(input_index++, world_->pole2AngularVelocity());
+    brain_->setInput(input_index++, pole_1_angular_velocity);
+    brain_->setInput(input_index++, pole_2_angular_velocity);
   }
   if (config.input_cart_distance)
-    brain_->setInput(input_index++, world_->cartDistance());
+    brain_->setInput(input_index++, cart_distance);
   if (config.input_cart_velocity)
-    brain_->setInput(input_index++, world_->cartVelocity());
+    brain_->setInput(input_index++, cart_velocity);
 
   brain_->think();
-
-  // act based on the output values
-  world_->moveCart(brain_->output(0));
+  return brain_->output(0);
 }
 
 int Agent::inputs(const Config& config) {
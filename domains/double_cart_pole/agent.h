@@ -27,8 +27,18 @@ class World;
 
 class Agent {
  public:
+  // the world is optional (nullptr) if the agent is only used through act()
   Agent(const darwin::Genotype* genotype, World* world);
   void simStep();
+
+  // runs the brain for the given state, returning the raw output (force)
+  float act(const Config& config,
+            float pole_1_angle,
+            float pole_2_angle,
+            float pole_1_angular_velocity,
+            float pole_2_angular_velocity,
+            float cart_distance,
+            float cart_velocity);
   
   static int inputs(const Config& config);
   static int outputs(const Config& config);
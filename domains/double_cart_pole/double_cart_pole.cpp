@@ -19,9 +19,14 @@
 #include <core/evolution.h>
 #include <core/exception.h>
 #include <core/logging.h>
+#include <core/math_2d.h>
 #include <core/parallel_for_each.h>
+#include <core/sim/world_pool.h>
 
+#include <algorithm>
+#include <memory>
 #include <random>
+#include <vector>
 using namespace std;
 
 namespace double_cart_pole {
@@ -54,11 +59,22 @@ bool DoubleCartPole::evaluatePopulation(darwin::Population* population) const {
     darwin::StageScope stage("Evaluate one world", population->size());
     core::log(" ... world %d\n", world_index);
 
-    const float initial_angle_1 = randomInitialAngle();
-    const float initial_angle_2 = randomInitialAngle();
+    // the test world (see darwin::evaluationSeed())
+    default_random_engine rnd(darwin::evaluationSeed(world_index));
+    const float initial_angle_1 = randomInitialAngle(rnd);
+    const float initial_angle_2 = randomInitialAngle(rnd);
+
+    if (config_.physics == sim::CartPolePhysics::Analytic) {
+      evaluateAnalytic(population, initial_angle_1, initial_angle_2);
+      continue;
+    }
+
+    // one world instance per thread, reset for each episode
+    sim::WorldPool<World> world_pool(
+        [&] { return make_unique<World>(initial_angle_1, initial_angle_2, this); });
 
     pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
-      World world(initial_angle_1, initial_angle_2, this);
+      World& world = *world_pool.acquire();
       Agent agent(genotype, &world);
 
       // simulation loop
@@ -81,9 +97,119 @@ bool DoubleCartPole::evaluatePopulation(darwin::Population* population) const {
   return false;
 }
 
-float DoubleCartPole::randomInitialAngle() const {
-  random_device rd;
-  default_random_engine rnd(rd());
+void DoubleCartPole::evaluateAnalytic(darwin::Population* population,
+                                      float initial_angle_1,
+                                      float initial_angle_2) const {
+  // the population is split into batches of carts which are stepped together
+  constexpr int kBatchSize = 64;
+  const int population_size = int(population->size());
+  vector<int> batches;
+  for (int index = 0; index < population_size; index += kBatchSize) {
+    batches.push_back(index);
+  }
+
+  const auto model = World::analyticModel(config_);
+  const vector<float> initial_angles = { float(math::degreesToRadians(initial_angle_1)),
+                                         float(math::degreesToRadians(initial_angle_2)) };
+
+  pp::for_each(batches, [&](int, int first_index) {
+    const int batch_size = min(kBatchSize, population_size - first_index);
+    sim::CartPoleBatch carts(model, batch_size);
+
+    vector<Agent> agents;
+    agents.reserve(batch_size);
+    for (int i = 0; i < batch_size; ++i) {
+      carts.reset(i, initial_angles);
+      agents.emplace_back((*population)[first_index + i], nullptr);
+    }
+
+    // simulation loop
+    vector<int> steps(batch_size, 0);
+    vector<bool> active(batch_size, true);
+    int active_count = batch_size;
+    for (int step = 0; step < config_.max_steps && active_count > 0; ++step) {
+      for (int i = 0; i < batch_size; ++i) {
+        if (active[i]) {
+          const float output = agents[i].act(config_,
+                                             carts.poleAngle(i, 0),
+                                             carts.poleAngle(i, 1),
+                                             carts.poleAngularVelocity(i, 0),
+                                             carts.poleAngularVelocity(i, 1),
+                                             carts.cartPosition(i),
+                                             carts.cartVelocity(i));
+          carts.setForce(i, actuatorForce(output));
+        }
+      }
+
+      carts.step(World::kTimeStep);
+
+      for (int i = 0; i < batch_size; ++i) {
+        if (active[i]) {
+          if (withinLimits(
+                  carts.cartPosition(i), carts.poleAngle(i, 0), carts.poleAngle(i, 1))) {
+            ++steps[i];
+          } else {
+            active[i] = false;
+            --active_count;
+          }
+        }
+      }
+    }
+
+    for (int i = 0; i < batch_size; ++i) {
+      CHECK(steps[i] > 0);
+
+      // the fitness is the average number of steps over all test worlds
+      (*population)[first_index + i]->fitness += float(steps[i]) / config_.test_worlds;
+
+      darwin::ProgressManager::reportProgress();
+    }
+  });
+}
+
+float DoubleCartPole::actuatorForce(float output) const {
+  CHECK(!isnan(output));
+
+  float force = output;
+
+  // discrete control forces?
+  if (config_.discrete_controls && force != 0) {
+    const auto magnitude = config_.discrete_force_magnitude;
+    force = force > 0 ? +magnitude : -magnitude;
+  }
+
+  // cap the maximum force magnitude
+  // (applies to the discrete inputs as well)
+  if (force < -config_.max_force) {
+    force = -config_.max_force;
+  } else if (force > config_.max_force) {
+    force = config_.max_force;
+  }
+
+  return force;
+}
+
+bool DoubleCartPole::withinLimits(float cart_distance,
+                                  float pole_1_angle,
+                                  float pole_2_angle) const {
+  // check cart distance
+  if (cart_distance < -config_.max_distance || cart_distance > config_.max_distance)
+    return false;
+
+  const auto max_angle = math::degreesToRadians(config_.max_angle);
+
+  // check pole 1 angle
+  if (pole_1_angle < -max_angle || pole_1_angle > max_angle)
+    return false;
+
+  // check pole 2 angle
+  if (pole_2_angle < -max_angle || pole_2_angle > max_angle)
+    return false;
+
+  return true;
+}
+
+float DoubleCartPole::randomInitialAngle(default_random_engine& rnd) const {
   uniform_real_distribution<float> dist(-config_.max_initial_angle,
                                         config_.max_initial_angle);
   return dist(rnd);
@@ -109,6 +235,9 @@ void DoubleCartPole::validateConfiguration() {
     throw core::Exception("Invalid configuration: pole_2_density must be positive");
   if (config_.cart_density < 0)
     throw core::Exception("Invalid configuration: cart_density must be positive or 0");
+  if (config_.physics == sim::CartPolePhysics::Analytic && config_.cart_friction != 0)
+    throw core::Exception(
+        "Invalid configuration: cart_friction is not supported by the analytic physics");
 
   if (inputs() < 1)
     throw core::Exception("Invalid configuration: at least one input must be selected");
@@ -16,6 +16,10 @@
 
 #include <core/darwin.h>
 #include <core/properties.h>
+#include <core/sim/cart_pole_batch.h>
+
+#include <random>
+using namespace std;
 
 namespace double_cart_pole {
 
@@ -41,6 +45,11 @@ struct Config : public core::PropertySet {
   PROPERTY(test_worlds, int, 5, "Number of test worlds per generation");
   PROPERTY(max_steps, int, 1000, "Maximum number of steps per episode");
 
+  PROPERTY(physics,
+           sim::CartPolePhysics,
+           sim::CartPolePhysics::Box2D,
+           "Physics engine (the analytic engine doesn't support cart friction)");
+
   PROPERTY(discrete_controls,
            bool,
            false,
@@ -89,6 +98,13 @@ struct Config : public core::PropertySet {
 //! ------:|------
 //!      0 | force
 //!
+//! ### Physics
+//!
+//! By default the cart and the poles are simulated using Box2D. Alternatively,
+//! `physics = analytic` selects the analytic equations of motion (sim::CartPoleBatch),
+//! which track the Box2D simulation closely (see sim::CartPoleBatch for the tolerance)
+//! and evaluate the population in batches of carts stepped together.
+//!
 class DoubleCartPole : public darwin::Domain {
  public:
   explicit DoubleCartPole(const core::PropertySet& config);
@@ -97,14 +113,28 @@ class DoubleCartPole : public darwin::Domain {
   size_t outputs() const override;
 
   bool evaluatePopulation(darwin::Population* population) const override;
+  bool independentEvaluation() const override { return true; }
+  vector<darwin::FidelityKnob> fidelityKnobs() const override {
+    return { { "max_steps", 100 }, { "test_worlds", 1 } };
+  }
   
   const Config& config() const { return config_; }
   
-  float randomInitialAngle() const;
+  float randomInitialAngle(default_random_engine& rnd) const;
+
+  //! Maps the brain output to the force applied to the cart
+  float actuatorForce(float output) const;
+
+  //! Checks the cart position and the pole angles (radians) against the episode limits
+  bool withinLimits(float cart_distance, float pole_1_angle, float pole_2_angle) const;
   
  private:
   void validateConfiguration();
 
+  void evaluateAnalytic(darwin::Population* population,
+                        float initial_angle_1,
+                        float initial_angle_2) const;
+
  private:
   Config config_;
 };
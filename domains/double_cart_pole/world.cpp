@@ -85,58 +85,35 @@ World::World(float initial_angle_1, float initial_angle_2, const DoubleCartPole*
   pole_2_ = createPole(config.pole_2_length, config.pole_2_density, initial_angle_2);
   createHinge(cart_, pole_1_);
   createHinge(cart_, pole_2_);
+
+  b2_world_.recordInitialState();
+}
+
+sim::CartPoleModel World::analyticModel(const Config& config) {
+  sim::CartPoleModel model;
+  model.gravity = config.gravity;
+  model.setCartBox(kCartHalfWidth * 2, kCartHalfHeight * 2, config.cart_density);
+  model.addPoleBox(kPoleHalfWidth * 2, config.pole_1_length, config.pole_1_density);
+  model.addPoleBox(kPoleHalfWidth * 2, config.pole_2_length, config.pole_2_density);
+  return model;
+}
+
+void World::reset() {
+  b2_world_.reset();
 }
 
 bool World::simStep() {
-  constexpr float32 kTimeStep = 1.0f / 50.0f;
   constexpr int32 kVelocityIterations = 5;
   constexpr int32 kPositionIterations = 5;
 
-  const auto& config = domain_->config();
-
   // box2d: simulate one step
-  b2_world_.Step(kTimeStep, kVelocityIterations, kPositionIterations);
-
-  // check cart distance
-  const auto distance = cartDistance();
-  if (distance < -config.max_distance || distance > config.max_distance)
-    return false;
-
-  const auto max_angle = math::degreesToRadians(config.max_angle);
-
-  // check pole 1 angle
-  const auto pole_1_angle = pole1Angle();
-  if (pole_1_angle < -max_angle || pole_1_angle > max_angle)
-    return false;
-    
-  // check pole 2 angle
-  const auto pole_2_angle = pole2Angle();
-  if (pole_2_angle < -max_angle || pole_2_angle > max_angle)
-    return false;
-
-  return true;
+  b2_world_.step(kTimeStep, kVelocityIterations, kPositionIterations);
+
+  return domain_->withinLimits(cartDistance(), pole1Angle(), pole2Angle());
 }
 
 void World::moveCart(float force) {
-  CHECK(!isnan(force));
-
-  const auto& config = domain_->config();
-
-  // discrete control forces?
-  if (config.discrete_controls && force != 0) {
-    const auto magnitude = config.discrete_force_magnitude;
-    force = force > 0 ? +magnitude : -magnitude;
-  }
-  
-  // cap the maximum force magnitude
-  // (applies to the discrete inputs as well)
-  if (force < -config.max_force) {
-    force = -config.max_force;
-  } else if (force > config.max_force) {
-    force = config.max_force;
-  }
-  
-  cart_->ApplyForceToCenter(b2Vec2(force, 0), true);
+  cart_->ApplyForceToCenter(b2Vec2(domain_->actuatorForce(force), 0), true);
 }
 
 }  // namespace double_cart_pole
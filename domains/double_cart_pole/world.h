@@ -16,6 +16,7 @@
 
 #include "double_cart_pole.h"
 
+#include <core/sim/resettable_world.h>
 #include <third_party/box2d/box2d.h>
 
 namespace double_cart_pole {
@@ -26,9 +27,19 @@ class World {
   static constexpr float kPoleHalfWidth = 0.02f;
   static constexpr float kGroundY = 0.1f;
 
+ public:
+  static constexpr float kTimeStep = 1.0f / 50.0f;
+
  public:
   World(float initial_angle_1, float initial_angle_2, const DoubleCartPole* domain);
-  
+
+  // the physical parameters used by the analytic physics engine
+  // (matching the Box2D world)
+  static sim::CartPoleModel analyticModel(const Config& config);
+
+  // restores the initial state (reusing the Box2D world)
+  void reset();
+
   // advances the physical simulation one step, returning false
   // if the state reaches one of the termination conditions
   bool simStep();
@@ -54,7 +65,7 @@ class World {
   void createHinge(b2Body* cart, b2Body* pole);
   
  private:
-  b2World b2_world_;
+  sim::ResettableWorld b2_world_;
 
   b2Body* cart_ = nullptr;
   b2Body* pole_1_ = nullptr;
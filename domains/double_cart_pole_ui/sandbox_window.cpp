@@ -22,6 +22,9 @@
 
 #include <QString>
 
+#include <random>
+using namespace std;
+
 namespace double_cart_pole_ui {
 
 bool SandboxWindow::setup() {
@@ -72,8 +75,9 @@ void SandboxWindow::newScene() {
   CHECK(domain_ != nullptr);
   CHECK(max_steps_ > 0);
 
-  const float initial_angle_1 = domain_->randomInitialAngle();
-  const float initial_angle_2 = domain_->randomInitialAngle();
+  default_random_engine rnd(random_device{}());
+  const float initial_angle_1 = domain_->randomInitialAngle(rnd);
+  const float initial_angle_2 = domain_->randomInitialAngle(rnd);
   world_ =
       make_unique<double_cart_pole::World>(initial_angle_1, initial_angle_2, domain_);
   agent_ = make_unique<double_cart_pole::Agent>(genotype_.get(), world_.get());
@@ -61,20 +61,19 @@ bool DroneFollow::evaluatePopulation(darwin::Population* population) const {
   const int generation = population->generation();
   core::log("\n. generation %d\n", generation);
 
-  // reset the fitness values
-  pp::for_each(*population,
-               [&](int, darwin::Genotype* genotype) { genotype->fitness = 0; });
+  darwin::RacingEvaluation race(population, config_.test_worlds, config_.racing);
 
   // evaluate each genotype (over N worlds)
   for (int world_index = 0; world_index < config_.test_worlds; ++world_index) {
     darwin::StageScope stage(
         core::format("World %d/%d", world_index + 1, config_.test_worlds),
-        population->size());
+        race.contenders().size());
     core::log(" ... world %d\n", world_index);
 
-    const auto random_seed = std::random_device{}();
+    const auto random_seed = Scene::Seed(darwin::evaluationSeed(world_index));
 
-    pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
+    pp::for_each(race.contenders(), [&](int, size_t genotype_index) {
+      const auto genotype = population->genotype(genotype_index);
       Scene scene(random_seed, this);
       sim::DroneController agent(genotype, scene.drone());
 
@@ -86,16 +85,19 @@ bool DroneFollow::evaluatePopulation(darwin::Population* population) const {
         }
       }
 
-      // normalize the fitness to [0, 1], invariant to the number of steps or test worlds
-      float episode_fitness = scene.fitness();
-      episode_fitness /= config_.max_steps;
-      episode_fitness /= config_.test_worlds;
-      genotype->fitness += episode_fitness;
+      // normalize the fitness to [0, 1], invariant to the number of steps
+      // (the race averages the episodes over all test worlds)
+      const float episode_fitness = scene.fitness() / config_.max_steps;
+      race.recordEpisode(genotype_index, episode_fitness);
 
       darwin::ProgressManager::reportProgress();
     });
+
+    race.finishWorld();
   }
 
+  race.finish();
+
   core::log("\n");
   return false;
 }
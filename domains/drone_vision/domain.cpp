@@ -56,20 +56,21 @@ bool DroneVision::evaluatePopulation(darwin::Population* population) const {
   const int generation = population->generation();
   core::log("\n. generation %d\n", generation);
 
-  // reset the fitness values
-  pp::for_each(*population,
-               [&](int, darwin::Genotype* genotype) { genotype->fitness = 0; });
+  darwin::RacingEvaluation race(population, config_.test_worlds, config_.racing);
 
   // evaluate each genotype (over N worlds)
   for (int world_index = 0; world_index < config_.test_worlds; ++world_index) {
     darwin::StageScope stage(
         core::format("World %d/%d", world_index + 1, config_.test_worlds),
-        population->size());
+        race.contenders().size());
     core::log(" ... world %d\n", world_index);
 
-    const auto target_velocity = randomTargetVelocity();
+    // the test world (see darwin::evaluationSeed())
+    default_random_engine rnd(darwin::evaluationSeed(world_index));
+    const auto target_velocity = randomTargetVelocity(rnd);
 
-    pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
+    pp::for_each(race.contenders(), [&](int, size_t genotype_index) {
+      const auto genotype = population->genotype(genotype_index);
       Scene scene(target_velocity, this);
       sim::DroneController agent(genotype, scene.drone());
 
@@ -81,24 +82,25 @@ bool DroneVision::evaluatePopulation(darwin::Population* population) const {
         }
       }
 
-      // normalize the fitness to [0, 1], invariant to the number of steps or test worlds
-      float episode_fitness = scene.fitness();
-      episode_fitness /= config_.max_steps;
-      episode_fitness /= config_.test_worlds;
-      genotype->fitness += episode_fitness;
+      // normalize the fitness to [0, 1], invariant to the number of steps
+      // (the race averages the episodes over all test worlds)
+      const float episode_fitness = scene.fitness() / config_.max_steps;
+      race.recordEpisode(genotype_index, episode_fitness);
 
       darwin::ProgressManager::reportProgress();
     });
+
+    race.finishWorld();
   }
 
+  race.finish();
+
   core::log("\n");
   return false;
 }
 
-b2Vec2 DroneVision::randomTargetVelocity() const {
+b2Vec2 DroneVision::randomTargetVelocity(default_random_engine& rnd) const {
   constexpr float kPi = 3.14159274101f;
-  random_device rd;
-  default_random_engine rnd(rd());
   uniform_real_distribution<float> dist(-kPi, kPi);
   const float angle = dist(rnd);
   return b2Vec2(cos(angle), sin(angle)) * config_.target_speed;
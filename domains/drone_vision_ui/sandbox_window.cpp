@@ -22,6 +22,9 @@
 
 #include <QString>
 
+#include <random>
+using namespace std;
+
 namespace drone_vision_ui {
 
 bool SandboxWindow::setup() {
@@ -82,7 +85,8 @@ void SandboxWindow::newScene() {
   setSceneUi(nullptr);
   scene_ui_.reset();
 
-  const auto target_velocity = domain_->randomTargetVelocity();
+  default_random_engine rnd(random_device{}());
+  const auto target_velocity = domain_->randomTargetVelocity(rnd);
   scene_ = make_unique<drone_vision::Scene>(target_velocity, domain_);
   agent_ = make_unique<sim::DroneController>(genotype_.get(), scene_->drone());
   step_ = 0;
@@ -35,11 +35,18 @@ void init() {
   darwin::registry()->domains.add<Factory>("harvester");
 }
 
-Harvester::Harvester() {
+Harvester::Harvester(const core::PropertySet& config) {
+  config_.copyFrom(config);
+  g_config.bind(&config_);
+
   inputs_ = Robot::inputsCount();
   outputs_ = Robot::outputsCount();
 }
 
+Harvester::~Harvester() {
+  g_config.unbind(&config_);
+}
+
 // TODO: try a different approach: for(genotype) { for(map) ... }
 bool Harvester::evaluatePopulation(darwin::Population* population) const {
   darwin::StageScope stage("Evaluate population");
@@ -49,10 +56,10 @@ bool Harvester::evaluatePopulation(darwin::Population* population) const {
   log("\n. generation %d\n", generation);
 
   // generate test maps
-  vector<unique_ptr<WorldMap>> test_world_maps(g_config.test_maps);
-  pp::for_each(test_world_maps, [&](int, unique_ptr<WorldMap>& test_map) {
-    test_map = make_unique<WorldMap>(g_config.map_height, g_config.map_width);
-    CHECK(test_map->generate());
+  vector<unique_ptr<WorldMap>> test_world_maps(g_config->test_maps);
+  pp::for_each(test_world_maps, [&](int index, unique_ptr<WorldMap>& test_map) {
+    test_map = make_unique<WorldMap>(g_config->map_height, g_config->map_width);
+    CHECK(test_map->generate(darwin::evaluationSeed(index)));
   });
 
   // "grow" robots from each genotype in the population
@@ -62,11 +69,12 @@ bool Harvester::evaluatePopulation(darwin::Population* population) const {
     darwin::StageScope stage("Ontogenesis");
     pp::for_each(robots, [&](int index, Robot& robot) {
       auto genotype = population->genotype(index);
-      robot.grow(genotype, g_config.initial_health);
-      genotype->fitness = 0;
+      robot.grow(genotype, g_config->initial_health);
     });
   }
 
+  darwin::RacingEvaluation race(population, g_config->test_maps, g_config->racing);
+
   // evaluate the robots on each test world map
   {
     darwin::StageScope stage("Evaluate test maps", test_world_maps.size());
@@ -75,8 +83,9 @@ bool Harvester::evaluatePopulation(darwin::Population* population) const {
       const WorldMap& template_map = *test_world_maps[map_index];
 
       {
-        darwin::StageScope stage("Evaluate one map", robots.size());
-        pp::for_each(robots, [&](int robot_index, Robot& robot) {
+        darwin::StageScope stage("Evaluate one map", race.contenders().size());
+        pp::for_each(race.contenders(), [&](int, size_t robot_index) {
+          Robot& robot = robots[robot_index];
           World sandbox(template_map, &robot);
 
           // TODO: revisit (a cleaner pattern?)
@@ -84,24 +93,26 @@ bool Harvester::evaluatePopulation(darwin::Population* population) const {
           while (robot.alive())
             sandbox.simStep();
 
-          population->genotype(robot_index)->fitness +=
-              robot.fitness() / test_world_maps.size();
+          race.recordEpisode(robot_index, robot.fitness());
 
           darwin::ProgressManager::reportProgress();
         });
       }
 
+      race.finishWorld();
+
       darwin::ProgressManager::reportProgress();
     }
   }
 
+  race.finish();
+
   log("\n");
   return false;
 }
 
 unique_ptr<darwin::Domain> Factory::create(const core::PropertySet& config) {
-  g_config.copyFrom(config);
-  return make_unique<Harvester>();
+  return make_unique<Harvester>(config);
 }
 
 unique_ptr<core::PropertySet> Factory::defaultConfig(darwin::ComplexityHint hint) const {
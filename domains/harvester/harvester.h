@@ -58,12 +58,19 @@ void init();
 //!
 class Harvester : public darwin::Domain {
  public:
-  Harvester();
+  explicit Harvester(const core::PropertySet& config);
+  ~Harvester() override;
+
   bool evaluatePopulation(darwin::Population* population) const override;
+  // racing ranks the genotypes against the rest of the evaluated population
+  bool independentEvaluation() const override {
+    return config_.racing.tag() == darwin::RacingType::None;
+  }
   size_t inputs() const override { return inputs_; }
   size_t outputs() const override { return outputs_; }
 
  private:
+  Config config_;
   size_t inputs_ = 0;
   size_t outputs_ = 0;
 };
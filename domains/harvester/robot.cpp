@@ -24,8 +24,9 @@ using namespace std;
 namespace harvester {
 
 Robot::Robot() {
-  CHECK(g_config.vision_resolution > 0);
-  vision_.resize(g_config.vision_resolution);
+  CHECK(g_config->vision_resolution > 0);
+  ray_directions_.resize(g_config->vision_resolution);
+  vision_.resize(g_config->vision_resolution);
 }
 
 float Robot::fitness() const {
@@ -90,19 +91,19 @@ double Robot::move(double dist) {
       return 0;
 
     case WorldMap::Cell::FruitBad:
-      updateHealth(g_config.bad_fruit_health);
+      updateHealth(g_config->bad_fruit_health);
       ++stats_.bad_fruits;
       ++stats_.visited_cells;
       break;
 
     case WorldMap::Cell::FruitJunk:
-      updateHealth(g_config.junk_fruit_health);
+      updateHealth(g_config->junk_fruit_health);
       ++stats_.junk_fruits;
       ++stats_.visited_cells;
       break;
 
     case WorldMap::Cell::FruitGood:
-      updateHealth(g_config.good_fruit_health);
+      updateHealth(g_config->good_fruit_health);
       ++stats_.good_fruits;
       ++stats_.visited_cells;
       break;
@@ -138,11 +139,11 @@ void Robot::simStep() {
 
   brain_->think();
 
-  auto rotation_angle = brain_->output(kOutputRotate) * g_config.rotation_speed;
-  auto move_dist = brain_->output(kOutputMove) * g_config.move_speed;
+  auto rotation_angle = brain_->output(kOutputRotate) * g_config->rotation_speed;
+  auto move_dist = brain_->output(kOutputMove) * g_config->move_speed;
 
   // actuators
-  if (g_config.exclusive_actuators) {
+  if (g_config->exclusive_actuators) {
     if (fabs(rotation_angle) >= fabs(move_dist)) {
       rotate(rotation_angle);
       stats_.last_move_dist = 0;
@@ -159,8 +160,8 @@ void Robot::simStep() {
   stats_.total_move_dist += fabs(stats_.last_move_dist);
 
   // update health
-  double move_drain = stats_.last_move_dist >= 0 ? g_config.forward_move_drain
-                                                 : -g_config.reverse_move_drain;
+  double move_drain = stats_.last_move_dist >= 0 ? g_config->forward_move_drain
+                                                 : -g_config->reverse_move_drain;
   int health_drain = 1 + int(stats_.last_move_dist * move_drain);
   CHECK(health_drain > 0);
   updateHealth(-health_drain);
@@ -170,26 +171,32 @@ void Robot::updateVision() {
   math::HMatrix2d hm;
   math::Vector2d ray_vector(1, 0);
 
-  if (g_config.vision_resolution > 1) {
-    hm.setRotation(angle_ - g_config.vision_fov / 2);
+  if (g_config->vision_resolution > 1) {
+    hm.setRotation(angle_ - g_config->vision_fov / 2);
     ray_vector = hm * ray_vector;
 
-    hm.setRotation(g_config.vision_fov / (g_config.vision_resolution - 1));
+    hm.setRotation(g_config->vision_fov / (g_config->vision_resolution - 1));
   } else {
     hm.setRotation(angle_);
     ray_vector = hm * ray_vector;
   }
 
+  for (auto& ray_direction : ray_directions_) {
+    ray_direction = ray_vector;
+    ray_vector = hm * ray_vector;
+  }
+
+  world_->castRays(pos_, ray_directions_, &vision_);
+
   const WorldMap& world_map = world_->worldMap();
   const math::Vector2d world_diagonal(world_map.cells.rows, world_map.cells.cols);
   const math::Scalar world_diagonal_length = world_diagonal.length();
 
-  for (int i = 0; i < g_config.vision_resolution; ++i) {
-    auto vision_ray = castRay(ray_vector);
-    vision_[i] = vision_ray;
+  for (int i = 0; i < g_config->vision_resolution; ++i) {
+    const auto& vision_ray = vision_[i];
 
     float color = 0;
-    switch (world_map.cells[vision_ray.row][vision_ray.col]) {
+    switch (world_->cell(vision_ray.row, vision_ray.col)) {
       case WorldMap::Cell::FruitBad:
         color = -1;
         break;
@@ -211,107 +218,7 @@ void Robot::updateVision() {
     float dist = vision_ray.ray.length() / world_diagonal_length;
     brain_->setInput(input_index + 0, dist);
     brain_->setInput(input_index + 1, color);
-
-    ray_vector = hm * ray_vector;
-  }
-}
-
-static bool isEmpty(WorldMap::Cell cell) {
-  return cell == WorldMap::Cell::Empty || cell == WorldMap::Cell::Visited;
-}
-
-Robot::Ray Robot::castRay(const math::Vector2d& v) const {
-  math::Scalar dx = 0;
-  math::Scalar dy = 0;
-  int col = int(pos_.x);
-  int row = int(pos_.y);
-
-  const WorldMap& world_map = world_->worldMap();
-
-  if (fabs(v.x) >= fabs(v.y)) {
-    const math::Scalar slope = v.y / v.x;
-
-    if (v.x > 0) {
-      dx = (col + 1) - pos_.x;
-      dy = dx * slope;
-
-      for (++col; col < world_map.cells.cols; ++col, dy += slope, dx += 1) {
-        if (row != int(dy + pos_.y)) {
-          row = int(dy + pos_.y);
-          if (!isEmpty(world_map.cells[row][col - 1])) {
-            dy = (v.y > 0 ? row : row + 1) - pos_.y;
-            dx = dy * (v.x / v.y);
-            --col;
-            break;
-          }
-        }
-
-        if (!isEmpty(world_map.cells[row][col]))
-          break;
-      }
-    } else {
-      dx = col - pos_.x;
-      dy = dx * slope;
-
-      for (--col; col >= 0; --col, dy -= slope, dx -= 1) {
-        if (row != int(dy + pos_.y)) {
-          row = int(dy + pos_.y);
-          if (!isEmpty(world_map.cells[row][col + 1])) {
-            dy = (v.y > 0 ? row : row + 1) - pos_.y;
-            dx = dy * (v.x / v.y);
-            ++col;
-            break;
-          }
-        }
-
-        if (!isEmpty(world_map.cells[row][col]))
-          break;
-      }
-    }
-  } else {
-    const math::Scalar slope = v.x / v.y;
-
-    if (v.y > 0) {
-      dy = (row + 1) - pos_.y;
-      dx = dy * slope;
-
-      for (++row; row < world_map.cells.rows; ++row, dx += slope, dy += 1) {
-        if (col != int(dx + pos_.x)) {
-          col = int(dx + pos_.x);
-          if (!isEmpty(world_map.cells[row - 1][col])) {
-            dx = (v.x > 0 ? col : col + 1) - pos_.x;
-            dy = dx * (v.y / v.x);
-            --row;
-            break;
-          }
-        }
-
-        if (!isEmpty(world_map.cells[row][col]))
-          break;
-      }
-    } else {
-      dy = row - pos_.y;
-      dx = dy * slope;
-
-      for (--row; row >= 0; --row, dx -= slope, dy -= 1) {
-        if (col != int(dx + pos_.x)) {
-          col = int(dx + pos_.x);
-          if (!isEmpty(world_map.cells[row + 1][col])) {
-            dx = (v.x > 0 ? col : col + 1) - pos_.x;
-            dy = dx * (v.y / v.x);
-            ++row;
-            break;
-          }
-        }
-
-        if (!isEmpty(world_map.cells[row][col]))
-          break;
-      }
-    }
   }
-
-  assert(!isEmpty(world_map.cells[row][col]));
-  return Ray(dx, dy, row, col);
 }
 
 }  // namespace harvester
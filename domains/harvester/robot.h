@@ -34,6 +34,16 @@ class Robot {
   static constexpr int kOutputMove = 0;
   static constexpr int kOutputRotate = 1;
 
+  struct Stats {
+    double last_move_dist = 0;
+    double total_move_dist = 0;
+    int good_fruits = 0;
+    int bad_fruits = 0;
+    int junk_fruits = 0;
+    int visited_cells = 0;
+  };
+
+ public:
   struct Ray {
     // relative to the robot's position
     math::Vector2d ray;
@@ -48,19 +58,10 @@ class Robot {
         : ray(dx, dy), row(row), col(col) {}
   };
 
-  struct Stats {
-    double last_move_dist = 0;
-    double total_move_dist = 0;
-    int good_fruits = 0;
-    int bad_fruits = 0;
-    int junk_fruits = 0;
-    int visited_cells = 0;
-  };
-
  public:
   Robot();
 
-  static int inputsCount() { return g_config.vision_resolution * 2; }
+  static int inputsCount() { return g_config->vision_resolution * 2; }
   static int outputsCount() { return kOutputs; }
 
   void grow(const darwin::Genotype* genotype, int initial_health);
@@ -80,7 +81,6 @@ class Robot {
  private:
   void resetState();
   void updateVision();
-  Ray castRay(const math::Vector2d& v) const;
 
   void rotate(double angle);
   double move(double dist);
@@ -99,6 +99,7 @@ class Robot {
   double angle_ = 0;
 
   // vision
+  vector<math::Vector2d> ray_directions_;
   vector<Ray> vision_;
 
   Stats stats_;
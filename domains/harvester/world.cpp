@@ -17,22 +17,20 @@
 #include "world_map.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 using namespace std;
 
 namespace harvester {
 
-World::World(const WorldMap& world_map, Robot* robot) : map_(world_map), robot_(robot) {
+World::World(const WorldMap& world_map, Robot* robot)
+    : map_(world_map), robot_(robot), visited_(map_.cells.rows * map_.cells.cols) {
   assert(robot_ != nullptr);
 }
 
 void World::simInit() {
-  // make sure the map hasn't been already used
-  //
-  // TODO: redesign the World interface to avoid the need for this validation
-  //
-  for (const auto& cell : map_.cells.values)
-    CHECK(cell != WorldMap::Cell::Visited);
-
+  fill(visited_.begin(), visited_.end(), false);
   step_ = 0;
   robot_->simInit(this);
 }
@@ -43,10 +41,63 @@ void World::simStep() {
 }
 
 WorldMap::Cell World::visit(int row, int col) {
-  auto orig_cell = map_.cells[row][col];
+  auto orig_cell = cell(row, col);
   if (orig_cell != WorldMap::Cell::Wall)
-    map_.cells[row][col] = WorldMap::Cell::Visited;
+    visited_[index(row, col)] = true;
   return orig_cell;
 }
 
+void World::castRays(const math::Vector2d& origin,
+                     const vector<math::Vector2d>& directions,
+                     vector<Robot::Ray>* hits) const {
+  assert(hits->size() == directions.size());
+  for (size_t i = 0; i < directions.size(); ++i)
+    (*hits)[i] = castRay(origin, directions[i]);
+}
+
+// the cells are visited in the order the ray crosses them, stepping one
+// row or one column at a time (whichever cell boundary is closer along the ray)
+Robot::Ray World::castRay(const math::Vector2d& origin, const math::Vector2d& v) const {
+  constexpr auto kInfinity = numeric_limits<math::Scalar>::infinity();
+
+  int col = int(origin.x);
+  int row = int(origin.y);
+  size_t cell_index = index(row, col);
+  assert(isEmpty(cell_index));
+
+  const int step_col = v.x > 0 ? 1 : -1;
+  const int step_row = v.y > 0 ? 1 : -1;
+  const ptrdiff_t step_index_row = step_row * ptrdiff_t(map_.cells.cols);
+
+  // the ray parameter increments between two consecutive column (or row) boundaries
+  const math::Scalar t_delta_x = v.x != 0 ? fabs(1 / v.x) : kInfinity;
+  const math::Scalar t_delta_y = v.y != 0 ? fabs(1 / v.y) : kInfinity;
+
+  // the ray parameter at the next column (or row) boundary
+  math::Scalar t_max_x = kInfinity;
+  math::Scalar t_max_y = kInfinity;
+  if (v.x != 0)
+    t_max_x = (v.x > 0 ? (col + 1) - origin.x : origin.x - col) * t_delta_x;
+  if (v.y != 0)
+    t_max_y = (v.y > 0 ? (row + 1) - origin.y : origin.y - row) * t_delta_y;
+
+  // the map is surrounded by walls, so the traversal always ends within the map
+  //
+  // (the loop is written to avoid data dependent branches, other than the exit)
+  //
+  math::Scalar t = 0;
+  do {
+    const bool x_step = t_max_x < t_max_y;
+    t = x_step ? t_max_x : t_max_y;
+    cell_index += x_step ? step_col : step_index_row;
+    t_max_x += x_step ? t_delta_x : 0;
+    t_max_y += x_step ? 0 : t_delta_y;
+    assert(cell_index < map_.cells.values.size());
+  } while (isEmpty(cell_index));
+
+  row = int(cell_index / map_.cells.cols);
+  col = int(cell_index % map_.cells.cols);
+  return Robot::Ray(v.x * t, v.y * t, row, col);
+}
+
 }  // namespace harvester
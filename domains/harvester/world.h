@@ -17,8 +17,20 @@
 #include "robot.h"
 #include "world_map.h"
 
+#include <core/math_2d.h>
+
+#include <vector>
+using namespace std;
+
 namespace harvester {
 
+//! A robot sandbox (a single episode) on top of a shared, read-only world map
+//!
+//! The world map is not copied: the cells visited during the episode are tracked
+//! in a separate bitset overlay, so a map can be shared by concurrent episodes.
+//!
+//! \note The world map must outlive the World instance
+//!
 class World {
  public:
   World(const WorldMap& world_map, Robot* robot);
@@ -33,13 +45,52 @@ class World {
   const Robot* robot() const { return robot_; }
   int currentStep() const { return step_; }
 
+  //! The current cell type (including the visited overlay)
+  WorldMap::Cell cell(int row, int col) const {
+    const auto base_cell = map_.cells[row][col];
+    return base_cell != WorldMap::Cell::Wall && visited_[index(row, col)]
+               ? WorldMap::Cell::Visited
+               : base_cell;
+  }
+
   // returns the previous cell type
   WorldMap::Cell visit(int row, int col);
 
+  //! Casts a batch of rays from the same origin (Amanatides & Woo grid traversal)
+  //!
+  //! The hits are reported as the points where the rays enter the first
+  //! non-empty cells, relative to the origin.
+  //!
+  void castRays(const math::Vector2d& origin,
+                const vector<math::Vector2d>& directions,
+                vector<Robot::Ray>* hits) const;
+
  private:
-  WorldMap map_;
+  size_t index(int row, int col) const { return row * map_.cells.cols + col; }
+
+  // returns true if a ray can pass through the cell
+  bool isEmpty(size_t index) const {
+    switch (map_.cells.values[index]) {
+      case WorldMap::Cell::Empty:
+      case WorldMap::Cell::Visited:
+        return true;
+      case WorldMap::Cell::Wall:
+        return false;
+      default:
+        // fruits are consumed when visited
+        return visited_[index];
+    }
+  }
+
+  Robot::Ray castRay(const math::Vector2d& origin, const math::Vector2d& v) const;
+
+ private:
+  const WorldMap& map_;
   Robot* robot_ = nullptr;
   int step_ = -1;
+
+  // the visited cells overlay ([row * cols + col])
+  vector<bool> visited_;
 };
 
 }  // namespace harvester
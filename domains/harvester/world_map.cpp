@@ -26,14 +26,15 @@ using namespace std;
 
 namespace harvester {
 
-Config g_config;
+static Config g_default_config;
+
+core::ContextSlot<Config> g_config(&g_default_config);
 
 // generate a random map
-bool WorldMap::generate(int max_attempts) {
+bool WorldMap::generate(uint64_t seed, int max_attempts) {
   CHECK(!cells.empty());
 
-  random_device rd;
-  default_random_engine rnd(rd());
+  default_random_engine rnd(seed);
   uniform_int_distribution<size_t> dist_row(0, cells.rows - 1);
   uniform_int_distribution<size_t> dist_col(0, cells.cols - 1);
   uniform_int_distribution<size_t> dist_size(1, 10);
@@ -48,7 +49,7 @@ bool WorldMap::generate(int max_attempts) {
         cells[row][col] = (v_edge || h_edge) ? Cell::Wall : Cell::Empty;
       }
 
-    for (int wall = 0; wall < g_config.map_walls; ++wall) {
+    for (int wall = 0; wall < g_config->map_walls; ++wall) {
       size_t row = dist_row(rnd);
       size_t col = dist_col(rnd);
       size_t width = dist_size(rnd);
@@ -94,9 +95,9 @@ bool WorldMap::generate(int max_attempts) {
   };
 
   // generate the fruits
-  placeFruits(g_config.map_good_fruits, Cell::FruitGood);
-  placeFruits(g_config.map_junk_fruits, Cell::FruitJunk);
-  placeFruits(g_config.map_bad_fruits, Cell::FruitBad);
+  placeFruits(g_config->map_good_fruits, Cell::FruitGood);
+  placeFruits(g_config->map_junk_fruits, Cell::FruitJunk);
+  placeFruits(g_config->map_bad_fruits, Cell::FruitBad);
 
   return true;
 }
@@ -150,8 +151,8 @@ bool WorldMap::isValid() const {
         FATAL("unexpected map cell type");
     }
 
-  return empty_space >= g_config.map_good_fruits + g_config.map_junk_fruits +
-                            g_config.map_bad_fruits + 1;  // start cell
+  return empty_space >= g_config->map_good_fruits + g_config->map_junk_fruits +
+                            g_config->map_bad_fruits + 1;  // start cell
 }
 
 }  // namespace harvester
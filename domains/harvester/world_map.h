@@ -14,11 +14,14 @@
 
 #pragma once
 
+#include <core/context.h>
 #include <core/math_2d.h>
 #include <core/matrix.h>
 #include <core/properties.h>
+#include <core/racing.h>
 
 #include <algorithm>
+#include <cstdint>
 #include <vector>
 using namespace std;
 
@@ -28,6 +31,11 @@ namespace harvester {
 struct Config : public core::PropertySet {
   PROPERTY(test_maps, int, 5, "Number of test maps");
 
+  VARIANT(racing,
+          darwin::RacingVariant,
+          darwin::RacingType::None,
+          "Early termination of the weakest genotypes (racing over the test maps)");
+
   // map configuration
   PROPERTY(map_width, int, 64, "Map width");
   PROPERTY(map_height, int, 64, "Map height");
@@ -66,7 +74,9 @@ struct Config : public core::PropertySet {
   PROPERTY(bad_fruit_health, int, -100, "Health update when eating a 'bad' fruit");
 };
 
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the domain instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 struct WorldMap {
   enum class Cell : char { Empty, Visited, FruitGood, FruitBad, FruitJunk, Wall };
@@ -84,7 +94,7 @@ struct WorldMap {
       cell = Cell::Empty;
   }
 
-  bool generate(int max_attempts = 1000);
+  bool generate(uint64_t seed, int max_attempts = 1000);
 
   Pos startPosition() const;
 
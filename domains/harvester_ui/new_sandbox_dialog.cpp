@@ -32,9 +32,9 @@ NewSandboxDialog::NewSandboxDialog(QWidget* parent)
   auto snapshot = darwin::evolution()->snapshot();
   ui->generation->setValue(snapshot.generation - 1);
 
-  ui->world_width->setValue(g_config.map_width);
-  ui->world_height->setValue(g_config.map_height);
-  ui->initial_health->setValue(g_config.initial_health);
+  ui->world_width->setValue(g_config->map_width);
+  ui->world_height->setValue(g_config->map_height);
+  ui->initial_health->setValue(g_config->initial_health);
 
   ui->generation->setFocus();
 }
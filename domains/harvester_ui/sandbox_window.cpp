@@ -23,6 +23,7 @@
 #include <QString>
 
 #include <cmath>
+#include <random>
 using namespace std;
 
 namespace harvester_ui {
@@ -54,8 +55,8 @@ bool SandboxWindow::setup() {
   auto world_width = dlg.worldWidth();
   auto world_height = dlg.worldHeight();
 
-  harvester::WorldMap world_map(world_height, world_width);
-  if (!world_map.generate()) {
+  auto world_map = make_unique<harvester::WorldMap>(world_height, world_width);
+  if (!world_map->generate(random_device{}())) {
     core::log("Can't generate sandbox map");
     return false;
   }
@@ -71,7 +72,8 @@ bool SandboxWindow::setup() {
     return false;
   }
 
-  world_ = make_unique<harvester::World>(world_map, robot_.get());
+  world_map_ = std::move(world_map);
+  world_ = make_unique<harvester::World>(*world_map_, robot_.get());
   world_->simInit();
 
   ui->world_widget->setWorld(world_.get());
@@ -119,12 +121,13 @@ void SandboxWindow::on_restart_clicked() {
   pause();
 
   // generate a new world map
-  const auto& old_world_map = world_->worldMap();
-  harvester::WorldMap world_map(int(old_world_map.cells.rows),
-                                int(old_world_map.cells.cols));
-  CHECK(world_map.generate());
+  auto world_map = make_unique<harvester::WorldMap>(int(world_map_->cells.rows),
+                                                    int(world_map_->cells.cols));
+  CHECK(world_map->generate(random_device{}()));
 
-  world_ = make_unique<harvester::World>(world_map, robot_.get());
+  // the old world references the old map, so it must be destroyed first
+  world_ = make_unique<harvester::World>(*world_map, robot_.get());
+  world_map_ = std::move(world_map);
   world_->simInit();
 
   ui->world_widget->setWorld(world_.get());
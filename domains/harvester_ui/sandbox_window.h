@@ -85,6 +85,7 @@ class SandboxWindow : public QFrame {
   QTimer timer_;
 
   unique_ptr<harvester::Robot> robot_;
+  unique_ptr<harvester::WorldMap> world_map_;
   unique_ptr<harvester::World> world_;
   Variables variables_;
 };
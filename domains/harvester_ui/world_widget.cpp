@@ -43,8 +43,6 @@ void WorldWidget::setWorld(const harvester::World* world) {
 }
 
 void WorldWidget::paintWorld(QPainter& painter) const {
-  const auto& world_map = world_->worldMap();
-
   // map "frame"
   painter.setPen(QPen(kGridColor, 0));
   painter.setBrush(kEmptyColor);
@@ -60,7 +58,7 @@ void WorldWidget::paintWorld(QPainter& painter) const {
   painter.setPen(Qt::NoPen);
   for (int i = 0; i < rows_; ++i)
     for (int j = 0; j < cols_; ++j)
-      switch (world_map.cells[i][j]) {
+      switch (world_->cell(i, j)) {
         case harvester::WorldMap::Cell::Wall:
           painter.setBrush(wall_brush);
           painter.drawRect(QRectF(j, i, 1, 1));
@@ -105,7 +103,6 @@ void WorldWidget::paintWorld(QPainter& painter) const {
 }
 
 void WorldWidget::paintRobot(QPainter& painter) const {
-  const auto& world_map = world_->worldMap();
   const auto robot = world_->robot();
   const auto& pos = robot->position();
 
@@ -114,7 +111,7 @@ void WorldWidget::paintRobot(QPainter& painter) const {
   // the robot itself
   painter.setPen(Qt::NoPen);
   painter.setBrush(kRobotColor);
-  const double robot_radius = harvester::g_config.robot_size / 2;
+  const double robot_radius = harvester::g_config->robot_size / 2;
   painter.drawEllipse(robot_location, robot_radius, robot_radius);
 
   // dead robot?
@@ -126,7 +123,7 @@ void WorldWidget::paintRobot(QPainter& painter) const {
   }
 
   // field of view
-  const double fov = math::radiansToDegrees(harvester::g_config.vision_fov);
+  const double fov = math::radiansToDegrees(harvester::g_config->vision_fov);
   const double angle = math::radiansToDegrees(robot->angle());
   constexpr double fov_size = 1e6;
   QRectF fov_rect(pos.x - fov_size, pos.y - fov_size, fov_size * 2, fov_size * 2);
@@ -150,7 +147,7 @@ void WorldWidget::paintRobot(QPainter& painter) const {
     }
 
     QColor color;
-    switch (world_map.cells[ray.row][ray.col]) {
+    switch (world_->cell(ray.row, ray.col)) {
       case harvester::WorldMap::Cell::Wall:
         color = wall_ray_color;
         break;
@@ -64,6 +64,13 @@ namespace find_max_value {
 //! 
 class FindMaxValue : public darwin::Domain {
  public:
+  explicit FindMaxValue(const core::PropertySet& config) {
+    config_.copyFrom(config);
+    g_config.bind(&config_);
+  }
+
+  ~FindMaxValue() override { g_config.unbind(&config_); }
+
   size_t inputs() const override { return Robot::kInputs; }
   size_t outputs() const override { return Robot::kOutputs; }
 
@@ -73,9 +80,11 @@ class FindMaxValue : public darwin::Domain {
     const int generation = population->generation();
     log("\n. generation %d\n", generation);
 
-    // generate test worlds
-    vector<World> worlds(g_config.test_worlds);
-    pp::for_each(worlds, [&](int, World& world) { world.generate(); });
+    // generate test worlds (see darwin::evaluationSeed())
+    vector<World> worlds(g_config->test_worlds);
+    pp::for_each(worlds, [&](int index, World& world) {
+      world.generate(darwin::evaluationSeed(index));
+    });
 
     // "grow" robots from each genotype in the population
     vector<Robot> robots(population->size());
@@ -118,12 +127,16 @@ class FindMaxValue : public darwin::Domain {
     log("\n");
     return false;
   }
+
+  bool independentEvaluation() const override { return true; }
+
+ private:
+  Config config_;
 };
 
 class Factory : public darwin::DomainFactory {
   unique_ptr<darwin::Domain> create(const core::PropertySet& config) override {
-    g_config.copyFrom(config);
-    return make_unique<FindMaxValue>();
+    return make_unique<FindMaxValue>(config);
   }
 
   unique_ptr<core::PropertySet> defaultConfig(
@@ -72,7 +72,7 @@ void Robot::simStep() {
 
   brain->setInput(kInputLeftAntena, pos == 0 ? 1.0f : 0.0f);
   brain->setInput(kInputRightAntena, pos == world->size() - 1 ? 1.0f : 0.0f);
-  brain->setInput(kInputValue, float(world->map(pos)) / g_config.max_value);
+  brain->setInput(kInputValue, float(world->map(pos)) / g_config->max_value);
 
   brain->think();
   --health;
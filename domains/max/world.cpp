@@ -26,20 +26,21 @@ using namespace std;
 
 namespace find_max_value {
 
-Config g_config;
+static Config g_default_config;
 
-void World::generate() {
-  CHECK(g_config.min_size >= kMinSize);
+core::ContextSlot<Config> g_config(&g_default_config);
 
-  random_device rd;
-  default_random_engine rnd(rd());
+void World::generate(uint64_t seed) {
+  CHECK(g_config->min_size >= kMinSize);
 
-  uniform_int_distribution<int> dist_size(g_config.min_size, g_config.max_size);
-  uniform_int_distribution<int> dist_val(1, g_config.max_value);
+  default_random_engine rnd(seed);
+
+  uniform_int_distribution<int> dist_size(g_config->min_size, g_config->max_size);
+  uniform_int_distribution<int> dist_val(1, g_config->max_value);
 
   map_.resize(dist_size(rnd));
 
-  if (g_config.easy_map) {
+  if (g_config->easy_map) {
     for (auto& value : map_)
       value = 0;
 
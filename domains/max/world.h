@@ -16,8 +16,10 @@
 
 #include "robot.h"
 
+#include <core/context.h>
 #include <core/properties.h>
 
+#include <cstdint>
 #include <memory>
 using namespace std;
 
@@ -36,7 +38,9 @@ struct Config : public core::PropertySet {
   PROPERTY(test_worlds, int, 10, "Number of test worlds per generation");
 };
 
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the domain instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 struct World {
  public:
@@ -45,7 +49,7 @@ struct World {
   int goal() const { return goal_; }
   int size() const { return int(map_.size()); }
 
-  void generate();
+  void generate(uint64_t seed);
   bool fullyExplored() const;
   void simInit(const World& world, Robot* robot);
   void simStep();
@@ -17,6 +17,7 @@
 #include "player.h"
 
 #include <core/darwin.h>
+#include <core/tournament.h>
 
 namespace pong {
 
@@ -43,7 +44,7 @@ class AnnPlayer : public Player {
   static constexpr int kOutputMoveDown = 1;
 
  public:
-  unique_ptr<darwin::Brain> brain;
+  darwin::Brain* brain = nullptr;
   const darwin::Genotype* genotype = nullptr;
   Stats stats;
   int generation = -1;
@@ -54,6 +55,12 @@ class AnnPlayer : public Player {
   void newGame(const Game* game, Side side) override;
 
   void grow(const darwin::Genotype* genotype);
+
+  //! Uses an already grown brain (owned by the caller)
+  void attach(const tournament::Contestant& contestant);
+
+ private:
+  unique_ptr<darwin::Brain> owned_brain_;
 };
 
 }  // namespace pong
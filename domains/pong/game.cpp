@@ -24,7 +24,9 @@ using namespace std;
 
 namespace pong {
 
-Config g_config;
+static Config g_default_config;
+
+core::ContextSlot<Config> g_config(&g_default_config);
 
 static constexpr float kPi = 3.14159265359f;
 static constexpr float kMaxAngle = kPi / 3.0f;
@@ -43,9 +45,9 @@ void Game::newSet() {
   ball_.x = 0;
   ball_.y = 0.5f;
   
-  ball_speed_ = g_config.serve_speed;
+  ball_speed_ = g_config->serve_speed;
 
-  if (g_config.simple_serve) {
+  if (g_config->simple_serve) {
     ball_.vx = ball_speed_;
     ball_.vy = 0;
   } else {
@@ -90,18 +92,18 @@ void Game::newGame(Player* player1, Player* player2) {
 }
 
 static void movePaddle(float& pos, Player::Action action) {
-  const float up_limit = 1 - g_config.paddle_size / 2;
-  const float down_limit = g_config.paddle_size / 2;
+  const float up_limit = 1 - g_config->paddle_size / 2;
+  const float down_limit = g_config->paddle_size / 2;
 
   switch (action) {
     case Player::Action::MoveUp:
-      pos += g_config.paddle_speed;
+      pos += g_config->paddle_speed;
       if (pos > up_limit)
         pos = up_limit;
       break;
 
     case Player::Action::MoveDown:
-      pos -= g_config.paddle_speed;
+      pos -= g_config->paddle_speed;
       if (pos < down_limit)
         pos = down_limit;
       break;
@@ -120,9 +122,9 @@ bool Game::moveBall(float dt) {
 
   Contact contact = Contact::None;
 
-  const float r = pong::g_config.ball_radius;
-  const float left = -1 + pong::g_config.paddle_offset + r;
-  const float right = 1 - pong::g_config.paddle_offset - r;
+  const float r = pong::g_config->ball_radius;
+  const float left = -1 + pong::g_config->paddle_offset + r;
+  const float right = 1 - pong::g_config->paddle_offset - r;
   const float up = 1 - r;
   const float down = r;
 
@@ -179,7 +181,7 @@ bool Game::moveBall(float dt) {
 
   CHECK(contact == Contact::Left || contact == Contact::Right);
 
-  const float phs = g_config.paddle_size / 2 + r;
+  const float phs = g_config->paddle_size / 2 + r;
   float dy = ball_.y - (contact == Contact::Left ? paddle_pos_p1_ : paddle_pos_p2_);
 
   if (fabs(dy) > phs) {
@@ -191,7 +193,7 @@ bool Game::moveBall(float dt) {
   }
 
   // ball return (bounce from a paddle)
-  ball_speed_ = g_config.ball_speed;
+  ball_speed_ = g_config->ball_speed;
   float angle = (dy / phs) * kMaxAngle;
   ball_.vx = cos(angle) * ball_speed_;
   ball_.vy = sin(angle) * ball_speed_;
@@ -223,50 +225,50 @@ bool Game::gameStep() {
 tournament::Scores PongRules::scores(tournament::GameOutcome outcome) const {
   switch (outcome) {
     case tournament::GameOutcome::FirstPlayerWins:
-      return { g_config.points_win, g_config.points_lose };
+      return { g_config->points_win, g_config->points_lose };
     case tournament::GameOutcome::Draw:
-      return { g_config.points_draw, g_config.points_draw };
+      return { g_config->points_draw, g_config->points_draw };
     case tournament::GameOutcome::SecondPlayerWins:
-      return { g_config.points_lose, g_config.points_win };
+      return { g_config->points_lose, g_config->points_win };
     default:
       FATAL("unexpected outcome");
   }
 }
 
 tournament::GameOutcome PongRules::play(Player* player1, Player* player2) const {
-  Game game(g_config.max_steps);
+  Game game(g_config->max_steps);
 
-  CHECK(g_config.sets_per_game > 0);
-  CHECK(g_config.sets_required_to_win > g_config.sets_per_game / 2);
-  CHECK(g_config.sets_required_to_win <= g_config.sets_per_game);
+  CHECK(g_config->sets_per_game > 0);
+  CHECK(g_config->sets_required_to_win > g_config->sets_per_game / 2);
+  CHECK(g_config->sets_required_to_win <= g_config->sets_per_game);
 
   // play the game
   game.newGame(player1, player2);
-  for (int set = 0; set < g_config.sets_per_game; ++set) {
+  for (int set = 0; set < g_config->sets_per_game; ++set) {
     while (game.gameStep())
       ;
     game.newSet();
   }
 
   // decide the final game results
-  if (game.scoreP1() >= g_config.sets_required_to_win) {
+  if (game.scoreP1() >= g_config->sets_required_to_win) {
     return tournament::GameOutcome::FirstPlayerWins;
-  } else if (game.scoreP2() >= g_config.sets_required_to_win) {
+  } else if (game.scoreP2() >= g_config->sets_required_to_win) {
     return tournament::GameOutcome::SecondPlayerWins;
   } else {
     return tournament::GameOutcome::Draw;
   }
 }
 
-tournament::GameOutcome PongRules::play(const darwin::Genotype* player1_genotype,
-                                        const darwin::Genotype* player2_genotype) const {
-  AnnPlayer player1;
-  player1.grow(player1_genotype);
+tournament::GameOutcome PongRules::play(const tournament::Contestant& player1,
+                                        const tournament::Contestant& player2) const {
+  AnnPlayer ann_player1;
+  ann_player1.attach(player1);
 
-  AnnPlayer player2;
-  player2.grow(player2_genotype);
+  AnnPlayer ann_player2;
+  ann_player2.attach(player2);
 
-  return play(&player1, &player2);
+  return play(&ann_player1, &ann_player2);
 }
 
 }  // namespace pong
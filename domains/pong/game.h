@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <core/context.h>
 #include <core/properties.h>
 #include <core/tournament_implementations.h>
 
@@ -54,7 +55,9 @@ struct Config : public core::PropertySet {
           "Tournament type");
 };
 
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the domain instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 class Game : public core::NonCopyable {
  public:
@@ -116,8 +119,8 @@ class PongRules : public tournament::GameRules {
 
   tournament::GameOutcome play(Player* player1, Player* player2) const;
   
-  tournament::GameOutcome play(const darwin::Genotype* player1_genotype,
-                               const darwin::Genotype* player2_genotype) const override;
+  tournament::GameOutcome play(const tournament::Contestant& player1,
+                               const tournament::Contestant& player2) const override;
 };
 
 }  // namespace pong
@@ -22,8 +22,11 @@
 #include <core/evolution.h>
 #include <core/logging.h>
 #include <core/exception.h>
+#include <core/parallel_for_each.h>
+#include <core/tournament.h>
 #include <core/tournament_implementations.h>
 
+#include <numeric>
 #include <random>
 using namespace std;
 
@@ -33,6 +36,25 @@ void init() {
   darwin::registry()->domains.add<Factory>("pong");
 }
 
+Pong::Pong(const core::PropertySet& config) {
+  config_.copyFrom(config);
+
+  // config values validation
+  if (config_.sets_per_game < 1)
+    throw core::Exception("Invalid config value: sets_per_game must be a positive value");
+  if (config_.sets_required_to_win <= config_.sets_per_game / 2)
+    throw core::Exception(
+        "Invalid config values: sets_required_to_win <= sets_per_game / 2");
+  if (config_.sets_required_to_win > config_.sets_per_game)
+    throw core::Exception("Invalid config values: sets_required_to_win > sets_per_game");
+
+  g_config.bind(&config_);
+}
+
+Pong::~Pong() {
+  g_config.unbind(&config_);
+}
+
 bool Pong::evaluatePopulation(darwin::Population* population) const {
   darwin::StageScope stage("Evaluate population");
 
@@ -40,7 +62,7 @@ bool Pong::evaluatePopulation(darwin::Population* population) const {
   core::log("\n. generation %d\n", generation);
 
   PongRules rules;
-  auto tournament = tournament::create(g_config.tournament_type);
+  auto tournament = tournament::create(g_config->tournament_type);
   tournament->evaluatePopulation(population, &rules);
   return false;
 }
@@ -49,21 +71,28 @@ struct CalibrationFitness : public core::PropertySet {
   PROPERTY(vs_handcrafted, float, 0, "Score vs. a handcrafted player");
 };
 
+// the calibration games are played in parallel, each game (and rematch) using
+// its own instances of the players (the champion brain is reused across games)
 static float calibrationScore(const PongRules& rules,
-                              Player& subject_player,
-                              Player& calibration_player) {
-  float calibration_score = 0;
-  int calibration_games = 0;
+                              tournament::ReplicatedBrain* champion) {
+  vector<float> game_scores(g_config->calibration_games);
+
+  auto play_game = [&](int game, const tournament::Contestant& contestant) {
+    AnnPlayer subject_player;
+    subject_player.attach(contestant);
+    HandcraftedPlayer calibration_player;
 
-  for (int i = 0; i < g_config.calibration_games; ++i) {
     auto outcome = rules.play(&subject_player, &calibration_player);
-    calibration_score += rules.scores(outcome).player1_score;
-    ++calibration_games;
+    game_scores[game] = rules.scores(outcome).player1_score;
 
     auto rematch_outcome = rules.play(&calibration_player, &subject_player);
-    calibration_score += rules.scores(rematch_outcome).player2_score;
-    ++calibration_games;
-  }
+    game_scores[game] += rules.scores(rematch_outcome).player2_score;
+  };
+  champion->playGames(int(game_scores.size()), play_game);
+
+  const float calibration_score =
+      accumulate(game_scores.begin(), game_scores.end(), 0.0f);
+  const int calibration_games = int(game_scores.size()) * 2;
 
   // normalize the fitness to make it invariant to the number of played games
   return calibration_score / calibration_games;
@@ -76,29 +105,17 @@ unique_ptr<core::PropertySet> Pong::calibrateGenotype(
   PongRules rules;
   auto calibration = make_unique<CalibrationFitness>();
 
-  AnnPlayer champion;
-  champion.grow(genotype);
+  // the champion brain is grown once per worker thread (not once per game)
+  tournament::ReplicatedBrain champion(genotype, &rules);
 
   // calibration: handcrafted
-  HandcraftedPlayer handcrafted_player;
-  calibration->vs_handcrafted = calibrationScore(rules, champion, handcrafted_player);
+  calibration->vs_handcrafted = calibrationScore(rules, &champion);
 
   return calibration;
 }
 
 unique_ptr<darwin::Domain> Factory::create(const core::PropertySet& config) {
-  g_config.copyFrom(config);
-
-  // config values validation
-  if (g_config.sets_per_game < 1)
-    throw core::Exception("Invalid config value: sets_per_game must be a positive value");
-  if (g_config.sets_required_to_win <= g_config.sets_per_game / 2)
-    throw core::Exception(
-        "Invalid config values: sets_required_to_win <= sets_per_game / 2");
-  if (g_config.sets_required_to_win > g_config.sets_per_game)
-    throw core::Exception("Invalid config values: sets_required_to_win > sets_per_game");
-
-  return make_unique<Pong>();
+  return make_unique<Pong>(config);
 }
 
 unique_ptr<core::PropertySet> Factory::defaultConfig(darwin::ComplexityHint hint) const {
@@ -57,6 +57,9 @@ void init();
 //!
 class Pong : public darwin::Domain {
  public:
+  explicit Pong(const core::PropertySet& config);
+  ~Pong() override;
+
   size_t inputs() const override { return AnnPlayer::kInputs; }
   size_t outputs() const override { return AnnPlayer::kOutputs; }
 
@@ -64,6 +67,9 @@ class Pong : public darwin::Domain {
 
   unique_ptr<core::PropertySet> calibrateGenotype(
       const darwin::Genotype* genotype) const override;
+
+ private:
+  Config config_;
 };
 
 class Factory : public darwin::DomainFactory {
@@ -22,7 +22,7 @@ Player::Action HandcraftedPlayer::action() {
       (side_ == Side::Left) ? game_->paddlePosP1() : game_->paddlePosP2();
 
   const auto& ball = game_->ball();
-  const float paddle_half_size = g_config.paddle_size / 2;
+  const float paddle_half_size = g_config->paddle_size / 2;
 
   // only track the ball if it's on its side of the court
   // (to discourage simple mirroring strategies)
@@ -68,7 +68,7 @@ void PongWidget::setDebugRendering(bool debug) {
 }
 
 void PongWidget::paintPaddle(QPainter& painter, float x, float y) const {
-  const float height = pong::g_config.paddle_size;
+  const float height = pong::g_config->paddle_size;
 
   QRectF paddle_rect(x < 0 ? x - kPaddleWidth : x, y - height / 2, kPaddleWidth, height);
 
@@ -86,8 +86,8 @@ void PongWidget::paintTrajectory(QPainter& painter,
 
   painter.setPen(QPen(kDebugLineColor, 0, Qt::DotLine, Qt::SquareCap, Qt::MiterJoin));
 
-  const float offset = pong::g_config.paddle_offset;
-  const float r = pong::g_config.ball_radius;
+  const float offset = pong::g_config->paddle_offset;
+  const float r = pong::g_config->ball_radius;
   const float left = -1 + offset + r;
   const float right = 1 - offset - r;
   const float up = 1 - r;
@@ -150,8 +150,8 @@ void PongWidget::paintBoard(QPainter& painter) const {
   painter.drawLine(QLineF(0, 0, 0, 1));
 
   if (debug_) {
-    const float dy = pong::g_config.ball_radius;
-    const float dx = pong::g_config.paddle_offset + dy;
+    const float dy = pong::g_config->ball_radius;
+    const float dx = pong::g_config->paddle_offset + dy;
     painter.setPen(QPen(kDebugLineColor, 0, Qt::DotLine, Qt::SquareCap, Qt::MiterJoin));
     painter.setBrush(Qt::NoBrush);
     painter.drawRect(QRectF(QPointF(-1 + dx, dy), QPointF(1 - dx, 1 - dy)));
@@ -196,7 +196,7 @@ void PongWidget::paintMessage(QPainter& painter,
 }
 
 void PongWidget::paintBall(QPainter& painter, const pong::Game::Ball& ball) const {
-  const float r = pong::g_config.ball_radius;
+  const float r = pong::g_config->ball_radius;
 
   if (debug_)
     paintTrajectory(painter, ball);
@@ -245,7 +245,7 @@ void PongWidget::paintEvent(QPaintEvent*) {
   paintScore(painter, 0.5f, 0.8f, game_->scoreP2());
 
   // paddles
-  const float offset = pong::g_config.paddle_offset;
+  const float offset = pong::g_config->paddle_offset;
   paintPaddle(painter, -1 + offset, game_->paddlePosP1());
   paintPaddle(painter, 1 - offset, game_->paddlePosP2());
 
@@ -57,6 +57,10 @@ class TestDomain : public darwin::Domain {
   size_t outputs() const override;
 
   bool evaluatePopulation(darwin::Population* population) const override;
+  bool independentEvaluation() const override { return true; }
+  vector<darwin::FidelityKnob> fidelityKnobs() const override {
+    return { { "eval_steps", 1 } };
+  }
   
   const Config& config() const { return config_; }
 
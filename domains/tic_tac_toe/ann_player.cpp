@@ -39,7 +39,7 @@ static float pieceValue(Board::Piece piece, Board::Piece side) {
 }
 
 int AnnPlayer::outputs() {
-  switch (g_config.ann_type) {
+  switch (g_config->ann_type) {
     case AnnType::Policy:
       return 9;
     case AnnType::Value:
@@ -51,10 +51,21 @@ int AnnPlayer::outputs() {
 
 void AnnPlayer::grow(const darwin::Genotype* genotype, int generation) {
   generation_ = generation;
-  brain_ = genotype->grow();
+  owned_brain_ = genotype->grow();
+  brain_ = owned_brain_.get();
+  memoized_brain_ = nullptr;
   genotype_ = genotype;
 }
 
+void AnnPlayer::attach(const tournament::Contestant& contestant) {
+  CHECK(contestant.brain != nullptr);
+  generation_ = -1;
+  owned_brain_.reset();
+  brain_ = contestant.brain;
+  memoized_brain_ = dynamic_cast<MemoizedBrain*>(contestant.brain);
+  genotype_ = contestant.genotype;
+}
+
 void AnnPlayer::newGame(const Board* board, Board::Piece side) {
   Player::newGame(board, side);
   brain_->resetState();
@@ -63,7 +74,21 @@ void AnnPlayer::newGame(const Board* board, Board::Piece side) {
 int AnnPlayer::move() {
   CHECK(side_ != Board::Piece::Empty);
 
-  switch (g_config.ann_type) {
+  if (memoized_brain_ != nullptr) {
+    const int position = board_->relativeIndex(side_);
+    int square = memoized_brain_->move(position);
+    if (square == Board::kNoSquare) {
+      square = brainMove();
+      memoized_brain_->setMove(position, square);
+    }
+    return square;
+  }
+
+  return brainMove();
+}
+
+int AnnPlayer::brainMove() {
+  switch (g_config->ann_type) {
     case AnnType::Policy:
       return policyBrainMove();
 
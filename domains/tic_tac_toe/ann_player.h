@@ -18,12 +18,43 @@
 #include "player.h"
 
 #include <core/darwin.h>
+#include <core/tournament.h>
 
+#include <cstdint>
 #include <memory>
+#include <vector>
 using namespace std;
 
 namespace tic_tac_toe {
 
+// A brain wrapper which caches the selected moves, indexed by Board::relativeIndex()
+//
+// The cached moves are only valid for brains without internal state
+// (see Config::memoize_moves)
+//
+class MemoizedBrain : public darwin::Brain {
+ public:
+  explicit MemoizedBrain(unique_ptr<darwin::Brain> brain)
+      : brain_(std::move(brain)), moves_(Board::kConfigurations, Board::kNoSquare) {}
+
+  // Brain interface
+  void setInput(int index, float value) override { brain_->setInput(index, value); }
+  float output(int index) const override { return brain_->output(index); }
+  void think() override { brain_->think(); }
+  void resetState() override { brain_->resetState(); }
+
+  // the cached move, or Board::kNoSquare
+  int move(int relative_index) const { return moves_[relative_index]; }
+
+  void setMove(int relative_index, int square) {
+    moves_[relative_index] = int8_t(square);
+  }
+
+ private:
+  unique_ptr<darwin::Brain> brain_;
+  vector<int8_t> moves_;
+};
+
 class AnnPlayer : public Player {
  public:
   static int inputs() { return 9; }
@@ -31,6 +62,9 @@ class AnnPlayer : public Player {
 
   void grow(const darwin::Genotype* genotype, int generation = -1);
 
+  //! Uses an already grown brain (owned by the caller)
+  void attach(const tournament::Contestant& contestant);
+
   auto genotype() const { return genotype_; }
 
   // Player interface
@@ -40,11 +74,14 @@ class AnnPlayer : public Player {
   string name() const override;
 
  private:
+  int brainMove();
   int policyBrainMove();
   int valueBrainMove();
 
  private:
-  unique_ptr<darwin::Brain> brain_;
+  darwin::Brain* brain_ = nullptr;
+  unique_ptr<darwin::Brain> owned_brain_;
+  MemoizedBrain* memoized_brain_ = nullptr;
   const darwin::Genotype* genotype_ = nullptr;
   int generation_ = -1;
 };
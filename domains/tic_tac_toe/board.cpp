@@ -33,6 +33,23 @@ Board::State Board::state() const {
   return State::Draw;
 }
 
+int Board::index() const {
+  int index = 0;
+  for (int square = kSize - 1; square >= 0; --square)
+    index = index * 3 + int(board_[square]);
+  return index;
+}
+
+int Board::relativeIndex(Piece side) const {
+  CHECK(side != Piece::Empty);
+  int index = 0;
+  for (int square = kSize - 1; square >= 0; --square) {
+    const auto piece = board_[square];
+    index = index * 3 + (piece == Piece::Empty ? 0 : (piece == side ? 1 : 2));
+  }
+  return index;
+}
+
 Board::Piece Board::otherSide(Board::Piece piece) {
   switch (piece) {
     case Piece::X:
@@ -53,6 +53,9 @@ class Board {
   static constexpr int kSize = 9;
   static constexpr int kNoSquare = -1;
 
+  // the number of distinct board configurations (3^9, including unreachable ones)
+  static constexpr int kConfigurations = 19683;
+
  public:
   Board() { reset(); }
 
@@ -67,6 +70,14 @@ class Board {
 
   State state() const;
 
+  // base-3 encoding of the board configuration, in the [0, kConfigurations) range
+  // (one digit per square: empty = 0, X = 1, zero = 2)
+  int index() const;
+
+  // same as index(), but relative to the specified side (own = 1, opponent = 2)
+  // (so the same relative configuration has the same index for X and zero)
+  int relativeIndex(Piece side) const;
+
   static Piece otherSide(Piece piece);
 
  private:
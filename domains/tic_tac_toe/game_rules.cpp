@@ -14,6 +14,7 @@
 
 #include "game_rules.h"
 #include "ann_player.h"
+#include "tic_tac_toe.h"
 
 namespace tic_tac_toe {
 
@@ -63,15 +64,24 @@ tournament::GameOutcome TicTacToeRules::play(Player* x_player, Player* o_player)
   }
 }
 
-tournament::GameOutcome TicTacToeRules::play(const darwin::Genotype* x_genotype,
-                                             const darwin::Genotype* o_genotype) const {
+tournament::GameOutcome TicTacToeRules::play(
+    const tournament::Contestant& x_contestant,
+    const tournament::Contestant& o_contestant) const {
   AnnPlayer x_player;
-  x_player.grow(x_genotype);
+  x_player.attach(x_contestant);
 
   AnnPlayer o_player;
-  o_player.grow(o_genotype);
+  o_player.attach(o_contestant);
 
   return play(&x_player, &o_player);
 }
 
+unique_ptr<darwin::Brain> TicTacToeRules::growBrain(
+    const darwin::Genotype* genotype) const {
+  auto brain = genotype->grow();
+  if (g_config->memoize_moves)
+    return make_unique<MemoizedBrain>(std::move(brain));
+  return brain;
+}
+
 }  // namespace tic_tac_toe
@@ -26,8 +26,10 @@ class TicTacToeRules : public tournament::GameRules {
 
   tournament::GameOutcome play(Player* x_player, Player* o_player) const;
 
-  tournament::GameOutcome play(const darwin::Genotype* x_genotype,
-                               const darwin::Genotype* o_genotype) const override;
+  tournament::GameOutcome play(const tournament::Contestant& x_contestant,
+                               const tournament::Contestant& o_contestant) const override;
+
+  unique_ptr<darwin::Brain> growBrain(const darwin::Genotype* genotype) const override;
 };
 
 }  // namespace tic_tac_toe
@@ -16,11 +16,83 @@
 
 #include <core/utils.h>
 
+#include <cstdint>
 #include <limits>
+#include <vector>
 using namespace std;
 
 namespace tic_tac_toe {
 
+namespace {
+
+// The best move for every reachable board configuration (indexed by Board::index())
+class PerfectPlayTable {
+ public:
+  PerfectPlayTable()
+      : moves_(Board::kConfigurations, Board::kNoSquare),
+        values_(Board::kConfigurations, kUnknownValue) {
+    Board board;
+    evaluate(board, Board::Piece::X, 0);
+  }
+
+  int move(const Board& board) const { return moves_[board.index()]; }
+
+ private:
+  // minimax value of an undecided board, relative to the side to move
+  //
+  // a win scores (1 + the number of empty squares left), so quicker wins
+  // are preferred (and, symmetrically, the losses are delayed)
+  //
+  int evaluate(Board& board, Board::Piece side, int pieces) {
+    const int index = board.index();
+    if (values_[index] != kUnknownValue)
+      return values_[index];
+
+    int best_value = numeric_limits<int>::min();
+    int best_move = Board::kNoSquare;
+
+    for (int square = 0; square < Board::kSize; ++square) {
+      if (board[square] != Board::Piece::Empty)
+        continue;
+
+      board[square] = side;
+
+      int value = 0;
+      switch (board.state()) {
+        case Board::State::Undecided:
+          value = -evaluate(board, Board::otherSide(side), pieces + 1);
+          break;
+        case Board::State::Draw:
+          value = 0;
+          break;
+        default:
+          value = Board::kSize - pieces;
+          break;
+      }
+
+      board[square] = Board::Piece::Empty;
+
+      if (value > best_value) {
+        best_value = value;
+        best_move = square;
+      }
+    }
+
+    CHECK(best_move != Board::kNoSquare);
+    moves_[index] = int8_t(best_move);
+    values_[index] = int8_t(best_value);
+    return best_value;
+  }
+
+ private:
+  static constexpr int8_t kUnknownValue = numeric_limits<int8_t>::min();
+
+  vector<int8_t> moves_;
+  vector<int8_t> values_;
+};
+
+}  // namespace
+
 int RandomPlayer::move() {
   CHECK(side_ != Board::Piece::Empty);
 
@@ -107,4 +179,15 @@ string RandomPlayer::name() const {
   return informed_choice_ ? "Informed Random" : "Random";
 }
 
+int PerfectPlayer::move() {
+  CHECK(side_ != Board::Piece::Empty);
+
+  static const auto table = new PerfectPlayTable();
+
+  const int move = table->move(*board_);
+  CHECK(move != Board::kNoSquare);
+  CHECK((*board_)[move] == Board::Piece::Empty);
+  return move;
+}
+
 }  // namespace tic_tac_toe
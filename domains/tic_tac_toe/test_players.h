@@ -39,4 +39,14 @@ class RandomPlayer : public Player {
   bool informed_choice_ = false;
 };
 
+// A perfect player, looking up the moves in a precomputed minimax table
+// (it never loses, and it wins as quickly as possible)
+class PerfectPlayer : public Player {
+ public:
+  // Player interface
+  int move() override;
+
+  string name() const override { return "Perfect"; }
+};
+
 }  // namespace tic_tac_toe
@@ -21,15 +21,19 @@
 #include <core/darwin.h>
 #include <core/evolution.h>
 #include <core/logging.h>
+#include <core/parallel_for_each.h>
 
 #include <algorithm>
 #include <memory>
+#include <numeric>
 #include <random>
 using namespace std;
 
 namespace tic_tac_toe {
 
-Config g_config;
+static Config g_default_config;
+
+core::ContextSlot<Config> g_config(&g_default_config);
 
 void init() {
   darwin::registry()->domains.add<Factory>("tic_tac_toe");
@@ -50,7 +54,7 @@ bool TicTacToe::evaluatePopulation(darwin::Population* population) const {
   core::log("\n. generation %d\n", generation);
 
   TicTacToeRules rules;
-  auto tournament = tournament::create(g_config.tournament_type);
+  auto tournament = tournament::create(g_config->tournament_type);
   tournament->evaluatePopulation(population, &rules);
   return false;
 }
@@ -58,28 +62,57 @@ bool TicTacToe::evaluatePopulation(darwin::Population* population) const {
 struct CalibrationFitness : public core::PropertySet {
   PROPERTY(vs_random_player, float, 0, "Play against a player picking random moves");
   PROPERTY(vs_average_player, float, 0, "Play against an average player");
+  PROPERTY(vs_perfect_player, float, 0, "Play against a perfect (minimax) player");
 };
 
+// the calibration matches are played in parallel, each match using its own
+// instances of the players (the champion brain is reused across matches)
 static float calibrationScore(const TicTacToeRules& rules,
-                              Player& subject_player,
-                              Player& calibration_player) {
-  float calibration_score = 0;
-  int calibration_games = 0;
+                              tournament::ReplicatedBrain* champion,
+                              bool informed_choice) {
+  vector<float> match_scores(g_config->calibration_matches);
+
+  auto play_match = [&](int match, const tournament::Contestant& contestant) {
+    AnnPlayer subject_player;
+    subject_player.attach(contestant);
+    RandomPlayer calibration_player(informed_choice);
 
-  for (int i = 0; i < g_config.calibration_matches; ++i) {
     auto outcome = rules.play(&subject_player, &calibration_player);
-    calibration_score += rules.scores(outcome).player1_score;
-    ++calibration_games;
+    match_scores[match] = rules.scores(outcome).player1_score;
 
     auto rematch_outcome = rules.play(&calibration_player, &subject_player);
-    calibration_score += rules.scores(rematch_outcome).player2_score;
-    ++calibration_games;
-  }
+    match_scores[match] += rules.scores(rematch_outcome).player2_score;
+  };
+  champion->playGames(int(match_scores.size()), play_match);
+
+  const float calibration_score =
+      accumulate(match_scores.begin(), match_scores.end(), 0.0f);
+  const int calibration_games = int(match_scores.size()) * 2;
 
   // normalize the fitness to make it invariant to the number of played games
   return calibration_score / calibration_games;
 }
 
+// both the champion and the perfect player are deterministic,
+// so a single match (game and rematch) is enough
+static float perfectPlayScore(const TicTacToeRules& rules,
+                              tournament::ReplicatedBrain* champion) {
+  float calibration_score = 0;
+  champion->playGames(1, [&](int, const tournament::Contestant& contestant) {
+    AnnPlayer subject_player;
+    subject_player.attach(contestant);
+    PerfectPlayer perfect_player;
+
+    auto outcome = rules.play(&subject_player, &perfect_player);
+    calibration_score = rules.scores(outcome).player1_score;
+
+    auto rematch_outcome = rules.play(&perfect_player, &subject_player);
+    calibration_score += rules.scores(rematch_outcome).player2_score;
+  });
+
+  return calibration_score / 2;
+}
+
 unique_ptr<core::PropertySet> TicTacToe::calibrateGenotype(
     const darwin::Genotype* genotype) const {
   darwin::StageScope stage("Evaluate champion");
@@ -87,16 +120,17 @@ unique_ptr<core::PropertySet> TicTacToe::calibrateGenotype(
   TicTacToeRules rules;
   auto calibration = make_unique<CalibrationFitness>();
 
-  AnnPlayer champion;
-  champion.grow(genotype);
+  // the champion brain is grown once per worker thread (not once per match)
+  tournament::ReplicatedBrain champion(genotype, &rules);
 
   // calibration: a completely random player
-  RandomPlayer random_player(false);
-  calibration->vs_random_player = calibrationScore(rules, champion, random_player);
+  calibration->vs_random_player = calibrationScore(rules, &champion, false);
 
   // calibration: an average player (preferring winning and blocking moves)
-  RandomPlayer average_player(true);
-  calibration->vs_average_player = calibrationScore(rules, champion, average_player);
+  calibration->vs_average_player = calibrationScore(rules, &champion, true);
+
+  // calibration: a perfect player
+  calibration->vs_perfect_player = perfectPlayScore(rules, &champion);
 
   return calibration;
 }
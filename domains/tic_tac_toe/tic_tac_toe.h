@@ -14,6 +14,7 @@
 
 #pragma once
 
+#include <core/context.h>
 #include <core/darwin.h>
 #include <core/properties.h>
 #include <core/stringify.h>
@@ -40,13 +41,21 @@ struct Config : public core::PropertySet {
   PROPERTY(ann_type, AnnType, AnnType::Value, "The role of the evolved brains");
   PROPERTY(calibration_matches, int, 100, "Number of calibration games");
 
+  PROPERTY(memoize_moves,
+           bool,
+           false,
+           "Cache the moves of each brain during a tournament "
+           "(only valid for brains without internal state, ex. feedforward)");
+
   VARIANT(tournament_type,
           tournament::TournamentVariant,
           tournament::TournamentType::Swiss,
           "Tournament type");
 };
 
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the domain instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 void init();
 
@@ -81,6 +90,13 @@ void init();
 //!
 class TicTacToe : public darwin::Domain {
  public:
+  explicit TicTacToe(const core::PropertySet& config) {
+    config_.copyFrom(config);
+    g_config.bind(&config_);
+  }
+
+  ~TicTacToe() override { g_config.unbind(&config_); }
+
   size_t inputs() const override;
   size_t outputs() const override;
 
@@ -88,12 +104,14 @@ class TicTacToe : public darwin::Domain {
 
   unique_ptr<core::PropertySet> calibrateGenotype(
       const darwin::Genotype* genotype) const override;
+
+ private:
+  Config config_;
 };
 
 class Factory : public darwin::DomainFactory {
   unique_ptr<darwin::Domain> create(const core::PropertySet& config) override {
-    g_config.copyFrom(config);
-    return make_unique<TicTacToe>();
+    return make_unique<TicTacToe>(config);
   }
 
   unique_ptr<core::PropertySet> defaultConfig(
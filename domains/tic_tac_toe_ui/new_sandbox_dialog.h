@@ -30,6 +30,7 @@ class NewSandboxDialog : public QDialog {
   static constexpr const char* kHumanPlayer = "Human player";
   static constexpr const char* kRandomPlayer = "Random";
   static constexpr const char* kInformedRandomPlayer = "Informed Random";
+  static constexpr const char* kPerfectPlayer = "Perfect";
 
  public:
   explicit NewSandboxDialog(QWidget* parent = nullptr);
@@ -52,6 +52,8 @@ static unique_ptr<tic_tac_toe::Player> newPlayer(const QString& type, int genera
     return make_unique<tic_tac_toe::RandomPlayer>(false);
   } else if (type == NewSandboxDialog::kInformedRandomPlayer) {
     return make_unique<tic_tac_toe::RandomPlayer>(true);
+  } else if (type == NewSandboxDialog::kPerfectPlayer) {
+    return make_unique<tic_tac_toe::PerfectPlayer>();
   } else {
     FATAL("Unexpected player type");
   }
@@ -20,7 +20,9 @@
 #include <core/exception.h>
 #include <core/logging.h>
 #include <core/parallel_for_each.h>
+#include <core/sim/world_pool.h>
 
+#include <memory>
 #include <random>
 using namespace std;
 
@@ -54,11 +56,17 @@ bool Unicycle::evaluatePopulation(darwin::Population* population) const {
     darwin::StageScope stage("Evaluate one world", population->size());
     core::log(" ... world %d\n", world_index);
 
-    const float initial_angle = randomInitialAngle();
-    const float target_position = randomTargetPosition();
+    // the test world (see darwin::evaluationSeed())
+    default_random_engine rnd(darwin::evaluationSeed(world_index));
+    const float initial_angle = randomInitialAngle(rnd);
+    const float target_position = randomTargetPosition(rnd);
+
+    // one world instance per thread, reset for each episode
+    sim::WorldPool<World> world_pool(
+        [&] { return make_unique<World>(initial_angle, target_position, this); });
 
     pp::for_each(*population, [&](int, darwin::Genotype* genotype) {
-      World world(initial_angle, target_position, this);
+      World& world = *world_pool.acquire();
       Agent agent(genotype, &world);
 
       // simulation loop
@@ -87,17 +95,13 @@ bool Unicycle::evaluatePopulation(darwin::Population* population) const {
   return false;
 }
 
-float Unicycle::randomInitialAngle() const {
-  random_device rd;
-  default_random_engine rnd(rd());
+float Unicycle::randomInitialAngle(default_random_engine& rnd) const {
   uniform_real_distribution<float> dist(-config_.max_initial_angle,
                                         config_.max_initial_angle);
   return dist(rnd);
 }
 
-float Unicycle::randomTargetPosition() const {
-  random_device rd;
-  default_random_engine rnd(rd());
+float Unicycle::randomTargetPosition(default_random_engine& rnd) const {
   uniform_real_distribution<float> dist(-config_.max_distance, config_.max_distance);
   return dist(rnd);
 }
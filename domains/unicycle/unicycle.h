@@ -17,6 +17,9 @@
 #include <core/darwin.h>
 #include <core/properties.h>
 
+#include <random>
+using namespace std;
+
 namespace unicycle {
 
 //! Unicycle domain configuration
@@ -107,11 +110,15 @@ class Unicycle : public darwin::Domain {
   size_t outputs() const override;
 
   bool evaluatePopulation(darwin::Population* population) const override;
+  bool independentEvaluation() const override { return true; }
+  vector<darwin::FidelityKnob> fidelityKnobs() const override {
+    return { { "max_steps", 100 }, { "test_worlds", 1 } };
+  }
   
   const Config& config() const { return config_; }
   
-  float randomInitialAngle() const;
-  float randomTargetPosition() const;
+  float randomInitialAngle(default_random_engine& rnd) const;
+  float randomTargetPosition(default_random_engine& rnd) const;
   
  private:
   void validateConfiguration();
@@ -96,11 +96,20 @@ void World::createHinge(b2Body* wheel, b2Body* pole) {
 World::World(float initial_angle, float target_position, const Unicycle* domain)
     : b2_world_(b2Vec2(0, -domain->config().gravity)),
       target_position_(target_position),
+      initial_target_position_(target_position),
       domain_(domain) {
   createGround();
   wheel_ = createWheel();
   pole_ = createPole(initial_angle);
   createHinge(wheel_, pole_);
+
+  b2_world_.recordInitialState();
+}
+
+void World::reset() {
+  b2_world_.reset();
+  fitness_bonus_ = 0;
+  target_position_ = initial_target_position_;
 }
 
 bool World::simStep() {
@@ -111,7 +120,7 @@ bool World::simStep() {
   const auto& config = domain_->config();
 
   // box2d: simulate one step
-  b2_world_.Step(kTimeStep, kVelocityIterations, kPositionIterations);
+  b2_world_.step(kTimeStep, kVelocityIterations, kPositionIterations);
 
   // check wheel distance
   const auto distance = wheelDistance();
@@ -16,6 +16,7 @@
 
 #include "unicycle.h"
 
+#include <core/sim/resettable_world.h>
 #include <third_party/box2d/box2d.h>
 
 namespace unicycle {
@@ -29,6 +30,9 @@ class World {
  public:
   World(float initial_angle, float target_position, const Unicycle* domain);
 
+  // restores the initial state (reusing the Box2D world)
+  void reset();
+
   // advances the physical simulation one step, returning false
   // if the state reaches one of the termination conditions
   bool simStep();
@@ -59,12 +63,13 @@ class World {
   void createHinge(b2Body* wheel, b2Body* pole);
   
  private:
-  b2World b2_world_;
+  sim::ResettableWorld b2_world_;
   b2Body* wheel_ = nullptr;
   b2Body* pole_ = nullptr;
   
   float fitness_bonus_ = 0;
   float target_position_ = 0;
+  float initial_target_position_ = 0;
   const Unicycle* domain_ = nullptr;
 };
 
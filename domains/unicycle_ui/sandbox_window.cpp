@@ -22,6 +22,9 @@
 
 #include <QString>
 
+#include <random>
+using namespace std;
+
 namespace unicycle_ui {
 
 bool SandboxWindow::setup() {
@@ -76,8 +79,9 @@ void SandboxWindow::newScene() {
   setSceneUi(nullptr);
   scene_ui_.reset();
 
-  const float initial_angle = domain_->randomInitialAngle();
-  const float target_position = domain_->randomTargetPosition();
+  default_random_engine rnd(random_device{}());
+  const float initial_angle = domain_->randomInitialAngle(rnd);
+  const float target_position = domain_->randomTargetPosition(rnd);
   world_ = make_unique<unicycle::World>(initial_angle, target_position, domain_);
   agent_ = make_unique<unicycle::Agent>(genotype_.get(), world_.get());
   step_ = 0;
@@ -33,8 +33,8 @@ class Brain : public darwin::Brain {
 
  public:
   explicit Brain(const Genotype* genotype) : output_layer_(genotype->output_layer) {
-    CHECK(g_inputs > 0);
-    inputs_.resize(g_inputs);
+    CHECK(*g_inputs > 0);
+    inputs_.resize(*g_inputs);
     for (const auto& layer : genotype->hidden_layers)
       hidden_layers_.emplace_back(layer);
   }
@@ -44,7 +44,7 @@ class Brain : public darwin::Brain {
   float output(int index) const override { return output_layer_.values[index]; }
 
   void think() override {
-    if (g_config.normalize_input)
+    if (g_config->normalize_input)
       ann::activateLayer(inputs_);
 
     vector<float>* prev_layer = &inputs_;
@@ -60,7 +60,7 @@ class Brain : public darwin::Brain {
 
     output_layer_.evaluate(*prev_layer);
 
-    if (g_config.normalize_output)
+    if (g_config->normalize_output)
       ann::activateLayer(output_layer_.values);
 
     // finally, map any NaNs to +Inf
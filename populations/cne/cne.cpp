@@ -22,23 +22,18 @@
 
 namespace cne {
 
-Config g_config;
+static Config g_default_config;
 
-size_t g_inputs = 0;
-size_t g_outputs = 0;
+core::ContextSlot<Config> g_config(&g_default_config);
+
+core::ContextSlot<size_t> g_inputs;
+core::ContextSlot<size_t> g_outputs;
 
 template <class GENOTYPE>
 class Factory : public darwin::PopulationFactory {
   unique_ptr<darwin::Population> create(const core::PropertySet& config,
                                         const darwin::Domain& domain) override {
-    g_config.copyFrom(config);
-    g_inputs = domain.inputs();
-    g_outputs = domain.outputs();
-    CHECK(g_inputs > 0);
-    CHECK(g_outputs > 0);
-    ann::setActivationFunction(g_config.activation_function);
-    ann::setGateActivationFunction(g_config.gate_activation_function);
-    return make_unique<Population<GENOTYPE>>();
+    return make_unique<Population<GENOTYPE>>(config, domain);
   }
 
   unique_ptr<core::PropertySet> defaultConfig(
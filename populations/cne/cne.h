@@ -15,6 +15,7 @@
 #pragma once
 
 #include <core/ann_activation_functions.h>
+#include <core/context.h>
 #include <core/utils.h>
 #include <core/darwin.h>
 #include <core/properties.h>
@@ -150,11 +151,13 @@ struct Config : public core::PropertySet {
           "Selection algorithm");
 };
 
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the population instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 // TODO: design a better interface
-extern size_t g_inputs;
-extern size_t g_outputs;
+extern core::ContextSlot<size_t> g_inputs;
+extern core::ContextSlot<size_t> g_outputs;
 
 // genetic operators
 void crossoverOperator(ann::Matrix& child,
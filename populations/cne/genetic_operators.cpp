@@ -34,7 +34,7 @@ void crossoverOperator(ann::Matrix& child,
   std::bernoulli_distribution dist_parent(preference);
   std::bernoulli_distribution dist_coin;
 
-  switch (g_config.crossover_operator) {
+  switch (g_config->crossover_operator) {
     case CrossoverOp::Mix: {
       for (size_t i = 0; i < rows; ++i)
         for (size_t j = 0; j < cols; ++j)
@@ -199,9 +199,9 @@ void mutationOperator(ann::Matrix& w, float mutation_std_dev) {
 
   std::random_device rd;
   std::default_random_engine rnd(rd());
-  std::bernoulli_distribution dist_mutate(g_config.mutation_chance);
+  std::bernoulli_distribution dist_mutate(g_config->mutation_chance);
 
-  switch (g_config.mutation_operator) {
+  switch (g_config->mutation_operator) {
     case MutationOp::IndividualCells: {
       for (size_t i = 0; i < w.rows; ++i)
         for (size_t j = 0; j < w.cols; ++j)
@@ -31,14 +31,14 @@ class Genotype : public darwin::Genotype {
 
  public:
   Genotype() {
-    CHECK(g_inputs > 0);
-    CHECK(g_outputs > 0);
-    size_t prev_size = g_inputs;
-    for (size_t size : g_config.hidden_layers) {
+    CHECK(*g_inputs > 0);
+    CHECK(*g_outputs > 0);
+    size_t prev_size = *g_inputs;
+    for (size_t size : g_config->hidden_layers) {
       hidden_layers.emplace_back(prev_size, size);
       prev_size = size;
     }
-    output_layer = { prev_size, g_outputs };
+    output_layer = { prev_size, *g_outputs };
   }
 
   void reset() override {
@@ -64,7 +64,7 @@ class Genotype : public darwin::Genotype {
     tmp_genotype.output_layer = json_obj.at("output_layer");
 
     // validate the genotype topology
-    size_t prev_size = g_inputs;
+    size_t prev_size = *g_inputs;
     for (const auto& layer : tmp_genotype.hidden_layers) {
       if (prev_size + 1 != layer.w.rows)
         throw core::Exception("Can't load genotype, invalid topology");
@@ -74,7 +74,7 @@ class Genotype : public darwin::Genotype {
     }
     if (prev_size + 1 != tmp_genotype.output_layer.w.rows)
       throw core::Exception("Can't load genotype, invalid topology");
-    if (tmp_genotype.output_layer.w.cols != g_outputs)
+    if (tmp_genotype.output_layer.w.cols != *g_outputs)
       throw core::Exception("Can't load genotype, invalid topology");
 
     // if everything went well, replace the genotype with the loaded one
@@ -99,9 +99,9 @@ class Genotype : public darwin::Genotype {
 
   void mutate() {
     for (auto& layer : hidden_layers) {
-      layer.mutate(ann::g_config.mutation_std_dev);
+      layer.mutate(ann::g_config->mutation_std_dev);
     }
-    output_layer.mutate(ann::g_config.mutation_std_dev);
+    output_layer.mutate(ann::g_config->mutation_std_dev);
   }
 
   void createPrimordialSeed() {
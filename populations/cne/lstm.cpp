@@ -68,6 +68,9 @@ void Layer::evaluate(const vector<float>& inputs) {
   assert(values.size() == lw.rows);
   assert(values.size() == w.cols);
 
+  const auto activate = ann::g_activation_functions->activation;
+  const auto activate_gate = ann::g_activation_functions->gate_activation;
+
   const size_t bias_index = w.rows - 1;
   for (size_t i = 0; i < w.cols; ++i) {
     float v = w[bias_index][i];
@@ -75,12 +78,12 @@ void Layer::evaluate(const vector<float>& inputs) {
       v += inputs[j] * w[j][i];
 
     const float prev = values[i];
-    float cand_C = ann::activate(lw[i][Wc] * v + lw[i][Uc] * prev + lw[i][Bc]);
-    float i_gate = ann::activateGate(lw[i][Wi] * v + lw[i][Ui] * prev + lw[i][Bi]);
-    float f_gate = ann::activateGate(lw[i][Wf] * v + lw[i][Uf] * prev + lw[i][Bf]);
-    float o_gate = ann::activateGate(lw[i][Wo] * v + lw[i][Uo] * prev + lw[i][Bo]);
+    float cand_C = activate(lw[i][Wc] * v + lw[i][Uc] * prev + lw[i][Bc]);
+    float i_gate = activate_gate(lw[i][Wi] * v + lw[i][Ui] * prev + lw[i][Bi]);
+    float f_gate = activate_gate(lw[i][Wf] * v + lw[i][Uf] * prev + lw[i][Bf]);
+    float o_gate = activate_gate(lw[i][Wo] * v + lw[i][Uo] * prev + lw[i][Bo]);
     cells[i] = f_gate * cells[i] + i_gate * cand_C;
-    values[i] = o_gate * ann::activate(cells[i]);
+    values[i] = o_gate * activate(cells[i]);
   }
 }
 
@@ -69,16 +69,19 @@ void Layer::evaluate(const vector<float>& inputs) {
   assert(values.size() == lw.rows);
   assert(values.size() == w.cols);
 
+  const auto activate = ann::g_activation_functions->activation;
+  const auto activate_gate = ann::g_activation_functions->gate_activation;
+
   const size_t bias_index = w.rows - 1;
   for (size_t i = 0; i < w.cols; ++i) {
     float v = w[bias_index][i];
     for (size_t j = 0; j < bias_index; ++j)
       v += inputs[j] * w[j][i];
 
-    float gate = ann::activateGate(lw[i][Wg] * v + lw[i][Ug] * cells[i] + lw[i][Bg]);
+    float gate = activate_gate(lw[i][Wg] * v + lw[i][Ug] * cells[i] + lw[i][Bg]);
     v += lw[i][Wc] * cells[i];
     cells[i] = v * gate;
-    values[i] = ann::activate(v);
+    values[i] = activate(v);
   }
 }
 
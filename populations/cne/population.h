@@ -84,25 +84,45 @@ class Population : public darwin::Population {
   };
 
  public:
-  Population() {
-    switch (g_config.selection_algorithm.tag()) {
+  Population(const core::PropertySet& config, const darwin::Domain& domain) {
+    config_.copyFrom(config);
+    inputs_ = domain.inputs();
+    outputs_ = domain.outputs();
+    CHECK(inputs_ > 0);
+    CHECK(outputs_ > 0);
+    activation_functions_ = ann::ActivationFunctions(config_.activation_function,
+                                                     config_.gate_activation_function);
+
+    g_config.bind(&config_);
+    g_inputs.bind(&inputs_);
+    g_outputs.bind(&outputs_);
+    ann::g_activation_functions.bind(&activation_functions_);
+
+    switch (config_.selection_algorithm.tag()) {
       case SelectionAlgorithmType::RouletteWheel:
         selection_algorithm_ = make_unique<selection::RouletteSelection>(
-            g_config.selection_algorithm.roulette_wheel);
+            config_.selection_algorithm.roulette_wheel);
         break;
       case SelectionAlgorithmType::CgpIslands:
         selection_algorithm_ = make_unique<selection::CgpIslandsSelection>(
-            g_config.selection_algorithm.cgp_islands);
+            config_.selection_algorithm.cgp_islands);
         break;
       case SelectionAlgorithmType::Truncation:
         selection_algorithm_ = make_unique<selection::TruncationSelection>(
-            g_config.selection_algorithm.truncation);
+            config_.selection_algorithm.truncation);
         break;
       default:
         FATAL("Unexpected selection algorithm type");
     }
   }
 
+  ~Population() override {
+    g_config.unbind(&config_);
+    g_inputs.unbind(&inputs_);
+    g_outputs.unbind(&outputs_);
+    ann::g_activation_functions.unbind(&activation_functions_);
+  }
+
   size_t size() const override { return genotypes_.size(); }
 
   int generation() const override { return generation_; }
@@ -149,6 +169,12 @@ class Population : public darwin::Population {
   }
 
  private:
+  // the population state, bound to the cne::g_* context slots
+  Config config_;
+  size_t inputs_ = 0;
+  size_t outputs_ = 0;
+  ann::ActivationFunctions activation_functions_;
+
   vector<GENOTYPE> genotypes_;
   int generation_ = 0;
   
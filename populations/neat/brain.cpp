@@ -24,25 +24,30 @@ void LstmNode::resetState() {
   cell = 0;
 }
 
-void LstmNode::activate(float input) {
-  float cand_C = ann::activate(lw[Wc] * input + lw[Uc] * value + lw[Bc]);
-  float i_gate = ann::activateGate(lw[Wi] * input + lw[Ui] * value + lw[Bi]);
-  float f_gate = ann::activateGate(lw[Wf] * input + lw[Uf] * value + lw[Bf]);
-  float o_gate = ann::activateGate(lw[Wo] * input + lw[Uo] * value + lw[Bo]);
+void LstmNode::activate(float input, const ann::ActivationFunctions& afn) {
+  float cand_C = afn.activation(lw[Wc] * input + lw[Uc] * value + lw[Bc]);
+  float i_gate = afn.gate_activation(lw[Wi] * input + lw[Ui] * value + lw[Bi]);
+  float f_gate = afn.gate_activation(lw[Wf] * input + lw[Uf] * value + lw[Bf]);
+  float o_gate = afn.gate_activation(lw[Wo] * input + lw[Uo] * value + lw[Bo]);
   cell = f_gate * cell + i_gate * cand_C;
-  value = o_gate * ann::activate(cell);
+  value = o_gate * afn.activation(cell);
 }
 
-Brain::Brain(const Genotype* genotype) {
-  const int kFirstOutput = kFirstInput + g_inputs;
+Brain::Brain(const Genotype* genotype)
+    : inputs_count_(*g_inputs),
+      outputs_count_(*g_outputs),
+      normalize_input_(g_config->normalize_input),
+      normalize_output_(g_config->normalize_output),
+      activation_functions_(*ann::g_activation_functions) {
+  const int kFirstOutput = kFirstInput + inputs_count_;
 
-  CHECK(g_inputs > 0);
-  CHECK(g_outputs > 0);
-  CHECK(genotype->nodes_count >= kFirstOutput + g_outputs);
+  CHECK(inputs_count_ > 0);
+  CHECK(outputs_count_ > 0);
+  CHECK(genotype->nodes_count >= kFirstOutput + outputs_count_);
 
   nodes_ = vector<unique_ptr<Node>>(genotype->nodes_count);
   for (auto& node : nodes_) {
-    node = g_config.use_lstm_nodes ? make_unique<LstmNode>(genotype->lw)
+    node = g_config->use_lstm_nodes ? make_unique<LstmNode>(genotype->lw)
                                    : make_unique<Node>();
   }
 
@@ -94,15 +99,15 @@ Brain::Brain(const Genotype* genotype) {
 }
 
 void Brain::think() {
-  const int kFirstOutput = kFirstInput + g_inputs;
-  const int kFirstHidden = kFirstOutput + g_outputs;
+  const int kFirstOutput = kFirstInput + inputs_count_;
+  const int kFirstHidden = kFirstOutput + outputs_count_;
 
   nodes_[kBiasNodeId]->value = 1.0f;
 
-  if (g_config.normalize_input) {
-    for (NodeId i = 0; i < g_inputs; ++i) {
+  if (normalize_input_) {
+    for (NodeId i = 0; i < inputs_count_; ++i) {
       const auto& node = nodes_[kFirstInput + i];
-      node->activate(node->value);
+      node->activate(node->value, activation_functions_);
     }
   }
 
@@ -114,8 +119,8 @@ void Brain::think() {
     for (const auto& link : node->inputs)
       value += nodes_[link.in]->value * link.weight;
 
-    if (g_config.normalize_output || node_id >= kFirstHidden)
-      node->activate(value);
+    if (normalize_output_ || node_id >= kFirstHidden)
+      node->activate(value, activation_functions_);
     else
       node->value = value;
   }
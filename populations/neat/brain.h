@@ -38,7 +38,10 @@ struct Node {
   vector<Link> inputs;
 
   virtual void resetState() { value = 0; }
-  virtual void activate(float input) { value = ann::activate(input); }
+
+  virtual void activate(float input, const ann::ActivationFunctions& afn) {
+    value = afn.activation(input);
+  }
 };
 
 struct LstmNode : public Node {
@@ -52,7 +55,7 @@ struct LstmNode : public Node {
 
   void resetState() override;
 
-  void activate(float input) override;
+  void activate(float input, const ann::ActivationFunctions& afn) override;
 };
 
 // Phenotype
@@ -65,14 +68,14 @@ class Brain : public darwin::Brain {
 
   // index is the input index [0, INPUTS)
   void setInput(int index, float value) override {
-    CHECK(index < g_inputs);
+    CHECK(index < inputs_count_);
     nodes_[kFirstInput + index]->value = value;
   }
 
   // index is the output index [0, OUTPUTS)
   float output(int index) const override {
-    CHECK(index < g_outputs);
-    return nodes_[kFirstInput + g_inputs + index]->value;
+    CHECK(index < outputs_count_);
+    return nodes_[kFirstInput + inputs_count_ + index]->value;
   }
 
   void think() override;
@@ -85,6 +88,14 @@ class Brain : public darwin::Brain {
  private:
   vector<unique_ptr<Node>> nodes_;
   vector<NodeId> eval_order_;
+
+  // the context values are captured when the brain is created
+  // (avoids the context slot lookups in the hot path)
+  const int inputs_count_;
+  const int outputs_count_;
+  const bool normalize_input_;
+  const bool normalize_output_;
+  const ann::ActivationFunctions activation_functions_;
 };
 
 }  // namespace neat
@@ -29,10 +29,10 @@ unique_ptr<darwin::Genotype> Genotype::clone() const {
 void Genotype::reset() {
   darwin::Genotype::reset();
 
-  CHECK(g_inputs > 0);
-  CHECK(g_outputs > 0);
+  CHECK(*g_inputs > 0);
+  CHECK(*g_outputs > 0);
   genes.clear();
-  nodes_count = g_inputs + g_outputs + 1;  // fixed node IDs
+  nodes_count = *g_inputs + *g_outputs + 1;  // fixed node IDs
   age = 0;
   lw = {};
 }
@@ -102,9 +102,9 @@ json Genotype::save() const {
   json_obj["genes"] = genes;
   json_obj["nodes_count"] = nodes_count;
   json_obj["lw"] = lw;
-  json_obj["inputs"] = g_inputs;
-  json_obj["outputs"] = g_outputs;
-  json_obj["lstm"] = g_config.use_lstm_nodes;
+  json_obj["inputs"] = *g_inputs;
+  json_obj["outputs"] = *g_outputs;
+  json_obj["lstm"] = g_config->use_lstm_nodes;
   return json_obj;
 }
 
@@ -118,13 +118,13 @@ void Genotype::load(const json& json_obj) {
   // check inputs & outputs count
   const int tmp_inputs = json_obj.at("inputs");
   const int tmp_outputs = json_obj.at("outputs");
-  if (tmp_inputs != g_inputs || tmp_outputs != g_outputs)
+  if (tmp_inputs != *g_inputs || tmp_outputs != *g_outputs)
     throw core::Exception("Can't load genotype, mismatched inputs or outputs count");
-  if (tmp_genotype.nodes_count < kFirstInput + g_inputs + g_outputs)
+  if (tmp_genotype.nodes_count < kFirstInput + *g_inputs + *g_outputs)
     throw core::Exception("Can't load genotype, invalid nodes count");
 
   // the genotype must be compatible with the current population configuration
-  if (json_obj.at("lstm") != g_config.use_lstm_nodes)
+  if (json_obj.at("lstm") != g_config->use_lstm_nodes)
     throw core::Exception("Can't load genotype, not matching the population config");
 
   // check all the node ids
@@ -147,9 +147,9 @@ void Genotype::load(const json& json_obj) {
 Innovation Genotype::createPrimordialSeed() {
   reset();
 
-  const NodeId kFirstOutput = kFirstInput + g_inputs;
+  const NodeId kFirstOutput = kFirstInput + *g_inputs;
 
-  const float range = ann::g_config.connection_range;
+  const float range = ann::g_config->connection_range;
 
   std::random_device rd;
   std::default_random_engine rnd(rd());
@@ -157,18 +157,18 @@ Innovation Genotype::createPrimordialSeed() {
 
   Innovation innovation = 1;
 
-  for (int out = 0; out < g_outputs; ++out) {
-    for (int in = 0; in < g_inputs; ++in)
+  for (int out = 0; out < *g_outputs; ++out) {
+    for (int in = 0; in < *g_inputs; ++in)
       genes.emplace_back(kFirstInput + in,
                          kFirstOutput + out,
                          ann::roundWeight(dist(rnd)),
                          innovation++);
 
-    if (g_config.implicit_bias_links)
+    if (g_config->implicit_bias_links)
       genes.emplace_back(
           kBiasNodeId, kFirstOutput + out, ann::roundWeight(dist(rnd)), innovation++);
 
-    if (g_config.recurrent_output_nodes) {
+    if (g_config->recurrent_output_nodes) {
       Gene self_link(kFirstOutput + out,
                      kFirstOutput + out,
                      ann::roundWeight(dist(rnd)),
@@ -178,7 +178,7 @@ Innovation Genotype::createPrimordialSeed() {
     }
   }
 
-  if (g_config.use_lstm_nodes)
+  if (g_config->use_lstm_nodes)
     for (float& w : lw)
       w = ann::roundWeight(dist(rnd));
 
@@ -203,7 +203,7 @@ void Genotype::inherit(const Genotype& parent1,
                        float preference) {
   reset();
 
-  const NodeId kHiddenFirst = 1 + g_inputs + g_outputs;
+  const NodeId kHiddenFirst = 1 + *g_inputs + *g_outputs;
 
   std::random_device rd;
   std::default_random_engine rnd(rd());
@@ -248,7 +248,7 @@ void Genotype::inherit(const Genotype& parent1,
     return mapped_node;
   };
 
-  if (g_config.use_lstm_nodes)
+  if (g_config->use_lstm_nodes)
     lw = dist_parent(rnd) ? parent1.lw : parent2.lw;
 
   // merge the genes from the parents
@@ -260,7 +260,7 @@ void Genotype::inherit(const Genotype& parent1,
         CHECK(g1->recurrent == g2->recurrent);
         Gene gene = dist_parent(rnd) ? *g1 : *g2;
 
-        if (g_config.preserve_connectivity) {
+        if (g_config->preserve_connectivity) {
           // make sure we don't mix disabled genes from a parent
           // w/o also carring the mutation which replaced it
           if (!gene.enabled && g1->enabled != g2->enabled) {
@@ -352,8 +352,8 @@ double Genotype::compatibility(const Genotype& ref) const {
   }
 
   constexpr double N = 1;  // same as the official NEAT implementation
-  return (g_config.c1 * E_count) / N + (g_config.c2 * D_count) / N +
-         g_config.c3 * (W / W_count);
+  return (g_config->c1 * E_count) / N + (g_config->c2 * D_count) / N +
+         g_config->c3 * (W / W_count);
 }
 
 unique_ptr<darwin::Brain> Genotype::grow() const {
@@ -107,17 +107,17 @@ class Genotype : public darwin::Genotype {
  private:
   template <class RND>
   void mutateWeights(RND& rnd) {
-    std::bernoulli_distribution dist_mutate(g_config.weight_mutation_chance);
+    std::bernoulli_distribution dist_mutate(g_config->weight_mutation_chance);
 
     // CONSIDER: trimming (disabling?) links with weight < epsilon?
     for (auto& gene : genes)
       if (dist_mutate(rnd))
-        ann::mutateValue(gene.weight, rnd, ann::g_config.mutation_std_dev);
+        ann::mutateValue(gene.weight, rnd, ann::g_config->mutation_std_dev);
 
-    if (g_config.use_lstm_nodes) {
+    if (g_config->use_lstm_nodes) {
       for (float& w : lw)
         if (dist_mutate(rnd))
-          ann::mutateValue(w, rnd, ann::g_config.mutation_std_dev);
+          ann::mutateValue(w, rnd, ann::g_config->mutation_std_dev);
     }
   }
 
@@ -131,9 +131,9 @@ class Genotype : public darwin::Genotype {
   template <class RND>
   void mutateNewLinks(RND& rnd, atomic<Innovation>& next_innovation) {
     const NodeId kInputFirst = 1;
-    const NodeId kOutputFirst = 1 + g_inputs;
+    const NodeId kOutputFirst = 1 + *g_inputs;
 
-    std::bernoulli_distribution dist_mutate(g_config.new_link_chance);
+    std::bernoulli_distribution dist_mutate(g_config->new_link_chance);
     if (dist_mutate(rnd)) {
       std::uniform_int_distribution<NodeId> dist_in_node(kInputFirst, nodes_count - 1);
       std::uniform_int_distribution<NodeId> dist_out_node(kOutputFirst, nodes_count - 1);
@@ -141,7 +141,7 @@ class Genotype : public darwin::Genotype {
       NodeId in = dist_in_node(rnd);
       NodeId out = dist_out_node(rnd);
 
-      const float range = ann::g_config.connection_range;
+      const float range = ann::g_config->connection_range;
       std::uniform_real_distribution<float> dist_weight(-range, range);
 
       // check to see if the link already exists
@@ -165,13 +165,13 @@ class Genotype : public darwin::Genotype {
 
   template <class RND>
   void mutateNewNodes(RND& rnd, atomic<Innovation>& next_innovation) {
-    std::bernoulli_distribution dist_mutate(g_config.new_node_chance);
+    std::bernoulli_distribution dist_mutate(g_config->new_node_chance);
     if (dist_mutate(rnd)) {
       // pick a random gene to split
       std::uniform_int_distribution<size_t> dist_gene_index(0, genes.size() - 1);
       auto& gene = genes[dist_gene_index(rnd)];
 
-      const float range = ann::g_config.connection_range;
+      const float range = ann::g_config->connection_range;
       std::uniform_real_distribution<float> dist_weight(-range, range);
 
       NodeId new_node_id = nodes_count++;
@@ -183,7 +183,7 @@ class Genotype : public darwin::Genotype {
       genes.push_back(pre_link);
       genes.push_back(post_link);
 
-      if (g_config.implicit_bias_links) {
+      if (g_config->implicit_bias_links) {
         Gene bias(kBiasNodeId,
                   new_node_id,
                   ann::roundWeight(dist_weight(rnd)),
@@ -191,7 +191,7 @@ class Genotype : public darwin::Genotype {
         genes.push_back(bias);
       }
 
-      if (g_config.recurrent_hidden_nodes) {
+      if (g_config->recurrent_hidden_nodes) {
         Gene self_link(new_node_id,
                        new_node_id,
                        ann::roundWeight(dist_weight(rnd)),
@@ -19,22 +19,17 @@
 
 namespace neat {
 
-Config g_config;
+static Config g_default_config;
 
-int g_inputs = 0;
-int g_outputs = 0;
+core::ContextSlot<Config> g_config(&g_default_config);
+
+core::ContextSlot<int> g_inputs;
+core::ContextSlot<int> g_outputs;
 
 class Factory : public darwin::PopulationFactory {
   unique_ptr<darwin::Population> create(const core::PropertySet& config,
                                         const darwin::Domain& domain) override {
-    g_config.copyFrom(config);
-    g_inputs = int(domain.inputs());
-    g_outputs = int(domain.outputs());
-    CHECK(g_inputs > 0);
-    CHECK(g_outputs > 0);
-    ann::setActivationFunction(g_config.activation_function);
-    ann::setGateActivationFunction(g_config.gate_activation_function);
-    return make_unique<Population>();
+    return make_unique<Population>(config, domain);
   }
 
   unique_ptr<core::PropertySet> defaultConfig(
@@ -15,6 +15,7 @@
 #pragma once
 
 #include <core/ann_activation_functions.h>
+#include <core/context.h>
 #include <core/properties.h>
 
 // A minimal implementation of NEAT, as described here:
@@ -107,11 +108,12 @@ struct Config : public core::PropertySet {
   PROPERTY(normalize_output, bool, false, "Normalize output values");
 };
 
-// global configuration values
-extern Config g_config;
+// the configuration values for the current context
+// (bound to the population instance, see core::ContextSlot)
+extern core::ContextSlot<Config> g_config;
 
 // TODO: design a better interface
-extern int g_inputs;
-extern int g_outputs;
+extern core::ContextSlot<int> g_inputs;
+extern core::ContextSlot<int> g_outputs;
 
 }  // namespace neat
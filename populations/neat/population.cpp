@@ -27,6 +27,28 @@ using namespace std;
 
 namespace neat {
 
+Population::Population(const core::PropertySet& config, const darwin::Domain& domain) {
+  config_.copyFrom(config);
+  inputs_ = int(domain.inputs());
+  outputs_ = int(domain.outputs());
+  CHECK(inputs_ > 0);
+  CHECK(outputs_ > 0);
+  activation_functions_ = ann::ActivationFunctions(config_.activation_function,
+                                                   config_.gate_activation_function);
+
+  g_config.bind(&config_);
+  g_inputs.bind(&inputs_);
+  g_outputs.bind(&outputs_);
+  ann::g_activation_functions.bind(&activation_functions_);
+}
+
+Population::~Population() {
+  g_config.unbind(&config_);
+  g_inputs.unbind(&inputs_);
+  g_outputs.unbind(&outputs_);
+  ann::g_activation_functions.unbind(&activation_functions_);
+}
+
 void Population::createPrimordialGeneration(int population_size) {
   core::log("Resetting evolution ...\n");
 
@@ -63,7 +85,7 @@ vector<size_t> Population::rankingIndex() const {
 void Population::assignSpecies(int index) {
   const auto& genotype = genotypes_[index];
   for (auto& species : species_) {
-    if (genotype.compatibility(species.origin) < g_config.compatibility_threshold) {
+    if (genotype.compatibility(species.origin) < g_config->compatibility_threshold) {
       species.genotypes.push_back(index);
       return;
     }
@@ -181,18 +203,18 @@ void Population::neatSelection() {
         species.genotypes.size(), 0, 1, [](double x) { return 1.1 - x; });
 
     auto dist_parent = [&](std::default_random_engine& rnd) {
-      return g_config.uniform_parents_distribution ? dist_parent_U(rnd)
+      return g_config->uniform_parents_distribution ? dist_parent_U(rnd)
                                                    : dist_parent_D(rnd);
     };
 
-    std::bernoulli_distribution dist_mutate_elite(g_config.elite_mutation_chance);
+    std::bernoulli_distribution dist_mutate_elite(g_config->elite_mutation_chance);
 
     double expected_offspring = 0;
     for (int i : species.genotypes)
       expected_offspring += genotypes_[i].fitness / average_fitness;
     expected_offspring = floor(expected_offspring);
 
-    if (expected_offspring < g_config.min_species_size) {
+    if (expected_offspring < g_config->min_species_size) {
       ++extinct_species;
     } else {
       for (int i = 0; i < expected_offspring; ++i) {
@@ -202,7 +224,7 @@ void Population::neatSelection() {
 
         float percentage = float(i) / species.genotypes.size();
 
-        if (percentage < g_config.elite_percentage) {
+        if (percentage < g_config->elite_percentage) {
           int parent = species.genotypes[i];
           child = genotypes_[parent];
           if (dist_mutate_elite(rnd)) {
@@ -270,7 +292,7 @@ void Population::neatSelection() {
   std::swap(genotypes_, next_generation);
 
   // recreate species
-  if (g_config.contiguous_species) {
+  if (g_config->contiguous_species) {
     for (auto& species : species_)
       species.genotypes.clear();
   } else {
@@ -301,14 +323,14 @@ void Population::classicSelection() {
     std::uniform_real_distribution<double> dist_survive(0, 1);
 
     auto old_genotype = genotypes_[rank_to_index[index]];
-    double time_left = (g_config.old_age - old_genotype.age) / double(g_config.old_age);
+    double time_left = (g_config->old_age - old_genotype.age) / double(g_config->old_age);
 
-    bool viable = old_genotype.age < g_config.larva_age ||
-                  old_genotype.fitness >= g_config.min_viable_fitness;
+    bool viable = old_genotype.age < g_config->larva_age ||
+                  old_genotype.fitness >= g_config->min_viable_fitness;
 
     // keep the elite population
-    const int elite_limit = max(2, int(genotypes_.size() * g_config.elite_percentage));
-    if (index < elite_limit && old_genotype.fitness >= g_config.elite_min_fitness) {
+    const int elite_limit = max(2, int(genotypes_.size() * g_config->elite_percentage));
+    if (index < elite_limit && old_genotype.fitness >= g_config->elite_min_fitness) {
       // direct reproduction
       genotype = old_genotype;
       genotype.genealogy = darwin::Genealogy("e", { index });
@@ -371,7 +393,7 @@ void Population::createNextGeneration() {
 
   ++generation_;
 
-  if (g_config.use_classic_selection) {
+  if (g_config->use_classic_selection) {
     classicSelection();
   } else {
     neatSelection();
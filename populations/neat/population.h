@@ -32,6 +32,9 @@ struct Species {
 
 class Population : public darwin::Population {
  public:
+  Population(const core::PropertySet& config, const darwin::Domain& domain);
+  ~Population() override;
+
   size_t size() const override { return genotypes_.size(); }
 
   int generation() const override { return generation_; }
@@ -52,6 +55,12 @@ class Population : public darwin::Population {
   void assignSpecies(int index);
 
  private:
+  // the population state, bound to the neat::g_* context slots
+  Config config_;
+  int inputs_ = 0;
+  int outputs_ = 0;
+  ann::ActivationFunctions activation_functions_;
+
   vector<Genotype> genotypes_;
   vector<Species> species_;
   atomic<Innovation> next_innovation_ = 0;
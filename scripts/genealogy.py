@@ -0,0 +1,165 @@
+# Copyright The Darwin Neuroevolution Framework Authors.
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#      http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+
+# decodes the compact genealogy records (see core/genealogy.h) and generates
+# a dot (https://www.graphviz.org) graph with the lineage of a genotype
+#
+# it can also be imported as a module (decode_genealogy() and lineage())
+
+import sqlite3
+import argparse
+
+COMPACT_GENEALOGY_VERSION = 1
+
+#------------------------------------------------------------------------------
+# compact genealogy decoding
+#------------------------------------------------------------------------------
+
+class _Reader:
+    def __init__(self, data):
+        self.data = data
+        self.offset = 0
+
+    def varint(self):
+        value = 0
+        shift = 0
+        while True:
+            byte = self.data[self.offset]
+            self.offset += 1
+            value |= (byte & 0x7f) << shift
+            if byte & 0x80 == 0:
+                return value
+            shift += 7
+
+    def zigzag(self):
+        value = self.varint()
+        return (value >> 1) ^ -(value & 1)
+
+    def string(self):
+        length = self.varint()
+        value = self.data[self.offset:self.offset + length].decode('utf-8')
+        self.offset += length
+        return value
+
+# returns a list of (genetic_operator, [parent ranks]) tuples, indexed by rank
+# (the genetic_operator is None if there's no genealogy information)
+def decode_genealogy(data):
+    reader = _Reader(data)
+    if reader.varint() != COMPACT_GENEALOGY_VERSION:
+        raise ValueError('Unsupported genealogy format version')
+    size = reader.varint()
+    operators = [reader.string() for _ in range(reader.varint())]
+    entries = []
+    prev_first_parent = 0
+    for _ in range(size):
+        code = reader.varint()
+        if code == 0:
+            entries.append((None, []))
+            continue
+        parents = []
+        for i in range(reader.varint()):
+            if i == 0:
+                parent = prev_first_parent + reader.zigzag()
+                prev_first_parent = parent
+            else:
+                parent = parents[-1] + reader.zigzag()
+            parents.append(parent)
+        entries.append((operators[code - 1], parents))
+    if reader.offset != len(data):
+        raise ValueError('Unexpected trailing genealogy data')
+    return entries
+
+# loads the decoded genealogy for all the generations in a trace
+def load_genealogy(db, trace_id):
+    # the compact genealogy requires the universe format version 2
+    (format_version,) = db.execute('pragma user_version').fetchone()
+    if format_version < 2:
+        raise ValueError('Missing compact genealogy (universe format version 1)')
+    generations = []
+    query = 'select generation, genealogy from generation where trace_id = ? order by generation'
+    for generation, data in db.execute(query, (trace_id,)):
+        if data is None:
+            raise ValueError(f'Missing compact genealogy (generation {generation})')
+        generations.append(decode_genealogy(data))
+    return generations
+
+# the lineage chain as a list of (generation, rank, genetic_operator),
+# following the first parent of each genotype
+def lineage(generations, generation, rank):
+    chain = []
+    while True:
+        genetic_operator, parents = generations[generation][rank]
+        chain.append((generation, rank, genetic_operator))
+        if generation == 0 or not parents:
+            return chain
+        rank = parents[0]
+        generation -= 1
+
+#------------------------------------------------------------------------------
+# lineage graph
+#------------------------------------------------------------------------------
+
+if __name__ == '__main__':
+    arg_parser = argparse.ArgumentParser(
+        description = 'Darwin genealogy graph', allow_abbrev = False)
+
+    arg_parser.add_argument('-u', '--universe', required = True,
+        help = 'Darwin universe database')
+    arg_parser.add_argument('-t', '--traceid', required = True, type = int,
+        help = 'Evolution Trace ID')
+    arg_parser.add_argument('-g', '--generation', type = int,
+        help = 'Generation (defaults to the last generation)')
+    arg_parser.add_argument('-r', '--rank', type = int, default = 0,
+        help = 'Genotype rank (defaults to the champion)')
+    arg_parser.add_argument('-d', '--depth', type = int, default = 10,
+        help = 'Max number of ancestor generations')
+
+    args = arg_parser.parse_args()
+
+    db = sqlite3.connect(args.universe)
+    generations = load_genealogy(db, args.traceid)
+    if not generations:
+        raise SystemExit('No genealogy information')
+
+    generation = args.generation if args.generation is not None else len(generations) - 1
+
+    graph = '''
+digraph genealogy {
+  rankdir=BT;
+  node [shape=circle, color=gray, fontsize=10];
+  edge [color=black];
+'''
+
+    # breadth-first traversal of the ancestors
+    current = {args.rank}
+    for _ in range(args.depth):
+        if generation == 0:
+            break
+        parents = set()
+        for rank in sorted(current):
+            genetic_operator, ranks = generations[generation][rank]
+            for index, parent in enumerate(ranks):
+                style = '' if index == 0 else ' [style=dashed, color=gray]'
+                graph += f'  G{generation - 1}_{parent} -> G{generation}_{rank}{style}\n'
+                parents.add(parent)
+            graph += f'  G{generation}_{rank} [label="g{generation}|r{rank}|{genetic_operator}", shape=Mrecord]\n'
+        current = parents
+        generation -= 1
+
+    for rank in sorted(current):
+        graph += f'  G{generation}_{rank} [label="g{generation}|r{rank}", shape=Mrecord]\n'
+
+    graph += '}\n'
+
+    print(graph)
@@ -0,0 +1,161 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/context.h>
+#include <core/parallel_for_each.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+using namespace std;
+
+namespace context_tests {
+
+static int g_fallback_value = -1;
+static core::ContextSlot<int> g_slot(&g_fallback_value);
+static core::ContextSlot<int> g_other_slot;
+
+TEST(ContextTest, BindAndUnbind) {
+  EXPECT_EQ(*g_slot, -1);
+  EXPECT_EQ(g_other_slot.get(), nullptr);
+
+  int value = 1;
+  g_slot.bind(&value);
+  EXPECT_EQ(*g_slot, 1);
+  EXPECT_EQ(g_other_slot.get(), nullptr);
+
+  // unbinding a different value is a no-op
+  int other_value = 2;
+  g_slot.unbind(&other_value);
+  EXPECT_EQ(*g_slot, 1);
+
+  g_slot.unbind(&value);
+  EXPECT_EQ(*g_slot, -1);
+}
+
+TEST(ContextTest, DefaultValue) {
+  int value = 1;
+  g_slot.setDefault(&value);
+
+  // the default value is visible on threads without their own bindings
+  int seen_value = 0;
+  thread([&] { seen_value = *g_slot; }).join();
+  EXPECT_EQ(seen_value, 1);
+
+  // a thread binding overrides the default value
+  int thread_value = 2;
+  thread([&] {
+    g_slot.bind(&thread_value);
+    seen_value = *g_slot;
+    g_slot.unbind(&thread_value);
+  }).join();
+  EXPECT_EQ(seen_value, 2);
+
+  g_slot.unbind(&value);
+  EXPECT_EQ(*g_slot, -1);
+}
+
+TEST(ContextTest, ContextScope) {
+  int value = 1;
+  g_slot.bind(&value);
+
+  int scope_value = 2;
+  int other_scope_value = 3;
+  core::Context context;
+  context.set(g_slot, &scope_value);
+  context.set(g_other_slot, &other_scope_value);
+
+  {
+    core::ContextScope scope(context);
+    EXPECT_EQ(*g_slot, 2);
+    EXPECT_EQ(*g_other_slot, 3);
+
+    // nested scopes
+    {
+      core::ContextScope nested_scope(core::Context{});
+      EXPECT_EQ(*g_slot, 1);
+      EXPECT_EQ(g_other_slot.get(), nullptr);
+    }
+
+    EXPECT_EQ(*g_slot, 2);
+    EXPECT_EQ(*g_other_slot, 3);
+  }
+
+  EXPECT_EQ(*g_slot, 1);
+  EXPECT_EQ(g_other_slot.get(), nullptr);
+
+  g_slot.unbind(&value);
+}
+
+TEST(ContextTest, IsolatedContextScope) {
+  int value = 1;
+  g_slot.bind(&value);
+
+  int isolated_value = 2;
+  {
+    core::IsolatedContextScope scope;
+    EXPECT_EQ(*g_slot, 1);
+
+    // the bindings made inside the scope don't leak out of it
+    g_slot.bind(&isolated_value);
+    g_other_slot.bind(&isolated_value);
+    EXPECT_EQ(*g_slot, 2);
+  }
+
+  EXPECT_EQ(*g_slot, 1);
+  EXPECT_EQ(g_other_slot.get(), nullptr);
+
+  int seen_value = 0;
+  thread([&] { seen_value = *g_slot; }).join();
+  EXPECT_EQ(seen_value, 1);
+
+  // unbinding the isolated value doesn't clear the restored default
+  g_slot.unbind(&isolated_value);
+  EXPECT_EQ(*g_slot, 1);
+
+  g_slot.unbind(&value);
+}
+
+TEST(ContextTest, ParallelForPropagation) {
+  constexpr int kValuesCount = 2;
+  int values[kValuesCount] = { 10, 20 };
+
+  // two "experiments" sharing the thread pool, each with its own context
+  vector<core::Context> contexts(kValuesCount);
+  for (int i = 0; i < kValuesCount; ++i) {
+    contexts[i].set(g_slot, &values[i]);
+  }
+
+  vector<thread> threads;
+  vector<vector<int>> results(kValuesCount, vector<int>(1000));
+  for (int i = 0; i < kValuesCount; ++i) {
+    threads.emplace_back([&, i] {
+      core::ContextScope scope(contexts[i]);
+      pp::for_each(results[i], [](int, int& result) { result = *g_slot; });
+    });
+  }
+
+  for (auto& t : threads) {
+    t.join();
+  }
+
+  for (int i = 0; i < kValuesCount; ++i) {
+    for (int result : results[i]) {
+      EXPECT_EQ(result, values[i]);
+    }
+  }
+}
+
+}  // namespace context_tests
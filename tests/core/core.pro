@@ -7,12 +7,22 @@ SOURCES += \
     io_utils_tests.cpp \
     properties_tests.cpp \
     format_tests.cpp \
+    genealogy_tests.cpp \
     compressed_fitness_tests.cpp \
+    context_tests.cpp \
+    evaluation_seed_tests.cpp \
     parallel_for_tests.cpp \
+    perf_counters_tests.cpp \
     properties_variant_tests.cpp \
+    multi_fidelity_tests.cpp \
+    racing_tests.cpp \
     misc_tests.cpp \
     selection_algorithms_tests.cpp \
+    sim/camera_tests.cpp \
+    sim/cart_pole_batch_tests.cpp \
     sim/track_tests.cpp \
-    tournament_tests.cpp
+    sim/world_pool_tests.cpp \
+    tournament_tests.cpp \
+    tracing_tests.cpp
     
 include(../tests_common.pri)
@@ -228,4 +228,28 @@ TEST_F(DatabaseTest, Pragmas) {
   }
 }
 
+TEST_F(DatabaseTest, Blobs) {
+  db->exec("create table blobs(id integer primary key, data blob)");
+
+  const db::Blob small_blob = { 0, 1, 2, 0xff, 0 };
+  db::Blob large_blob(100000);
+  for (size_t i = 0; i < large_blob.size(); ++i)
+    large_blob[i] = uint8_t(i * 31);
+
+  db->exec("insert into blobs(id, data) values(?, ?)", 1, small_blob);
+  db->exec("insert into blobs(id, data) values(?, ?)", 2, large_blob);
+  db->exec("insert into blobs(id, data) values(?, ?)", 3, db::Blob());
+  db->exec("insert into blobs(id, data) values(?, ?)", 4, nullopt);
+
+  auto results = db->exec<int, db::Blob>("select id, data from blobs order by id");
+  ASSERT_EQ(results.size(), 4);
+  EXPECT_EQ(get<1>(results[0]), small_blob);
+  EXPECT_EQ(get<1>(results[1]), large_blob);
+  EXPECT_EQ(get<1>(results[2]), db::Blob());
+  EXPECT_FALSE(get<1>(results[3]).has_value());
+
+  // blob values can't be extracted as other types
+  EXPECT_THROW(db->exec<string>("select data from blobs where id = 1"), core::Exception);
+}
+
 }  // namespace database_tests
@@ -0,0 +1,65 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/darwin.h>
+#include <core/parallel_for_each.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+namespace evaluation_seed_tests {
+
+TEST(EvaluationSeedTest, RandomSeeds) {
+  // without an explicit seed, every call returns a new random seed
+  EXPECT_NE(darwin::evaluationSeed(0), darwin::evaluationSeed(0));
+}
+
+TEST(EvaluationSeedTest, SeedScope) {
+  uint64_t first_seeds[2] = {};
+  {
+    darwin::EvaluationSeedScope seed_scope(42);
+    first_seeds[0] = darwin::evaluationSeed(0);
+    first_seeds[1] = darwin::evaluationSeed(1);
+    EXPECT_EQ(darwin::evaluationSeed(0), first_seeds[0]);
+    EXPECT_NE(first_seeds[0], first_seeds[1]);
+
+    // nested scopes
+    {
+      darwin::EvaluationSeedScope nested_seed_scope(43);
+      EXPECT_NE(darwin::evaluationSeed(0), first_seeds[0]);
+    }
+    EXPECT_EQ(darwin::evaluationSeed(0), first_seeds[0]);
+  }
+
+  // the same seed reproduces the same environments
+  darwin::EvaluationSeedScope seed_scope(42);
+  EXPECT_EQ(darwin::evaluationSeed(0), first_seeds[0]);
+  EXPECT_EQ(darwin::evaluationSeed(1), first_seeds[1]);
+}
+
+TEST(EvaluationSeedTest, ParallelForPropagation) {
+  darwin::EvaluationSeedScope seed_scope(7);
+  const uint64_t expected_seed = darwin::evaluationSeed(5);
+
+  vector<uint64_t> seeds(1000);
+  pp::for_each(seeds, [](int, uint64_t& seed) { seed = darwin::evaluationSeed(5); });
+  for (const auto seed : seeds) {
+    EXPECT_EQ(seed, expected_seed);
+  }
+}
+
+}  // namespace evaluation_seed_tests
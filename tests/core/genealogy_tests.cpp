@@ -0,0 +1,278 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/utils.h>
+#include <core/darwin.h>
+#include <core/database.h>
+#include <core/exception.h>
+#include <core/genealogy.h>
+#include <core/universe.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace genealogy_tests {
+
+struct TestGenotype : public darwin::Genotype {
+  unique_ptr<darwin::Brain> grow() const override { FATAL("Not implemented"); }
+  unique_ptr<darwin::Genotype> clone() const override { FATAL("Not implemented"); }
+  json save() const override { FATAL("Not implemented"); }
+  void load(const json&) override { FATAL("Not implemented"); }
+};
+
+// the genotypes are stored in reverse ranking order, which makes sure that
+// the compact encoding is not accidentally using the genotype indexes
+struct TestPopulation : public darwin::Population {
+  vector<TestGenotype> genotypes;
+  int current_generation = 0;
+
+  explicit TestPopulation(size_t size) : genotypes(size) {
+    for (size_t i = 0; i < size; ++i)
+      genotypes[i].fitness = float(i);
+  }
+
+  size_t size() const override { return genotypes.size(); }
+
+  darwin::Genotype* genotype(size_t i) override { return &genotypes[i]; }
+  const darwin::Genotype* genotype(size_t i) const override { return &genotypes[i]; }
+
+  int generation() const override { return current_generation; }
+
+  vector<size_t> rankingIndex() const override {
+    vector<size_t> ranking_index(genotypes.size());
+    for (size_t i = 0; i < ranking_index.size(); ++i)
+      ranking_index[i] = genotypes.size() - i - 1;
+    return ranking_index;
+  }
+
+  darwin::Genotype* rankedGenotype(size_t rank) {
+    return genotype(rankingIndex()[rank]);
+  }
+
+  void createPrimordialGeneration(int) override { FATAL("Not implemented"); }
+  void createNextGeneration() override { FATAL("Not implemented"); }
+};
+
+TEST(CompactGenealogyTest, EmptyGenealogy) {
+  TestPopulation population(10);
+
+  const auto data = darwin::CompactGenealogy::encode(&population);
+  const auto genealogy = darwin::CompactGenealogy::decode(data);
+
+  ASSERT_EQ(genealogy.size(), 10);
+  EXPECT_TRUE(genealogy.operators().empty());
+  for (int rank = 0; rank < genealogy.size(); ++rank) {
+    EXPECT_EQ(genealogy.operatorCode(rank), darwin::GenerationGenealogy::kNoOperator);
+    EXPECT_EQ(genealogy.parentsCount(rank), 0);
+    EXPECT_TRUE(genealogy.geneticOperator(rank).empty());
+  }
+}
+
+TEST(CompactGenealogyTest, RoundTrip) {
+  constexpr int kPopulationSize = 5000;
+  const string kOperators[] = { "r", "c", "em", "e", "i" };
+
+  TestPopulation population(kPopulationSize);
+
+  default_random_engine rnd;
+  uniform_int_distribution<int> dist_operator(0, 5);
+  uniform_int_distribution<int> dist_parent(0, kPopulationSize - 1);
+
+  for (auto& genotype : population.genotypes) {
+    const int op = dist_operator(rnd);
+    if (op == 5)
+      continue;
+    genotype.genealogy.genetic_operator = kOperators[op];
+    const int parents_count = (op == 1 || op == 4) ? 2 : 1;
+    for (int i = 0; i < parents_count; ++i)
+      genotype.genealogy.parents.push_back(dist_parent(rnd));
+  }
+
+  const auto data = darwin::CompactGenealogy::encode(&population);
+  const auto genealogy = darwin::CompactGenealogy::decode(data);
+
+  ASSERT_EQ(genealogy.size(), kPopulationSize);
+  EXPECT_EQ(genealogy.operators().size(), 5);
+
+  for (int rank = 0; rank < kPopulationSize; ++rank) {
+    const auto& expected = population.rankedGenotype(rank)->genealogy;
+    const auto actual = genealogy.entry(rank);
+    EXPECT_EQ(actual.genetic_operator, expected.genetic_operator);
+    EXPECT_EQ(actual.parents, expected.parents);
+  }
+
+  // the compact encoding should be significantly smaller than the JSON format
+  json json_genealogy;
+  for (const auto& genotype : population.genotypes) {
+    json json_genealogy_entry;
+    const auto& entry = genotype.genealogy;
+    if (!entry.genetic_operator.empty())
+      json_genealogy_entry[entry.genetic_operator] = entry.parents;
+    json_genealogy.push_back(json_genealogy_entry);
+  }
+  EXPECT_LT(data.size() * 2, json_genealogy.dump().size());
+}
+
+TEST(CompactGenealogyTest, MalformedData) {
+  TestPopulation population(100);
+  for (auto& genotype : population.genotypes)
+    genotype.genealogy = darwin::Genealogy("c", { 1, 2 });
+
+  auto data = darwin::CompactGenealogy::encode(&population);
+  EXPECT_NO_THROW(darwin::CompactGenealogy::decode(data));
+
+  // truncated data
+  auto truncated_data = data;
+  truncated_data.pop_back();
+  EXPECT_THROW(darwin::CompactGenealogy::decode(truncated_data), core::Exception);
+
+  // trailing data
+  auto extra_data = data;
+  extra_data.push_back(0);
+  EXPECT_THROW(darwin::CompactGenealogy::decode(extra_data), core::Exception);
+
+  // unknown format version
+  auto bad_version = data;
+  bad_version[0] = 0x7f;
+  EXPECT_THROW(darwin::CompactGenealogy::decode(bad_version), core::Exception);
+
+  EXPECT_THROW(darwin::CompactGenealogy::decode({}), core::Exception);
+}
+
+struct GenealogyReaderTest : public testing::Test {
+  GenealogyReaderTest() {
+    const auto test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    path = string(TEST_TEMP_PATH) + "/" + test_info->test_case_name() + "_" +
+           test_info->name() + ".darwin";
+    fs::remove(path);
+    universe = darwin::Universe::create(path);
+  }
+
+  ~GenealogyReaderTest() {
+    universe.reset();
+    fs::remove(path);
+  }
+
+  unique_ptr<darwin::Universe> universe;
+  string path;
+};
+
+TEST_F(GenealogyReaderTest, Lineage) {
+  constexpr int kPopulationSize = 8;
+  constexpr int kGenerations = 5;
+
+  auto db_experiment = universe->newExperiment(nullopt, "{}", nullopt);
+  auto db_variation = universe->newVariation(db_experiment->id, "{}");
+  auto db_trace = universe->newTrace(db_variation->id, "{}");
+
+  // each genotype at rank i is a replica of the rank (i + 1) from the previous
+  // generation, with an extra crossover parent at rank 0
+  for (int generation = 0; generation < kGenerations; ++generation) {
+    TestPopulation population(kPopulationSize);
+    population.current_generation = generation;
+    if (generation > 0) {
+      for (int rank = 0; rank < kPopulationSize; ++rank) {
+        population.rankedGenotype(rank)->genealogy =
+            darwin::Genealogy("c", { (rank + 1) % kPopulationSize, 0 });
+      }
+    }
+
+    darwin::DbGeneration db_generation;
+    db_generation.trace_id = db_trace->id;
+    db_generation.generation = generation;
+    db_generation.summary = "{}";
+    db_generation.genealogy = darwin::CompactGenealogy::encode(&population);
+    universe->newGeneration(db_generation);
+  }
+
+  darwin::GenealogyReader reader(universe.get(), db_trace->id);
+  ASSERT_EQ(reader.generations(), kGenerations);
+
+  const auto lineage = reader.lineage(kGenerations - 1, 2);
+  ASSERT_EQ(lineage.size(), kGenerations);
+  for (int i = 0; i < kGenerations; ++i) {
+    EXPECT_EQ(lineage[i].generation, kGenerations - 1 - i);
+    EXPECT_EQ(lineage[i].rank, 2 + i);
+    EXPECT_EQ(lineage[i].genetic_operator, i == kGenerations - 1 ? "" : "c");
+  }
+
+  const auto ancestors = reader.ancestors(kGenerations - 1, 2, 2);
+  ASSERT_EQ(ancestors.size(), 2);
+  EXPECT_EQ(ancestors[0], vector<int>({ 0, 3 }));
+  EXPECT_EQ(ancestors[1], vector<int>({ 0, 1, 4 }));
+
+  EXPECT_THROW(reader.lineage(kGenerations, 0), core::Exception);
+  EXPECT_THROW(reader.lineage(0, kPopulationSize), core::Exception);
+}
+
+TEST_F(GenealogyReaderTest, MissingGenealogy) {
+  auto db_experiment = universe->newExperiment(nullopt, "{}", nullopt);
+  auto db_variation = universe->newVariation(db_experiment->id, "{}");
+  auto db_trace = universe->newTrace(db_variation->id, "{}");
+
+  darwin::DbGeneration db_generation;
+  db_generation.trace_id = db_trace->id;
+  db_generation.generation = 0;
+  db_generation.summary = "{}";
+  universe->newGeneration(db_generation);
+
+  EXPECT_THROW(darwin::GenealogyReader(universe.get(), db_trace->id), core::Exception);
+}
+
+TEST_F(GenealogyReaderTest, FormatUpgradedOnlyWhenWriting) {
+  const auto formatVersion = [&] {
+    db::Connection db(path, db::OpenMode::ExistingDatabase);
+    return db.exec<int>("pragma user_version").singleValue().value();
+  };
+
+  auto db_experiment = universe->newExperiment(nullopt, "{}", nullopt);
+  auto db_variation = universe->newVariation(db_experiment->id, "{}");
+  auto db_trace = universe->newTrace(db_variation->id, "{}");
+
+  darwin::DbGeneration db_generation;
+  db_generation.trace_id = db_trace->id;
+  db_generation.generation = 0;
+  db_generation.summary = "{}";
+  universe->newGeneration(db_generation);
+
+  // reopening the universe doesn't upgrade it
+  universe.reset();
+  universe = darwin::Universe::open(path);
+  EXPECT_EQ(formatVersion(), 1);
+  EXPECT_EQ(universe->loadGenealogy(db_trace->id).size(), 1);
+
+  // writing a compact genealogy does
+  TestPopulation population(4);
+  population.current_generation = 1;
+  db_generation.generation = 1;
+  db_generation.genealogy = darwin::CompactGenealogy::encode(&population);
+  universe->newGeneration(db_generation);
+  EXPECT_EQ(formatVersion(), 2);
+
+  const auto genealogy = universe->loadGenealogy(db_trace->id);
+  ASSERT_EQ(genealogy.size(), 2);
+  EXPECT_FALSE(genealogy[0]);
+  EXPECT_TRUE(genealogy[1]);
+}
+
+}  // namespace genealogy_tests
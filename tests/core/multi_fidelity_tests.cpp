@@ -0,0 +1,263 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/darwin.h>
+#include <core/exception.h>
+#include <core/multi_fidelity.h>
+#include <third_party/gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+using namespace std;
+
+namespace multi_fidelity_tests {
+
+class TestGenotype : public darwin::Genotype {
+ public:
+  float value = 0;
+
+ private:
+  unique_ptr<darwin::Brain> grow() const override { FATAL("Not implemented"); }
+
+  unique_ptr<darwin::Genotype> clone() const override { FATAL("Not implemented"); }
+
+  json save() const override { FATAL("Not implemented"); }
+
+  void load(const json&) override { FATAL("Not implemented"); }
+};
+
+class TestPopulation : public darwin::Population {
+ public:
+  explicit TestPopulation(size_t size) : genotypes_(size) {
+    vector<float> values(size);
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = float(i);
+    }
+    std::shuffle(values.begin(), values.end(), std::default_random_engine(1));
+    for (size_t i = 0; i < size; ++i) {
+      genotypes_[i].value = values[i];
+    }
+  }
+
+  size_t size() const override { return genotypes_.size(); }
+
+  darwin::Genotype* genotype(size_t index) override { return &genotypes_[index]; }
+
+  const darwin::Genotype* genotype(size_t index) const override {
+    return &genotypes_[index];
+  }
+
+  float value(size_t index) const { return genotypes_[index].value; }
+
+  vector<size_t> rankingIndex() const override { FATAL("Not implemented"); }
+  int generation() const override { return 0; }
+  void createPrimordialGeneration(int) override { FATAL("Not implemented"); }
+  void createNextGeneration() override { FATAL("Not implemented"); }
+
+ private:
+  vector<TestGenotype> genotypes_;
+};
+
+// the fitness is a function of the genotype's value
+class TestDomain : public darwin::Domain {
+ public:
+  explicit TestDomain(function<float(float)> fitness) : fitness_(std::move(fitness)) {}
+
+  size_t inputs() const override { return 1; }
+  size_t outputs() const override { return 1; }
+
+  bool evaluatePopulation(darwin::Population* population) const override {
+    seeds_.push_back(darwin::evaluationSeed(0));
+    for (size_t i = 0; i < population->size(); ++i) {
+      auto genotype = population->genotype(i);
+      genotype->fitness = fitness_(dynamic_cast<TestGenotype*>(genotype)->value);
+      ++evaluations_;
+    }
+    return false;
+  }
+
+  bool independentEvaluation() const override { return true; }
+
+  int evaluations() const { return evaluations_; }
+
+  // the test world seed observed by each evaluatePopulation() call
+  const vector<uint64_t>& seeds() const { return seeds_; }
+
+ private:
+  function<float(float)> fitness_;
+  mutable int evaluations_ = 0;
+  mutable vector<uint64_t> seeds_;
+};
+
+TEST(MultiFidelityTest, Correlated) {
+  constexpr size_t kPopulationSize = 100;
+
+  TestPopulation population(kPopulationSize);
+  TestDomain domain([](float value) { return value; });
+  auto low_fidelity_domain =
+      make_unique<TestDomain>([](float value) { return value / 10 + 1000; });
+
+  darwin::MultiFidelityConfig config;
+  config.calibration_samples = 20;
+  config.promote_fraction = 0.3f;
+
+  darwin::MultiFidelityEvaluation evaluation(
+      &domain, std::move(low_fidelity_domain), config);
+  EXPECT_FALSE(evaluation.evaluatePopulation(&population));
+
+  EXPECT_DOUBLE_EQ(evaluation.correlation(), 1.0);
+  EXPECT_FALSE(evaluation.fallback());
+  EXPECT_LT(evaluation.fullEvaluations(), kPopulationSize);
+  EXPECT_EQ(domain.evaluations(), int(evaluation.fullEvaluations()));
+
+  // the top genotypes get their full fidelity fitness
+  for (size_t i = 0; i < kPopulationSize; ++i) {
+    if (population.value(i) >= kPopulationSize * 0.75f) {
+      EXPECT_EQ(population[i]->fitness, population.value(i));
+    }
+  }
+
+  // the ranking is preserved (the fit is exact for a linear correlation)
+  for (size_t i = 0; i < kPopulationSize; ++i) {
+    EXPECT_NEAR(population[i]->fitness, population.value(i), 1e-2);
+  }
+}
+
+TEST(MultiFidelityTest, ScreenedGenotypesRankBelowPromoted) {
+  constexpr size_t kPopulationSize = 60;
+
+  TestPopulation population(kPopulationSize);
+
+  // the low fidelity is optimistic for the weak genotypes
+  TestDomain domain([](float value) { return value * value; });
+  auto low_fidelity_domain = make_unique<TestDomain>([](float value) { return value; });
+
+  darwin::MultiFidelityConfig config;
+  config.calibration_samples = 10;
+  config.promote_fraction = 0.5f;
+
+  darwin::MultiFidelityEvaluation evaluation(
+      &domain, std::move(low_fidelity_domain), config);
+  evaluation.evaluatePopulation(&population);
+  EXPECT_FALSE(evaluation.fallback());
+
+  // the promoted genotypes are the ones above the learned threshold
+  float min_promoted = 1e10f;
+  float max_screened = -1e10f;
+  for (size_t i = 0; i < kPopulationSize; ++i) {
+    const float value = population.value(i);
+    const float fitness = population[i]->fitness;
+    if (fitness == value * value && value >= kPopulationSize / 2) {
+      min_promoted = min(min_promoted, fitness);
+    } else if (fitness != value * value) {
+      max_screened = max(max_screened, fitness);
+    }
+  }
+  EXPECT_LE(max_screened, min_promoted);
+}
+
+TEST(MultiFidelityTest, Fallback) {
+  constexpr size_t kPopulationSize = 50;
+
+  TestPopulation population(kPopulationSize);
+  TestDomain domain([](float value) { return value; });
+  auto low_fidelity_domain = make_unique<TestDomain>([](float value) { return -value; });
+
+  darwin::MultiFidelityConfig config;
+  darwin::MultiFidelityEvaluation evaluation(
+      &domain, std::move(low_fidelity_domain), config);
+  evaluation.evaluatePopulation(&population);
+
+  // the fidelities are anti-correlated, so every genotype gets a full evaluation
+  EXPECT_DOUBLE_EQ(evaluation.correlation(), -1.0);
+  EXPECT_TRUE(evaluation.fallback());
+  EXPECT_EQ(evaluation.fullEvaluations(), kPopulationSize);
+  for (size_t i = 0; i < kPopulationSize; ++i) {
+    EXPECT_EQ(population[i]->fitness, population.value(i));
+  }
+}
+
+TEST(MultiFidelityTest, SmallPopulation) {
+  constexpr size_t kPopulationSize = 5;
+
+  TestPopulation population(kPopulationSize);
+  TestDomain domain([](float value) { return value; });
+  auto low_fidelity_domain = make_unique<TestDomain>([](float value) { return value; });
+
+  // the whole population is used for calibration
+  darwin::MultiFidelityConfig config;
+  darwin::MultiFidelityEvaluation evaluation(
+      &domain, std::move(low_fidelity_domain), config);
+  evaluation.evaluatePopulation(&population);
+
+  EXPECT_EQ(evaluation.fullEvaluations(), kPopulationSize);
+  for (size_t i = 0; i < kPopulationSize; ++i) {
+    EXPECT_EQ(population[i]->fitness, population.value(i));
+  }
+}
+
+TEST(MultiFidelityTest, SameTestWorlds) {
+  constexpr size_t kPopulationSize = 50;
+
+  TestPopulation population(kPopulationSize);
+  TestDomain domain([](float value) { return value * value; });
+  auto low_fidelity_domain = make_unique<TestDomain>([](float value) { return value; });
+  const auto low_fidelity_seeds = &low_fidelity_domain->seeds();
+
+  darwin::MultiFidelityConfig config;
+  config.calibration_samples = 10;
+  darwin::MultiFidelityEvaluation evaluation(
+      &domain, std::move(low_fidelity_domain), config);
+  evaluation.evaluatePopulation(&population);
+
+  // the low fidelity, calibration and promoted evaluations share the test worlds
+  ASSERT_EQ(low_fidelity_seeds->size(), 1);
+  ASSERT_EQ(domain.seeds().size(), 2);
+  EXPECT_EQ(domain.seeds()[0], low_fidelity_seeds->front());
+  EXPECT_EQ(domain.seeds()[1], low_fidelity_seeds->front());
+
+  // ... but every evaluatePopulation() call samples new test worlds
+  evaluation.evaluatePopulation(&population);
+  ASSERT_EQ(low_fidelity_seeds->size(), 2);
+  EXPECT_NE(low_fidelity_seeds->at(1), low_fidelity_seeds->front());
+}
+
+TEST(MultiFidelityTest, InvalidConfiguration) {
+  TestDomain domain([](float value) { return value; });
+  const auto lowFidelityDomain = [] {
+    return make_unique<TestDomain>([](float value) { return value; });
+  };
+
+  darwin::MultiFidelityConfig config;
+  config.low_fidelity = 0;
+  EXPECT_THROW(darwin::MultiFidelityEvaluation(&domain, lowFidelityDomain(), config),
+               core::Exception);
+
+  config.low_fidelity = 0.5f;
+  config.calibration_samples = 2;
+  EXPECT_THROW(darwin::MultiFidelityEvaluation(&domain, lowFidelityDomain(), config),
+               core::Exception);
+
+  config.calibration_samples = 10;
+  config.promote_fraction = 1.5f;
+  EXPECT_THROW(darwin::MultiFidelityEvaluation(&domain, lowFidelityDomain(), config),
+               core::Exception);
+}
+
+}  // namespace multi_fidelity_tests
@@ -14,10 +14,16 @@
 
 #include <core/utils.h>
 #include <core/parallel_for_each.h>
+#include <core/platform_abstraction_layer.h>
 
 #include <third_party/gtest/gtest.h>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <set>
+#include <thread>
 #include <vector>
 using namespace std;
 
@@ -75,4 +81,121 @@ TEST(ParallelForTest, LargeArrays) {
   parallelForLoop(1000000);
 }
 
+// independent parallel-for-loops, started from different threads
+TEST(ParallelForTest, ConcurrentLoops) {
+  constexpr int kThreads = 4;
+  vector<thread> threads;
+  for (int i = 0; i < kThreads; ++i) {
+    threads.emplace_back([] {
+      for (int array_size = 0; array_size < 2000; array_size += 97) {
+        parallelForLoop(array_size);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(ParallelForTest, NumaNodes) {
+  const auto nodes = pal::numaNodes();
+  ASSERT_FALSE(nodes.empty());
+  for (const auto& node_cpus : nodes) {
+    EXPECT_FALSE(node_cpus.empty());
+    for (int cpu : node_cpus)
+      EXPECT_GE(cpu, 0);
+  }
+}
+
+// standalone thread pools, with explicit worker threads placement
+TEST(ParallelForTest, ThreadAffinity) {
+  for (auto affinity : { pp::ThreadAffinity::None,
+                         pp::ThreadAffinity::Cores,
+                         pp::ThreadAffinity::NumaNodes }) {
+    for (int threads_count : { 1, 3, 8 }) {
+      pp::ThreadPool thread_pool(threads_count, nullptr, affinity);
+      EXPECT_EQ(thread_pool.threadsCount(), threads_count);
+      EXPECT_EQ(thread_pool.affinity(), affinity);
+
+      for (int shards_count = 1; shards_count < 300; shards_count += 37) {
+        vector<atomic<int>> shards(shards_count);
+        auto shard_body = [&](int shard) { ++shards[shard]; };
+        pp::WorkBatch batch(shards_count, shard_body);
+        thread_pool.processBatch(&batch);
+
+        // each shard must be executed exactly once
+        for (const auto& shard : shards)
+          EXPECT_EQ(shard, 1);
+      }
+    }
+  }
+}
+
+// a controller which pauses the work until resume() is called
+class PausingController : public pp::Controller {
+ public:
+  void checkpoint() override {
+    unique_lock<mutex> guard(lock_);
+    resumed_cv_.wait(guard, [&] { return !paused_; });
+  }
+
+  bool tryCheckpoint() override {
+    unique_lock<mutex> guard(lock_);
+    return !paused_;
+  }
+
+  void resume() {
+    unique_lock<mutex> guard(lock_);
+    paused_ = false;
+    resumed_cv_.notify_all();
+  }
+
+ private:
+  bool paused_ = true;
+  mutex lock_;
+  condition_variable resumed_cv_;
+};
+
+// a paused batch must not hold any of the shared worker threads
+TEST(ParallelForTest, PausedBatch) {
+  constexpr int kShardsCount = 50;
+
+  pp::ThreadPool thread_pool(2);
+  PausingController pausing_controller;
+
+  atomic<int> paused_work = 0;
+  thread paused_thread([&] {
+    auto context = core::Context::current();
+    context.set(pp::g_controller, static_cast<pp::Controller*>(&pausing_controller));
+    core::ContextScope context_scope(context);
+    auto shard_body = [&](int) { ++paused_work; };
+    pp::WorkBatch batch(kShardsCount, shard_body);
+    thread_pool.processBatch(&batch);
+  });
+
+  // the other batches still get the worker threads
+  mutex lock;
+  set<thread::id> threads;
+  for (int i = 0; i < 10; ++i) {
+    vector<atomic<int>> shards(kShardsCount);
+    auto shard_body = [&](int shard) {
+      this_thread::sleep_for(chrono::milliseconds(1));
+      ++shards[shard];
+      unique_lock<mutex> guard(lock);
+      threads.insert(this_thread::get_id());
+    };
+    pp::WorkBatch batch(kShardsCount, shard_body);
+    thread_pool.processBatch(&batch);
+    for (const auto& shard : shards)
+      EXPECT_EQ(shard, 1);
+  }
+  EXPECT_GT(threads.size(), 1);
+  EXPECT_EQ(paused_work, 0);
+
+  // resuming the paused batch
+  pausing_controller.resume();
+  paused_thread.join();
+  EXPECT_EQ(paused_work, kShardsCount);
+}
+
 }  // namespace parallel_for_tests
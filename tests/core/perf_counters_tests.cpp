@@ -0,0 +1,77 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/utils.h>
+#include <core/perf_counters.h>
+#include <core/scope_guard.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <stdio.h>
+using namespace std;
+
+namespace perf_counters_tests {
+
+TEST(PerfCountersTest, Values) {
+  core::PerfCountersValues a;
+  a.cycles = 100;
+  a.instructions = 200;
+  a.cache_misses = 3;
+  a.branch_misses = 4;
+
+  core::PerfCountersValues b = a;
+  b += a;
+  EXPECT_EQ(b.cycles, 200);
+  EXPECT_EQ(b.instructions, 400);
+  EXPECT_EQ(b.cache_misses, 6);
+  EXPECT_EQ(b.branch_misses, 8);
+
+  const auto delta = b - a;
+  EXPECT_EQ(delta.cycles, 100);
+  EXPECT_EQ(delta.branch_misses, 4);
+
+  // deltas are clamped to zero
+  const auto negative_delta = a - b;
+  EXPECT_EQ(negative_delta.cycles, 0);
+  EXPECT_EQ(negative_delta.instructions, 0);
+
+  json json_values = a;
+  EXPECT_EQ(json_values["instructions"], 200);
+}
+
+TEST(PerfCountersTest, CurrentThread) {
+  core::PerfCounters::registerThread();
+
+  if (!core::PerfCounters::enable()) {
+    // the hardware counters are not available in this environment
+    EXPECT_FALSE(core::PerfCounters::enabled());
+    EXPECT_EQ(core::PerfCounters::read().cycles, 0);
+    return;
+  }
+
+  SCOPE_EXIT { core::PerfCounters::disable(); };
+  EXPECT_TRUE(core::PerfCounters::enabled());
+
+  const auto start = core::PerfCounters::read();
+
+  volatile double sum = 0;
+  for (int i = 0; i < 1000000; ++i)
+    sum = sum + i * 0.5;
+
+  const auto delta = core::PerfCounters::read() - start;
+  EXPECT_GT(delta.cycles, 0);
+  EXPECT_GT(delta.instructions, 1000000);
+}
+
+}  // namespace perf_counters_tests
@@ -20,7 +20,9 @@
 #include <third_party/json/json.h>
 using json = nlohmann::json;
 
+#include <math.h>
 #include <stdio.h>
+#include <limits>
 #include <map>
 #include <sstream>
 #include <string>
@@ -218,6 +220,25 @@ TEST(PropertiesTest, SetValuesString) {
   }
 }
 
+TEST(PropertiesTest, FloatSpecialValues) {
+  TestProperties test;
+  auto resolution = test.properties()[1];
+  ASSERT_EQ(resolution->name(), "resolution");
+
+  test.resolution = numeric_limits<float>::infinity();
+  resolution->setValue(resolution->value());
+  EXPECT_EQ(test.resolution, numeric_limits<float>::infinity());
+
+  resolution->setValue(" -inf ");
+  EXPECT_EQ(test.resolution, -numeric_limits<float>::infinity());
+
+  resolution->setValue("nan");
+  EXPECT_TRUE(isnan(test.resolution));
+
+  EXPECT_THROW(resolution->setValue("inf inf"), core::Exception);
+  EXPECT_THROW(resolution->setValue("infinite"), core::Exception);
+}
+
 TEST(PropertiesTest, EmptyProperties) {
   core_test::TestCaseOutput output;
 
@@ -0,0 +1,193 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/darwin.h>
+#include <core/exception.h>
+#include <core/racing.h>
+#include <third_party/gtest/gtest.h>
+
+#include <functional>
+#include <vector>
+using namespace std;
+
+namespace racing_tests {
+
+class TestGenotype : public darwin::Genotype {
+  unique_ptr<darwin::Brain> grow() const override { FATAL("Not implemented"); }
+
+  unique_ptr<darwin::Genotype> clone() const override { FATAL("Not implemented"); }
+
+  json save() const override { FATAL("Not implemented"); }
+
+  void load(const json&) override { FATAL("Not implemented"); }
+};
+
+class TestPopulation : public darwin::Population {
+ public:
+  explicit TestPopulation(size_t size) : genotypes_(size) {
+    for (auto& genotype : genotypes_) {
+      genotype.fitness = -1;
+    }
+  }
+
+  size_t size() const override { return genotypes_.size(); }
+
+  darwin::Genotype* genotype(size_t index) override { return &genotypes_[index]; }
+
+  const darwin::Genotype* genotype(size_t index) const override {
+    return &genotypes_[index];
+  }
+
+  vector<size_t> rankingIndex() const override { FATAL("Not implemented"); }
+  int generation() const override { FATAL("Not implemented"); }
+  void createPrimordialGeneration(int) override { FATAL("Not implemented"); }
+  void createNextGeneration() override { FATAL("Not implemented"); }
+
+ private:
+  vector<TestGenotype> genotypes_;
+};
+
+// runs a complete race, returning the number of contenders for each test world
+vector<size_t> runRace(darwin::Population* population,
+                       int test_worlds,
+                       const darwin::RacingVariant& racing,
+                       const function<float(size_t, int)>& episode_fitness) {
+  vector<size_t> contenders_count;
+  darwin::RacingEvaluation race(population, test_worlds, racing);
+  for (int world_index = 0; world_index < test_worlds; ++world_index) {
+    contenders_count.push_back(race.contenders().size());
+    for (size_t genotype_index : race.contenders()) {
+      race.recordEpisode(genotype_index, episode_fitness(genotype_index, world_index));
+    }
+    race.finishWorld();
+  }
+  race.finish();
+  return contenders_count;
+}
+
+TEST(RacingTest, NoRacing) {
+  constexpr int kTestWorlds = 4;
+
+  TestPopulation population(10);
+  darwin::RacingVariant racing;
+  racing.selectCase(darwin::RacingType::None);
+
+  const auto contenders_count =
+      runRace(&population, kTestWorlds, racing, [](size_t index, int world_index) {
+        return float(index * 10 + world_index);
+      });
+
+  // every genotype is evaluated on every world, the fitness is the average
+  for (size_t count : contenders_count) {
+    EXPECT_EQ(count, population.size());
+  }
+  for (size_t i = 0; i < population.size(); ++i) {
+    EXPECT_FLOAT_EQ(population[i]->fitness, i * 10 + 1.5f);
+  }
+}
+
+TEST(RacingTest, SuccessiveHalving) {
+  constexpr int kTestWorlds = 4;
+
+  TestPopulation population(8);
+  darwin::RacingVariant racing;
+  racing.selectCase(darwin::RacingType::SuccessiveHalving);
+  racing.successive_halving.rung_worlds = 1;
+  racing.successive_halving.keep_fraction = 0.5f;
+
+  const auto contenders_count =
+      runRace(&population, kTestWorlds, racing, [](size_t index, int) {
+        return float(index);
+      });
+
+  EXPECT_EQ(contenders_count, vector<size_t>({ 8, 4, 2, 1 }));
+
+  // the winner gets its average episode fitness
+  EXPECT_FLOAT_EQ(population[7]->fitness, 7);
+
+  // the eliminated genotypes are ranked below the ones which advanced further,
+  // in the order of their partial results
+  for (size_t i = 1; i < population.size(); ++i) {
+    EXPECT_LT(population[i - 1]->fitness, population[i]->fitness);
+  }
+}
+
+TEST(RacingTest, EliminatedRankBelowSurvivors) {
+  constexpr int kTestWorlds = 6;
+
+  TestPopulation population(20);
+  darwin::RacingVariant racing;
+  racing.selectCase(darwin::RacingType::SuccessiveHalving);
+  racing.successive_halving.rung_worlds = 2;
+  racing.successive_halving.keep_fraction = 0.3f;
+
+  // the first rung favors the even genotypes, the next ones favor the lower indexes
+  const auto contenders_count =
+      runRace(&population, kTestWorlds, racing, [](size_t index, int world_index) {
+        if (world_index < 2)
+          return index % 2 == 0 ? 100.0f + index : -float(index);
+        return 50.0f - 10.0f * index;
+      });
+
+  EXPECT_EQ(contenders_count, vector<size_t>({ 20, 20, 6, 6, 2, 2 }));
+
+  float worst_survivor = 1e10f;
+  float best_eliminated = -1e10f;
+  for (size_t i = 0; i < population.size(); ++i) {
+    const float fitness = population[i]->fitness;
+    if (i == 8 || i == 10) {
+      worst_survivor = min(worst_survivor, fitness);
+    } else {
+      best_eliminated = max(best_eliminated, fitness);
+    }
+  }
+  EXPECT_GT(worst_survivor, best_eliminated);
+}
+
+TEST(RacingTest, KeepAll) {
+  constexpr int kTestWorlds = 3;
+
+  TestPopulation population(5);
+  darwin::RacingVariant racing;
+  racing.selectCase(darwin::RacingType::SuccessiveHalving);
+  racing.successive_halving.keep_fraction = 1.0f;
+
+  const auto contenders_count =
+      runRace(&population, kTestWorlds, racing, [](size_t index, int world_index) {
+        return float(world_index == 0 ? index : 0);
+      });
+
+  EXPECT_EQ(contenders_count, vector<size_t>({ 5, 5, 5 }));
+  for (size_t i = 0; i < population.size(); ++i) {
+    EXPECT_FLOAT_EQ(population[i]->fitness, i / 3.0f);
+  }
+}
+
+TEST(RacingTest, InvalidConfiguration) {
+  TestPopulation population(5);
+  darwin::RacingVariant racing;
+  racing.selectCase(darwin::RacingType::SuccessiveHalving);
+
+  racing.successive_halving.rung_worlds = 0;
+  EXPECT_THROW(darwin::RacingEvaluation(&population, 3, racing), core::Exception);
+
+  racing.successive_halving.rung_worlds = 1;
+  racing.successive_halving.keep_fraction = 0;
+  EXPECT_THROW(darwin::RacingEvaluation(&population, 3, racing), core::Exception);
+
+  racing.successive_halving.keep_fraction = 1.5f;
+  EXPECT_THROW(darwin::RacingEvaluation(&population, 3, racing), core::Exception);
+}
+
+}  // namespace racing_tests
@@ -0,0 +1,143 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/sim/camera.h>
+#include <core/sim/track.h>
+#include <third_party/box2d/box2d.h>
+#include <third_party/gtest/gtest.h>
+
+#include <math.h>
+#include <random>
+using namespace std;
+
+namespace camera_tests {
+
+// a track, a few dynamic bodies of each shape type and two lights
+class CameraTest : public testing::Test {
+ protected:
+  CameraTest() : world_(b2Vec2(0, 0)), track_(kSeed, trackConfig()) {
+    track_.createFixtures(&world_);
+
+    default_random_engine rnd(kSeed);
+    uniform_real_distribution<float> x_dist(-20, 20);
+    uniform_real_distribution<float> y_dist(-10, 10);
+    uniform_real_distribution<float> angle_dist(-3.14f, 3.14f);
+    uniform_real_distribution<float> size_dist(0.1f, 1.0f);
+
+    for (int i = 0; i < 30; ++i) {
+      b2BodyDef body_def;
+      body_def.type = b2_dynamicBody;
+      body_def.position.Set(x_dist(rnd), y_dist(rnd));
+      body_def.angle = angle_dist(rnd);
+      auto body = world_.CreateBody(&body_def);
+
+      b2CircleShape circle;
+      circle.m_radius = size_dist(rnd);
+      b2PolygonShape box;
+      box.SetAsBox(size_dist(rnd), size_dist(rnd));
+      b2EdgeShape edge;
+      edge.Set(b2Vec2(-size_dist(rnd), 0), b2Vec2(size_dist(rnd), 0));
+      const b2Shape* shapes[] = { &circle, &box, &edge };
+
+      b2FixtureDef fixture_def;
+      fixture_def.shape = shapes[i % 3];
+      fixture_def.material.color = b2Color(0.5f, 1, 0.5f);
+      fixture_def.material.shininess = 10;
+      body->CreateFixture(&fixture_def);
+    }
+
+    b2BodyDef light_body_def;
+    light_body_def.position.Set(0, 0);
+    auto light_body = world_.CreateBody(&light_body_def);
+    for (const auto& position : { b2Vec2(-10, 0), b2Vec2(10, 5) }) {
+      b2LightDef light_def;
+      light_def.body = light_body;
+      light_def.position = position;
+      light_def.color = b2Color(1, 1, 1);
+      light_def.intensity = 2.0f;
+      light_def.attenuation_distance = 25.0f;
+      world_.CreateLight(&light_def);
+    }
+  }
+
+  static sim::TrackConfig trackConfig() {
+    sim::TrackConfig track_config;
+    track_config.gates = true;
+    return track_config;
+  }
+
+  // renders the same view with both ray casting implementations,
+  // returning the number of mismatched receptors
+  static int compareRender(sim::Camera* camera) {
+    camera->setBatchedRaycasting(false);
+    const auto reference = camera->render();
+    camera->setBatchedRaycasting(true);
+    const auto batched = camera->render();
+    EXPECT_EQ(reference.size(), batched.size());
+
+    // tiny rounding differences are expected (ex. FMA contraction), but they can
+    // occasionally flip a grazing intersection so a few mismatches are tolerated
+    constexpr float kEpsilon = 1e-3f;
+    int mismatches = 0;
+    for (size_t i = 0; i < reference.size(); ++i) {
+      const auto& a = reference[i];
+      const auto& b = batched[i];
+      if (fabsf(a.depth - b.depth) > kEpsilon ||
+          fabsf(a.color.r - b.color.r) > kEpsilon ||
+          fabsf(a.color.g - b.color.g) > kEpsilon ||
+          fabsf(a.color.b - b.color.b) > kEpsilon) {
+        ++mismatches;
+      }
+    }
+    return mismatches;
+  }
+
+  static constexpr unsigned kSeed = 7;
+
+  b2World world_;
+  sim::Track track_;
+};
+
+TEST_F(CameraTest, BatchedRaycasting) {
+  b2BodyDef body_def;
+  body_def.type = b2_dynamicBody;
+  auto camera_body = world_.CreateBody(&body_def);
+
+  b2PolygonShape shape;
+  shape.SetAsBox(0.2f, 0.4f);
+  b2FixtureDef fixture_def;
+  fixture_def.shape = &shape;
+  fixture_def.userData = camera_body;
+  camera_body->CreateFixture(&fixture_def);
+
+  sim::Camera camera(camera_body, 120, 0.1f, 50.0f, 64);
+  camera.setPosition(b2Vec2(0, 0.1f));
+  camera.setFilterId(camera_body);
+
+  default_random_engine rnd(kSeed);
+  uniform_real_distribution<float> x_dist(-20, 20);
+  uniform_real_distribution<float> y_dist(-10, 10);
+  uniform_real_distribution<float> angle_dist(-3.14f, 3.14f);
+
+  constexpr int kViews = 50;
+  int mismatches = 0;
+  for (int i = 0; i < kViews; ++i) {
+    camera_body->SetTransform(b2Vec2(x_dist(rnd), y_dist(rnd)), angle_dist(rnd));
+    camera.setShadowAttenuation(i % 2 == 0 ? 1.0f : 0.3f);
+    mismatches += compareRender(&camera);
+  }
+  EXPECT_LE(mismatches, kViews * camera.resolution() / 100);
+}
+
+}  // namespace camera_tests
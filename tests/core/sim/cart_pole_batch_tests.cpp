@@ -0,0 +1,163 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/sim/cart_pole_batch.h>
+#include <third_party/gtest/gtest.h>
+
+#include <math.h>
+#include <vector>
+using namespace std;
+
+namespace cart_pole_batch_tests {
+
+constexpr float kTimeStep = 1.0f / 50.0f;
+
+sim::CartPoleModel singlePoleModel() {
+  sim::CartPoleModel model;
+  model.gravity = 9.8f;
+  model.setCartBox(0.4f, 0.1f, 0.0f);
+  model.addPoleBox(0.04f, 1.5f, 1.0f);
+  return model;
+}
+
+sim::CartPoleModel doublePoleModel() {
+  auto model = singlePoleModel();
+  model.addPoleBox(0.04f, 0.3f, 1.0f);
+  return model;
+}
+
+TEST(CartPoleBatchTest, Model) {
+  sim::CartPoleModel model;
+  model.setCartBox(0.4f, 0.1f, 0.0f);
+  EXPECT_EQ(model.cart_mass, 1.0f);
+  model.setCartBox(0.4f, 0.1f, 10.0f);
+  EXPECT_FLOAT_EQ(model.cart_mass, 0.4f);
+
+  model.addPoleBox(0.1f, 2.0f, 5.0f);
+  ASSERT_EQ(model.poles.size(), 1);
+  const auto& pole = model.poles[0];
+  EXPECT_FLOAT_EQ(pole.mass, 1.0f);
+  EXPECT_FLOAT_EQ(pole.com_distance, 1.0f);
+  EXPECT_FLOAT_EQ(pole.hinge_inertia, (0.01f + 4.0f) / 12 + 1.0f);
+}
+
+TEST(CartPoleBatchTest, Equilibrium) {
+  sim::CartPoleBatch carts(doublePoleModel(), 11);
+  for (int i = 0; i < carts.size(); ++i) {
+    carts.reset(i, { 0.0f, 0.0f });
+  }
+  for (int step = 0; step < 1000; ++step) {
+    carts.step(kTimeStep);
+  }
+  for (int i = 0; i < carts.size(); ++i) {
+    EXPECT_EQ(carts.cartPosition(i), 0);
+    EXPECT_EQ(carts.cartVelocity(i), 0);
+    EXPECT_EQ(carts.poleAngle(i, 0), 0);
+    EXPECT_EQ(carts.poleAngle(i, 1), 0);
+  }
+}
+
+// small oscillations of a hanging pole (the cart is free to move)
+TEST(CartPoleBatchTest, HangingPolePeriod) {
+  const auto model = singlePoleModel();
+  const auto& pole = model.poles[0];
+  const float total_mass = model.cart_mass + pole.mass;
+  const float ml = pole.mass * pole.com_distance;
+  const double omega_squared = ml * model.gravity * total_mass /
+                               (pole.hinge_inertia * total_mass - ml * ml);
+  const double expected_period = 2 * M_PI / sqrt(omega_squared);
+
+  constexpr float kSmallTimeStep = 1.0f / 2000.0f;
+  constexpr float kAmplitude = 0.01f;
+
+  sim::CartPoleBatch carts(model, 1);
+  carts.reset(0, { float(M_PI) + kAmplitude });
+
+  // measure the time between two upward zero crossings
+  vector<double> crossings;
+  float prev_offset = kAmplitude;
+  for (int step = 1; step < 100000 && crossings.size() < 2; ++step) {
+    carts.step(kSmallTimeStep);
+    const float offset = carts.poleAngle(0, 0) - float(M_PI);
+    if (prev_offset < 0 && offset >= 0) {
+      crossings.push_back(step * kSmallTimeStep);
+    }
+    prev_offset = offset;
+  }
+  ASSERT_EQ(crossings.size(), 2);
+  EXPECT_NEAR(crossings[1] - crossings[0], expected_period, expected_period * 0.005);
+}
+
+TEST(CartPoleBatchTest, Symmetry) {
+  sim::CartPoleBatch carts(doublePoleModel(), 2);
+  carts.reset(0, { +0.1f, -0.05f });
+  carts.reset(1, { -0.1f, +0.05f });
+  for (int step = 0; step < 50; ++step) {
+    const float force = (step % 7) * 0.5f;
+    carts.setForce(0, +force);
+    carts.setForce(1, -force);
+    carts.step(kTimeStep);
+    EXPECT_EQ(carts.cartPosition(0), -carts.cartPosition(1));
+    EXPECT_EQ(carts.cartVelocity(0), -carts.cartVelocity(1));
+    EXPECT_EQ(carts.poleAngle(0, 0), -carts.poleAngle(1, 0));
+    EXPECT_EQ(carts.poleAngle(0, 1), -carts.poleAngle(1, 1));
+    EXPECT_EQ(carts.poleAngularVelocity(0, 1), -carts.poleAngularVelocity(1, 1));
+  }
+}
+
+// carts stepped in a batch match the same carts simulated individually
+// (the batch size is not a multiple of kLanes, so both kernels are exercised)
+TEST(CartPoleBatchTest, BatchMatchesIndividualCarts) {
+  constexpr int kCarts = sim::CartPoleBatch::kLanes * 2 + 3;
+  constexpr int kSteps = 100;
+
+  const auto model = doublePoleModel();
+
+  auto initialAngles = [](int index) -> vector<float> {
+    return { 0.02f * (index - kCarts / 2), -0.01f * (index % 5) };
+  };
+
+  auto force = [](int index, int step) {
+    return sinf(step * 0.05f + index) * 2.0f;
+  };
+
+  sim::CartPoleBatch batch(model, kCarts);
+  for (int i = 0; i < kCarts; ++i) {
+    batch.reset(i, initialAngles(i));
+  }
+  for (int step = 0; step < kSteps; ++step) {
+    for (int i = 0; i < kCarts; ++i) {
+      batch.setForce(i, force(i, step));
+    }
+    batch.step(kTimeStep);
+  }
+
+  for (int i = 0; i < kCarts; ++i) {
+    sim::CartPoleBatch cart(model, 1);
+    cart.reset(0, initialAngles(i));
+    for (int step = 0; step < kSteps; ++step) {
+      cart.setForce(0, force(i, step));
+      cart.step(kTimeStep);
+    }
+    EXPECT_NEAR(batch.cartPosition(i), cart.cartPosition(0), 1e-3f);
+    EXPECT_NEAR(batch.cartVelocity(i), cart.cartVelocity(0), 1e-3f);
+    for (int pole = 0; pole < 2; ++pole) {
+      EXPECT_NEAR(batch.poleAngle(i, pole), cart.poleAngle(0, pole), 1e-3f);
+      EXPECT_NEAR(
+          batch.poleAngularVelocity(i, pole), cart.poleAngularVelocity(0, pole), 1e-3f);
+    }
+  }
+}
+
+}  // namespace cart_pole_batch_tests
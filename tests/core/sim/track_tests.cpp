@@ -98,4 +98,35 @@ TEST(TrackTest, LowResolution) {
   }
 }
 
+TEST(TrackTest, SharedGeometry) {
+  sim::TrackConfig track_config;
+  track_config.gates = true;
+
+  const sim::Track test_track(random_device{}(), track_config);
+
+  auto fixturesCount = [](b2World* world) {
+    int count = 0;
+    for (auto body = world->GetBodyList(); body != nullptr; body = body->GetNext()) {
+      for (auto fixture = body->GetFixtureList(); fixture; fixture = fixture->GetNext()) {
+        ++count;
+      }
+    }
+    return count;
+  };
+
+  // the same track instantiated in multiple worlds
+  b2World first_world(b2Vec2(0, 0));
+  test_track.createFixtures(&first_world);
+  const int expected_count = fixturesCount(&first_world);
+  EXPECT_GE(expected_count, 2 * test_track.nodesCount());
+
+  constexpr int kWorlds = 10;
+  for (int i = 0; i < kWorlds; ++i) {
+    b2World world(b2Vec2(0, 0));
+    test_track.createFixtures(&world);
+    EXPECT_EQ(world.GetBodyCount(), first_world.GetBodyCount());
+    EXPECT_EQ(fixturesCount(&world), expected_count);
+  }
+}
+
 }  // namespace track_tests
@@ -0,0 +1,170 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/parallel_for_each.h>
+#include <core/sim/resettable_world.h>
+#include <core/sim/world_pool.h>
+#include <third_party/box2d/box2d.h>
+#include <third_party/gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <vector>
+using namespace std;
+
+namespace world_pool_tests {
+
+struct TestWorld {
+  static atomic<int> instances;
+  static atomic<int> resets;
+
+  int steps = 0;
+
+  TestWorld() { ++instances; }
+
+  void reset() {
+    steps = 0;
+    ++resets;
+  }
+};
+
+atomic<int> TestWorld::instances = 0;
+atomic<int> TestWorld::resets = 0;
+
+TEST(WorldPoolTest, PerThreadInstances) {
+  TestWorld::instances = 0;
+  TestWorld::resets = 0;
+
+  constexpr int kEpisodes = 1000;
+  vector<int> episodes(kEpisodes);
+
+  sim::WorldPool<TestWorld> world_pool([] { return make_unique<TestWorld>(); });
+  pp::for_each(episodes, [&](int, int& steps) {
+    TestWorld* world = world_pool.acquire();
+    EXPECT_EQ(world->steps, 0);
+    for (int i = 0; i < 10; ++i) {
+      ++world->steps;
+    }
+    steps = world->steps;
+  });
+
+  for (int steps : episodes) {
+    EXPECT_EQ(steps, 10);
+  }
+
+  // one instance per worker thread, reset for all the other episodes
+  EXPECT_GE(TestWorld::instances, 1);
+  EXPECT_EQ(world_pool.size(), TestWorld::instances);
+  EXPECT_EQ(TestWorld::instances + TestWorld::resets, kEpisodes);
+}
+
+// a pendulum hanging from a static anchor, plus a box resting on the ground
+class PendulumWorld {
+ public:
+  PendulumWorld() : world_(b2Vec2(0, -10)) {
+    b2BodyDef ground_def;
+    auto ground = world_.CreateBody(&ground_def);
+    b2EdgeShape ground_shape;
+    ground_shape.Set(b2Vec2(-10, 0), b2Vec2(10, 0));
+    ground->CreateFixture(&ground_shape, 0.0f);
+
+    b2BodyDef box_def;
+    box_def.type = b2_dynamicBody;
+    box_def.position.Set(3, 0.5f);
+    box_ = world_.CreateBody(&box_def);
+    b2PolygonShape box_shape;
+    box_shape.SetAsBox(0.5f, 0.5f);
+    box_->CreateFixture(&box_shape, 1.0f);
+
+    b2BodyDef bob_def;
+    bob_def.type = b2_dynamicBody;
+    bob_def.position.Set(-2, 5);
+    bob_ = world_.CreateBody(&bob_def);
+    b2CircleShape bob_shape;
+    bob_shape.m_radius = 0.2f;
+    bob_->CreateFixture(&bob_shape, 1.0f);
+
+    b2RevoluteJointDef joint_def;
+    joint_def.Initialize(ground, bob_, b2Vec2(0, 5));
+    world_.CreateJoint(&joint_def);
+
+    world_.recordInitialState();
+  }
+
+  void reset() { world_.reset(); }
+
+  void step(float push) {
+    box_->ApplyForceToCenter(b2Vec2(push, 0), true);
+    world_.step(1.0f / 50.0f, 5, 5);
+  }
+
+  // creates an extra body (which is not part of the initial state)
+  void dropBall() {
+    b2BodyDef ball_def;
+    ball_def.type = b2_dynamicBody;
+    ball_def.position.Set(3, 3);
+    auto ball = world_.CreateBody(&ball_def);
+    b2CircleShape ball_shape;
+    ball_shape.m_radius = 0.3f;
+    ball->CreateFixture(&ball_shape, 1.0f);
+  }
+
+  vector<float> state() const {
+    return { box_->GetPosition().x,         box_->GetPosition().y,
+             box_->GetAngle(),              box_->GetLinearVelocity().x,
+             bob_->GetPosition().x,         bob_->GetPosition().y,
+             bob_->GetAngularVelocity(),    bob_->GetLinearVelocity().y };
+  }
+
+  int bodiesCount() const { return world_.GetBodyCount(); }
+
+ private:
+  sim::ResettableWorld world_;
+  b2Body* box_ = nullptr;
+  b2Body* bob_ = nullptr;
+};
+
+TEST(ResettableWorldTest, MatchesNewWorld) {
+  constexpr int kSteps = 200;
+  auto push = [](int step) { return (step % 40 < 20) ? 20.0f : -20.0f; };
+
+  // the reference trajectory, using a new world
+  vector<vector<float>> reference;
+  {
+    PendulumWorld world;
+    for (int step = 0; step < kSteps; ++step) {
+      world.step(push(step));
+      reference.push_back(world.state());
+    }
+  }
+
+  // a "dirty" episode, followed by a reset
+  PendulumWorld world;
+  world.dropBall();
+  for (int step = 0; step < kSteps / 2; ++step) {
+    world.step(-push(step) * 2);
+  }
+  world.reset();
+  EXPECT_EQ(world.bodiesCount(), 3);
+
+  for (int step = 0; step < kSteps; ++step) {
+    world.step(push(step));
+    const auto state = world.state();
+    for (size_t i = 0; i < state.size(); ++i) {
+      EXPECT_FLOAT_EQ(state[i], reference[step][i]) << "step " << step;
+    }
+  }
+}
+
+}  // namespace world_pool_tests
@@ -19,7 +19,11 @@
 #include <third_party/gtest/gtest.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <random>
+#include <utility>
 #include <vector>
 using namespace std;
 
@@ -32,6 +36,22 @@ enum class TestPlayerStrategy {
   RandomOutcome,  // random outcome (when facing another RandomOutcome)
 };
 
+struct TestGenotype;
+
+struct TestBrain : public darwin::Brain {
+  const TestGenotype* genotype = nullptr;
+
+  // used to detect concurrent games using the same brain
+  atomic<bool> in_use = false;
+
+  explicit TestBrain(const TestGenotype* genotype) : genotype(genotype) {}
+
+  void setInput(int, float) override { FATAL("Not implemented"); }
+  float output(int) const override { FATAL("Not implemented"); }
+  void think() override { FATAL("Not implemented"); }
+  void resetState() override {}
+};
+
 struct TestGenotype : public darwin::Genotype {
   // the hardcoded gameplay strategy
   TestPlayerStrategy strategy = TestPlayerStrategy::RandomOutcome;
@@ -39,7 +59,14 @@ struct TestGenotype : public darwin::Genotype {
   // keep track of the genotypes which participated in the tournament
   mutable bool participated = false;
 
-  unique_ptr<darwin::Brain> grow() const override { FATAL("Not implemented"); }
+  // the number of grown brains (the tournaments should grow each genotype once)
+  mutable int grow_count = 0;
+
+  unique_ptr<darwin::Brain> grow() const override {
+    ++grow_count;
+    return make_unique<TestBrain>(this);
+  }
+
   unique_ptr<darwin::Genotype> clone() const override { FATAL("Not implemented"); }
   json save() const override { FATAL("Not implemented"); }
   void load(const json&) override { FATAL("Not implemented"); }
@@ -62,6 +89,7 @@ struct TestPopulation : public darwin::Population {
 
   void generateTestStrategies() {
     for (size_t i = 0; i < genotypes_.size(); ++i) {
+      genotypes_[i].grow_count = 0;
       switch (i) {
         case 0:
           genotypes_[i].strategy = TestPlayerStrategy::AlwaysWin;
@@ -87,6 +115,7 @@ struct TestPopulation : public darwin::Population {
     // make sure everyone participated in the tournament
     for (const auto& genotype : genotypes_) {
       EXPECT_TRUE(genotype.participated);
+      EXPECT_EQ(genotype.grow_count, 1);
     }
 
     // rank the genotypes
@@ -136,14 +165,31 @@ class TestGameRules : public tournament::GameRules {
     }
   }
 
-  tournament::GameOutcome play(const darwin::Genotype* player1_genotype,
-                               const darwin::Genotype* player2_genotype) const override {
-    EXPECT_NE(player1_genotype, player2_genotype);
-    auto p1 = dynamic_cast<const TestGenotype*>(player1_genotype);
-    auto p2 = dynamic_cast<const TestGenotype*>(player2_genotype);
+  tournament::GameOutcome play(const tournament::Contestant& player1,
+                               const tournament::Contestant& player2) const override {
+    EXPECT_NE(player1.genotype, player2.genotype);
+    auto p1 = dynamic_cast<const TestGenotype*>(player1.genotype);
+    auto p2 = dynamic_cast<const TestGenotype*>(player2.genotype);
     p1->participated = true;
     p2->participated = true;
 
+    // the brains must match the genotypes, and they must not be in use
+    auto p1_brain = dynamic_cast<TestBrain*>(player1.brain);
+    auto p2_brain = dynamic_cast<TestBrain*>(player2.brain);
+    EXPECT_EQ(p1_brain->genotype, p1);
+    EXPECT_EQ(p2_brain->genotype, p2);
+    EXPECT_FALSE(p1_brain->in_use.exchange(true));
+    EXPECT_FALSE(p2_brain->in_use.exchange(true));
+    auto outcome = gameOutcome(p1, p2);
+    p1_brain->in_use = false;
+    p2_brain->in_use = false;
+    return outcome;
+  }
+
+ private:
+  static tournament::GameOutcome gameOutcome(const TestGenotype* p1,
+                                             const TestGenotype* p2) {
+
     if (p1->strategy == TestPlayerStrategy::AlwaysWin) {
       EXPECT_NE(p2->strategy, TestPlayerStrategy::AlwaysWin);
       return tournament::GameOutcome::FirstPlayerWins;
@@ -178,6 +224,27 @@ class TestGameRules : public tournament::GameRules {
   }
 };
 
+// records all the games played
+class RecordingGameRules : public TestGameRules {
+ public:
+  tournament::GameOutcome play(const tournament::Contestant& player1,
+                               const tournament::Contestant& player2) const override {
+    {
+      unique_lock<mutex> guard(lock_);
+      games_.push_back(minmax(player1.genotype, player2.genotype));
+    }
+    return TestGameRules::play(player1, player2);
+  }
+
+  vector<pair<const darwin::Genotype*, const darwin::Genotype*>> games() const {
+    return games_;
+  }
+
+ private:
+  mutable mutex lock_;
+  mutable vector<pair<const darwin::Genotype*, const darwin::Genotype*>> games_;
+};
+
 struct TournamentTest : public testing::TestWithParam<int> {
   void testTournament(tournament::Tournament* tournament) {
     constexpr int kTournamentsCount = 5;
@@ -232,6 +299,30 @@ TEST_P(TournamentTest, SwissTournament_Full) {
   testTournament(&tournament);
 }
 
+// a large population (multiple pairing groups), which should not need any rematches
+TEST(SwissTournamentTest, NoRematches) {
+  constexpr int kPopulationSize = 5000;
+  constexpr int kRounds = 12;
+
+  tournament::SwissTournamentConfig config;
+  config.rounds = kRounds;
+  config.rematches = false;
+
+  TestPopulation population;
+  population.createPrimordialGeneration(kPopulationSize);
+  population.generateTestStrategies();
+
+  RecordingGameRules rules;
+  tournament::SwissTournament tournament(config);
+  tournament.evaluatePopulation(&population, &rules);
+  population.validateResults();
+
+  auto games = rules.games();
+  EXPECT_EQ(games.size(), kPopulationSize / 2 * kRounds);
+  std::sort(games.begin(), games.end());
+  EXPECT_TRUE(std::adjacent_find(games.begin(), games.end()) == games.end());
+}
+
 // instantiate the test cases with various population sizes
 // (must be even values - some of the tournament implementations require it)
 INSTANTIATE_TEST_CASE_P(All, TournamentTest, testing::Values(2, 4, 100));
@@ -0,0 +1,122 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <core/utils.h>
+#include <core/parallel_for_each.h>
+#include <core/scope_guard.h>
+#include <core/tracing.h>
+
+#include <third_party/gtest/gtest.h>
+#include <third_party/json/json.h>
+using nlohmann::json;
+
+#include <fstream>
+#include <set>
+#include <string>
+#include <vector>
+using namespace std;
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+namespace tracing_tests {
+
+TEST(TracingTest, Disabled) {
+  core::Tracing::disable();
+  core::Tracing::clear();
+
+  {
+    core::TraceScope trace_scope("disabled", "test");
+  }
+
+  EXPECT_TRUE(core::Tracing::collectEvents().empty());
+}
+
+TEST(TracingTest, WorkerThreads) {
+  core::Tracing::clear();
+  core::Tracing::enable();
+  SCOPE_EXIT { core::Tracing::disable(); };
+
+  vector<int> array(1000);
+  pp::for_each(array, [](int, int& value) {
+    core::TraceScope trace_scope("loop body", "test");
+    value = 1;
+  });
+
+  {
+    core::TraceScope trace_scope("main thread", "test");
+  }
+
+  const auto events = core::Tracing::collectEvents();
+
+  int loop_body_spans = 0;
+  int main_thread_spans = 0;
+  for (size_t i = 0; i < events.size(); ++i) {
+    const auto& event = events[i];
+    EXPECT_LE(event.begin, event.end);
+    EXPECT_GE(event.thread_id, 0);
+    if (i > 0) {
+      EXPECT_LE(events[i - 1].begin, event.begin);
+    }
+    if (event.name == "loop body")
+      ++loop_body_spans;
+    else if (event.name == "main thread")
+      ++main_thread_spans;
+  }
+
+  EXPECT_EQ(loop_body_spans, int(array.size()));
+  EXPECT_EQ(main_thread_spans, 1);
+
+  // the events are removed once collected
+  EXPECT_TRUE(core::Tracing::collectEvents().empty());
+}
+
+TEST(TracingTest, ChromeTraceExport) {
+  core::Tracing::clear();
+  core::Tracing::enable();
+  SCOPE_EXIT { core::Tracing::disable(); };
+
+  core::Tracing::setThreadName("Test thread");
+
+  const auto now = core::Tracing::Clock::now();
+  core::Tracing::recordSpan("first", "test", now, now + chrono::milliseconds(2));
+  core::Tracing::recordSpan(
+      "second", "test", now + chrono::milliseconds(1), now + chrono::milliseconds(3));
+  const auto path = fs::path(TEST_TEMP_PATH) / "chrome_trace_test.json";
+  core::Tracing::exportChromeTrace(path);
+  SCOPE_EXIT { fs::remove(path); };
+
+  json json_trace;
+  ifstream(path) >> json_trace;
+
+  set<string> names;
+  bool thread_name_found = false;
+  for (const auto& json_event : json_trace["traceEvents"]) {
+    if (json_event["ph"] == "M") {
+      thread_name_found |= json_event["args"]["name"] == "Test thread";
+    } else {
+      EXPECT_EQ(json_event["ph"], "X");
+      EXPECT_EQ(json_event["cat"], "test");
+      names.insert(json_event["name"].get<string>());
+      if (json_event["name"] == "first") {
+        EXPECT_NEAR(json_event["dur"].get<double>(), 2000.0, 1.0);
+      }
+    }
+  }
+
+  EXPECT_TRUE(thread_name_found);
+  EXPECT_EQ(names, set<string>({ "first", "second" }));
+}
+
+}  // namespace tracing_tests
@@ -3,7 +3,11 @@ include(../tests_common.pri)
 
 SOURCES += \
     main.cpp \
-    smoke_tests.cpp
+    evaluation_workers_tests.cpp \
+    island_model_tests.cpp \
+    multi_fidelity_tests.cpp \
+    smoke_tests.cpp \
+    steady_state_tests.cpp
     
 HEADERS += \
     test_environment.h
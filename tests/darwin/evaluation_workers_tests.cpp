@@ -0,0 +1,209 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_environment.h"
+
+#include <core/darwin.h>
+#include <core/evaluation_workers.h>
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/scope_guard.h>
+#include <core/universe.h>
+#include <core/utils.h>
+
+#include <third_party/gtest/gtest.h>
+
+#ifdef DARWIN_OS_LINUX
+#include <signal.h>
+#endif
+
+#include <memory>
+#include <string>
+using namespace std;
+
+namespace evaluation_workers_tests {
+
+#ifdef DARWIN_OS_LINUX
+
+// the worker processes are started from the test executable
+// (see the darwin::EvaluationWorkers::isWorkerProcess() check in main())
+class EvaluationWorkersTest : public testing::Test {
+ protected:
+  EvaluationWorkersTest() {
+    universe_ = darwin::Universe::open(DarwinTestEnvironment::universePath());
+  }
+
+  shared_ptr<darwin::Experiment> newExperiment(const string& test_name,
+                                               const string& domain_name,
+                                               const string& population_name,
+                                               int population_size) {
+    darwin::ExperimentSetup setup;
+    setup.population_size = population_size;
+    setup.population_name = population_name;
+    setup.domain_name = domain_name;
+    setup.population_hint = darwin::ComplexityHint::Minimal;
+    setup.domain_hint = darwin::ComplexityHint::Minimal;
+    auto name = core::format(
+        "evaluation_workers/%s/%s/%s", test_name, domain_name, population_name);
+    return make_shared<darwin::Experiment>(name, setup, nullopt, universe_.get());
+  }
+
+  unique_ptr<darwin::Universe> universe_;
+};
+
+TEST_F(EvaluationWorkersTest, Evolution) {
+  constexpr int kGenerations = 3;
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+  evolution_config.evaluation_workers = 2;
+  evolution_config.evaluation_batch_size = 7;
+
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("evolution", "find_max_value", "neat", 20);
+  ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+  evolution->run();
+
+  evolution->waitForState(darwin::Evolution::State::Stopped);
+  const auto snapshot = evolution->snapshot();
+  EXPECT_EQ(snapshot.trace->size(), kGenerations);
+  ASSERT_TRUE(evolution->reset());
+}
+
+TEST_F(EvaluationWorkersTest, TournamentDomain) {
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.evaluation_workers = 2;
+
+  // the fitness values depend on the other genotypes,
+  // so the population can't be evaluated in batches
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("tournament", "tic_tac_toe", "neat", 10);
+  EXPECT_THROW(evolution->newExperiment(experiment, evolution_config),
+               core::Exception);
+}
+
+TEST_F(EvaluationWorkersTest, InvalidWorkerExecutable) {
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.evaluation_workers = 2;
+  evolution_config.evaluation_worker = "/darwin/invalid/evaluation_worker";
+
+  auto experiment = newExperiment("invalid_worker", "test_domain", "neat", 10);
+  EXPECT_THROW(darwin::EvaluationWorkers(*experiment, evolution_config),
+               core::Exception);
+}
+
+TEST_F(EvaluationWorkersTest, WorkerRestart) {
+  constexpr int kGenerations = 4;
+  constexpr int kPausedGeneration = 1;
+  constexpr float kFitness = 2.5f;
+
+  auto experiment = newExperiment("restart", "test_domain", "neat", 50);
+
+  // test_domain with a fixed fitness value
+  auto domain_config = experiment->domainConfig()->toJson();
+  domain_config["fitness_mean"] = core::toString(kFitness);
+  domain_config["fitness_stddev"] = "0";
+  experiment->domainConfig()->fromJson(domain_config);
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+  evolution_config.evaluation_workers = 3;
+  evolution_config.evaluation_batch_size = 4;
+
+  auto evolution = darwin::Evolution::create();
+  ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+
+  auto events_subscription = evolution->events.subscribe([&](uint32_t hints) {
+    if ((hints & darwin::Evolution::EventFlag::EndGeneration) != 0) {
+      if (evolution->snapshot().generation == kPausedGeneration)
+        evolution->pause();
+    }
+  });
+  SCOPE_EXIT { evolution->events.unsubscribe(events_subscription); };
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Paused);
+
+  const auto evaluation_workers = evolution->evaluationWorkers();
+  ASSERT_NE(evaluation_workers, nullptr);
+  EXPECT_EQ(evaluation_workers->restartsCount(), 0);
+
+  // a worker crash is recovered by restarting the worker process
+  const auto pids = evaluation_workers->workerProcessIds();
+  ASSERT_EQ(pids.size(), 3);
+  ASSERT_EQ(::kill(pids[1], SIGKILL), 0);
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Stopped);
+
+  EXPECT_EQ(evaluation_workers->restartsCount(), 1);
+  EXPECT_EQ(evaluation_workers->workerProcessIds().size(), 3);
+
+  // every genotype was evaluated, in every generation
+  const auto snapshot = evolution->snapshot();
+  ASSERT_EQ(snapshot.trace->size(), kGenerations);
+  for (int i = 0; i < kGenerations; ++i) {
+    const auto& summary = snapshot.trace->generationSummary(i);
+    EXPECT_EQ(summary.best_fitness, kFitness);
+    EXPECT_EQ(summary.worst_fitness, kFitness);
+  }
+
+  ASSERT_TRUE(evolution->reset());
+}
+
+TEST_F(EvaluationWorkersTest, WorkerTimeout) {
+  constexpr int kGenerations = 3;
+  constexpr int kPausedGeneration = 0;
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+  evolution_config.evaluation_workers = 2;
+  evolution_config.evaluation_batch_size = 5;
+  evolution_config.evaluation_batch_timeout = 1;
+
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("timeout", "test_domain", "neat", 20);
+  ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+
+  auto events_subscription = evolution->events.subscribe([&](uint32_t hints) {
+    if ((hints & darwin::Evolution::EventFlag::EndGeneration) != 0) {
+      if (evolution->snapshot().generation == kPausedGeneration)
+        evolution->pause();
+    }
+  });
+  SCOPE_EXIT { evolution->events.unsubscribe(events_subscription); };
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Paused);
+
+  const auto evaluation_workers = evolution->evaluationWorkers();
+  ASSERT_NE(evaluation_workers, nullptr);
+
+  // a worker which stops responding is restarted after the batch timeout
+  const auto pids = evaluation_workers->workerProcessIds();
+  ASSERT_EQ(pids.size(), 2);
+  ASSERT_EQ(::kill(pids[0], SIGSTOP), 0);
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Stopped);
+
+  EXPECT_EQ(evaluation_workers->restartsCount(), 1);
+  EXPECT_EQ(evolution->snapshot().trace->size(), kGenerations);
+
+  ASSERT_TRUE(evolution->reset());
+}
+
+#endif  // DARWIN_OS_LINUX
+
+}  // namespace evaluation_workers_tests
@@ -0,0 +1,182 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_environment.h"
+
+#include <core/context.h>
+#include <core/darwin.h>
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/island_model.h>
+#include <core/scope_guard.h>
+#include <core/thread_pool.h>
+#include <core/universe.h>
+#include <core/utils.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace island_model_tests {
+
+struct PassThroughController : public pp::Controller {
+  void checkpoint() override {}
+};
+
+class IslandModelTest : public testing::Test {
+ protected:
+  IslandModelTest() {
+    universe_ = darwin::Universe::open(DarwinTestEnvironment::universePath());
+  }
+
+  shared_ptr<darwin::Experiment> newExperiment(const string& test_name,
+                                               int population_size) {
+    darwin::ExperimentSetup setup;
+    setup.population_size = population_size;
+    setup.population_name = "neat";
+    setup.domain_name = "test_domain";
+    setup.population_hint = darwin::ComplexityHint::Minimal;
+    setup.domain_hint = darwin::ComplexityHint::Minimal;
+    auto name = core::format("island_model/%s", test_name);
+    return make_shared<darwin::Experiment>(name, setup, nullopt, universe_.get());
+  }
+
+  unique_ptr<darwin::Universe> universe_;
+};
+
+TEST_F(IslandModelTest, InvalidConfig) {
+  darwin::IslandModelConfig config;
+  config.islands = 0;
+  EXPECT_THROW(darwin::IslandModel{ config }, core::Exception);
+
+  config.islands = 2;
+  config.migration_interval = 0;
+  EXPECT_THROW(darwin::IslandModel{ config }, core::Exception);
+}
+
+TEST_F(IslandModelTest, Migrate) {
+  constexpr int kPopulationSize = 10;
+  constexpr int kMigrants = 3;
+
+  // the populations are used outside an evolution instance, so the parallel
+  // loops must not wait for it and the stages must not be reported
+  PassThroughController pass_through;
+  pp::Controller* controller = &pass_through;
+  auto context = core::Context::current();
+  context.set(pp::g_controller, controller);
+  core::ContextScope context_scope(context);
+  darwin::ProgressManager::setBackgroundThread(true);
+  SCOPE_EXIT { darwin::ProgressManager::setBackgroundThread(false); };
+
+  auto experiment = newExperiment("migrate", kPopulationSize);
+  auto domain = experiment->domainFactory()->create(*experiment->domainConfig());
+
+  // two islands, with non-overlapping fitness values
+  vector<unique_ptr<darwin::Population>> populations;
+  for (int island = 0; island < 2; ++island) {
+    auto population =
+        experiment->populationFactory()->create(*experiment->populationConfig(), *domain);
+    population->createPrimordialGeneration(kPopulationSize);
+    for (size_t i = 0; i < population->size(); ++i) {
+      population->genotype(i)->fitness = float(island * 100 + i);
+    }
+    populations.push_back(std::move(population));
+  }
+
+  darwin::IslandModelConfig config;
+  config.islands = 2;
+  config.topology = darwin::MigrationTopology::Ring;
+  config.migrants = kMigrants;
+  darwin::IslandModel island_model(config);
+
+  // nothing to receive yet
+  EXPECT_EQ(island_model.migrate(1, populations[1].get()), 0);
+
+  // island 0 receives the top genotypes from island 1
+  auto source = populations[1].get();
+  auto target = populations[0].get();
+  EXPECT_EQ(island_model.migrate(0, target), kMigrants);
+  EXPECT_EQ(island_model.immigrantsCount(0), kMigrants);
+  EXPECT_EQ(island_model.immigrantsCount(1), 0);
+
+  // the immigrants replaced the worst genotypes, keeping their fitness values
+  for (int i = 0; i < kMigrants; ++i) {
+    const auto source_genotype = source->genotype(kPopulationSize - 1 - i);
+    const auto target_genotype = target->genotype(i);
+    EXPECT_EQ(target_genotype->fitness, source_genotype->fitness);
+    EXPECT_EQ(target_genotype->save(), source_genotype->save());
+  }
+  EXPECT_EQ(target->genotype(kPopulationSize - 1)->fitness, kPopulationSize - 1);
+
+  // the same emigrants are not received twice
+  EXPECT_EQ(island_model.migrate(0, target), 0);
+
+  // island 1 receives the latest emigrants of island 0
+  // (published by the last migration, so they are the island 1 genotypes)
+  EXPECT_EQ(island_model.migrate(1, source), kMigrants);
+  EXPECT_EQ(source->genotype(0)->fitness, 100 + kPopulationSize - 1);
+  EXPECT_EQ(source->genotype(kPopulationSize - 1)->fitness, 100 + kPopulationSize - 1);
+}
+
+TEST_F(IslandModelTest, Evolution) {
+  constexpr int kIslands = 3;
+  constexpr int kGenerations = 4;
+
+  darwin::IslandModelConfig config;
+  config.islands = kIslands;
+  config.topology = darwin::MigrationTopology::Ring;
+  config.migration_interval = 1;
+  config.migrants = 2;
+  auto island_model = make_shared<darwin::IslandModel>(config);
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+
+  auto experiment = newExperiment("evolution", 10);
+
+  vector<unique_ptr<darwin::Evolution>> islands;
+  for (int island = 0; island < kIslands; ++island) {
+    // each island uses its own Experiment instance
+    auto db_experiment = universe_->loadExperiment(experiment->dbExperimentId());
+    auto island_experiment =
+        make_shared<darwin::Experiment>(db_experiment.get(), universe_.get());
+
+    auto evolution = darwin::Evolution::create();
+    ASSERT_TRUE(evolution->newExperiment(island_experiment, evolution_config));
+    evolution->joinIslandModel(island_model, island);
+    islands.push_back(std::move(evolution));
+  }
+
+  for (auto& evolution : islands) {
+    evolution->run();
+  }
+
+  int immigrants_count = 0;
+  for (int island = 0; island < kIslands; ++island) {
+    auto& evolution = islands[island];
+    evolution->waitForState(darwin::Evolution::State::Stopped);
+    EXPECT_EQ(evolution->snapshot().trace->size(), kGenerations);
+    immigrants_count += island_model->immigrantsCount(island);
+    ASSERT_TRUE(evolution->reset());
+  }
+
+  // with a ring topology, at least one of the islands must receive immigrants
+  // (regardless of the relative speed of the islands)
+  EXPECT_GT(immigrants_count, 0);
+}
+
+}  // namespace island_model_tests
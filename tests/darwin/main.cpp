@@ -16,6 +16,7 @@
 
 #include <core/utils.h>
 #include <core/darwin.h>
+#include <core/evaluation_workers.h>
 #include <core/evolution.h>
 #include <core/runtime.h>
 #include <registry/registry.h>
@@ -23,6 +24,12 @@
 #include <third_party/gtest/gtest.h>
 
 int main(int argc, char* argv[]) {
+  // evaluation worker processes (see darwin::EvaluationWorkers)
+  if (darwin::EvaluationWorkers::isWorkerProcess(argc, argv)) {
+    registry::init();
+    return darwin::EvaluationWorkers::workerMain(argc, argv);
+  }
+
   // Darwin initialization
   //
   // NOTE: this must be done before InitGoogleTest() in order
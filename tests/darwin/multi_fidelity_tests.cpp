@@ -0,0 +1,110 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_environment.h"
+
+#include <core/darwin.h>
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/multi_fidelity.h>
+#include <core/universe.h>
+#include <core/utils.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <memory>
+#include <string>
+using namespace std;
+
+namespace multi_fidelity_tests {
+
+class MultiFidelityTest : public testing::Test {
+ protected:
+  MultiFidelityTest() {
+    universe_ = darwin::Universe::open(DarwinTestEnvironment::universePath());
+  }
+
+  shared_ptr<darwin::Experiment> newExperiment(const string& test_name,
+                                               const string& domain_name,
+                                               const string& population_name,
+                                               int population_size) {
+    darwin::ExperimentSetup setup;
+    setup.population_size = population_size;
+    setup.population_name = population_name;
+    setup.domain_name = domain_name;
+    setup.population_hint = darwin::ComplexityHint::Minimal;
+    setup.domain_hint = darwin::ComplexityHint::Minimal;
+    auto name =
+        core::format("multi_fidelity/%s/%s/%s", test_name, domain_name, population_name);
+    return make_shared<darwin::Experiment>(name, setup, nullopt, universe_.get());
+  }
+
+  static void enableMultiFidelity(darwin::EvolutionConfig* config) {
+    config->evaluation_fidelity.selectCase(darwin::EvaluationFidelity::MultiFidelity);
+    config->evaluation_fidelity.multi_fidelity.calibration_samples = 10;
+  }
+
+  unique_ptr<darwin::Universe> universe_;
+};
+
+TEST_F(MultiFidelityTest, Evolve) {
+  constexpr int kGenerations = 4;
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+  enableMultiFidelity(&evolution_config);
+
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("evolve", "test_domain", "neat", 50);
+  ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+  evolution->run();
+
+  evolution->waitForState(darwin::Evolution::State::Stopped);
+  EXPECT_EQ(evolution->snapshot().trace->size(), kGenerations);
+  ASSERT_TRUE(evolution->reset());
+}
+
+TEST_F(MultiFidelityTest, UnsupportedDomains) {
+  darwin::EvolutionConfig evolution_config;
+  enableMultiFidelity(&evolution_config);
+
+  // no fidelity knobs
+  {
+    auto evolution = darwin::Evolution::create();
+    auto experiment = newExperiment("unsupported", "find_max_value", "neat", 10);
+    EXPECT_THROW(evolution->newExperiment(experiment, evolution_config),
+                 core::Exception);
+  }
+
+  // tournament based evaluation
+  {
+    auto evolution = darwin::Evolution::create();
+    auto experiment = newExperiment("unsupported", "tic_tac_toe", "neat", 10);
+    EXPECT_THROW(evolution->newExperiment(experiment, evolution_config),
+                 core::Exception);
+  }
+}
+
+TEST_F(MultiFidelityTest, SteadyState) {
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.steady_state = true;
+  enableMultiFidelity(&evolution_config);
+
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("steady_state", "test_domain", "neat", 10);
+  EXPECT_THROW(evolution->newExperiment(experiment, evolution_config),
+               core::Exception);
+}
+
+}  // namespace multi_fidelity_tests
@@ -109,9 +109,9 @@ struct SmokeTest : public testing::TestWithParam<ExperimentConfig> {
     // start the experiment
     evolution->newExperiment(experiment, evolution_config);
     evolution->run();
-    evolution->waitForState(darwin::Evolution::State::Running);
 
     // wait for termination
+    // (note that short experiments may stop before observing the Running state)
     evolution->waitForState(termination_state);
 
     // final snapshot
@@ -151,6 +151,62 @@ TEST_P(SmokeTest, DetailedResults) {
   runEvolution("detailed", evolution_config, darwin::Evolution::State::Stopped);
 }
 
+TEST_P(SmokeTest, OverlappedCalibration) {
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = 3;
+  evolution_config.overlap_calibration = true;
+  runEvolution("overlapped", evolution_config, darwin::Evolution::State::Stopped);
+}
+
+// independent experiments, running concurrently (sharing the thread pool)
+TEST(ConcurrentExperimentsTest, SharedThreadPool) {
+  auto universe = darwin::Universe::open(DarwinTestEnvironment::universePath());
+
+  // the same population types are used with different domains, so the
+  // experiments have different configurations and different inputs/outputs counts
+  const vector<pair<string, string>> setups = {
+    { "harvester", "cne.lstm" },
+    { "tic_tac_toe", "cne.lstm" },
+    { "find_max_value", "neat" },
+    { "pong", "neat" },
+  };
+
+  constexpr int kPopulationSize = 10;
+  constexpr int kGenerations = 3;
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+
+  vector<unique_ptr<darwin::Evolution>> evolutions;
+  for (const auto& [domain_name, population_name] : setups) {
+    darwin::ExperimentSetup experiment_setup;
+    experiment_setup.population_size = kPopulationSize;
+    experiment_setup.population_name = population_name;
+    experiment_setup.domain_name = domain_name;
+    experiment_setup.population_hint = darwin::ComplexityHint::Minimal;
+    experiment_setup.domain_hint = darwin::ComplexityHint::Minimal;
+
+    auto name = core::format("concurrent/%s/%s", domain_name, population_name);
+    auto experiment =
+        make_shared<darwin::Experiment>(name, experiment_setup, nullopt, universe.get());
+
+    auto evolution = darwin::Evolution::create();
+    ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+    evolutions.push_back(std::move(evolution));
+  }
+
+  for (auto& evolution : evolutions) {
+    evolution->run();
+  }
+
+  for (auto& evolution : evolutions) {
+    evolution->waitForState(darwin::Evolution::State::Stopped);
+    const auto snapshot = evolution->snapshot();
+    EXPECT_EQ(snapshot.trace->size(), kGenerations);
+    ASSERT_TRUE(evolution->reset());
+  }
+}
+
 vector<ExperimentConfig> everyDomainPopulationCombination() {
   auto registry = darwin::registry();
   CHECK(!registry->domains.empty());
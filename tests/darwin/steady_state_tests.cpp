@@ -0,0 +1,163 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "test_environment.h"
+
+#include <core/darwin.h>
+#include <core/evolution.h>
+#include <core/exception.h>
+#include <core/scope_guard.h>
+#include <core/universe.h>
+#include <core/utils.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <memory>
+#include <string>
+using namespace std;
+
+namespace steady_state_tests {
+
+class SteadyStateTest : public testing::Test {
+ protected:
+  SteadyStateTest() {
+    universe_ = darwin::Universe::open(DarwinTestEnvironment::universePath());
+  }
+
+  shared_ptr<darwin::Experiment> newExperiment(const string& test_name,
+                                               const string& domain_name,
+                                               const string& population_name,
+                                               int population_size) {
+    darwin::ExperimentSetup setup;
+    setup.population_size = population_size;
+    setup.population_name = population_name;
+    setup.domain_name = domain_name;
+    setup.population_hint = darwin::ComplexityHint::Minimal;
+    setup.domain_hint = darwin::ComplexityHint::Minimal;
+    auto name =
+        core::format("steady_state/%s/%s/%s", test_name, domain_name, population_name);
+    return make_shared<darwin::Experiment>(name, setup, nullopt, universe_.get());
+  }
+
+  void evolve(const string& test_name,
+              const string& population_name,
+              darwin::SteadyStateReplacement replacement) {
+    constexpr int kGenerations = 5;
+
+    darwin::EvolutionConfig evolution_config;
+    evolution_config.max_generations = kGenerations;
+    evolution_config.steady_state = true;
+    evolution_config.steady_state_replacement = replacement;
+
+    auto evolution = darwin::Evolution::create();
+    auto experiment = newExperiment(test_name, "find_max_value", population_name, 30);
+    ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+    evolution->run();
+
+    evolution->waitForState(darwin::Evolution::State::Stopped);
+    const auto trace = evolution->snapshot().trace;
+    ASSERT_EQ(trace->size(), kGenerations);
+
+    // the champion is never replaced, so the best fitness can't decrease
+    for (int generation = 1; generation < kGenerations; ++generation) {
+      const auto prev_summary = trace->generationSummary(generation - 1);
+      const auto summary = trace->generationSummary(generation);
+      EXPECT_EQ(summary.generation, generation);
+      EXPECT_GE(summary.best_fitness, prev_summary.best_fitness);
+    }
+
+    ASSERT_TRUE(evolution->reset());
+  }
+
+  unique_ptr<darwin::Universe> universe_;
+};
+
+TEST_F(SteadyStateTest, ReplaceWorst) {
+  evolve("worst", "neat", darwin::SteadyStateReplacement::Worst);
+  evolve("worst", "cne.lstm", darwin::SteadyStateReplacement::Worst);
+}
+
+TEST_F(SteadyStateTest, ReplaceOldest) {
+  evolve("oldest", "neat", darwin::SteadyStateReplacement::Oldest);
+  evolve("oldest", "cgp", darwin::SteadyStateReplacement::Oldest);
+}
+
+TEST_F(SteadyStateTest, TournamentDomain) {
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.steady_state = true;
+
+  // the children can't be evaluated one at a time
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("tournament", "tic_tac_toe", "neat", 10);
+  EXPECT_THROW(evolution->newExperiment(experiment, evolution_config),
+               core::Exception);
+}
+
+TEST_F(SteadyStateTest, PauseAndResume) {
+  constexpr int kGenerations = 6;
+  constexpr int kPausedGeneration = 2;
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.max_generations = kGenerations;
+  evolution_config.steady_state = true;
+
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("pause", "test_domain", "neat", 40);
+  ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+
+  auto events_subscription = evolution->events.subscribe([&](uint32_t hints) {
+    if ((hints & darwin::Evolution::EventFlag::EndGeneration) != 0) {
+      if (evolution->snapshot().generation == kPausedGeneration)
+        evolution->pause();
+    }
+  });
+  SCOPE_EXIT { evolution->events.unsubscribe(events_subscription); };
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Paused);
+  EXPECT_LT(evolution->snapshot().trace->size(), kGenerations);
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Stopped);
+  EXPECT_EQ(evolution->snapshot().trace->size(), kGenerations);
+  ASSERT_TRUE(evolution->reset());
+}
+
+TEST_F(SteadyStateTest, Cancel) {
+  constexpr int kPausedGeneration = 3;
+
+  darwin::EvolutionConfig evolution_config;
+  evolution_config.steady_state = true;
+  evolution_config.steady_state_replacement = darwin::SteadyStateReplacement::Oldest;
+
+  auto evolution = darwin::Evolution::create();
+  auto experiment = newExperiment("cancel", "test_domain", "cne.feedforward", 40);
+  ASSERT_TRUE(evolution->newExperiment(experiment, evolution_config));
+
+  auto events_subscription = evolution->events.subscribe([&](uint32_t hints) {
+    if ((hints & darwin::Evolution::EventFlag::EndGeneration) != 0) {
+      if (evolution->snapshot().generation == kPausedGeneration)
+        evolution->pause();
+    }
+  });
+  SCOPE_EXIT { evolution->events.unsubscribe(events_subscription); };
+
+  evolution->run();
+  evolution->waitForState(darwin::Evolution::State::Paused);
+
+  // the evaluator threads are stopped while paused
+  ASSERT_TRUE(evolution->reset());
+}
+
+}  // namespace steady_state_tests
@@ -0,0 +1,12 @@
+
+include(../tests_common.pri)
+
+SOURCES += \
+    main.cpp \
+    sweep_tests.cpp \
+    ../../darwin_cli/cli_options.cpp \
+    ../../darwin_cli/sweep.cpp
+
+HEADERS += \
+    ../../darwin_cli/cli_options.h \
+    ../../darwin_cli/sweep.h
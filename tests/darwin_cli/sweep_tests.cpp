@@ -0,0 +1,267 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <darwin_cli/sweep.h>
+
+#include <core/exception.h>
+#include <core/utils.h>
+
+#include <third_party/gtest/gtest.h>
+
+#include <set>
+#include <string>
+#include <vector>
+using namespace std;
+
+namespace sweep_tests {
+
+using darwin_cli::Section;
+using darwin_cli::SweepConfig;
+using darwin_cli::SweepSearch;
+
+// the swept values of a variation, in the parameters order
+vector<string> variationValues(const vector<darwin_cli::PropertyOverride>& overrides) {
+  vector<string> values;
+  for (const auto& property_override : overrides) {
+    values.push_back(property_override.value);
+  }
+  return values;
+}
+
+TEST(SweepTest, ParseParameters) {
+  const auto parameters = darwin_cli::parseSweepParameters(json::parse(R"({
+    "setup.population_size": [ 100, 500 ],
+    "core.activation_function": [ "tanh", "relu" ],
+    "population.mutation_std_dev": { "min": 0.1, "max": 1.0, "log": true },
+    "domain.max_steps": { "min": 10, "max": 20 }
+  })"));
+  ASSERT_EQ(parameters.size(), 4);
+
+  // the parameters are ordered by name
+  EXPECT_EQ(parameters[0].section, Section::Core);
+  EXPECT_EQ(parameters[0].path, "activation_function");
+  EXPECT_EQ(parameters[0].values, (vector<string>{ "tanh", "relu" }));
+  EXPECT_FALSE(parameters[0].range);
+
+  EXPECT_EQ(parameters[1].section, Section::Domain);
+  EXPECT_EQ(parameters[1].path, "max_steps");
+  ASSERT_TRUE(parameters[1].range);
+  EXPECT_EQ(parameters[1].range->min, 10);
+  EXPECT_EQ(parameters[1].range->max, 20);
+  EXPECT_TRUE(parameters[1].range->integer);
+  EXPECT_FALSE(parameters[1].range->log);
+
+  EXPECT_EQ(parameters[2].section, Section::Population);
+  ASSERT_TRUE(parameters[2].range);
+  EXPECT_FALSE(parameters[2].range->integer);
+  EXPECT_TRUE(parameters[2].range->log);
+
+  EXPECT_EQ(parameters[3].section, Section::Setup);
+  EXPECT_EQ(parameters[3].path, "population_size");
+  EXPECT_EQ(parameters[3].values, (vector<string>{ "100", "500" }));
+}
+
+TEST(SweepTest, InvalidParameters) {
+  const auto parse = [](const char* json_text) {
+    return darwin_cli::parseSweepParameters(json::parse(json_text));
+  };
+
+  EXPECT_THROW(parse(R"([ 1, 2 ])"), core::Exception);
+
+  // missing or invalid section
+  EXPECT_THROW(parse(R"({ "population_size": [ 1, 2 ] })"), core::Exception);
+  EXPECT_THROW(parse(R"({ "foo.bar": [ 1, 2 ] })"), core::Exception);
+
+  // the sections which are not recorded in the universe
+  EXPECT_THROW(parse(R"({ "evolution.max_generations": [ 1, 2 ] })"), core::Exception);
+  EXPECT_THROW(parse(R"({ "sweep.samples": [ 1, 2 ] })"), core::Exception);
+
+  // invalid values
+  EXPECT_THROW(parse(R"({ "setup.population_size": [] })"), core::Exception);
+  EXPECT_THROW(parse(R"({ "setup.population_size": 100 })"), core::Exception);
+  EXPECT_THROW(parse(R"({ "setup.population_size": [ [ 1 ] ] })"), core::Exception);
+  EXPECT_THROW(parse(R"({ "setup.population_size": [ null ] })"), core::Exception);
+
+  // invalid ranges
+  EXPECT_THROW(parse(R"({ "domain.max_steps": { "min": 10 } })"), core::Exception);
+  EXPECT_THROW(parse(R"({ "domain.max_steps": { "min": "1", "max": 5 } })"),
+               core::Exception);
+  EXPECT_THROW(parse(R"({ "domain.max_steps": { "min": 20, "max": 10 } })"),
+               core::Exception);
+  EXPECT_THROW(parse(R"({ "domain.scale": { "min": 0, "max": 1, "log": true } })"),
+               core::Exception);
+}
+
+TEST(SweepTest, GridSearch) {
+  const auto parameters = darwin_cli::parseSweepParameters(json::parse(R"({
+    "domain.a": [ 1, 2 ],
+    "domain.b": [ "x", "y", "z" ],
+    "setup.c": [ true ]
+  })"));
+
+  SweepConfig config;
+  config.search = SweepSearch::Grid;
+  const auto variations = darwin_cli::sweepVariations(config, parameters);
+
+  // every combination, the last parameter varies the fastest
+  const vector<vector<string>> expected_values = {
+    { "1", "x", "true" }, { "1", "y", "true" }, { "1", "z", "true" },
+    { "2", "x", "true" }, { "2", "y", "true" }, { "2", "z", "true" },
+  };
+  ASSERT_EQ(variations.size(), expected_values.size());
+  for (size_t i = 0; i < variations.size(); ++i) {
+    EXPECT_EQ(variationValues(variations[i]), expected_values[i]);
+    ASSERT_EQ(variations[i].size(), parameters.size());
+    for (size_t j = 0; j < parameters.size(); ++j) {
+      EXPECT_EQ(variations[i][j].section, parameters[j].section);
+      EXPECT_EQ(variations[i][j].path, parameters[j].path);
+    }
+  }
+}
+
+TEST(SweepTest, GridSearchRejectsRanges) {
+  const auto parameters = darwin_cli::parseSweepParameters(json::parse(R"({
+    "domain.a": [ 1, 2 ],
+    "domain.b": { "min": 1, "max": 2 }
+  })"));
+
+  SweepConfig config;
+  config.search = SweepSearch::Grid;
+  EXPECT_THROW(darwin_cli::sweepVariations(config, parameters), core::Exception);
+}
+
+TEST(SweepTest, RandomSearch) {
+  const auto parameters = darwin_cli::parseSweepParameters(json::parse(R"({
+    "domain.a_values": [ "x", "y", "z" ],
+    "domain.b_real": { "min": -1.0, "max": 1.0 },
+    "domain.c_integer": { "min": 1, "max": 4 },
+    "domain.d_log": { "min": 0.001, "max": 1000.0, "log": true },
+    "domain.e_log_integer": { "min": 1, "max": 1000, "log": true }
+  })"));
+
+  constexpr int kSamples = 500;
+
+  SweepConfig config;
+  config.search = SweepSearch::Random;
+  config.samples = kSamples;
+  config.seed = 7;
+  const auto variations = darwin_cli::sweepVariations(config, parameters);
+  ASSERT_EQ(variations.size(), kSamples);
+
+  set<string> discrete_values;
+  set<int> integer_values;
+  int below_one = 0;
+  int log_integer_below_32 = 0;
+  for (const auto& variation : variations) {
+    ASSERT_EQ(variation.size(), parameters.size());
+
+    discrete_values.insert(variation[0].value);
+
+    const auto real_value = core::fromString<double>(variation[1].value);
+    EXPECT_GE(real_value, -1.0);
+    EXPECT_LE(real_value, 1.0);
+
+    // the integer ranges produce integer values, including both bounds
+    const auto integer_value = core::fromString<int>(variation[2].value);
+    EXPECT_EQ(variation[2].value, to_string(integer_value));
+    EXPECT_GE(integer_value, 1);
+    EXPECT_LE(integer_value, 4);
+    integer_values.insert(integer_value);
+
+    // the log ranges are sampled uniformly over the orders of magnitude
+    const auto log_value = core::fromString<double>(variation[3].value);
+    EXPECT_GE(log_value, 0.001);
+    EXPECT_LE(log_value, 1000.0);
+    if (log_value < 1)
+      ++below_one;
+
+    const auto log_integer_value = core::fromString<int>(variation[4].value);
+    EXPECT_EQ(variation[4].value, to_string(log_integer_value));
+    EXPECT_GE(log_integer_value, 1);
+    EXPECT_LE(log_integer_value, 1000);
+    if (log_integer_value < 32)
+      ++log_integer_below_32;
+  }
+
+  EXPECT_EQ(discrete_values, (set<string>{ "x", "y", "z" }));
+  EXPECT_EQ(integer_values, (set<int>{ 1, 2, 3, 4 }));
+
+  // (a uniform sampling would put ~0.1% of the samples below 1,
+  //  and ~3% of the integer samples below 32)
+  EXPECT_GT(below_one, kSamples / 3);
+  EXPECT_LT(below_one, kSamples * 2 / 3);
+  EXPECT_GT(log_integer_below_32, kSamples / 3);
+  EXPECT_LT(log_integer_below_32, kSamples * 2 / 3);
+}
+
+TEST(SweepTest, RandomSearchSeed) {
+  const auto parameters = darwin_cli::parseSweepParameters(json::parse(R"({
+    "domain.a": { "min": 0.0, "max": 1.0 }
+  })"));
+
+  SweepConfig config;
+  config.search = SweepSearch::Random;
+  config.samples = 5;
+
+  // the same seed reproduces the same variations
+  config.seed = 1;
+  const auto variations = darwin_cli::sweepVariations(config, parameters);
+  const auto same_variations = darwin_cli::sweepVariations(config, parameters);
+  ASSERT_EQ(variations.size(), 5);
+  ASSERT_EQ(same_variations.size(), 5);
+  for (size_t i = 0; i < variations.size(); ++i) {
+    EXPECT_EQ(variationValues(variations[i]), variationValues(same_variations[i]));
+  }
+
+  config.seed = 2;
+  const auto other_variations = darwin_cli::sweepVariations(config, parameters);
+  EXPECT_NE(variationValues(variations[0]), variationValues(other_variations[0]));
+
+  // invalid number of samples
+  config.samples = 0;
+  EXPECT_THROW(darwin_cli::sweepVariations(config, parameters), core::Exception);
+}
+
+TEST(SweepTest, Rungs) {
+  SweepConfig config;
+
+  // the budget is multiplied by eta, up to the max generations
+  config.halving_eta = 3;
+  config.min_generations = 5;
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 100), (vector<int>{ 5, 15, 45, 100 }));
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 45), (vector<int>{ 5, 15, 45 }));
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 46), (vector<int>{ 5, 15, 45, 46 }));
+
+  // a single rung if the first budget covers the max generations
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 5), (vector<int>{ 5 }));
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 3), (vector<int>{ 3 }));
+
+  config.halving_eta = 2;
+  config.min_generations = 1;
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 10), (vector<int>{ 1, 2, 4, 8, 10 }));
+
+  // no early stopping
+  config.halving_eta = 1;
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 10), (vector<int>{ 10 }));
+  config.halving_eta = 0;
+  config.min_generations = 0;
+  EXPECT_EQ(darwin_cli::sweepRungs(config, 10), (vector<int>{ 10 }));
+
+  // invalid first rung budget
+  config.halving_eta = 3;
+  config.min_generations = 0;
+  EXPECT_THROW(darwin_cli::sweepRungs(config, 10), core::Exception);
+}
+
+}  // namespace sweep_tests
@@ -16,9 +16,13 @@
 #include <domains/cart_pole/world.h>
 
 #include <core/darwin.h>
+#include <core/exception.h>
+#include <core/math_2d.h>
+#include <core/sim/cart_pole_batch.h>
 #include <tests/domains/test_brain.h>
 #include <third_party/gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 using namespace std;
@@ -128,6 +132,86 @@ TEST(CartPoleTest, World_PoleInertia) {
   EXPECT_LT(simulation(-1.0f), config.max_steps);
 }
 
+// the analytic physics tracks the Box2D simulation
+// (see sim::CartPoleBatch for the documented tolerance)
+TEST(CartPoleTest, World_AnalyticPhysics) {
+  cart_pole::Config config;
+  config.discrete_controls = false;
+  config.max_force = 5.0f;
+  config.max_steps = 250;
+  cart_pole::CartPole cart_pole(config);
+
+  // a simple (linear) stabilizing controller
+  auto controller = [](float x, float v, float angle, float angular_velocity) {
+    return x + 2 * v - (40 * angle + 10 * angular_velocity);
+  };
+
+  auto simulation = [&](float initial_angle, bool controlled) {
+    cart_pole::World world(initial_angle, &cart_pole);
+    sim::CartPoleBatch carts(cart_pole::World::analyticModel(config), 1);
+    carts.reset(0, { float(math::degreesToRadians(initial_angle)) });
+
+    float max_angle_diff = 0;
+    float max_distance_diff = 0;
+    int box2d_steps = 0;
+    int analytic_steps = 0;
+    bool box2d_active = true;
+    bool analytic_active = true;
+    for (int step = 0; step < config.max_steps; ++step) {
+      if (box2d_active) {
+        if (controlled) {
+          world.moveCart(controller(world.cartDistance(),
+                                    world.cartVelocity(),
+                                    world.poleAngle(),
+                                    world.poleAngularVelocity()));
+        }
+        box2d_active = world.simStep();
+        box2d_steps += box2d_active ? 1 : 0;
+      }
+
+      if (analytic_active) {
+        if (controlled) {
+          const float force = controller(carts.cartPosition(0),
+                                         carts.cartVelocity(0),
+                                         carts.poleAngle(0, 0),
+                                         carts.poleAngularVelocity(0, 0));
+          carts.setForce(0, cart_pole.actuatorForce(force));
+        }
+        carts.step(cart_pole::World::kTimeStep);
+        analytic_active =
+            cart_pole.withinLimits(carts.cartPosition(0), carts.poleAngle(0, 0));
+        analytic_steps += analytic_active ? 1 : 0;
+      }
+
+      if (!box2d_active || !analytic_active)
+        break;
+
+      const float angle_diff = fabsf(world.poleAngle() - carts.poleAngle(0, 0));
+      const float distance_diff = fabsf(world.cartDistance() - carts.cartPosition(0));
+      max_angle_diff = max(max_angle_diff, angle_diff);
+      max_distance_diff = max(max_distance_diff, distance_diff);
+    }
+
+    // the episodes may end one step apart
+    EXPECT_LE(abs(box2d_steps - analytic_steps), 1);
+
+    if (controlled) {
+      EXPECT_EQ(box2d_steps, config.max_steps);
+      EXPECT_LT(max_angle_diff, 1e-2f);
+      EXPECT_LT(max_distance_diff, 1e-2f);
+    } else {
+      EXPECT_LT(box2d_steps, config.max_steps);
+      EXPECT_LT(max_angle_diff, 2e-2f);
+      EXPECT_LT(max_distance_diff, 2e-2f);
+    }
+  };
+
+  simulation(+5.0f, false);
+  simulation(-10.0f, false);
+  simulation(+5.0f, true);
+  simulation(-10.0f, true);
+}
+
 TEST(CartPoleTest, EvaluatePopulation_SingleInput) {
   constexpr int kMaxSteps = 100;
 
@@ -189,4 +273,47 @@ TEST(CartPoleTest, EvaluatePopulation_EveryInput) {
   EXPECT_GT(population[4]->fitness, 0);
 }
 
+TEST(CartPoleTest, EvaluatePopulation_AnalyticPhysics) {
+  constexpr int kMaxSteps = 250;
+
+  cart_pole::Config config;
+  config.physics = sim::CartPolePhysics::Analytic;
+  config.max_initial_angle = 0.0f;
+  config.max_steps = kMaxSteps;
+  config.max_force = 5.0f;
+  config.test_worlds = 3;
+  config.discrete_controls = false;
+
+  // more genotypes than a single batch of carts
+  vector<float> force_values(100, 0.0f);
+  force_values[1] = +1.0f;
+  force_values[2] = -1.0f;
+  force_values[98] = +2.0f;
+  force_values[99] = -2.0f;
+
+  cart_pole::CartPole cart_pole(config);
+  TestPopulation population(&cart_pole, force_values);
+  cart_pole.evaluatePopulation(&population);
+
+  // force = 0.0f
+  EXPECT_EQ(population[0]->fitness, kMaxSteps);
+  EXPECT_EQ(population[97]->fitness, kMaxSteps);
+
+  // force = +/-1.0f
+  EXPECT_GT(population[0]->fitness, population[1]->fitness);
+  EXPECT_EQ(population[1]->fitness, population[2]->fitness);
+
+  // force = +/-2.0f
+  EXPECT_GT(population[2]->fitness, population[98]->fitness);
+  EXPECT_EQ(population[98]->fitness, population[99]->fitness);
+  EXPECT_GT(population[99]->fitness, 0);
+}
+
+TEST(CartPoleTest, AnalyticPhysics_CartFriction) {
+  cart_pole::Config config;
+  config.physics = sim::CartPolePhysics::Analytic;
+  config.cart_friction = 0.1f;
+  EXPECT_THROW(cart_pole::CartPole cart_pole(config), core::Exception);
+}
+
 }  // namespace cart_pole_tests
@@ -6,7 +6,9 @@ SOURCES += \
     cart_pole_tests.cpp \
     double_cart_pole_tests.cpp \
     unicycle_tests.cpp \
-    ballistics_tests.cpp
+    ballistics_tests.cpp \
+    harvester_tests.cpp \
+    tic_tac_toe_tests.cpp
 
 HEADERS += \
     test_brain.h
@@ -16,9 +16,13 @@
 #include <domains/double_cart_pole/world.h>
 
 #include <core/darwin.h>
+#include <core/exception.h>
+#include <core/math_2d.h>
+#include <core/sim/cart_pole_batch.h>
 #include <tests/domains/test_brain.h>
 #include <third_party/gtest/gtest.h>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 using namespace std;
@@ -134,6 +138,65 @@ TEST(DoubleCartPoleTest, World_PoleInertia) {
   EXPECT_LT(simulation(-1.0f), config.max_steps);
 }
 
+// the analytic physics tracks the Box2D simulation
+// (see sim::CartPoleBatch for the documented tolerance)
+TEST(DoubleCartPoleTest, World_AnalyticPhysics) {
+  double_cart_pole::Config config;
+  config.discrete_controls = false;
+  config.max_steps = 250;
+  double_cart_pole::DoubleCartPole cart_pole(config);
+
+  auto simulation = [&](float initial_angle_1, float initial_angle_2, float force) {
+    double_cart_pole::World world(initial_angle_1, initial_angle_2, &cart_pole);
+    sim::CartPoleBatch carts(double_cart_pole::World::analyticModel(config), 1);
+    carts.reset(0,
+                { float(math::degreesToRadians(initial_angle_1)),
+                  float(math::degreesToRadians(initial_angle_2)) });
+
+    float max_angle_diff = 0;
+    float max_distance_diff = 0;
+    int box2d_steps = 0;
+    int analytic_steps = 0;
+    bool box2d_active = true;
+    bool analytic_active = true;
+    for (int step = 0; step < config.max_steps; ++step) {
+      if (box2d_active) {
+        world.moveCart(force);
+        box2d_active = world.simStep();
+        box2d_steps += box2d_active ? 1 : 0;
+      }
+
+      if (analytic_active) {
+        carts.setForce(0, cart_pole.actuatorForce(force));
+        carts.step(double_cart_pole::World::kTimeStep);
+        analytic_active = cart_pole.withinLimits(
+            carts.cartPosition(0), carts.poleAngle(0, 0), carts.poleAngle(0, 1));
+        analytic_steps += analytic_active ? 1 : 0;
+      }
+
+      if (!box2d_active || !analytic_active)
+        break;
+
+      const float angle_1_diff = fabsf(world.pole1Angle() - carts.poleAngle(0, 0));
+      const float angle_2_diff = fabsf(world.pole2Angle() - carts.poleAngle(0, 1));
+      const float distance_diff = fabsf(world.cartDistance() - carts.cartPosition(0));
+      max_angle_diff = max(max_angle_diff, max(angle_1_diff, angle_2_diff));
+      max_distance_diff = max(max_distance_diff, distance_diff);
+    }
+
+    // the episodes may end one step apart
+    EXPECT_LE(abs(box2d_steps - analytic_steps), 1);
+    EXPECT_LT(max_angle_diff, 5e-2f);
+    EXPECT_LT(max_distance_diff, 2e-2f);
+  };
+
+  simulation(0.0f, 0.0f, 0.0f);
+  simulation(+5.0f, -3.0f, 0.0f);
+  simulation(-2.0f, +8.0f, 0.0f);
+  simulation(0.0f, 0.0f, +1.0f);
+  simulation(+5.0f, -3.0f, -2.0f);
+}
+
 TEST(DoubleCartPoleTest, EvaluatePopulation_SingleInput) {
   constexpr int kMaxSteps = 100;
 
@@ -195,4 +258,47 @@ TEST(DoubleCartPoleTest, EvaluatePopulation_EveryInput) {
   EXPECT_GT(population[4]->fitness, 0);
 }
 
+TEST(DoubleCartPoleTest, EvaluatePopulation_AnalyticPhysics) {
+  constexpr int kMaxSteps = 250;
+
+  double_cart_pole::Config config;
+  config.physics = sim::CartPolePhysics::Analytic;
+  config.max_initial_angle = 0.0f;
+  config.max_steps = kMaxSteps;
+  config.max_force = 5.0f;
+  config.test_worlds = 3;
+  config.discrete_controls = false;
+
+  // more genotypes than a single batch of carts
+  vector<float> force_values(100, 0.0f);
+  force_values[1] = +1.0f;
+  force_values[2] = -1.0f;
+  force_values[98] = +2.0f;
+  force_values[99] = -2.0f;
+
+  double_cart_pole::DoubleCartPole cart_pole(config);
+  TestPopulation population(&cart_pole, force_values);
+  cart_pole.evaluatePopulation(&population);
+
+  // force = 0.0f
+  EXPECT_EQ(population[0]->fitness, kMaxSteps);
+  EXPECT_EQ(population[97]->fitness, kMaxSteps);
+
+  // force = +/-1.0f
+  EXPECT_GT(population[0]->fitness, population[1]->fitness);
+  EXPECT_EQ(population[1]->fitness, population[2]->fitness);
+
+  // force = +/-2.0f
+  EXPECT_GT(population[2]->fitness, population[98]->fitness);
+  EXPECT_EQ(population[98]->fitness, population[99]->fitness);
+  EXPECT_GT(population[99]->fitness, 0);
+}
+
+TEST(DoubleCartPoleTest, AnalyticPhysics_CartFriction) {
+  double_cart_pole::Config config;
+  config.physics = sim::CartPolePhysics::Analytic;
+  config.cart_friction = 0.1f;
+  EXPECT_THROW(double_cart_pole::DoubleCartPole cart_pole(config), core::Exception);
+}
+
 }  // namespace double_cart_pole_tests
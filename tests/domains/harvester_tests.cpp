@@ -0,0 +1,125 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <domains/harvester/harvester.h>
+#include <domains/harvester/robot.h>
+#include <domains/harvester/world.h>
+#include <domains/harvester/world_map.h>
+
+#include <core/math_2d.h>
+#include <third_party/gtest/gtest.h>
+
+#include <vector>
+using namespace std;
+
+namespace harvester_tests {
+
+using harvester::WorldMap;
+
+// a small map, surrounded by walls
+WorldMap testMap() {
+  WorldMap world_map(10, 10);
+  for (int i = 0; i < 10; ++i) {
+    world_map.cells[0][i] = WorldMap::Cell::Wall;
+    world_map.cells[9][i] = WorldMap::Cell::Wall;
+    world_map.cells[i][0] = WorldMap::Cell::Wall;
+    world_map.cells[i][9] = WorldMap::Cell::Wall;
+  }
+  world_map.cells[5][7] = WorldMap::Cell::Wall;
+  world_map.cells[5][4] = WorldMap::Cell::FruitGood;
+  world_map.cells[3][2] = WorldMap::Cell::FruitBad;
+  return world_map;
+}
+
+TEST(HarvesterTest, VisitedOverlay) {
+  const auto world_map = testMap();
+  harvester::Robot robot;
+  harvester::World world_a(world_map, &robot);
+  harvester::World world_b(world_map, &robot);
+
+  EXPECT_EQ(world_a.visit(5, 4), WorldMap::Cell::FruitGood);
+  EXPECT_EQ(world_a.visit(5, 4), WorldMap::Cell::Visited);
+  EXPECT_EQ(world_a.visit(5, 5), WorldMap::Cell::Empty);
+  EXPECT_EQ(world_a.visit(0, 3), WorldMap::Cell::Wall);
+  EXPECT_EQ(world_a.cell(5, 4), WorldMap::Cell::Visited);
+  EXPECT_EQ(world_a.cell(5, 5), WorldMap::Cell::Visited);
+  EXPECT_EQ(world_a.cell(0, 3), WorldMap::Cell::Wall);
+
+  // the map, and the other worlds sharing it, are not affected
+  EXPECT_EQ(world_map.cells[5][4], WorldMap::Cell::FruitGood);
+  EXPECT_EQ(world_map.cells[5][5], WorldMap::Cell::Empty);
+  EXPECT_EQ(world_b.cell(5, 4), WorldMap::Cell::FruitGood);
+  EXPECT_EQ(world_b.visit(5, 4), WorldMap::Cell::FruitGood);
+}
+
+TEST(HarvesterTest, CastRays) {
+  const auto world_map = testMap();
+  harvester::Robot robot;
+  harvester::World world(world_map, &robot);
+
+  // (x, y) = (col, row)
+  const math::Vector2d origin(2.5, 5.5);
+  const vector<math::Vector2d> directions = {
+    { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -2 }, { 1, 1.5 },
+  };
+
+  vector<harvester::Robot::Ray> hits(directions.size());
+  world.castRays(origin, directions, &hits);
+
+  // good fruit
+  EXPECT_DOUBLE_EQ(hits[0].ray.x, 1.5);
+  EXPECT_DOUBLE_EQ(hits[0].ray.y, 0);
+  EXPECT_EQ(hits[0].row, 5);
+  EXPECT_EQ(hits[0].col, 4);
+
+  // left wall
+  EXPECT_DOUBLE_EQ(hits[1].ray.x, -1.5);
+  EXPECT_EQ(hits[1].col, 0);
+
+  // bottom wall
+  EXPECT_DOUBLE_EQ(hits[2].ray.y, 3.5);
+  EXPECT_EQ(hits[2].row, 9);
+
+  // bad fruit
+  EXPECT_DOUBLE_EQ(hits[3].ray.x, 0);
+  EXPECT_DOUBLE_EQ(hits[3].ray.y, -1.5);
+  EXPECT_EQ(hits[3].row, 3);
+  EXPECT_EQ(hits[3].col, 2);
+
+  // enters the bottom wall through the top edge (row 9), at x = 2.5 + 3.5 / 1.5
+  EXPECT_DOUBLE_EQ(hits[4].ray.y, 3.5);
+  EXPECT_DOUBLE_EQ(hits[4].ray.x, 3.5 / 1.5);
+  EXPECT_EQ(hits[4].row, 9);
+  EXPECT_EQ(hits[4].col, 4);
+
+  // the visited fruits are consumed, so the rays pass through
+  world.visit(5, 4);
+  world.visit(3, 2);
+  world.castRays(origin, directions, &hits);
+  EXPECT_DOUBLE_EQ(hits[0].ray.x, 4.5);
+  EXPECT_EQ(hits[0].col, 7);
+  EXPECT_DOUBLE_EQ(hits[3].ray.y, -4.5);
+  EXPECT_EQ(hits[3].row, 0);
+}
+
+// racing makes the fitness values depend on the rest of the evaluated genotypes
+TEST(HarvesterTest, IndependentEvaluation) {
+  harvester::Config config;
+  EXPECT_TRUE(harvester::Harvester(config).independentEvaluation());
+
+  config.racing.selectCase(darwin::RacingType::SuccessiveHalving);
+  EXPECT_FALSE(harvester::Harvester(config).independentEvaluation());
+}
+
+}  // namespace harvester_tests
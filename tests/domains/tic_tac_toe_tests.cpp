@@ -0,0 +1,116 @@
+// Copyright The Darwin Neuroevolution Framework Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <domains/tic_tac_toe/ann_player.h>
+#include <domains/tic_tac_toe/board.h>
+#include <domains/tic_tac_toe/game_rules.h>
+#include <domains/tic_tac_toe/test_players.h>
+
+#include <core/darwin.h>
+#include <third_party/gtest/gtest.h>
+
+#include <math.h>
+#include <memory>
+using namespace std;
+
+namespace tic_tac_toe_tests {
+
+using tic_tac_toe::Board;
+using tournament::GameOutcome;
+
+// a stateless brain, with an arbitrary (but deterministic) output
+struct FixedBrain : public darwin::Brain {
+  float inputs[Board::kSize] = {};
+  float value = 0;
+  int think_count = 0;
+
+  void setInput(int index, float input) override { inputs[index] = input; }
+  float output(int) const override { return value; }
+
+  void think() override {
+    value = 0;
+    for (int i = 0; i < Board::kSize; ++i)
+      value += sinf(float(i + 1) * 1.7f) * inputs[i];
+    ++think_count;
+  }
+
+  void resetState() override {}
+};
+
+TEST(TicTacToeTest, BoardIndex) {
+  Board board;
+  EXPECT_EQ(board.index(), 0);
+  EXPECT_EQ(board.relativeIndex(Board::Piece::X), 0);
+
+  board[0] = Board::Piece::X;
+  board[1] = Board::Piece::Zero;
+  board[8] = Board::Piece::X;
+  const int expected_index = 1 + 2 * 3 + 1 * 6561;
+  EXPECT_EQ(board.index(), expected_index);
+  EXPECT_EQ(board.relativeIndex(Board::Piece::X), expected_index);
+  EXPECT_EQ(board.relativeIndex(Board::Piece::Zero), 2 + 1 * 3 + 2 * 6561);
+
+  for (int square = 0; square < Board::kSize; ++square)
+    board[square] = Board::Piece::Zero;
+  EXPECT_EQ(board.index(), Board::kConfigurations - 1);
+}
+
+TEST(TicTacToeTest, PerfectPlayer) {
+  tic_tac_toe::TicTacToeRules rules;
+
+  tic_tac_toe::PerfectPlayer perfect_player;
+  tic_tac_toe::PerfectPlayer perfect_opponent;
+  EXPECT_EQ(rules.play(&perfect_player, &perfect_opponent), GameOutcome::Draw);
+
+  // the perfect player never loses
+  for (bool informed_choice : { false, true }) {
+    tic_tac_toe::RandomPlayer random_player(informed_choice);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_NE(rules.play(&perfect_player, &random_player),
+                GameOutcome::SecondPlayerWins);
+      EXPECT_NE(rules.play(&random_player, &perfect_player),
+                GameOutcome::FirstPlayerWins);
+    }
+  }
+}
+
+TEST(TicTacToeTest, MemoizedMoves) {
+  tic_tac_toe::TicTacToeRules rules;
+  tic_tac_toe::PerfectPlayer perfect_player;
+
+  auto fixed_brain = make_unique<FixedBrain>();
+  auto memoized_thinking = fixed_brain.get();
+  tic_tac_toe::MemoizedBrain memoized_brain(std::move(fixed_brain));
+  FixedBrain reference_brain;
+
+  tic_tac_toe::AnnPlayer memoized_player;
+  memoized_player.attach({ nullptr, &memoized_brain });
+  tic_tac_toe::AnnPlayer reference_player;
+  reference_player.attach({ nullptr, &reference_brain });
+
+  const auto outcome = rules.play(&reference_player, &perfect_player);
+  const auto rematch_outcome = rules.play(&perfect_player, &reference_player);
+
+  EXPECT_EQ(rules.play(&memoized_player, &perfect_player), outcome);
+  EXPECT_EQ(rules.play(&perfect_player, &memoized_player), rematch_outcome);
+  const int think_count = memoized_thinking->think_count;
+  EXPECT_GT(think_count, 0);
+
+  // the same games again, using only the cached moves
+  EXPECT_EQ(rules.play(&memoized_player, &perfect_player), outcome);
+  EXPECT_EQ(rules.play(&perfect_player, &memoized_player), rematch_outcome);
+  EXPECT_EQ(memoized_thinking->think_count, think_count);
+}
+
+}  // namespace tic_tac_toe_tests
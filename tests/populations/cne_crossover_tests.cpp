@@ -19,7 +19,14 @@
 namespace cne_crossover_tests {
 
 struct CneCrossoverTest : public testing::TestWithParam<cne::CrossoverOp> {
-  CneCrossoverTest() { cne::g_config.crossover_operator = GetParam(); }
+  CneCrossoverTest() {
+    config.crossover_operator = GetParam();
+    cne::g_config.bind(&config);
+  }
+
+  ~CneCrossoverTest() { cne::g_config.unbind(&config); }
+
+  cne::Config config;
 };
 
 TEST_P(CneCrossoverTest, SmokeTestSingleElement) {
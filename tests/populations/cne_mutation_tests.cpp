@@ -20,16 +20,26 @@ namespace cne_mutation_tests {
 
 struct CneMutationTest : public testing::TestWithParam<cne::MutationOp> {
   CneMutationTest() {
-    cne::g_config.mutation_operator = GetParam();
-    cne::g_config.mutation_chance = 0.8f;
+    config.mutation_operator = GetParam();
+    config.mutation_chance = 0.8f;
+    cne::g_config.bind(&config);
+    ann::g_config.bind(&ann_config);
   }
+
+  ~CneMutationTest() {
+    cne::g_config.unbind(&config);
+    ann::g_config.unbind(&ann_config);
+  }
+
+  cne::Config config;
+  ann::Config ann_config;
 };
 
 TEST_P(CneMutationTest, SmokeTestSingleElement) {
   constexpr size_t kRows = 1;
   constexpr size_t kCols = 1;
   constexpr float kStdDev = 1.0f;
-  ann::g_config.mutation_normal_distribution = false;
+  ann_config.mutation_normal_distribution = false;
   ann::Matrix child(kRows, kCols);
   cne::mutationOperator(child, kStdDev);
 }
@@ -38,7 +48,7 @@ TEST_P(CneMutationTest, SmokeTestColumn) {
   constexpr size_t kRows = 9;
   constexpr size_t kCols = 1;
   constexpr float kStdDev = 2.0f;
-  ann::g_config.mutation_normal_distribution = true;
+  ann_config.mutation_normal_distribution = true;
   ann::Matrix child(kRows, kCols);
   cne::mutationOperator(child, kStdDev);
 }
@@ -47,7 +57,7 @@ TEST_P(CneMutationTest, SmokeTestRow) {
   constexpr size_t kRows = 1;
   constexpr size_t kCols = 2;
   constexpr float kStdDev = 1.0f;
-  ann::g_config.mutation_normal_distribution = false;
+  ann_config.mutation_normal_distribution = false;
   ann::Matrix child(kRows, kCols);
   cne::mutationOperator(child, kStdDev);
 }
@@ -56,7 +66,7 @@ TEST_P(CneMutationTest, SmokeTestGeneric) {
   constexpr size_t kRows = 2;
   constexpr size_t kCols = 17;
   constexpr float kStdDev = 4.0f;
-  ann::g_config.mutation_normal_distribution = true;
+  ann_config.mutation_normal_distribution = true;
   ann::Matrix child(kRows, kCols);
   cne::mutationOperator(child, kStdDev);
 }
@@ -5,6 +5,7 @@ SUBDIRS += \
     bindings \
     core \
     darwin \
+    darwin_cli \
     populations \
     domains \
     third_party